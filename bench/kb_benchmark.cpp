@@ -0,0 +1,361 @@
+#include "kb_benchmark.h"
+#include "lexer.h"
+#include "obelisk.h"
+#include "parser.h"
+#include "version.h"
+
+#include <unistd.h>
+
+#include <algorithm>
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <stdexcept>
+
+static void obelisk::showKbBenchmarkUsage()
+{
+    std::cout << obelisk::kbBenchmarkUsageMessage << std::endl;
+}
+
+static void obelisk::buildKnowledgeBase(const std::string& sourceFile,
+    std::unique_ptr<obelisk::KnowledgeBase>& kb)
+{
+    auto parser = std::unique_ptr<obelisk::Parser> {new obelisk::Parser(
+        std::shared_ptr<obelisk::Lexer> {new obelisk::Lexer(sourceFile)})};
+
+    // prime the first token
+    parser->getNextToken();
+    while (true)
+    {
+        switch (parser->getCurrentToken())
+        {
+            case obelisk::Lexer::kTokenEof :
+                parser->insertStatements(kb);
+                return;
+            case obelisk::Lexer::kTokenFact :
+                parser->handleFact(kb);
+                break;
+            case obelisk::Lexer::kTokenRule :
+                parser->handleRule(kb);
+                break;
+            case obelisk::Lexer::kTokenAction :
+                parser->handleAction(kb);
+                break;
+            case obelisk::Lexer::kTokenTransitive :
+                parser->handleTransitive(kb);
+                break;
+            default :
+                parser->getNextToken();
+                break;
+        }
+    }
+}
+
+static void obelisk::printResult(std::ostream& output,
+    const std::string& benchmark,
+    const obelisk::SyntheticKbOptions& options,
+    std::size_t operations,
+    std::vector<std::uint64_t>& latencies)
+{
+    std::sort(latencies.begin(), latencies.end());
+
+    auto percentile = [&latencies](std::size_t percent) -> std::uint64_t
+    {
+        if (latencies.empty())
+        {
+            return 0;
+        }
+        return latencies[(latencies.size() - 1) * percent / 100];
+    };
+
+    std::uint64_t nanoseconds = 0;
+    for (auto latency : latencies)
+    {
+        nanoseconds += latency;
+    }
+    auto seconds    = nanoseconds / 1e9;
+    auto throughput = seconds > 0 ? operations / seconds : 0;
+
+    std::ostringstream line;
+    line << "{\"version\":\"" << obelisk::version << "\",\"benchmark\":\""
+         << benchmark << "\",\"facts\":" << options.facts
+         << ",\"entities\":" << options.entities
+         << ",\"verbs\":" << options.verbs << ",\"skew\":" << options.skew
+         << ",\"chains\":" << options.chains
+         << ",\"fan_out\":" << options.fanOut << ",\"depth\":" << options.depth
+         << ",\"seed\":" << options.seed << ",\"operations\":" << operations
+         << std::fixed << std::setprecision(9) << ",\"seconds\":" << seconds
+         << std::setprecision(2) << ",\"throughput\":" << throughput
+         << ",\"p50_ns\":" << percentile(50)
+         << ",\"p99_ns\":" << percentile(99)
+         << ",\"max_ns\":" << (latencies.empty() ? 0 : latencies.back())
+         << "}";
+    output << line.str() << std::endl;
+}
+
+static int obelisk::benchmarkKnowledgeBase(
+    const obelisk::SyntheticKbOptions& options,
+    std::size_t queries,
+    const std::string& directory,
+    std::ostream& output)
+{
+    auto name       = "kb_" + std::to_string(options.facts);
+    auto sourceFile = directory + "/" + name + ".obk";
+    auto kbFile     = directory + "/" + name + ".kb";
+    auto fileKbFile = directory + "/" + name + ".file.kb";
+
+    auto elapsed = [](std::chrono::steady_clock::time_point start)
+    {
+        return static_cast<std::uint64_t>(
+            std::chrono::duration_cast<std::chrono::nanoseconds>(
+                std::chrono::steady_clock::now() - start)
+                .count());
+    };
+
+    try
+    {
+        obelisk::SyntheticKb synthetic(options);
+        std::size_t statements = 0;
+        {
+            std::ofstream stream(sourceFile);
+            statements = synthetic.write(stream);
+            if (!stream)
+            {
+                throw std::runtime_error("could not write " + sourceFile);
+            }
+        }
+
+        // the KnowledgeBase is built in memory and saved once, so the build
+        // and the disk are measured separately
+        std::vector<std::uint64_t> latencies;
+        {
+            auto kb = std::unique_ptr<obelisk::KnowledgeBase> {
+                new obelisk::KnowledgeBase(kbFile.c_str(),
+                    obelisk::KnowledgeBase::kLayoutRowid,
+                    obelisk::KnowledgeBase::kStorageMemory)};
+
+            auto start = std::chrono::steady_clock::now();
+            buildKnowledgeBase(sourceFile, kb);
+            latencies = {elapsed(start)};
+            printResult(output, "build", options, statements, latencies);
+
+            auto rules = options.chains * options.depth * options.fanOut;
+            start      = std::chrono::steady_clock::now();
+            kb->propagate();
+            latencies = {elapsed(start)};
+            printResult(output, "propagate", options, rules, latencies);
+
+            start = std::chrono::steady_clock::now();
+            kb->save();
+            latencies = {elapsed(start)};
+            printResult(output, "save", options, statements, latencies);
+        }
+
+        // the same build and propagate straight into a file, the way obelisk
+        // loads source code, so they can be compared with the in-memory ones
+        {
+            auto kb = std::unique_ptr<obelisk::KnowledgeBase> {
+                new obelisk::KnowledgeBase(fileKbFile.c_str())};
+
+            auto start = std::chrono::steady_clock::now();
+            buildKnowledgeBase(sourceFile, kb);
+            latencies = {elapsed(start)};
+            printResult(output, "build_file", options, statements, latencies);
+
+            auto rules = options.chains * options.depth * options.fanOut;
+            start      = std::chrono::steady_clock::now();
+            kb->propagate();
+            latencies = {elapsed(start)};
+            printResult(output, "propagate_file", options, rules, latencies);
+        }
+        std::filesystem::remove(fileKbFile);
+
+        obelisk::Obelisk obelisk(kbFile);
+
+        auto queryFacts = [&](const std::string& benchmark,
+                              const std::vector<obelisk::SyntheticFact>& facts)
+        {
+            if (facts.empty())
+            {
+                return;
+            }
+            latencies.clear();
+            for (std::size_t i = 0; i < queries; i++)
+            {
+                auto& fact = facts[i % facts.size()];
+                auto start = std::chrono::steady_clock::now();
+                obelisk.query(fact.leftEntity, fact.verb, fact.rightEntity);
+                latencies.push_back(elapsed(start));
+            }
+            printResult(output, benchmark, options, queries, latencies);
+        };
+
+        // facts that don't exist are made of entities that were never
+        // generated
+        std::vector<obelisk::SyntheticFact> missingFacts;
+        for (auto& fact : synthetic.getStatedFacts())
+        {
+            missingFacts.push_back(
+                {fact.leftEntity + "x", fact.verb, fact.rightEntity});
+        }
+
+        queryFacts("query_stated", synthetic.getStatedFacts());
+        queryFacts("query_derived", synthetic.getDerivedFacts());
+        queryFacts("query_missing", missingFacts);
+
+        auto& actionFacts = synthetic.getActionFacts();
+        if (!actionFacts.empty())
+        {
+            latencies.clear();
+            for (std::size_t i = 0; i < queries; i++)
+            {
+                auto& fact = actionFacts[i % actionFacts.size()];
+                auto start = std::chrono::steady_clock::now();
+                obelisk.queryAction(fact.leftEntity,
+                    fact.verb,
+                    fact.rightEntity);
+                latencies.push_back(elapsed(start));
+            }
+            printResult(output, "query_action", options, queries, latencies);
+        }
+    }
+    catch (obelisk::LexerException& exception)
+    {
+        std::cout << "Error: " << exception.what() << std::endl;
+        return EXIT_FAILURE;
+    }
+    catch (obelisk::ParserException& exception)
+    {
+        std::cout << "Error: " << exception.what() << std::endl;
+        return EXIT_FAILURE;
+    }
+    catch (obelisk::KnowledgeBaseException& exception)
+    {
+        std::cout << "Error: " << exception.what() << std::endl;
+        return EXIT_FAILURE;
+    }
+    catch (std::exception& exception)
+    {
+        std::cout << "Error: " << exception.what() << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    std::filesystem::remove(sourceFile);
+    std::filesystem::remove(kbFile);
+    std::filesystem::remove(fileKbFile);
+    return EXIT_SUCCESS;
+}
+
+int main(int argc, char** argv)
+{
+    obelisk::SyntheticKbOptions options;
+    std::vector<std::size_t> scales {1000, 10000};
+    std::size_t queries = 10000;
+    std::string outputFile;
+
+    while (true)
+    {
+        int option_index = 0;
+        auto option      = getopt_long(argc,
+            argv,
+            "ho:q:n:e:b:z:c:f:d:s:",
+            obelisk::kb_benchmark_long_options,
+            &option_index);
+        switch (option)
+        {
+            case 'o' :
+                outputFile = std::string(optarg);
+                continue;
+            case 'q' :
+                try
+                {
+                    queries = std::stoull(optarg);
+                }
+                catch (std::exception& exception)
+                {
+                    obelisk::showKbBenchmarkUsage();
+                    return EXIT_FAILURE;
+                }
+                continue;
+            case 'n' :
+                try
+                {
+                    scales.clear();
+                    std::istringstream list(optarg);
+                    std::string scale;
+                    while (std::getline(list, scale, ','))
+                    {
+                        scales.push_back(std::stoull(scale));
+                    }
+                }
+                catch (std::exception& exception)
+                {
+                    obelisk::showKbBenchmarkUsage();
+                    return EXIT_FAILURE;
+                }
+                continue;
+            case 'h' :
+                obelisk::showKbBenchmarkUsage();
+                return EXIT_SUCCESS;
+                break;
+            case -1 :
+                break;
+            default :
+                try
+                {
+                    if (optarg != nullptr
+                        && obelisk::setSyntheticKbOption(option,
+                            optarg,
+                            options))
+                    {
+                        continue;
+                    }
+                }
+                catch (std::exception& exception)
+                {
+                    // an invalid value shows the usage like an unknown option
+                }
+                obelisk::showKbBenchmarkUsage();
+                return EXIT_FAILURE;
+                break;
+        }
+
+        break;
+    }
+
+    std::ofstream outputStream;
+    if (!outputFile.empty())
+    {
+        outputStream.open(outputFile);
+        if (!outputStream)
+        {
+            std::cout << "Error: could not create " << outputFile << std::endl;
+            return EXIT_FAILURE;
+        }
+    }
+    std::ostream& output = outputFile.empty() ? std::cout : outputStream;
+
+    auto directory = std::filesystem::temp_directory_path()
+                   / ("obelisk_kb_benchmark_" + std::to_string(getpid()));
+    std::filesystem::create_directories(directory);
+
+    auto result = EXIT_SUCCESS;
+    for (auto scale : scales)
+    {
+        options.facts = scale;
+        result        = obelisk::benchmarkKnowledgeBase(options,
+            queries,
+            directory.string(),
+            output);
+        if (result != EXIT_SUCCESS)
+        {
+            break;
+        }
+    }
+
+    std::filesystem::remove_all(directory);
+    return result;
+}
@@ -0,0 +1,113 @@
+#ifndef OBELISK_KB_BENCHMARK_H
+#define OBELISK_KB_BENCHMARK_H
+
+#include "knowledge_base.h"
+#include "synthetic_kb.h"
+
+#include <getopt.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <ostream>
+#include <string>
+#include <vector>
+
+namespace obelisk
+{
+    /**
+     * @brief The usage messsage displayed during help or incorrect usage.
+     *
+     */
+    std::string kbBenchmarkUsageMessage = R"(Usage: kb_benchmark [OPTION]...
+Measure building, propagating and querying synthetic obelisk knowledge bases.
+Each result is printed as one JSON object per line.
+
+Options:
+  -h, --help            shows this help/usage message
+  -o, --output=FILE     the file to write the results to (default stdout)
+  -q, --queries=N       the number of queries of each kind (default 10000)
+  -n, --facts=N[,N]...  the number of facts stated in each knowledge base, one
+                        knowledge base is measured for each number (default
+                        1000,10000)
+)" + obelisk::syntheticKbUsageMessage;
+
+    /**
+     * @brief The command line arguments that kb_benchmark accepts.
+     *
+     */
+    static struct option kb_benchmark_long_options[] = {
+        {"help",     no_argument,       0, 'h'},
+        {"output",   required_argument, 0, 'o'},
+        {"queries",  required_argument, 0, 'q'},
+        {"facts",    required_argument, 0, 'n'},
+        {"entities", required_argument, 0, 'e'},
+        {"verbs",    required_argument, 0, 'b'},
+        {"skew",     required_argument, 0, 'z'},
+        {"chains",   required_argument, 0, 'c'},
+        {"fan-out",  required_argument, 0, 'f'},
+        {"depth",    required_argument, 0, 'd'},
+        {"seed",     required_argument, 0, 's'},
+        {0,          0,                 0, 0  }
+    };
+
+    /**
+     * @brief Prints out the usage of kb_benchmark to the stdout.
+     *
+     */
+    static void showKbBenchmarkUsage();
+
+    /**
+     * @brief Parse a source file and insert its statements into a
+     * KnowledgeBase.
+     *
+     * @param[in] sourceFile The source file.
+     * @param[in] kb The KnowledgeBase to insert the statements into.
+     */
+    static void buildKnowledgeBase(const std::string& sourceFile,
+        std::unique_ptr<obelisk::KnowledgeBase>& kb);
+
+    /**
+     * @brief Print one result as a JSON object on its own line.
+     *
+     * The keys are always printed in the same order so the results of two
+     * versions of obelisk can be compared with diff. The latencies are
+     * sorted in place, a phase that is run once has its own time as its only
+     * latency.
+     *
+     * @param[in] output The stream to print the result to.
+     * @param[in] benchmark The name of the benchmark.
+     * @param[in] options The options of the knowledge base.
+     * @param[in] operations The number of operations measured.
+     * @param[in] latencies The time of each run in nanoseconds.
+     */
+    static void printResult(std::ostream& output,
+        const std::string& benchmark,
+        const obelisk::SyntheticKbOptions& options,
+        std::size_t operations,
+        std::vector<std::uint64_t>& latencies);
+
+    /**
+     * @brief Benchmark one knowledge base.
+     *
+     * The knowledge base is built in memory from generated source code, its
+     * rules are propagated and it is saved. The build and propagation are
+     * then measured again on a KnowledgeBase file. The saved knowledge base
+     * is opened like an application would and the stated facts, the derived
+     * facts, facts that don't exist and the suggested actions are queried
+     * one at a time.
+     *
+     * @param[in] options The options of the knowledge base.
+     * @param[in] queries The number of queries of each kind.
+     * @param[in] directory The directory to write the temporary files to.
+     * @param[in] output The stream to print the results to.
+     * @return int Returns EXIT_SUCCESS or EXIT_FAILURE.
+     */
+    static int benchmarkKnowledgeBase(
+        const obelisk::SyntheticKbOptions& options,
+        std::size_t queries,
+        const std::string& directory,
+        std::ostream& output);
+} // namespace obelisk
+
+#endif
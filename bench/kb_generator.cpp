@@ -0,0 +1,90 @@
+#include "kb_generator.h"
+
+#include <fstream>
+#include <iostream>
+#include <stdexcept>
+
+static void obelisk::showGeneratorUsage()
+{
+    std::cout << obelisk::generatorUsageMessage << std::endl;
+}
+
+int main(int argc, char** argv)
+{
+    obelisk::SyntheticKbOptions options;
+    std::string outputFile;
+
+    while (true)
+    {
+        int option_index = 0;
+        auto option      = getopt_long(argc,
+            argv,
+            "ho:n:e:b:z:c:f:d:s:",
+            obelisk::generator_long_options,
+            &option_index);
+        switch (option)
+        {
+            case 'o' :
+                outputFile = std::string(optarg);
+                continue;
+            case 'n' :
+                try
+                {
+                    options.facts = std::stoull(optarg);
+                }
+                catch (std::exception& exception)
+                {
+                    obelisk::showGeneratorUsage();
+                    return EXIT_FAILURE;
+                }
+                continue;
+            case 'h' :
+                obelisk::showGeneratorUsage();
+                return EXIT_SUCCESS;
+                break;
+            case -1 :
+                break;
+            default :
+                try
+                {
+                    if (optarg != nullptr
+                        && obelisk::setSyntheticKbOption(option,
+                            optarg,
+                            options))
+                    {
+                        continue;
+                    }
+                }
+                catch (std::exception& exception)
+                {
+                    // an invalid value shows the usage like an unknown option
+                }
+                obelisk::showGeneratorUsage();
+                return EXIT_FAILURE;
+                break;
+        }
+
+        break;
+    }
+
+    obelisk::SyntheticKb kb(options);
+    if (outputFile.empty())
+    {
+        kb.write(std::cout);
+        return std::cout ? EXIT_SUCCESS : EXIT_FAILURE;
+    }
+
+    std::ofstream stream(outputFile);
+    if (!stream)
+    {
+        std::cout << "Error: could not create " << outputFile << std::endl;
+        return EXIT_FAILURE;
+    }
+    kb.write(stream);
+    if (!stream)
+    {
+        std::cout << "Error: could not write " << outputFile << std::endl;
+        return EXIT_FAILURE;
+    }
+    return EXIT_SUCCESS;
+}
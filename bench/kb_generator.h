@@ -0,0 +1,50 @@
+#ifndef OBELISK_KB_GENERATOR_H
+#define OBELISK_KB_GENERATOR_H
+
+#include "synthetic_kb.h"
+
+#include <getopt.h>
+
+#include <string>
+
+namespace obelisk
+{
+    /**
+     * @brief The usage messsage displayed during help or incorrect usage.
+     *
+     */
+    std::string generatorUsageMessage = R"(Usage: kb_generator [OPTION]...
+Generate the obelisk source code of a synthetic knowledge base.
+
+Options:
+  -h, --help            shows this help/usage message
+  -o, --output=FILE     the file to write the source code to (default stdout)
+  -n, --facts=N         the number of facts stated (default 1000)
+)" + obelisk::syntheticKbUsageMessage;
+
+    /**
+     * @brief The command line arguments that kb_generator accepts.
+     *
+     */
+    static struct option generator_long_options[] = {
+        {"help",     no_argument,       0, 'h'},
+        {"output",   required_argument, 0, 'o'},
+        {"facts",    required_argument, 0, 'n'},
+        {"entities", required_argument, 0, 'e'},
+        {"verbs",    required_argument, 0, 'b'},
+        {"skew",     required_argument, 0, 'z'},
+        {"chains",   required_argument, 0, 'c'},
+        {"fan-out",  required_argument, 0, 'f'},
+        {"depth",    required_argument, 0, 'd'},
+        {"seed",     required_argument, 0, 's'},
+        {0,          0,                 0, 0  }
+    };
+
+    /**
+     * @brief Prints out the usage of kb_generator to the stdout.
+     *
+     */
+    static void showGeneratorUsage();
+} // namespace obelisk
+
+#endif
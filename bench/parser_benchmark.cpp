@@ -0,0 +1,359 @@
+#include "knowledge_base.h"
+#include "lexer.h"
+#include "parser.h"
+#include "parser_benchmark.h"
+
+#include <unistd.h>
+
+#include <algorithm>
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <limits>
+#include <memory>
+#include <stdexcept>
+#include <vector>
+
+static void obelisk::showBenchmarkUsage()
+{
+    std::cout << obelisk::benchmarkUsageMessage << std::endl;
+}
+
+static std::size_t obelisk::generateSource(const std::string& shape,
+    std::size_t size,
+    std::size_t side,
+    const std::string& sourceFile)
+{
+    std::ofstream stream(sourceFile);
+    if (!stream)
+    {
+        throw std::runtime_error("could not create " + sourceFile);
+    }
+
+    std::size_t statements = 0;
+    if (shape == "facts")
+    {
+        for (std::size_t i = 0; i < size; i++)
+        {
+            stream << "fact(\"entity " << i << "\" is \"thing " << i % 1000
+                   << "\");\n";
+            statements++;
+        }
+    }
+    else if (shape == "cross")
+    {
+        // every statement has side entities on each side
+        auto perStatement = std::max<std::size_t>(side * side, 1);
+        for (std::size_t produced = 0; produced < size;
+             produced += perStatement)
+        {
+            stream << "fact(";
+            for (std::size_t i = 0; i < side; i++)
+            {
+                stream << (i == 0 ? "" : " and ") << "\"left " << statements
+                       << " " << i << "\"";
+            }
+            stream << " has ";
+            for (std::size_t i = 0; i < side; i++)
+            {
+                stream << (i == 0 ? "" : " and ") << "\"right " << i << "\"";
+            }
+            stream << ");\n";
+            statements++;
+        }
+    }
+    else if (shape == "rules")
+    {
+        // one chain where each level is derived from the one before it
+        stream << "fact(\"x\" is \"level 0\");\n";
+        statements++;
+        for (std::size_t i = 0; i < size; i++)
+        {
+            stream << "rule(\"x\" is \"level " << i + 1
+                   << "\" if \"x\" is \"level " << i << "\");\n";
+            statements++;
+        }
+    }
+    else if (shape == "comments")
+    {
+        const std::string comment(120, 'c');
+        for (std::size_t i = 0; i < size; i++)
+        {
+            stream << "# " << comment << "\n// " << comment << "\n";
+            stream << "fact(\"entity " << i << "\" is \"thing " << i % 1000
+                   << "\");\n";
+            statements++;
+        }
+    }
+    else
+    {
+        throw std::invalid_argument("unknown shape " + shape);
+    }
+
+    if (!stream)
+    {
+        throw std::runtime_error("could not write " + sourceFile);
+    }
+    return statements;
+}
+
+static std::size_t obelisk::lexSource(const std::string& sourceFile)
+{
+    obelisk::Lexer lexer(sourceFile);
+    std::size_t tokens = 0;
+    while (lexer.getToken() != obelisk::Lexer::kTokenEof)
+    {
+        tokens++;
+    }
+    return tokens;
+}
+
+static void obelisk::parseSource(const std::string& sourceFile,
+    std::unique_ptr<obelisk::KnowledgeBase>& kb)
+{
+    auto parser = std::unique_ptr<obelisk::Parser> {new obelisk::Parser(
+        std::shared_ptr<obelisk::Lexer> {new obelisk::Lexer(sourceFile)})};
+    parser->setRetainStatements(!kb);
+
+    // prime the first token
+    parser->getNextToken();
+    while (true)
+    {
+        switch (parser->getCurrentToken())
+        {
+            case obelisk::Lexer::kTokenEof :
+                if (kb)
+                {
+                    parser->insertStatements(kb);
+                }
+                return;
+            case obelisk::Lexer::kTokenFact :
+                parser->handleFact(kb);
+                break;
+            case obelisk::Lexer::kTokenRule :
+                parser->handleRule(kb);
+                break;
+            case obelisk::Lexer::kTokenAction :
+                parser->handleAction(kb);
+                break;
+            case obelisk::Lexer::kTokenTransitive :
+                parser->handleTransitive(kb);
+                break;
+            default :
+                parser->getNextToken();
+                break;
+        }
+    }
+}
+
+static double obelisk::timePhase(unsigned int repeat,
+    const std::function<void()>& phase)
+{
+    auto fastest = std::numeric_limits<double>::max();
+    for (unsigned int i = 0; i < repeat; i++)
+    {
+        auto start = std::chrono::steady_clock::now();
+        phase();
+        std::chrono::duration<double> elapsed
+            = std::chrono::steady_clock::now() - start;
+        fastest = std::min(fastest, elapsed.count());
+    }
+    return fastest;
+}
+
+static void obelisk::printThroughput(const std::string& shape,
+    const std::string& phase,
+    std::size_t bytes,
+    std::size_t tokens,
+    std::size_t statements,
+    double seconds)
+{
+    std::cout << std::left << std::setw(10) << shape << std::setw(8) << phase
+              << std::right << std::fixed << std::setprecision(2)
+              << std::setw(12) << bytes / 1e6 / seconds << std::setw(16)
+              << tokens / seconds << std::setw(16) << statements / seconds
+              << std::setprecision(4) << std::setw(12) << seconds
+              << std::endl;
+}
+
+static int obelisk::benchmarkShape(const std::string& shape,
+    std::size_t size,
+    std::size_t side,
+    unsigned int repeat,
+    const std::string& directory)
+{
+    auto sourceFile = directory + "/" + shape + ".obk";
+    auto kbFile     = directory + "/" + shape + ".kb";
+
+    try
+    {
+        auto statements = generateSource(shape, size, side, sourceFile);
+        auto bytes      = std::filesystem::file_size(sourceFile);
+
+        std::size_t tokens = 0;
+        auto seconds       = timePhase(repeat,
+            [&]()
+            {
+                tokens = lexSource(sourceFile);
+            });
+        printThroughput(shape, "lex", bytes, tokens, statements, seconds);
+
+        seconds = timePhase(repeat,
+            [&]()
+            {
+                std::unique_ptr<obelisk::KnowledgeBase> kb;
+                parseSource(sourceFile, kb);
+            });
+        printThroughput(shape, "parse", bytes, tokens, statements, seconds);
+
+        // the KnowledgeBase is kept in memory and never saved, so only the
+        // inserts are measured and not the disk
+        seconds = timePhase(repeat,
+            [&]()
+            {
+                auto kb = std::unique_ptr<obelisk::KnowledgeBase> {
+                    new obelisk::KnowledgeBase(kbFile.c_str(),
+                        obelisk::KnowledgeBase::kLayoutRowid,
+                        obelisk::KnowledgeBase::kStorageMemory)};
+                parseSource(sourceFile, kb);
+            });
+        printThroughput(shape, "insert", bytes, tokens, statements, seconds);
+
+        // the same inserts into a file, which is what obelisk does when it
+        // loads source code, so the cost of the journal and the syncs shows
+        // next to the in-memory number
+        seconds = timePhase(repeat,
+            [&]()
+            {
+                std::filesystem::remove(kbFile);
+                auto kb = std::unique_ptr<obelisk::KnowledgeBase> {
+                    new obelisk::KnowledgeBase(kbFile.c_str())};
+                parseSource(sourceFile, kb);
+            });
+        printThroughput(shape, "file", bytes, tokens, statements, seconds);
+    }
+    catch (obelisk::LexerException& exception)
+    {
+        std::cout << "Error: " << exception.what() << std::endl;
+        return EXIT_FAILURE;
+    }
+    catch (obelisk::ParserException& exception)
+    {
+        std::cout << "Error: " << exception.what() << std::endl;
+        return EXIT_FAILURE;
+    }
+    catch (obelisk::KnowledgeBaseException& exception)
+    {
+        std::cout << "Error: " << exception.what() << std::endl;
+        return EXIT_FAILURE;
+    }
+    catch (std::exception& exception)
+    {
+        std::cout << "Error: " << exception.what() << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    std::filesystem::remove(sourceFile);
+    std::filesystem::remove(kbFile);
+    return EXIT_SUCCESS;
+}
+
+int main(int argc, char** argv)
+{
+    std::vector<std::string> shapes {"facts", "cross", "rules", "comments"};
+    std::size_t size    = 20000;
+    std::size_t side    = 100;
+    unsigned int repeat = 3;
+
+    while (true)
+    {
+        int option_index = 0;
+        switch (getopt_long(argc,
+            argv,
+            "hr:s:n:w:",
+            obelisk::benchmark_long_options,
+            &option_index))
+        {
+            case 'r' :
+                try
+                {
+                    repeat = std::max(std::stoul(optarg), 1UL);
+                }
+                catch (std::exception& exception)
+                {
+                    obelisk::showBenchmarkUsage();
+                    return EXIT_FAILURE;
+                }
+                continue;
+            case 's' :
+                if (std::string(optarg) != "all")
+                {
+                    shapes = {std::string(optarg)};
+                }
+                continue;
+            case 'n' :
+                try
+                {
+                    size = std::stoul(optarg);
+                }
+                catch (std::exception& exception)
+                {
+                    obelisk::showBenchmarkUsage();
+                    return EXIT_FAILURE;
+                }
+                continue;
+            case 'w' :
+                try
+                {
+                    side = std::stoul(optarg);
+                }
+                catch (std::exception& exception)
+                {
+                    obelisk::showBenchmarkUsage();
+                    return EXIT_FAILURE;
+                }
+                continue;
+            case 'h' :
+                obelisk::showBenchmarkUsage();
+                return EXIT_SUCCESS;
+                break;
+            default :
+                obelisk::showBenchmarkUsage();
+                return EXIT_FAILURE;
+                break;
+
+            case -1 :
+                break;
+        }
+
+        break;
+    }
+
+    auto directory = std::filesystem::temp_directory_path()
+                   / ("obelisk_benchmark_" + std::to_string(getpid()));
+    std::filesystem::create_directories(directory);
+
+    std::cout << std::left << std::setw(10) << "shape" << std::setw(8)
+              << "phase" << std::right << std::setw(12) << "MB/s"
+              << std::setw(16) << "tokens/s" << std::setw(16)
+              << "statements/s" << std::setw(12) << "seconds" << std::endl;
+
+    auto result = EXIT_SUCCESS;
+    for (auto& shape : shapes)
+    {
+        result = obelisk::benchmarkShape(shape,
+            size,
+            side,
+            repeat,
+            directory.string());
+        if (result != EXIT_SUCCESS)
+        {
+            break;
+        }
+    }
+
+    std::filesystem::remove_all(directory);
+    return result;
+}
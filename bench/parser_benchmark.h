@@ -0,0 +1,142 @@
+#ifndef OBELISK_PARSER_BENCHMARK_H
+#define OBELISK_PARSER_BENCHMARK_H
+
+#include "parser.h"
+
+#include <getopt.h>
+
+#include <cstddef>
+#include <functional>
+#include <memory>
+#include <string>
+
+namespace obelisk
+{
+    /**
+     * @brief The usage messsage displayed during help or incorrect usage.
+     *
+     */
+    std::string benchmarkUsageMessage
+        = R"(Usage: parser_benchmark [OPTION]...
+Measure the throughput of the obelisk lexer and parser on generated source
+code.
+
+Options:
+  -h, --help            shows this help/usage message
+  -r, --repeat=N        number of times each phase is run, the fastest run
+                        is reported (default 3)
+  -s, --shape=SHAPE     the shape of the generated source code: facts,
+                        cross, rules, comments or all (default)
+  -n, --size=N          the number of facts each shape produces (default
+                        20000)
+  -w, --side=N          the number of entities on each side of the cross
+                        products of the cross shape (default 100))";
+
+    /**
+     * @brief The command line arguments that parser_benchmark accepts.
+     *
+     */
+    static struct option benchmark_long_options[] = {
+        {"help",   no_argument,       0, 'h'},
+        {"repeat", required_argument, 0, 'r'},
+        {"shape",  required_argument, 0, 's'},
+        {"size",   required_argument, 0, 'n'},
+        {"side",   required_argument, 0, 'w'},
+        {0,        0,                 0, 0  }
+    };
+
+    /**
+     * @brief Prints out the usage of parser_benchmark to the stdout.
+     *
+     */
+    static void showBenchmarkUsage();
+
+    /**
+     * @brief Generate obelisk source code of a given shape.
+     *
+     * The facts shape has one small fact per statement, the cross shape has
+     * fact statements with large cross products, the rules shape is one long
+     * chain of rules and the comments shape has a long comment before each
+     * small fact.
+     *
+     * @param[in] shape The shape of the source code.
+     * @param[in] size The number of facts the source code produces.
+     * @param[in] side The number of entities on each side of a cross
+     * product.
+     * @param[in] sourceFile The file to write the source code to.
+     * @return std::size_t Returns the number of statements written.
+     */
+    static std::size_t generateSource(const std::string& shape,
+        std::size_t size,
+        std::size_t side,
+        const std::string& sourceFile);
+
+    /**
+     * @brief Lex a source file without parsing it.
+     *
+     * @param[in] sourceFile The source file.
+     * @return std::size_t Returns the number of tokens found.
+     */
+    static std::size_t lexSource(const std::string& sourceFile);
+
+    /**
+     * @brief Parse a source file, inserting the statements into a
+     * KnowledgeBase if there is one.
+     *
+     * @param[in] sourceFile The source file.
+     * @param[in] kb The KnowledgeBase to insert the statements into, or null
+     * to only parse them.
+     */
+    static void parseSource(const std::string& sourceFile,
+        std::unique_ptr<obelisk::KnowledgeBase>& kb);
+
+    /**
+     * @brief Time a phase of the benchmark.
+     *
+     * @param[in] repeat The number of times to run the phase.
+     * @param[in] phase The phase to run.
+     * @return double Returns the time of the fastest run in seconds.
+     */
+    static double timePhase(unsigned int repeat,
+        const std::function<void()>& phase);
+
+    /**
+     * @brief Print the throughput of a phase.
+     *
+     * @param[in] shape The shape of the source code.
+     * @param[in] phase The name of the phase.
+     * @param[in] bytes The size of the source file in bytes.
+     * @param[in] tokens The number of tokens in the source file.
+     * @param[in] statements The number of statements in the source file.
+     * @param[in] seconds The time the phase took.
+     */
+    static void printThroughput(const std::string& shape,
+        const std::string& phase,
+        std::size_t bytes,
+        std::size_t tokens,
+        std::size_t statements,
+        double seconds);
+
+    /**
+     * @brief Benchmark lexing, parsing, and parsing with insertion into a
+     * KnowledgeBase for one shape of source code.
+     *
+     * The insertion is measured twice, once into a KnowledgeBase kept in
+     * memory and once into a KnowledgeBase file.
+     *
+     * @param[in] shape The shape of the source code.
+     * @param[in] size The number of facts the source code produces.
+     * @param[in] side The number of entities on each side of a cross
+     * product.
+     * @param[in] repeat The number of times each phase is run.
+     * @param[in] directory The directory to write the temporary files to.
+     * @return int Returns EXIT_SUCCESS or EXIT_FAILURE.
+     */
+    static int benchmarkShape(const std::string& shape,
+        std::size_t size,
+        std::size_t side,
+        unsigned int repeat,
+        const std::string& directory);
+} // namespace obelisk
+
+#endif
@@ -0,0 +1,199 @@
+#include "synthetic_kb.h"
+
+#include <algorithm>
+#include <cmath>
+#include <random>
+
+bool obelisk::setSyntheticKbOption(int option,
+    const std::string& argument,
+    obelisk::SyntheticKbOptions& options)
+{
+    switch (option)
+    {
+        case 'e' :
+            options.entities = std::stoull(argument);
+            return true;
+        case 'b' :
+            options.verbs = std::stoull(argument);
+            return true;
+        case 'z' :
+            options.skew = std::stod(argument);
+            return true;
+        case 'c' :
+            options.chains = std::stoull(argument);
+            return true;
+        case 'f' :
+            options.fanOut = std::stoull(argument);
+            return true;
+        case 'd' :
+            options.depth = std::stoull(argument);
+            return true;
+        case 's' :
+            options.seed = std::stoull(argument);
+            return true;
+        default :
+            return false;
+    }
+}
+
+obelisk::SyntheticKb::SyntheticKb(const obelisk::SyntheticKbOptions& options) :
+    options_(options)
+{
+}
+
+std::size_t obelisk::SyntheticKb::write(std::ostream& stream)
+{
+    std::mt19937_64 random(options_.seed);
+    auto uniform = [&random](std::size_t count) -> std::size_t
+    {
+        return count == 0 ? 0 : random() % count;
+    };
+    auto unit = [&random]()
+    {
+        return (random() >> 11) * 0x1.0p-53;
+    };
+
+    // the cumulative weights of the verbs, the verb at rank r has a weight
+    // of 1 / r^skew
+    auto verbs = std::max<std::size_t>(options_.verbs, 1);
+    std::vector<double> verbWeights;
+    double totalWeight = 0;
+    for (std::size_t verb = 0; verb < verbs; verb++)
+    {
+        totalWeight += 1.0 / std::pow(verb + 1, options_.skew);
+        verbWeights.push_back(totalWeight);
+    }
+    auto pickVerb = [&]()
+    {
+        auto verb = std::upper_bound(verbWeights.begin(),
+                        verbWeights.end(),
+                        unit() * totalWeight)
+                  - verbWeights.begin();
+        return std::min<std::size_t>(verb, verbWeights.size() - 1);
+    };
+
+    // verbs may only have letters, so their numbers are written in base 26
+    auto letters = [](std::size_t number)
+    {
+        std::string digits;
+        do
+        {
+            digits.insert(digits.begin(), static_cast<char>('a' + number % 26));
+            number /= 26;
+        }
+        while (number > 0);
+        return digits;
+    };
+
+    auto writeFact = [&stream](const obelisk::SyntheticFact& fact)
+    {
+        stream << "\"" << fact.leftEntity << "\" " << fact.verb << " \""
+               << fact.rightEntity << "\"";
+    };
+
+    statedFacts_.clear();
+    derivedFacts_.clear();
+    actionFacts_.clear();
+
+    std::size_t statements = 0;
+    for (std::size_t i = 0; i < options_.facts; i++)
+    {
+        obelisk::SyntheticFact fact;
+        fact.leftEntity  = "e" + std::to_string(uniform(options_.entities));
+        fact.verb        = "v" + letters(pickVerb());
+        fact.rightEntity = "e" + std::to_string(uniform(options_.entities));
+
+        stream << "fact(";
+        writeFact(fact);
+        stream << ");\n";
+        statements++;
+
+        if (statedFacts_.size() < kMaxSamples)
+        {
+            statedFacts_.push_back(std::move(fact));
+        }
+    }
+
+    for (std::size_t chain = 0; chain < options_.chains; chain++)
+    {
+        // each chain starts at a stated fact
+        obelisk::SyntheticFact reason;
+        if (statedFacts_.empty())
+        {
+            reason.leftEntity  = "chain" + std::to_string(chain);
+            reason.verb        = "va";
+            reason.rightEntity = "root";
+
+            stream << "fact(";
+            writeFact(reason);
+            stream << ");\n";
+            statements++;
+        }
+        else
+        {
+            reason = statedFacts_[uniform(statedFacts_.size())];
+        }
+
+        for (std::size_t level = 1; level <= options_.depth; level++)
+        {
+            obelisk::SyntheticFact next;
+            for (std::size_t rule = 0; rule < options_.fanOut; rule++)
+            {
+                obelisk::SyntheticFact derived {reason.leftEntity,
+                    "l" + letters(level) + "F" + letters(rule),
+                    reason.rightEntity};
+
+                stream << "rule(";
+                writeFact(derived);
+                stream << " if ";
+                writeFact(reason);
+                stream << ");\n";
+                statements++;
+
+                if (rule == 0)
+                {
+                    next = derived;
+                }
+                if (derivedFacts_.size() < kMaxSamples)
+                {
+                    derivedFacts_.push_back(std::move(derived));
+                }
+            }
+            if (options_.fanOut > 0)
+            {
+                reason = std::move(next);
+            }
+        }
+
+        // the end of the chain suggests an action
+        stream << "action(if ";
+        writeFact(reason);
+        stream << " then \"act\" else \"wait\");\n";
+        statements++;
+
+        if (actionFacts_.size() < kMaxSamples)
+        {
+            actionFacts_.push_back(std::move(reason));
+        }
+    }
+
+    return statements;
+}
+
+const std::vector<obelisk::SyntheticFact>&
+    obelisk::SyntheticKb::getStatedFacts() const
+{
+    return statedFacts_;
+}
+
+const std::vector<obelisk::SyntheticFact>&
+    obelisk::SyntheticKb::getDerivedFacts() const
+{
+    return derivedFacts_;
+}
+
+const std::vector<obelisk::SyntheticFact>&
+    obelisk::SyntheticKb::getActionFacts() const
+{
+    return actionFacts_;
+}
@@ -0,0 +1,224 @@
+#ifndef OBELISK_SYNTHETIC_KB_H
+#define OBELISK_SYNTHETIC_KB_H
+
+#include <cstddef>
+#include <cstdint>
+#include <ostream>
+#include <string>
+#include <vector>
+
+namespace obelisk
+{
+    /**
+     * @brief The SyntheticKbOptions struct controls the shape of a generated
+     * knowledge base.
+     *
+     */
+    struct SyntheticKbOptions
+    {
+            /**
+             * @brief The number of facts stated, duplicates are stated again
+             * instead of being replaced, so slightly fewer unique facts are
+             * made.
+             *
+             */
+            std::size_t facts = 1000;
+
+            /**
+             * @brief The number of distinct entities the facts are made of.
+             *
+             */
+            std::size_t entities = 1000;
+
+            /**
+             * @brief The number of distinct verbs of the stated facts.
+             *
+             */
+            std::size_t verbs = 10;
+
+            /**
+             * @brief The exponent of the Zipf distribution the verbs are
+             * picked with, 0 picks every verb equally often and larger values
+             * make the first verbs more common.
+             *
+             */
+            double skew = 1.0;
+
+            /**
+             * @brief The number of rule chains.
+             *
+             */
+            std::size_t chains = 100;
+
+            /**
+             * @brief The number of rules that have the same reason at each
+             * level of a chain.
+             *
+             */
+            std::size_t fanOut = 2;
+
+            /**
+             * @brief The number of levels of each chain.
+             *
+             */
+            std::size_t depth = 4;
+
+            /**
+             * @brief The seed of the random numbers, the same options always
+             * generate the same source code.
+             *
+             */
+            std::uint64_t seed = 1;
+    };
+
+    /**
+     * @brief The usage of the options shared by the tools that generate a
+     * knowledge base, the number of facts is described by each tool.
+     *
+     */
+    const std::string syntheticKbUsageMessage
+        = R"(  -e, --entities=N      the number of distinct entities (default 1000)
+  -b, --verbs=N         the number of distinct verbs (default 10)
+  -z, --skew=S          the Zipf exponent the verbs are picked with, 0 picks
+                        every verb equally often (default 1.0)
+  -c, --chains=N        the number of rule chains (default 100)
+  -f, --fan-out=N       the number of rules at each level of a chain (default
+                        2)
+  -d, --depth=N         the number of levels of each chain (default 4)
+  -s, --seed=N          the seed of the random numbers (default 1))";
+
+    /**
+     * @brief Set one of the options of a SyntheticKb from a command line
+     * argument.
+     *
+     * @param[in] option The short option, one of e, b, z, c, f, d or s.
+     * @param[in] argument The value of the option.
+     * @param[out] options The options to set.
+     * @return true Returns true if the option was set.
+     * @return false Returns false if the option isn't an option of a
+     * SyntheticKb.
+     * @exception std::invalid_argument Thrown if the value isn't a number.
+     * @exception std::out_of_range Thrown if the value is too large.
+     */
+    bool setSyntheticKbOption(int option,
+        const std::string& argument,
+        obelisk::SyntheticKbOptions& options);
+
+    /**
+     * @brief The SyntheticFact struct is the names of a generated fact.
+     *
+     */
+    struct SyntheticFact
+    {
+            /**
+             * @brief The name of the left entity.
+             *
+             */
+            std::string leftEntity;
+
+            /**
+             * @brief The name of the verb.
+             *
+             */
+            std::string verb;
+
+            /**
+             * @brief The name of the right entity.
+             *
+             */
+            std::string rightEntity;
+    };
+
+    /**
+     * @brief The SyntheticKb class generates the obelisk source code of a
+     * knowledge base of a given size and shape.
+     *
+     * The stated facts are made of random entities and of verbs picked with a
+     * Zipf distribution. Each rule chain starts at a stated fact, every level
+     * derives fanOut facts from the first fact of the level before it, and
+     * the last fact of the chain has a suggested action. The numbers come
+     * from a 64 bit Mersenne Twister and are turned into ranges without the
+     * distributions of the standard library, whose results differ between
+     * implementations, so the source code is the same on every platform.
+     *
+     */
+    class SyntheticKb
+    {
+        private:
+            /**
+             * @brief The most facts of each kind kept to be queried.
+             *
+             */
+            static constexpr std::size_t kMaxSamples = 10000;
+
+            /**
+             * @brief The options of the knowledge base.
+             *
+             */
+            obelisk::SyntheticKbOptions options_;
+
+            /**
+             * @brief A sample of the stated facts.
+             *
+             */
+            std::vector<obelisk::SyntheticFact> statedFacts_;
+
+            /**
+             * @brief A sample of the facts derived by the rules.
+             *
+             */
+            std::vector<obelisk::SyntheticFact> derivedFacts_;
+
+            /**
+             * @brief A sample of the facts that have a suggested action.
+             *
+             */
+            std::vector<obelisk::SyntheticFact> actionFacts_;
+
+        public:
+            /**
+             * @brief Construct a new SyntheticKb object.
+             *
+             * @param[in] options The options of the knowledge base.
+             */
+            SyntheticKb(const obelisk::SyntheticKbOptions& options);
+
+            /**
+             * @brief Write the source code of the knowledge base.
+             *
+             * @param[in] stream The stream to write the source code to.
+             * @return std::size_t Returns the number of statements written.
+             */
+            std::size_t write(std::ostream& stream);
+
+            /**
+             * @brief Get a sample of the stated facts, available after the
+             * source code is written.
+             *
+             * @return const std::vector<obelisk::SyntheticFact>& Returns the
+             * facts.
+             */
+            const std::vector<obelisk::SyntheticFact>& getStatedFacts() const;
+
+            /**
+             * @brief Get a sample of the facts derived by the rules, available
+             * after the source code is written.
+             *
+             * @return const std::vector<obelisk::SyntheticFact>& Returns the
+             * facts.
+             */
+            const std::vector<obelisk::SyntheticFact>& getDerivedFacts()
+                const;
+
+            /**
+             * @brief Get a sample of the facts that have a suggested action,
+             * available after the source code is written.
+             *
+             * @return const std::vector<obelisk::SyntheticFact>& Returns the
+             * facts.
+             */
+            const std::vector<obelisk::SyntheticFact>& getActionFacts() const;
+    };
+} // namespace obelisk
+
+#endif
@@ -1,5 +1,7 @@
 #include "lexer.h"
 
+#include <chrono>
+#include <ctime>
 #include <iostream>
 
 obelisk::Lexer::Lexer(const std::string& sourceFile)
@@ -19,12 +21,51 @@ obelisk::Lexer::~Lexer()
 }
 
 int obelisk::Lexer::getToken()
+{
+    if (!timing_)
+    {
+        auto token = readToken();
+        if (token != kTokenEof)
+        {
+            tokenCount_++;
+        }
+        return token;
+    }
+
+    auto wallStart = std::chrono::steady_clock::now();
+    auto cpuStart  = std::clock();
+    int token      = kTokenEof;
+    try
+    {
+        token = readToken();
+    }
+    catch (obelisk::LexerException& exception)
+    {
+        addTime(wallStart, cpuStart);
+        throw;
+    }
+    addTime(wallStart, cpuStart);
+    if (token != kTokenEof)
+    {
+        tokenCount_++;
+    }
+    return token;
+}
+
+int obelisk::Lexer::readToken()
 {
     while (isspace(lastChar))
     {
         lastChar = fileStream_.get();
     }
 
+    if (lastChar == '"')
+    {
+        readString();
+        lastChar = fileStream_.get();
+        return kTokenString;
+    }
+
     if (isalpha(lastChar))
     {
         eraseIdentifier();
@@ -59,6 +100,11 @@ int obelisk::Lexer::getToken()
             return Token::kTokenExtern;
         }
 
+        if (getIdentifier() == "transitive")
+        {
+            return Token::kTokenTransitive;
+        }
+
         return Token::kTokenIdentifier;
     }
 
@@ -92,7 +138,7 @@ int obelisk::Lexer::getToken()
 
         if (lastChar != EOF)
         {
-            return getToken();
+            return readToken();
         }
     }
     else if (lastChar == '/')
@@ -104,7 +150,7 @@ int obelisk::Lexer::getToken()
 
             if (lastChar != EOF)
             {
-                return getToken();
+                return readToken();
             }
         }
     }
@@ -128,6 +174,47 @@ void obelisk::Lexer::commentLine(int* lastChar)
     while (*lastChar != EOF && *lastChar != '\n' && *lastChar != '\r');
 }
 
+void obelisk::Lexer::readString()
+{
+    // the buffer is reused, so a string only allocates when it is longer
+    // than every string before it
+    stringValue_.clear();
+    while (true)
+    {
+        auto thisChar = fileStream_.get();
+        switch (thisChar)
+        {
+            case '"' :
+                return;
+            case EOF :
+            case '\n' :
+            case '\r' :
+                throw obelisk::LexerException("unterminated string");
+            case '\\' :
+                thisChar = fileStream_.get();
+                switch (thisChar)
+                {
+                    case '"' :
+                    case '\\' :
+                        break;
+                    case 'n' :
+                        thisChar = '\n';
+                        break;
+                    case 't' :
+                        thisChar = '\t';
+                        break;
+                    default :
+                        throw obelisk::LexerException(
+                            "invalid escape sequence in string");
+                }
+                break;
+            default :
+                break;
+        }
+        stringValue_ += (char) thisChar;
+    }
+}
+
 const std::string& obelisk::Lexer::getIdentifier()
 {
     return identifier_;
@@ -157,3 +244,39 @@ void obelisk::Lexer::setNumberValue(double numberValue)
 {
     numberValue_ = numberValue;
 }
+
+const std::string& obelisk::Lexer::getStringValue()
+{
+    return stringValue_;
+}
+
+void obelisk::Lexer::addTime(
+    const std::chrono::steady_clock::time_point& wallStart,
+    std::clock_t cpuStart)
+{
+    std::chrono::duration<double> wallSeconds
+        = std::chrono::steady_clock::now() - wallStart;
+    wallSeconds_ += wallSeconds.count();
+    cpuSeconds_
+        += static_cast<double>(std::clock() - cpuStart) / CLOCKS_PER_SEC;
+}
+
+void obelisk::Lexer::setTiming(bool timing)
+{
+    timing_ = timing;
+}
+
+std::size_t obelisk::Lexer::getTokenCount()
+{
+    return tokenCount_;
+}
+
+double obelisk::Lexer::getWallSeconds()
+{
+    return wallSeconds_;
+}
+
+double obelisk::Lexer::getCpuSeconds()
+{
+    return cpuSeconds_;
+}
@@ -1,6 +1,9 @@
 #ifndef OBELISK_LEXER_H
 #define OBELISK_LEXER_H
 
+#include <chrono>
+#include <cstddef>
+#include <ctime>
 #include <fstream>
 #include <string>
 
@@ -29,6 +32,33 @@ namespace obelisk
              *
              */
             double numberValue_ = 0;
+            /**
+             * @brief The contents of the last found string, with its escape
+             * sequences replaced.
+             *
+             */
+            std::string stringValue_;
+            /**
+             * @brief The number of tokens read, not counting the end of the
+             * file.
+             *
+             */
+            std::size_t tokenCount_ = 0;
+            /**
+             * @brief Whether the time spent reading tokens is measured.
+             *
+             */
+            bool timing_ = false;
+            /**
+             * @brief The wall clock time spent reading tokens in seconds.
+             *
+             */
+            double wallSeconds_ = 0;
+            /**
+             * @brief The processor time spent reading tokens in seconds.
+             *
+             */
+            double cpuSeconds_ = 0;
 
             /**
              * @brief Set the identifier.
@@ -60,6 +90,34 @@ namespace obelisk
              * the line.
              */
             void commentLine(int* lastChar);
+            /**
+             * @brief Read a string up to its closing double quote.
+             *
+             * The opening double quote has already been read. A backslash
+             * escapes the next character, \n and \t stand for a new line and
+             * a tab.
+             *
+             * @throws LexerException when the string isn't closed on the same
+             * line or has an unknown escape sequence.
+             */
+            void readString();
+            /**
+             * @brief Read the next token in the source code.
+             *
+             * @throws LexerException when an invalid token is found.
+             * @return int Returns a Token value or char if no known token was
+             * found.
+             */
+            int readToken();
+            /**
+             * @brief Add the time since a token was started to the time spent
+             * reading tokens.
+             *
+             * @param[in] wallStart The wall clock time the token was started.
+             * @param[in] cpuStart The processor time the token was started.
+             */
+            void addTime(const std::chrono::steady_clock::time_point& wallStart,
+                std::clock_t cpuStart);
 
         public:
             /**
@@ -120,10 +178,17 @@ namespace obelisk
                 kTokenNumber = -8,
 
                 /**
-                 * @brief A string.
+                 * @brief A string in double quotes, its contents are kept
+                 * exactly as written.
                  *
                  */
-                kTokenString = -9
+                kTokenString = -9,
+
+                /**
+                 * @brief A declaration that a verb is transitive.
+                 *
+                 */
+                kTokenTransitive = -10
             };
 
             /**
@@ -162,6 +227,48 @@ namespace obelisk
              * @return double Return the last number that was found.
              */
             double getNumberValue();
+
+            /**
+             * @brief Get the contents of the last string.
+             *
+             * @return const std::string& Returns the contents of the string
+             * without its quotes.
+             */
+            const std::string& getStringValue();
+
+            /**
+             * @brief Set whether the time spent reading tokens is measured.
+             *
+             * The clocks are read around every token, so this is left off
+             * unless the time is wanted.
+             *
+             * @param[in] timing Whether to measure the time.
+             */
+            void setTiming(bool timing);
+
+            /**
+             * @brief Get the number of tokens read so far.
+             *
+             * @return std::size_t Returns the number of tokens, not counting
+             * the end of the file.
+             */
+            std::size_t getTokenCount();
+
+            /**
+             * @brief Get the wall clock time spent reading tokens while timing
+             * was on.
+             *
+             * @return double Returns the time in seconds.
+             */
+            double getWallSeconds();
+
+            /**
+             * @brief Get the processor time spent reading tokens while timing
+             * was on.
+             *
+             * @return double Returns the time in seconds.
+             */
+            double getCpuSeconds();
     };
 
     /**
@@ -0,0 +1,437 @@
+#include "backup.h"
+#include "knowledge_base.h"
+
+#include <cstring>
+
+// the file control opcode that reads the number of pages written to a
+// replica, opcodes above 100 are left to applications
+static constexpr int kFileControlWritten = 0x4f424b;
+
+// the file of a database opened through the replica VFS, the file of the
+// default VFS follows it in memory
+struct ReplicaFile
+{
+        sqlite3_file base;
+        sqlite3_file* file;
+        bool database;
+        sqlite3_int64 written;
+};
+
+static sqlite3_vfs* getDefaultVfs(sqlite3_vfs* vfs)
+{
+    return static_cast<sqlite3_vfs*>(vfs->pAppData);
+}
+
+static sqlite3_file* getFile(sqlite3_file* file)
+{
+    return reinterpret_cast<ReplicaFile*>(file)->file;
+}
+
+static int replicaClose(sqlite3_file* file)
+{
+    return getFile(file)->pMethods->xClose(getFile(file));
+}
+
+static int replicaRead(sqlite3_file* file,
+    void* buffer,
+    int size,
+    sqlite3_int64 offset)
+{
+    return getFile(file)->pMethods->xRead(getFile(file), buffer, size, offset);
+}
+
+static int replicaWrite(sqlite3_file* file,
+    const void* buffer,
+    int size,
+    sqlite3_int64 offset)
+{
+    auto replicaFile = reinterpret_cast<ReplicaFile*>(file);
+    if (replicaFile->database)
+    {
+        // the page is left alone if the file already holds it, a short read
+        // means the file has to grow so it is always written
+        auto page = static_cast<char*>(sqlite3_malloc(size));
+        if (page == nullptr)
+        {
+            return SQLITE_NOMEM;
+        }
+        auto result = replicaRead(file, page, size, offset);
+        auto same
+            = result == SQLITE_OK && std::memcmp(page, buffer, size) == 0;
+        sqlite3_free(page);
+        if (same)
+        {
+            return SQLITE_OK;
+        }
+        replicaFile->written++;
+    }
+
+    return getFile(file)->pMethods->xWrite(getFile(file),
+        buffer,
+        size,
+        offset);
+}
+
+static int replicaTruncate(sqlite3_file* file, sqlite3_int64 size)
+{
+    return getFile(file)->pMethods->xTruncate(getFile(file), size);
+}
+
+static int replicaSync(sqlite3_file* file, int flags)
+{
+    return getFile(file)->pMethods->xSync(getFile(file), flags);
+}
+
+static int replicaFileSize(sqlite3_file* file, sqlite3_int64* size)
+{
+    return getFile(file)->pMethods->xFileSize(getFile(file), size);
+}
+
+static int replicaLock(sqlite3_file* file, int level)
+{
+    return getFile(file)->pMethods->xLock(getFile(file), level);
+}
+
+static int replicaUnlock(sqlite3_file* file, int level)
+{
+    return getFile(file)->pMethods->xUnlock(getFile(file), level);
+}
+
+static int replicaCheckReservedLock(sqlite3_file* file, int* result)
+{
+    return getFile(file)->pMethods->xCheckReservedLock(getFile(file), result);
+}
+
+static int replicaFileControl(sqlite3_file* file, int op, void* arg)
+{
+    if (op == kFileControlWritten)
+    {
+        *static_cast<sqlite3_int64*>(arg)
+            = reinterpret_cast<ReplicaFile*>(file)->written;
+        return SQLITE_OK;
+    }
+
+    return getFile(file)->pMethods->xFileControl(getFile(file), op, arg);
+}
+
+static int replicaSectorSize(sqlite3_file* file)
+{
+    return getFile(file)->pMethods->xSectorSize(getFile(file));
+}
+
+static int replicaDeviceCharacteristics(sqlite3_file* file)
+{
+    return getFile(file)->pMethods->xDeviceCharacteristics(getFile(file));
+}
+
+static int replicaShmMap(sqlite3_file* file,
+    int region,
+    int size,
+    int extend,
+    void volatile** memory)
+{
+    return getFile(file)->pMethods->xShmMap(getFile(file),
+        region,
+        size,
+        extend,
+        memory);
+}
+
+static int replicaShmLock(sqlite3_file* file, int offset, int count, int flags)
+{
+    return getFile(file)->pMethods->xShmLock(getFile(file),
+        offset,
+        count,
+        flags);
+}
+
+static void replicaShmBarrier(sqlite3_file* file)
+{
+    getFile(file)->pMethods->xShmBarrier(getFile(file));
+}
+
+static int replicaShmUnmap(sqlite3_file* file, int deleteFlag)
+{
+    return getFile(file)->pMethods->xShmUnmap(getFile(file), deleteFlag);
+}
+
+// memory mapped pages are left out, they could be written without going
+// through xWrite
+static const sqlite3_io_methods replicaMethods = {2,
+    replicaClose,
+    replicaRead,
+    replicaWrite,
+    replicaTruncate,
+    replicaSync,
+    replicaFileSize,
+    replicaLock,
+    replicaUnlock,
+    replicaCheckReservedLock,
+    replicaFileControl,
+    replicaSectorSize,
+    replicaDeviceCharacteristics,
+    replicaShmMap,
+    replicaShmLock,
+    replicaShmBarrier,
+    replicaShmUnmap,
+    nullptr,
+    nullptr};
+
+static int replicaOpen(sqlite3_vfs* vfs,
+    const char* name,
+    sqlite3_file* file,
+    int flags,
+    int* outFlags)
+{
+    auto replicaFile      = reinterpret_cast<ReplicaFile*>(file);
+    replicaFile->file     = reinterpret_cast<sqlite3_file*>(replicaFile + 1);
+    replicaFile->database = (flags & SQLITE_OPEN_MAIN_DB) != 0;
+    replicaFile->written  = 0;
+
+    auto defaultVfs = getDefaultVfs(vfs);
+    auto result     = defaultVfs->xOpen(defaultVfs,
+        name,
+        replicaFile->file,
+        flags,
+        outFlags);
+    if (result == SQLITE_OK && replicaFile->file->pMethods != nullptr)
+    {
+        // every method of the default file is passed on, so the replica file
+        // can only offer the ones the default file has
+        if (replicaFile->file->pMethods->iVersion < 2)
+        {
+            replicaFile->file->pMethods->xClose(replicaFile->file);
+            return SQLITE_CANTOPEN;
+        }
+        file->pMethods = &replicaMethods;
+    }
+    else
+    {
+        file->pMethods = nullptr;
+    }
+
+    return result;
+}
+
+static int replicaDelete(sqlite3_vfs* vfs, const char* name, int syncDir)
+{
+    return getDefaultVfs(vfs)->xDelete(getDefaultVfs(vfs), name, syncDir);
+}
+
+static int replicaAccess(sqlite3_vfs* vfs,
+    const char* name,
+    int flags,
+    int* result)
+{
+    return getDefaultVfs(vfs)->xAccess(getDefaultVfs(vfs), name, flags, result);
+}
+
+static int replicaFullPathname(sqlite3_vfs* vfs,
+    const char* name,
+    int size,
+    char* result)
+{
+    return getDefaultVfs(vfs)->xFullPathname(getDefaultVfs(vfs),
+        name,
+        size,
+        result);
+}
+
+static void* replicaDlOpen(sqlite3_vfs* vfs, const char* filename)
+{
+    return getDefaultVfs(vfs)->xDlOpen(getDefaultVfs(vfs), filename);
+}
+
+static void replicaDlError(sqlite3_vfs* vfs, int size, char* message)
+{
+    getDefaultVfs(vfs)->xDlError(getDefaultVfs(vfs), size, message);
+}
+
+static void (*replicaDlSym(sqlite3_vfs* vfs, void* handle, const char* symbol))(
+    void)
+{
+    return getDefaultVfs(vfs)->xDlSym(getDefaultVfs(vfs), handle, symbol);
+}
+
+static void replicaDlClose(sqlite3_vfs* vfs, void* handle)
+{
+    getDefaultVfs(vfs)->xDlClose(getDefaultVfs(vfs), handle);
+}
+
+static int replicaRandomness(sqlite3_vfs* vfs, int size, char* result)
+{
+    return getDefaultVfs(vfs)->xRandomness(getDefaultVfs(vfs), size, result);
+}
+
+static int replicaSleep(sqlite3_vfs* vfs, int microseconds)
+{
+    return getDefaultVfs(vfs)->xSleep(getDefaultVfs(vfs), microseconds);
+}
+
+static int replicaCurrentTime(sqlite3_vfs* vfs, double* time)
+{
+    return getDefaultVfs(vfs)->xCurrentTime(getDefaultVfs(vfs), time);
+}
+
+static int replicaGetLastError(sqlite3_vfs* vfs, int size, char* message)
+{
+    return getDefaultVfs(vfs)->xGetLastError(getDefaultVfs(vfs),
+        size,
+        message);
+}
+
+static int replicaCurrentTimeInt64(sqlite3_vfs* vfs, sqlite3_int64* time)
+{
+    return getDefaultVfs(vfs)->xCurrentTimeInt64(getDefaultVfs(vfs), time);
+}
+
+sqlite3_vfs* obelisk::Backup::getVfs()
+{
+    static sqlite3_vfs* vfs = []() -> sqlite3_vfs*
+    {
+        auto defaultVfs = sqlite3_vfs_find(nullptr);
+        if (defaultVfs == nullptr || defaultVfs->iVersion < 2)
+        {
+            return nullptr;
+        }
+
+        static sqlite3_vfs replicaVfs = {2,
+            static_cast<int>(sizeof(ReplicaFile)) + defaultVfs->szOsFile,
+            defaultVfs->mxPathname,
+            nullptr,
+            "obelisk-replica",
+            defaultVfs,
+            replicaOpen,
+            replicaDelete,
+            replicaAccess,
+            replicaFullPathname,
+            replicaDlOpen,
+            replicaDlError,
+            replicaDlSym,
+            replicaDlClose,
+            replicaRandomness,
+            replicaSleep,
+            replicaCurrentTime,
+            replicaGetLastError,
+            replicaCurrentTimeInt64,
+            nullptr,
+            nullptr,
+            nullptr};
+        if (sqlite3_vfs_register(&replicaVfs, 0) != SQLITE_OK)
+        {
+            return nullptr;
+        }
+        return &replicaVfs;
+    }();
+
+    return vfs;
+}
+
+obelisk::Backup::Backup(sqlite3* dbConnection, const std::string& filename)
+{
+    auto vfs = getVfs();
+    if (vfs == nullptr)
+    {
+        throw obelisk::KnowledgeBaseException(
+            "replica file system could not be registered");
+    }
+
+    auto result = sqlite3_open_v2(filename.c_str(),
+        &replica_,
+        SQLITE_OPEN_READWRITE | SQLITE_OPEN_CREATE,
+        vfs->zName);
+    if (result != SQLITE_OK)
+    {
+        sqlite3_close_v2(replica_);
+        throw obelisk::KnowledgeBaseException("replica could not be opened");
+    }
+
+    backup_ = sqlite3_backup_init(replica_, "main", dbConnection, "main");
+    if (backup_ == nullptr)
+    {
+        std::string error(sqlite3_errmsg(replica_));
+        sqlite3_close_v2(replica_);
+        throw obelisk::KnowledgeBaseException(error);
+    }
+}
+
+obelisk::Backup::~Backup()
+{
+    if (backup_ != nullptr)
+    {
+        sqlite3_backup_finish(backup_);
+    }
+    if (replica_ != nullptr)
+    {
+        sqlite3_close_v2(replica_);
+    }
+}
+
+bool obelisk::Backup::step(int pages)
+{
+    if (done_)
+    {
+        return true;
+    }
+
+    busy_       = false;
+    auto result = sqlite3_backup_step(backup_, pages);
+    switch (result)
+    {
+        case SQLITE_OK :
+            break;
+        case SQLITE_DONE :
+            done_ = true;
+            break;
+        case SQLITE_BUSY :
+        case SQLITE_LOCKED :
+            // another connection is writing, the step can be tried again
+            busy_ = true;
+            break;
+        default :
+            throw obelisk::KnowledgeBaseException(
+                "database could not be copied to the replica");
+            break;
+    }
+
+    return done_;
+}
+
+bool obelisk::Backup::getBusy()
+{
+    return busy_;
+}
+
+int obelisk::Backup::getRemaining()
+{
+    return sqlite3_backup_remaining(backup_);
+}
+
+int obelisk::Backup::getPageCount()
+{
+    return sqlite3_backup_pagecount(backup_);
+}
+
+std::size_t obelisk::Backup::finish()
+{
+    if (!done_)
+    {
+        throw obelisk::KnowledgeBaseException(
+            "the backup has pages left to copy");
+    }
+
+    auto result = sqlite3_backup_finish(backup_);
+    backup_     = nullptr;
+    if (result != SQLITE_OK)
+    {
+        throw obelisk::KnowledgeBaseException(sqlite3_errmsg(replica_));
+    }
+
+    sqlite3_int64 written = 0;
+    sqlite3_file_control(replica_, "main", kFileControlWritten, &written);
+
+    sqlite3_close_v2(replica_);
+    replica_ = nullptr;
+
+    return written;
+}
@@ -0,0 +1,171 @@
+#include "fact_cursor.h"
+#include "models/error.h"
+
+#include <string>
+#include <utility>
+
+obelisk::FactCursor::FactCursor(sqlite3* dbConnection, obelisk::Fact& pattern) :
+    dbConnection_(dbConnection)
+{
+    if (dbConnection == nullptr)
+    {
+        throw obelisk::DatabaseException("database isn't open");
+    }
+
+    // only add the positions that are given, so the query fits one of the
+    // indexes on the fact table
+    std::string query
+        = "SELECT f.id, f.left_entity, le.name, f.verb, v.name, f.right_entity, re.name, f.is_true FROM fact f JOIN entity le ON le.id = f.left_entity JOIN verb v ON v.id = f.verb JOIN entity re ON re.id = f.right_entity WHERE (f.is_true > 0";
+    std::vector<sqlite3_int64> ids;
+
+    auto& leftEntity = pattern.getLeftEntity();
+    if (leftEntity.getName() != "")
+    {
+        leftEntity.selectByName(dbConnection);
+        if (leftEntity.getId() == 0)
+        {
+            // an unknown entity can't match anything
+            done_ = true;
+            return;
+        }
+        query += " AND f.left_entity=?";
+        ids.push_back(leftEntity.getId());
+    }
+
+    auto& verb = pattern.getVerb();
+    if (verb.getName() != "")
+    {
+        verb.selectByName(dbConnection);
+        if (verb.getId() == 0)
+        {
+            done_ = true;
+            return;
+        }
+        query += " AND f.verb=?";
+        ids.push_back(verb.getId());
+    }
+
+    auto& rightEntity = pattern.getRightEntity();
+    if (rightEntity.getName() != "")
+    {
+        rightEntity.selectByName(dbConnection);
+        if (rightEntity.getId() == 0)
+        {
+            done_ = true;
+            return;
+        }
+        query += " AND f.right_entity=?";
+        ids.push_back(rightEntity.getId());
+    }
+
+    query += ")";
+
+    auto result = sqlite3_prepare_v2(dbConnection,
+        query.c_str(),
+        -1,
+        &ppStmt_,
+        nullptr);
+    if (result != SQLITE_OK)
+    {
+        throw obelisk::DatabaseException(sqlite3_errmsg(dbConnection));
+    }
+
+    for (std::size_t i = 0; i < ids.size(); i++)
+    {
+        result = sqlite3_bind_int64(ppStmt_, i + 1, ids[i]);
+        switch (result)
+        {
+            case SQLITE_OK :
+                break;
+            case SQLITE_TOOBIG :
+                throw obelisk::DatabaseSizeException();
+                break;
+            case SQLITE_RANGE :
+                throw obelisk::DatabaseRangeException();
+                break;
+            case SQLITE_NOMEM :
+                throw obelisk::DatabaseMemoryException();
+                break;
+            default :
+                throw obelisk::DatabaseException(
+                    sqlite3_errmsg(dbConnection));
+                break;
+        }
+    }
+}
+
+obelisk::FactCursor::~FactCursor()
+{
+    if (ppStmt_)
+    {
+        sqlite3_finalize(ppStmt_);
+    }
+}
+
+void obelisk::FactCursor::setFilter(
+    std::function<bool(obelisk::Fact&)> filter)
+{
+    filter_ = std::move(filter);
+}
+
+bool obelisk::FactCursor::step(obelisk::Fact& fact)
+{
+    while (stepRow(fact))
+    {
+        if (!filter_ || filter_(fact))
+        {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+bool obelisk::FactCursor::stepRow(obelisk::Fact& fact)
+{
+    if (done_)
+    {
+        return false;
+    }
+
+    auto result = sqlite3_step(ppStmt_);
+    switch (result)
+    {
+        case SQLITE_DONE :
+            done_ = true;
+            return false;
+        case SQLITE_ROW :
+            fact = obelisk::Fact(sqlite3_column_int64(ppStmt_, 0),
+                obelisk::Entity(sqlite3_column_int64(ppStmt_, 1),
+                    (char*) sqlite3_column_text(ppStmt_, 2)),
+                obelisk::Entity(sqlite3_column_int64(ppStmt_, 5),
+                    (char*) sqlite3_column_text(ppStmt_, 6)),
+                obelisk::Verb(sqlite3_column_int64(ppStmt_, 3),
+                    (char*) sqlite3_column_text(ppStmt_, 4)),
+                sqlite3_column_double(ppStmt_, 7));
+            return true;
+        case SQLITE_BUSY :
+            throw obelisk::DatabaseBusyException();
+            break;
+        case SQLITE_MISUSE :
+            throw obelisk::DatabaseMisuseException();
+            break;
+        default :
+            throw obelisk::DatabaseException(sqlite3_errmsg(dbConnection_));
+            break;
+    }
+}
+
+std::size_t obelisk::FactCursor::step(std::vector<obelisk::Fact>& facts,
+    std::size_t max)
+{
+    std::size_t count = 0;
+    obelisk::Fact fact;
+    while (count < max && step(fact))
+    {
+        facts.push_back(std::move(fact));
+        count++;
+    }
+
+    return count;
+}
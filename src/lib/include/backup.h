@@ -0,0 +1,131 @@
+#ifndef OBELISK_BACKUP_H
+#define OBELISK_BACKUP_H
+
+#include <sqlite3.h>
+
+#include <cstddef>
+#include <string>
+
+namespace obelisk
+{
+    /**
+     * @brief The Backup class copies a KnowledgeBase to a replica file a few
+     * pages at a time.
+     *
+     * The replica is opened with SQLite and the pages are copied into it with
+     * the online backup API, so the replica is locked and journaled like any
+     * other database and readers never see it half written. The replica is
+     * opened through a VFS that compares every page SQLite writes with the
+     * one already in the file and skips it if they are the same, so only the
+     * pages that changed are written to the replica.
+     *
+     * The KnowledgeBase is only locked while a step runs. Changes made to it
+     * between two steps are picked up by the copy, so the replica holds a
+     * consistent copy once the Backup is finished.
+     *
+     */
+    class Backup
+    {
+        private:
+            /**
+             * @brief The connection to the replica.
+             *
+             */
+            sqlite3* replica_ = nullptr;
+
+            /**
+             * @brief The backup handle that copies the pages.
+             *
+             */
+            sqlite3_backup* backup_ = nullptr;
+
+            /**
+             * @brief Set once every page has been copied.
+             *
+             */
+            bool done_ = false;
+
+            /**
+             * @brief Set if the last step couldn't copy anything because the
+             * KnowledgeBase or replica was locked.
+             *
+             */
+            bool busy_ = false;
+
+            /**
+             * @brief Get the replica VFS, it is registered the first time it
+             * is needed.
+             *
+             * @return sqlite3_vfs* Returns the VFS.
+             */
+            static sqlite3_vfs* getVfs();
+
+        public:
+            /**
+             * @brief Construct a new Backup object.
+             *
+             * @param[in] dbConnection The connection to the KnowledgeBase to
+             * copy.
+             * @param[in] filename The replica file, it is created if it
+             * doesn't exist.
+             */
+            Backup(sqlite3* dbConnection, const std::string& filename);
+
+            /**
+             * @brief Destroy the Backup object.
+             *
+             * A Backup that wasn't finished is abandoned and the replica is
+             * left as it was. The Backup must be destroyed before the
+             * KnowledgeBase it was created from.
+             */
+            ~Backup();
+
+            Backup(const Backup&)            = delete;
+            Backup& operator=(const Backup&) = delete;
+
+            /**
+             * @brief Copy up to a number of pages to the replica.
+             *
+             * @param[in] pages The most pages to copy, -1 copies every page.
+             * @return true If every page has been copied.
+             * @return false If there are pages left, or the KnowledgeBase or
+             * replica was locked and the step has to be tried again later.
+             */
+            bool step(int pages);
+
+            /**
+             * @brief Get whether the last step couldn't copy anything because
+             * the KnowledgeBase or replica was locked by another connection.
+             *
+             * @return true If the last step has to be tried again later.
+             * @return false If the last step copied its pages.
+             */
+            bool getBusy();
+
+            /**
+             * @brief Get the number of pages that are left to copy after the
+             * last step.
+             *
+             * @return int Returns the number of pages.
+             */
+            int getRemaining();
+
+            /**
+             * @brief Get the number of pages in the KnowledgeBase at the last
+             * step.
+             *
+             * @return int Returns the number of pages.
+             */
+            int getPageCount();
+
+            /**
+             * @brief Finish the Backup and close the replica.
+             *
+             * @return std::size_t Returns the number of pages written to the
+             * replica, the pages that were already the same are not counted.
+             */
+            std::size_t finish();
+    };
+} // namespace obelisk
+
+#endif
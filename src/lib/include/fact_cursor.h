@@ -0,0 +1,118 @@
+#ifndef OBELISK_FACT_CURSOR_H
+#define OBELISK_FACT_CURSOR_H
+
+#include "models/fact.h"
+
+#include <sqlite3.h>
+
+#include <cstddef>
+#include <functional>
+#include <vector>
+
+namespace obelisk
+{
+    /**
+     * @brief The FactCursor class steps through the true facts that match a
+     * pattern.
+     *
+     * Any of the left Entity, Verb and right Entity in the pattern can be left
+     * empty to match everything. The names in the pattern are looked up once
+     * and the facts are then selected by ID, using the index that fits the
+     * positions that are given. The facts are read from the database as the
+     * cursor is stepped, so a large result never has to be held in memory.
+     *
+     */
+    class FactCursor
+    {
+        private:
+            /**
+             * @brief The SQLite connection handle.
+             *
+             */
+            sqlite3* dbConnection_;
+
+            /**
+             * @brief The statement that selects the facts, or nullptr if
+             * nothing can match.
+             *
+             */
+            sqlite3_stmt* ppStmt_ = nullptr;
+
+            /**
+             * @brief Set once every matching Fact has been returned.
+             *
+             */
+            bool done_ = false;
+
+            /**
+             * @brief The facts this returns false for are skipped, or empty
+             * to return every matching Fact.
+             *
+             */
+            std::function<bool(obelisk::Fact&)> filter_;
+
+            /**
+             * @brief Step to the next row of the statement.
+             *
+             * @param[out] fact The Fact of the row.
+             * @return true If a row was read.
+             * @return false If there are no more rows.
+             */
+            bool stepRow(obelisk::Fact& fact);
+
+        public:
+            /**
+             * @brief Construct a new FactCursor object.
+             *
+             * @param[in] dbConnection The database connection to use.
+             * @param[in] pattern The pattern to match. An Entity or Verb with
+             * an empty name matches everything.
+             */
+            FactCursor(sqlite3* dbConnection, obelisk::Fact& pattern);
+
+            /**
+             * @brief Destroy the FactCursor object.
+             *
+             * This finalizes the statement, the cursor must be destroyed
+             * before the KnowledgeBase it was created from.
+             */
+            ~FactCursor();
+
+            FactCursor(const FactCursor&)            = delete;
+            FactCursor& operator=(const FactCursor&) = delete;
+
+            /**
+             * @brief Set a filter that the facts must also pass.
+             *
+             * The filter is checked as the cursor is stepped, for conditions
+             * the query can't express.
+             *
+             * @param[in] filter The filter, it returns true for the facts to
+             * keep.
+             */
+            void setFilter(std::function<bool(obelisk::Fact&)> filter);
+
+            /**
+             * @brief Step to the next matching Fact.
+             *
+             * @param[out] fact The Fact, with the IDs and names of its
+             * entities and Verb and its truth.
+             * @return true If a Fact was returned.
+             * @return false If there are no more facts.
+             */
+            bool step(obelisk::Fact& fact);
+
+            /**
+             * @brief Step through up to a number of matching facts.
+             *
+             * @param[out] facts The facts are appended to this.
+             * @param[in] max The most facts to return.
+             * @return std::size_t Returns the number of facts returned, this is
+             * less than max once the facts run out.
+             */
+            std::size_t step(std::vector<obelisk::Fact>& facts,
+                std::size_t max);
+    };
+} // namespace obelisk
+
+#endif
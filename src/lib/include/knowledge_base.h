@@ -1,19 +1,32 @@
 #ifndef OBELISK_KNOWLEDGE_BASE_H
 #define OBELISK_KNOWLEDGE_BASE_H
 
+#include "backup.h"
+#include "fact_cursor.h"
 #include "models/action.h"
+#include "models/change_log.h"
+#include "models/closure.h"
 #include "models/entity.h"
 #include "models/fact.h"
+#include "models/pattern_rule.h"
 #include "models/rule.h"
+#include "models/statistic.h"
 #include "models/suggest_action.h"
 #include "models/verb.h"
+#include "profiler.h"
 
 #include <sqlite3.h>
 
+#include <cstddef>
 #include <functional>
 #include <iostream>
+#include <map>
 #include <memory>
+#include <set>
 #include <string>
+#include <thread>
+#include <tuple>
+#include <unordered_map>
 
 namespace obelisk
 {
@@ -24,12 +37,158 @@ namespace obelisk
      */
     class KnowledgeBase
     {
+        public:
+            /**
+             * @brief How the truth of derived facts is determined.
+             *
+             */
+            enum Evaluation
+            {
+                /**
+                 * @brief Rules are applied when facts are inserted and the
+                 * derived facts are stored in the KnowledgeBase.
+                 *
+                 */
+                kEvaluationForward,
+
+                /**
+                 * @brief Rules are applied backwards from the queried fact at
+                 * query time.
+                 *
+                 */
+                kEvaluationBackward
+            };
+
+            /**
+             * @brief How the confidence of a reason and the weight of a rule
+             * are combined into the confidence of the Fact it derives.
+             *
+             */
+            enum Combine
+            {
+                /**
+                 * @brief The Fact is as true as the weaker of the reason and
+                 * the weight. When several rules derive the same Fact the
+                 * strongest one is kept.
+                 *
+                 */
+                kCombineMinimum,
+
+                /**
+                 * @brief The confidence of the reason is scaled by the weight.
+                 * When several rules derive the same Fact the strongest one is
+                 * kept.
+                 *
+                 */
+                kCombineProduct,
+
+                /**
+                 * @brief The confidence of the reason is scaled by the weight
+                 * and the rules that derive the same Fact are treated as
+                 * independent causes, so each one raises the confidence.
+                 *
+                 */
+                kCombineNoisyOr
+            };
+
+            /**
+             * @brief How the facts and rules are stored in a new
+             * KnowledgeBase.
+             *
+             */
+            enum Layout
+            {
+                /**
+                 * @brief The facts and rules are stored by their IDs, with a
+                 * separate index on their contents.
+                 *
+                 */
+                kLayoutRowid,
+                /**
+                 * @brief The facts and rules are stored in the order of their
+                 * contents, which halves the pages read when looking them up
+                 * and makes the file smaller.
+                 *
+                 */
+                kLayoutClustered
+            };
+
+            /**
+             * @brief Where the KnowledgeBase is kept while it is used.
+             *
+             */
+            enum Storage
+            {
+                /**
+                 * @brief The KnowledgeBase is read from and written to its
+                 * file as it is used.
+                 *
+                 */
+                kStorageFile,
+                /**
+                 * @brief The KnowledgeBase is kept in memory, starting from
+                 * its file if it exists, and is written to the file in a
+                 * single write by save.
+                 *
+                 */
+                kStorageMemory,
+                /**
+                 * @brief The image of the file is loaded into memory so that
+                 * queries never touch the disk. Changes are not written back.
+                 *
+                 */
+                kStorageImage
+            };
+
+            /**
+             * @brief What the last call to propagate did.
+             *
+             */
+            struct PropagationStatistics
+            {
+                    /**
+                     * @brief The number of times the rules were loaded and
+                     * swept.
+                     *
+                     */
+                    std::size_t rulePasses = 0;
+
+                    /**
+                     * @brief The number of sweeps over the rules of a strongly
+                     * connected component, a component without a cycle is
+                     * swept once.
+                     *
+                     */
+                    std::size_t componentSweeps = 0;
+
+                    /**
+                     * @brief The number of times every PatternRule was
+                     * applied to the true facts.
+                     *
+                     */
+                    std::size_t patternRulePasses = 0;
+
+                    /**
+                     * @brief The number of times the rules raised the
+                     * confidence of a stored Fact.
+                     *
+                     */
+                    std::size_t derivedFacts = 0;
+
+                    /**
+                     * @brief The number of facts derived or changed by the
+                     * pattern rules.
+                     *
+                     */
+                    std::size_t derivedPatternFacts = 0;
+            };
+
         private:
             /**
              * @brief The filename of the opened KnowledgeBase.
              *
              */
-            const char* filename_;
+            std::string filename_;
 
             /**
              * @brief The SQLite connection handle.
@@ -43,6 +202,102 @@ namespace obelisk
              */
             int flags_;
 
+            /**
+             * @brief Where the KnowledgeBase is kept while it is used.
+             *
+             */
+            Storage storage_;
+
+            /**
+             * @brief The layout of the fact and rule tables.
+             *
+             */
+            Layout layout_ = kLayoutRowid;
+
+            /**
+             * @brief The evaluation used when querying facts.
+             *
+             */
+            Evaluation evaluation_ = kEvaluationForward;
+
+            /**
+             * @brief How confidences are combined when rules are applied.
+             *
+             */
+            Combine combine_ = kCombineProduct;
+
+            /**
+             * @brief The number of threads used to propagate the rules.
+             *
+             */
+            unsigned int threads_ = std::thread::hardware_concurrency();
+
+            /**
+             * @brief Changes in confidence smaller than this are ignored, so
+             * that propagation around a cycle of rules comes to an end.
+             *
+             */
+            static constexpr double kEpsilon = 1e-9;
+
+            /**
+             * @brief The version of the tables, kept in the user_version of
+             * the database. A KnowledgeBase with an older version is upgraded
+             * when it is opened.
+             *
+             */
+            static constexpr int kSchemaVersion = 3;
+
+            /**
+             * @brief A goal of backward evaluation, the IDs of the left
+             * Entity, Verb and right Entity of a Fact.
+             *
+             */
+            using Goal
+                = std::tuple<sqlite3_int64, sqlite3_int64, sqlite3_int64>;
+
+            /**
+             * @brief The answers of the goals that have been resolved by
+             * backward evaluation, indexed by the IDs of the left Entity, Verb
+             * and right Entity.
+             *
+             */
+            std::map<Goal, double> table_;
+
+            /**
+             * @brief Whether the edges of the entities are cached in memory.
+             *
+             */
+            bool adjacencyCache_ = false;
+
+            /**
+             * @brief The cached true facts with each Entity on their left,
+             * indexed by the ID of the Entity.
+             *
+             */
+            std::unordered_map<sqlite3_int64, std::vector<obelisk::Fact>>
+                outgoing_;
+
+            /**
+             * @brief The cached true facts with each Entity on their right,
+             * indexed by the ID of the Entity.
+             *
+             */
+            std::unordered_map<sqlite3_int64, std::vector<obelisk::Fact>>
+                incoming_;
+
+            /**
+             * @brief Measures the SQL statements while profiling is enabled,
+             * or nullptr if it isn't.
+             *
+             */
+            std::unique_ptr<obelisk::Profiler> profiler_;
+
+            /**
+             * @brief What the last call to propagate did.
+             *
+             */
+            PropagationStatistics propagationStatistics_;
+
             /**
              * @brief Enable foreign key functionality in the open database.
              *
@@ -51,6 +306,12 @@ namespace obelisk
              */
             void enableForeignKeys();
 
+            /**
+             * @brief Load the image of the file into the in-memory database.
+             *
+             */
+            void deserialize();
+
             /**
              * @brief Create the tables in the database.
              *
@@ -58,6 +319,260 @@ namespace obelisk
              */
             void createTable(std::function<const char*()> function);
 
+            /**
+             * @brief Add the columns, tables and indexes that are missing from
+             * a KnowledgeBase created by an older version.
+             *
+             * The facts already in the KnowledgeBase are counted into the
+             * Statistic tables if those have to be added. Nothing is changed
+             * if the upgrade fails.
+             */
+            void upgradeTables();
+
+            /**
+             * @brief Get the version of the tables in the database.
+             *
+             * @return int Returns the version, 0 if it was never set.
+             */
+            int getSchemaVersion();
+
+            /**
+             * @brief Set the version of the tables in the database to the
+             * current version.
+             *
+             */
+            void setSchemaVersion();
+
+            /**
+             * @brief Check whether the database has a table.
+             *
+             * @param[in] table The name of the table.
+             * @return true If the table exists.
+             * @return false If the table doesn't exist.
+             */
+            bool hasTable(const char* table);
+
+            /**
+             * @brief Check whether a table in the database has a column.
+             *
+             * @param[in] table The name of the table.
+             * @param[in] column The name of the column.
+             * @return true If the column exists.
+             * @return false If the table or column doesn't exist.
+             */
+            bool hasColumn(const char* table, const char* column);
+
+            /**
+             * @brief Check whether a query returns a row.
+             *
+             * @param[in] query The query to run.
+             * @param[in] first The text bound to the first parameter.
+             * @param[in] second The text bound to the second parameter, or
+             * nullptr if the query only has one.
+             * @return true If the query returned a row.
+             * @return false If the query returned no rows.
+             */
+            bool hasRow(const char* query,
+                const char* first,
+                const char* second);
+
+            /**
+             * @brief Run a query that doesn't return any rows.
+             *
+             * @param[in] query The query to run.
+             */
+            void execute(const char* query);
+
+            /**
+             * @brief Combine the confidence of a reason with the weight of the
+             * rule that uses it.
+             *
+             * @param[in] weight The weight of the rule.
+             * @param[in] isTrue The confidence of the reason.
+             * @return double Returns the confidence the rule gives its Fact.
+             */
+            double combine(double weight, double isTrue);
+
+            /**
+             * @brief Add the confidence given by one more rule to the
+             * confidence given by the other rules that derive the same Fact.
+             *
+             * @param[in] isTrue The confidence given by the other rules.
+             * @param[in] ruleIsTrue The confidence given by the rule.
+             * @return double Returns the combined confidence.
+             */
+            double aggregate(double isTrue, double ruleIsTrue);
+
+            /**
+             * @brief Get the confidence given to a Fact by the rules that
+             * derive it, using the stored confidence of their reasons.
+             *
+             * @param[in] fact The Fact, it must contain its ID.
+             * @return double Returns the confidence.
+             */
+            double combineRules(obelisk::Fact& fact);
+
+            /**
+             * @brief Add the chains that a true Fact of a transitive Verb
+             * connects to the Closure, or raise the ones it makes more
+             * confident.
+             *
+             * The confidence of a chain is the minimum of its facts when
+             * using the minimum Combine and their product otherwise.
+             *
+             * @param[in] fact The Fact, it must contain the IDs of its
+             * entities and Verb.
+             */
+            void insertClosure(obelisk::Fact& fact);
+
+            /**
+             * @brief Build the Closure of a Verb again from its true facts.
+             *
+             * The chains only ever grow as facts are added, so this is how a
+             * Fact that became less true is taken out of the chains that went
+             * through it.
+             *
+             * @param[in] verbId The ID of the Verb.
+             */
+            void rebuildClosure(sqlite3_int64 verbId);
+
+            /**
+             * @brief Raise the stored facts of the transitive verbs that are
+             * connected by a chain in the Closure, so the rules that use them
+             * as reasons see the chain.
+             *
+             * @return true If any Fact changed.
+             * @return false If nothing changed.
+             */
+            bool propagateClosure();
+
+            /**
+             * @brief Propagate the confidences through the rules in memory and
+             * store the facts that changed.
+             *
+             * The rules are visited one strongly connected component at a
+             * time in dependency order, only the components with a cycle are
+             * repeated until they stop changing.
+             *
+             * Groups of rules that are not connected to each other are
+             * propagated in parallel over the truths held in memory.
+             *
+             * @return true If any Fact changed.
+             * @return false If nothing changed.
+             */
+            bool propagateRules();
+
+            /**
+             * @brief Apply every PatternRule to the facts that are true.
+             *
+             * The confidences given to the same Fact by several pattern rules
+             * are aggregated before the Fact is raised, and the facts are
+             * stored in a single transaction.
+             *
+             * @return true If any Fact was derived or changed.
+             * @return false If nothing changed.
+             */
+            bool propagatePatternRules();
+
+            /**
+             * @brief Resolve the truth of a Fact by walking the rules backward
+             * from it.
+             *
+             * Answers are stored in the table so that each goal is only
+             * resolved once. Goals that are being resolved further up the
+             * chain are answered with their stored truth, and any answer that
+             * relied on them is not kept in the table.
+             *
+             * @param[in] fact The Fact to resolve, it must contain the IDs of
+             * its entities and Verb. If the Fact is stored it must also
+             * contain its ID and stored truth.
+             * @param[in,out] goals The goals currently being resolved.
+             * @param[out] dependent Set to true if the answer relied on a goal
+             * that is still being resolved.
+             * @return double Returns the truth of the Fact.
+             */
+            double resolveFact(obelisk::Fact& fact,
+                std::set<Goal>& goals,
+                bool& dependent);
+
+            /**
+             * @brief Resolve the truth of a Fact through a PatternRule whose
+             * Fact pattern matches it.
+             *
+             * @param[in] patternRule The PatternRule to use.
+             * @param[in] fact The Fact to resolve.
+             * @param[in,out] goals The goals currently being resolved.
+             * @param[out] dependent Set to true if the answer relied on a goal
+             * that is still being resolved.
+             * @return double Returns the truth of the strongest reason that
+             * matches, before the weight of the PatternRule is applied.
+             */
+            double resolvePatternRule(obelisk::PatternRule& patternRule,
+                obelisk::Fact& fact,
+                std::set<Goal>& goals,
+                bool& dependent);
+
+            /**
+             * @brief Bind an Entity to one side of a pattern.
+             *
+             * @param[in] variable The variable on this side of the pattern or
+             * an empty string if the side is an Entity.
+             * @param[in] patternEntityId The ID of the Entity on this side of
+             * the pattern.
+             * @param[in] entityId The ID of the Entity to bind.
+             * @param[in,out] bindings The IDs bound to each variable so far.
+             * @return true If the Entity fits the pattern.
+             * @return false If the Entity doesn't fit the pattern.
+             */
+            bool bindEntity(const std::string& variable,
+                sqlite3_int64 patternEntityId,
+                sqlite3_int64 entityId,
+                std::unordered_map<std::string, sqlite3_int64>& bindings);
+
+            /**
+             * @brief Raise the confidence of a Fact.
+             *
+             * The Fact is inserted if it doesn't exist yet. Nothing is done if
+             * the Fact is already at least as true.
+             *
+             * @param[in,out] fact The Fact to raise, it must contain the IDs of
+             * its entities and Verb.
+             * @param[in] isTrue The confidence to raise the Fact to.
+             * @return true If the Fact was inserted or raised.
+             * @return false If nothing changed.
+             */
+            bool deriveFact(obelisk::Fact& fact, double isTrue);
+
+            /**
+             * @brief Match a reason with a PatternRule and get the Fact the
+             * PatternRule gives, without storing it.
+             *
+             * @param[in] patternRule The PatternRule to apply.
+             * @param[in] reason The Fact to match with the reason of the
+             * PatternRule.
+             * @param[out] fact The Fact given by the PatternRule, with the IDs
+             * of its entities and Verb.
+             * @return true If the reason matches.
+             * @return false If the reason doesn't match.
+             */
+            bool bindPatternRule(obelisk::PatternRule& patternRule,
+                obelisk::Fact& reason,
+                obelisk::Fact& fact);
+
+            /**
+             * @brief Derive the Fact of a PatternRule from a true reason.
+             *
+             * @param[in] patternRule The PatternRule to apply.
+             * @param[in] reason The true Fact to match with the reason of the
+             * PatternRule.
+             * @param[out] fact The derived Fact.
+             * @return true If the derived Fact was inserted or raised.
+             * @return false If the reason doesn't match or nothing changed.
+             */
+            bool derivePatternRule(obelisk::PatternRule& patternRule,
+                obelisk::Fact& reason,
+                obelisk::Fact& fact);
+
         public:
             /**
              * @brief Construct a new KnowledgeBase object.
@@ -65,18 +580,33 @@ namespace obelisk
              * @param[in] filename The name of the file to save the knowledge
              * base as.
              * @param[in] flags The flags to open the KnowledgeBase with.
+             * @param[in] layout The layout of the tables if the file is
+             * created, an existing file keeps its layout.
+             * @param[in] storage Where the KnowledgeBase is kept while it is
+             * used.
              */
-            KnowledgeBase(const char* filename, int flags);
+            KnowledgeBase(const char* filename,
+                int flags,
+                Layout layout   = kLayoutRowid,
+                Storage storage = kStorageFile);
 
             /**
              * @brief Construct a new KnowledgeBase object.
              *
              * @param[in] filename The name of the file to save the knowledge
              * base as.
+             * @param[in] layout The layout of the tables if the file is
+             * created, an existing file keeps its layout.
+             * @param[in] storage Where the KnowledgeBase is kept while it is
+             * used.
              */
-            KnowledgeBase(const char* filename) :
+            KnowledgeBase(const char* filename,
+                Layout layout   = kLayoutRowid,
+                Storage storage = kStorageFile) :
                 KnowledgeBase(filename,
-                    SQLITE_OPEN_READWRITE | SQLITE_OPEN_CREATE)
+                    SQLITE_OPEN_READWRITE | SQLITE_OPEN_CREATE,
+                    layout,
+                    storage)
             {
             }
 
@@ -87,6 +617,144 @@ namespace obelisk
              */
             ~KnowledgeBase();
 
+            /**
+             * @brief Write an in-memory KnowledgeBase to its file.
+             *
+             * The whole database is serialized and written next to the file
+             * before replacing it, so the file is never left half written.
+             * This does nothing unless the storage is kStorageMemory.
+             */
+            void save();
+
+            /**
+             * @brief Start a transaction, so the changes made until it is
+             * committed are written to the file at once.
+             *
+             * Transactions nest, only committing the outermost one writes the
+             * changes.
+             *
+             */
+            void beginTransaction();
+
+            /**
+             * @brief Commit the transaction started last.
+             *
+             */
+            void commitTransaction();
+
+            /**
+             * @brief Undo the changes of the transaction started last and end
+             * it.
+             *
+             */
+            void rollbackTransaction();
+
+            /**
+             * @brief Start copying the KnowledgeBase to a replica file.
+             *
+             * The pages are copied as the returned Backup is stepped, so the
+             * caller decides how many pages to copy at a time and what to do
+             * in between. Only the pages that differ from the ones already in
+             * the replica are written to it.
+             *
+             * @param[in] filename The replica file, it is created if it
+             * doesn't exist.
+             * @return std::unique_ptr<obelisk::Backup> Returns the Backup to
+             * step, it must be destroyed before the KnowledgeBase.
+             */
+            std::unique_ptr<obelisk::Backup> startBackup(
+                const std::string& filename);
+
+            /**
+             * @brief Copy the KnowledgeBase to a replica file, writing only
+             * the pages that differ from the ones already in the replica.
+             *
+             * This steps a Backup until every page is copied. The database is
+             * only locked for short moments and writes made in between are
+             * picked up by the copy.
+             *
+             * @param[in] filename The replica file, it is created if it
+             * doesn't exist.
+             * @param[in] pages The most pages copied in each step.
+             * @return std::size_t Returns the number of pages written to the
+             * replica.
+             */
+            std::size_t backup(const std::string& filename, int pages = 64);
+
+            /**
+             * @brief Get whether the changes made to the KnowledgeBase are
+             * logged.
+             *
+             * @return true If the changes are logged.
+             * @return false If the changes aren't logged.
+             */
+            bool getChangeLog();
+
+            /**
+             * @brief Set whether the changes made to the KnowledgeBase are
+             * logged.
+             *
+             * The setting is saved in the KnowledgeBase. The log is disabled
+             * in a new KnowledgeBase. A replica should be copied after the log
+             * is enabled, since changes made before that aren't logged.
+             *
+             * @param[in] enabled Whether to log the changes.
+             */
+            void setChangeLog(bool enabled);
+
+            /**
+             * @brief Get the ID of the last change made to the
+             * KnowledgeBase.
+             *
+             * A replica that was copied from this KnowledgeBase has the same
+             * ID as long as it is kept up to date, so it can be passed to
+             * getChanges to find the changes the replica is missing.
+             *
+             * @return sqlite3_int64 Returns the ID or 0 if nothing has
+             * changed.
+             */
+            sqlite3_int64 getChangeId();
+
+            /**
+             * @brief Get a range of the logged changes, which can be replayed
+             * with applyChanges.
+             *
+             * @param[in] after The changes after this ID are selected.
+             * @param[in] last The ID of the last change to select.
+             * @param[out] changes The changes in the order they were made.
+             */
+            void getChanges(sqlite3_int64 after,
+                sqlite3_int64 last,
+                std::vector<obelisk::ChangeLog::Change>& changes);
+
+            /**
+             * @brief Delete the logged changes up to and including an ID.
+             *
+             * This is used once every replica has applied the changes. The
+             * IDs of later changes are not affected.
+             *
+             * @param[in] upTo The ID of the last change to delete.
+             */
+            void truncateChanges(sqlite3_int64 upTo);
+
+            /**
+             * @brief Replay changes read from another KnowledgeBase with
+             * getChanges onto this one.
+             *
+             * This KnowledgeBase must be a copy of the other one as it was
+             * before the first change. Each change is replayed with the
+             * statement of its table and operation, so only the kinds of
+             * changes the log records can be applied. The changes are applied
+             * in a single transaction, so if any of them fails none of them
+             * are kept.
+             *
+             * @param[in] changes The changes.
+             * @return std::size_t Returns the number of changes applied.
+             * @throws DatabaseException If a change can't be replayed.
+             */
+            std::size_t applyChanges(
+                const std::vector<obelisk::ChangeLog::Change>& changes);
+
             /**
              * @brief Add entities to the KnowledgeBase.
              *
@@ -137,6 +805,16 @@ namespace obelisk
              */
             void addRules(std::vector<obelisk::Rule>& rules);
 
+            /**
+             * @brief Add pattern rules to the KnowledgeBase.
+             *
+             * @param[in,out] patternRules The pattern rules to add. If the
+             * insert is successful it will have a row ID, if not the ID will be
+             * 0.
+             */
+            void addPatternRules(
+                std::vector<obelisk::PatternRule>& patternRules);
+
             /**
              * @brief Get an Entity object based on the ID it contains.
              *
@@ -185,28 +863,301 @@ namespace obelisk
              */
             void getRule(obelisk::Rule& rule);
 
+            /**
+             * @brief Get a PatternRule based on the IDs and variables it
+             * contains.
+             *
+             * @param[in,out] patternRule The PatternRule object should contain
+             * its patterns and the ID will be filled in.
+             */
+            void getPatternRule(obelisk::PatternRule& patternRule);
+
+            /**
+             * @brief Apply a PatternRule to the facts already in the
+             * KnowledgeBase.
+             *
+             * The true facts matching the reason are joined using the indexes
+             * on the Verb and entities, and every Fact derived from them is
+             * raised to the confidence the PatternRule gives it.
+             *
+             * Nothing is done when using backward evaluation.
+             *
+             * @param[in] patternRule The PatternRule to apply.
+             */
+            void applyPatternRule(obelisk::PatternRule& patternRule);
+
+            /**
+             * @brief Make a Verb transitive.
+             *
+             * The true facts that already use the Verb are added to the
+             * Closure, after that the Closure is kept up to date as facts are
+             * inserted or made true.
+             *
+             * @param[in,out] verb The Verb, it must contain its ID.
+             */
+            void setTransitive(obelisk::Verb& verb);
+
             /**
              * @brief Check if a rule looks for this Fact, if so update its
              * truth.
              *
+             * This follows the rules one Fact at a time, use propagate after
+             * loading many facts instead.
+             *
+             * Nothing is done when using backward evaluation.
+             *
              * @param[in,out] fact The Fact to check for existing rules.
              */
             void checkRule(obelisk::Fact& fact);
 
+            /**
+             * @brief Propagate the confidence of every Fact through the rules
+             * and pattern rules until nothing changes.
+             *
+             * The rules are loaded once and swept in memory, and the facts
+             * that changed are stored in a single transaction. A Fact keeps
+             * its stored confidence if that is higher than what the rules
+             * give it.
+             *
+             * Nothing is done when using backward evaluation.
+             */
+            void propagate();
+
+            /**
+             * @brief Get what the last call to propagate did.
+             *
+             * @return const PropagationStatistics& Returns the statistics.
+             */
+            const PropagationStatistics& getPropagationStatistics();
+
             /**
              * @brief Update the is true field in the KnowledgeBase.
              *
-             * @param[in,out] fact The fact to update.
+             * If the Fact becomes less true and its Verb is transitive, the
+             * Closure of the Verb is built again so the chains through the
+             * Fact lose its old confidence. The facts that were raised by
+             * those chains or derived from them keep their truth.
+             *
+             * @param[in,out] fact The fact to update, it must contain its ID.
              */
             void updateIsTrue(obelisk::Fact& fact);
 
+            /**
+             * @brief Get the evaluation used when querying facts.
+             *
+             * @return Evaluation Returns the evaluation.
+             */
+            Evaluation getEvaluation();
+
+            /**
+             * @brief Set the evaluation used when querying facts.
+             *
+             * @param[in] evaluation The evaluation.
+             */
+            void setEvaluation(Evaluation evaluation);
+
+            /**
+             * @brief Get the layout of the fact and rule tables.
+             *
+             * @return Layout Returns the layout the file was created with.
+             */
+            Layout getLayout();
+
+            /**
+             * @brief Get how confidences are combined when rules are applied.
+             *
+             * @return Combine Returns the combine mode.
+             */
+            Combine getCombine();
+
+            /**
+             * @brief Set how confidences are combined when rules are applied.
+             *
+             * @param[in] combine The combine mode.
+             */
+            void setCombine(Combine combine);
+
+            /**
+             * @brief Get the number of threads used to propagate the rules.
+             *
+             * @return unsigned int Returns the number of threads.
+             */
+            unsigned int getThreads();
+
+            /**
+             * @brief Set the number of threads used to propagate the rules.
+             *
+             * @param[in] threads The number of threads, 0 or 1 propagates on
+             * the calling thread.
+             */
+            void setThreads(unsigned int threads);
+
+            /**
+             * @brief Check if the SQL statements are being profiled.
+             *
+             * @return true If profiling is enabled.
+             * @return false If profiling is disabled.
+             */
+            bool getProfiling();
+
+            /**
+             * @brief Enable or disable profiling of the SQL statements.
+             *
+             * While enabled every statement run on the database is timed and
+             * its scan, sort and automatic index counters are recorded. This
+             * slows every statement down a little, so it is off by default.
+             * Disabling it forgets what was measured.
+             *
+             * @param[in] profiling Whether to profile the statements.
+             */
+            void setProfiling(bool profiling);
+
+            /**
+             * @brief Get what was measured for each SQL statement since
+             * profiling was enabled.
+             *
+             * @return std::vector<obelisk::StatementProfile> Returns the
+             * statements sorted by the total time spent in them, or nothing if
+             * profiling is disabled.
+             */
+            std::vector<obelisk::StatementProfile> getProfile();
+
+            /**
+             * @brief Forget the answers resolved by backward evaluation and
+             * the cached edges of the entities.
+             *
+             * This is done automatically when facts or rules are changed
+             * through this KnowledgeBase, but must be called if the database
+             * was changed by something else.
+             */
+            void clearTable();
+
+            /**
+             * @brief Get the number of true and false facts that use a Verb.
+             *
+             * The counts are maintained as facts change, so this doesn't scan
+             * the facts.
+             *
+             * @param[in] verb The Verb, it is looked up by name if it doesn't
+             * have an ID.
+             * @param[out] trueFacts The number of true facts.
+             * @param[out] falseFacts The number of false facts.
+             */
+            void getStatistics(obelisk::Verb& verb,
+                long long& trueFacts,
+                long long& falseFacts);
+
+            /**
+             * @brief Get the number of true and false facts that mention an
+             * Entity on either side.
+             *
+             * @param[in] entity The Entity, it is looked up by name if it
+             * doesn't have an ID.
+             * @param[out] trueFacts The number of true facts.
+             * @param[out] falseFacts The number of false facts.
+             */
+            void getStatistics(obelisk::Entity& entity,
+                long long& trueFacts,
+                long long& falseFacts);
+
+            /**
+             * @brief Check if the edges of the entities are cached in memory.
+             *
+             * @return true If the edges are cached.
+             * @return false If the edges are read from the database every
+             * time.
+             */
+            bool getAdjacencyCache();
+
+            /**
+             * @brief Set whether the edges of the entities are cached in
+             * memory.
+             *
+             * Caching helps when the same entities are walked over and over,
+             * the cache is cleared whenever a Fact is changed.
+             *
+             * @param[in] adjacencyCache Whether to cache the edges.
+             */
+            void setAdjacencyCache(bool adjacencyCache);
+
+            /**
+             * @brief Get the outgoing edges of an Entity, which are the true
+             * facts that have the Entity on their left.
+             *
+             * @param[in] entityId The ID of the Entity.
+             * @param[out] facts The facts are appended to this, each one holds
+             * the IDs of its Verb and right Entity.
+             */
+            void getOutgoing(sqlite3_int64 entityId,
+                std::vector<obelisk::Fact>& facts);
+
+            /**
+             * @brief Get the incoming edges of an Entity, which are the true
+             * facts that have the Entity on their right.
+             *
+             * @param[in] entityId The ID of the Entity.
+             * @param[out] facts The facts are appended to this, each one holds
+             * the IDs of its left Entity and Verb.
+             */
+            void getIncoming(sqlite3_int64 entityId,
+                std::vector<obelisk::Fact>& facts);
+
+            /**
+             * @brief Find a shortest path of true facts from one Entity to
+             * another.
+             *
+             * The search runs breadth first from both ends at once, always
+             * growing the smaller side, so only a fraction of the entities
+             * that a search from one end would visit are read.
+             *
+             * @param[in] fromEntityId The ID of the Entity to start from.
+             * @param[in] toEntityId The ID of the Entity to reach.
+             * @param[in] maxDepth The most facts the path may have.
+             * @param[out] path The facts from the start to the end, empty if
+             * both are the same Entity.
+             * @return true If a path was found.
+             * @return false If there is no path within maxDepth facts.
+             */
+            bool findPath(sqlite3_int64 fromEntityId,
+                sqlite3_int64 toEntityId,
+                std::size_t maxDepth,
+                std::vector<obelisk::Fact>& path);
+
             /**
              * @brief Query the KnowledgeBase to see if a Fact is true or false.
              *
+             * If the Verb is transitive, the Fact is also true if a chain of
+             * true facts connects its entities, and it is given the higher of
+             * its own confidence and the confidence of the chain.
+             *
              * @param[in] fact The Fact to check.
              */
             void queryFact(obelisk::Fact& fact);
 
+            /**
+             * @brief Query the KnowledgeBase for the true facts that match a
+             * pattern.
+             *
+             * Only the facts stored in the KnowledgeBase are matched, facts
+             * that backward evaluation would derive at query time are not.
+             *
+             * @param[in] pattern The pattern, an Entity or Verb with an empty
+             * name matches everything.
+             * @return std::unique_ptr<obelisk::FactCursor> Returns a cursor to
+             * step through the matching facts.
+             */
+            std::unique_ptr<obelisk::FactCursor> queryPattern(
+                obelisk::Fact& pattern);
+
+            /**
+             * @brief Query the KnowledgeBase to see if a Fact is true or false
+             * using the given evaluation.
+             *
+             * @param[in] fact The Fact to check.
+             * @param[in] evaluation The evaluation to use for this query.
+             */
+            void queryFact(obelisk::Fact& fact, Evaluation evaluation);
+
             /**
              * @brief Query the KnowledgeBase to get a suggested action based
              * on a Fact.
@@ -218,6 +1169,20 @@ namespace obelisk
             void querySuggestAction(obelisk::Fact& fact,
                 obelisk::Action& action);
 
+            /**
+             * @brief Query the truth of a Fact and the Action it suggests.
+             *
+             * With forward evaluation the stored truth is final, so the Fact
+             * and its Action are selected together in one statement. With
+             * backward evaluation the Fact is resolved first and the Action is
+             * selected afterwards.
+             *
+             * @param[in,out] fact The Fact to query, by the names of its
+             * entities and Verb.
+             * @param[out] action The Action that is suggested to take.
+             */
+            void queryAction(obelisk::Fact& fact, obelisk::Action& action);
+
             /**
              * @brief Take a float and divide it into 2 floats.
              *
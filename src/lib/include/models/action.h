@@ -19,7 +19,7 @@ namespace obelisk
              * @brief The ID of the Action in the KnowledgeBase.
              *
              */
-            int id_;
+            sqlite3_int64 id_;
 
             /**
              * @brief The name of the Action.
@@ -43,7 +43,7 @@ namespace obelisk
              *
              * @param[in] id The ID of the Action.
              */
-            Action(int id) :
+            Action(sqlite3_int64 id) :
                 id_(id),
                 name_("")
             {
@@ -66,7 +66,7 @@ namespace obelisk
              * @param[in] id The ID of the Action.
              * @param[in] name The name of the Action.
              */
-            Action(int id, std::string name) :
+            Action(sqlite3_int64 id, std::string name) :
                 id_(id),
                 name_(name)
             {
@@ -82,16 +82,16 @@ namespace obelisk
             /**
              * @brief Get the ID of the Action.
              *
-             * @return int& Returns the ID.
+             * @return sqlite3_int64& Returns the ID.
              */
-            int& getId();
+            sqlite3_int64& getId();
 
             /**
              * @brief Set the ID of the Action.
              *
              * @param[in] id Set the ID of the Action.
              */
-            void setId(int id);
+            void setId(sqlite3_int64 id);
 
             /**
              * @brief Get the name of the Action.
@@ -119,6 +119,9 @@ namespace obelisk
              * @brief Insert an Action into the KnowledgeBase based on the
              * object's fields.
              *
+             * If the ID is 0 the database picks one, otherwise the Action is
+             * inserted with the given ID.
+             *
              * @param[in] dbConnection The database connection to use.
              */
             void insert(sqlite3* dbConnection);
@@ -0,0 +1,200 @@
+#ifndef OBELISK_MODELS_CHANGE_LOG_H
+#define OBELISK_MODELS_CHANGE_LOG_H
+
+#include <sqlite3.h>
+
+#include <cstddef>
+#include <string>
+#include <vector>
+
+namespace obelisk
+{
+    /**
+     * @brief The ChangeLog model is an append only log of the changes made to
+     * the KnowledgeBase.
+     *
+     * While the log is enabled, triggers on the tables that hold the
+     * knowledge record every insert, update and delete in the same
+     * transaction as the change itself. A change is recorded as the table,
+     * the operation and the values of the row that the operation needs, the
+     * IDs included, not as SQL. Replaying the changes in order on a copy of
+     * the KnowledgeBase brings the copy up to date, and each change is
+     * replayed with the one statement that belongs to its table and
+     * operation. The Statistic tables aren't logged since their own triggers
+     * update them while the changes are replayed.
+     *
+     * The log is disabled by default, so a KnowledgeBase that isn't
+     * replicated doesn't pay for it, and the changes that every replica has
+     * applied can be deleted.
+     *
+     */
+    class ChangeLog
+    {
+        public:
+            /**
+             * @brief The most values a change holds, the columns of a
+             * PatternRule.
+             *
+             */
+            static constexpr std::size_t kValues = 12;
+
+            /**
+             * @brief A value of a changed row with the type SQLite stored it
+             * as.
+             *
+             */
+            struct Value
+            {
+                    /**
+                     * @brief The type of the value, SQLITE_INTEGER,
+                     * SQLITE_FLOAT, SQLITE_TEXT or SQLITE_NULL.
+                     *
+                     */
+                    int type = SQLITE_NULL;
+
+                    /**
+                     * @brief The value if it is an integer.
+                     *
+                     */
+                    sqlite3_int64 integer = 0;
+
+                    /**
+                     * @brief The value if it is a real.
+                     *
+                     */
+                    double real = 0;
+
+                    /**
+                     * @brief The value if it is text.
+                     *
+                     */
+                    std::string text;
+            };
+
+            /**
+             * @brief A logged change.
+             *
+             */
+            struct Change
+            {
+                    /**
+                     * @brief The ID of the change in the log.
+                     *
+                     */
+                    sqlite3_int64 id = 0;
+
+                    /**
+                     * @brief The name of the table that changed.
+                     *
+                     */
+                    std::string table;
+
+                    /**
+                     * @brief The operation, "insert", "update" or "delete".
+                     *
+                     */
+                    std::string operation;
+
+                    /**
+                     * @brief The values the operation needs, in the order of
+                     * the parameters of its statement. Any values after those
+                     * must be null.
+                     *
+                     */
+                    std::vector<obelisk::ChangeLog::Value> values;
+            };
+
+            /**
+             * @brief Create the ChangeLog table in the KnowledgeBase if it
+             * doesn't exist yet.
+             *
+             * @return const char* Returns the query used to create the table.
+             */
+            static const char* createTable();
+
+            /**
+             * @brief Create the triggers that log the changes, which enables
+             * the log.
+             *
+             * The tables that are logged must already exist. Only the
+             * triggers that don't exist yet are created, so this can also be
+             * used to add missing triggers to an older KnowledgeBase.
+             *
+             * @return const char* Returns the query used to create the
+             * triggers.
+             */
+            static const char* createTriggers();
+
+            /**
+             * @brief Drop the triggers that log the changes, which disables
+             * the log.
+             *
+             * @return const char* Returns the query used to drop the
+             * triggers.
+             */
+            static const char* dropTriggers();
+
+            /**
+             * @brief Select the ID of the last change.
+             *
+             * The ID keeps counting up after the changes are deleted, so it
+             * can't be given to a change that was already made.
+             *
+             * @param[in] dbConnection The database connection to use.
+             * @return sqlite3_int64 Returns the ID or 0 if nothing has
+             * changed.
+             */
+            static sqlite3_int64 selectLast(sqlite3* dbConnection);
+
+            /**
+             * @brief Select a range of changes.
+             *
+             * @param[in] dbConnection The database connection to use.
+             * @param[in] after The changes after this ID are selected.
+             * @param[in] last The ID of the last change to select.
+             * @param[out] changes The changes are appended to this in the
+             * order they were made.
+             */
+            static void selectRange(sqlite3* dbConnection,
+                sqlite3_int64 after,
+                sqlite3_int64 last,
+                std::vector<obelisk::ChangeLog::Change>& changes);
+
+            /**
+             * @brief Delete the changes up to and including an ID.
+             *
+             * @param[in] dbConnection The database connection to use.
+             * @param[in] last The ID of the last change to delete.
+             */
+            static void deleteUpTo(sqlite3* dbConnection, sqlite3_int64 last);
+
+            /**
+             * @brief Replay a change.
+             *
+             * Only the tables and operations the triggers log can be replayed,
+             * each with a fixed statement whose parameters are bound to the
+             * values of the change, so a change can't run any other SQL.
+             *
+             * @param[in] dbConnection The database connection to use.
+             * @param[in] change The change to replay.
+             * @throws DatabaseException If the table and operation aren't
+             * logged or the change doesn't have the values of its statement.
+             */
+            static void apply(sqlite3* dbConnection,
+                const obelisk::ChangeLog::Change& change);
+
+        private:
+            /**
+             * @brief Get the statement that replays a change.
+             *
+             * @param[in] table The name of the table that changed.
+             * @param[in] operation The operation.
+             * @return const char* Returns the statement or nullptr if the
+             * table and operation aren't logged.
+             */
+            static const char* getStatement(const std::string& table,
+                const std::string& operation);
+    };
+} // namespace obelisk
+
+#endif
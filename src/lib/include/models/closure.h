@@ -0,0 +1,97 @@
+#ifndef OBELISK_MODELS_CLOSURE_H
+#define OBELISK_MODELS_CLOSURE_H
+
+#include "models/fact.h"
+
+#include <sqlite3.h>
+
+namespace obelisk
+{
+    /**
+     * @brief The Closure model is the reachability index of the transitive
+     * verbs. It holds a row for every pair of entities that are connected by
+     * a chain of true facts using the same transitive Verb, so checking if a
+     * chain exists is a single lookup no matter how deep the chain is.
+     *
+     * Each row also holds the confidence of the best chain between the pair,
+     * the product or the minimum of the confidences of its facts.
+     *
+     * The index trades space and insert time for the lookups. A Verb whose
+     * facts connect n entities can have up to n² rows, a single chain of n
+     * entities already has n(n-1)/2, and one Fact that joins two chains adds
+     * a row for every pair across them. Only verbs whose chains stay short
+     * or sparse should be made transitive.
+     *
+     * Rows are only ever added or raised as facts become more true. When a
+     * Fact becomes less true the chains of its Verb are deleted with
+     * deleteByVerb and built again from the facts that are still true.
+     *
+     */
+    class Closure
+    {
+        public:
+            /**
+             * @brief Create the Closure table in the KnowledgeBase.
+             *
+             * @return const char* Returns the query used to create the table.
+             */
+            static const char* createTable();
+
+            /**
+             * @brief Add the pairs of entities that a true Fact connects to
+             * the Closure.
+             *
+             * Every Entity that reaches the left Entity is connected to every
+             * Entity that is reached by the right Entity. A pair that is
+             * already connected is raised if the chain through the Fact is
+             * more confident. Nothing is added if the Verb of the Fact is not
+             * transitive.
+             *
+             * @param[in] dbConnection The database connection to use.
+             * @param[in] fact The Fact, it must contain the IDs of its
+             * entities and Verb and its confidence.
+             * @param[in] minimum Whether the confidence of a chain is the
+             * minimum of the confidences of its facts instead of their
+             * product.
+             */
+            static void insertFact(sqlite3* dbConnection,
+                obelisk::Fact& fact,
+                bool minimum);
+
+            /**
+             * @brief Delete every chain of a Verb.
+             *
+             * @param[in] dbConnection The database connection to use.
+             * @param[in] verbId The ID of the Verb.
+             * @return int Returns the number of chains that were deleted.
+             */
+            static int deleteByVerb(sqlite3* dbConnection,
+                sqlite3_int64 verbId);
+
+            /**
+             * @brief Select whether a chain of facts connects the entities of
+             * the Fact by the names of the entities and Verb. If it does, the
+             * Fact is given the confidence of the chain.
+             *
+             * @param[in] dbConnection The database connection to use.
+             * @param[in,out] fact The Fact to check.
+             */
+            static void selectByName(sqlite3* dbConnection,
+                obelisk::Fact& fact);
+
+            /**
+             * @brief Raise the facts whose entities are connected by a chain
+             * to the confidence of the chain.
+             *
+             * A stored Fact that isn't true on its own can still be the reason
+             * of a rule, so it has to hold the confidence the chain gives it
+             * before the rules are propagated.
+             *
+             * @param[in] dbConnection The database connection to use.
+             * @return int Returns the number of facts that were raised.
+             */
+            static int updateFacts(sqlite3* dbConnection);
+    };
+} // namespace obelisk
+
+#endif
@@ -19,7 +19,7 @@ namespace obelisk
              * @brief The ID of the Entity in the KnowledgeBase.
              *
              */
-            int id_;
+            sqlite3_int64 id_;
 
             /**
              * @brief The name of the Entity.
@@ -43,7 +43,7 @@ namespace obelisk
              *
              * @param[in] id The ID of the Entity.
              */
-            Entity(int id) :
+            Entity(sqlite3_int64 id) :
                 id_(id),
                 name_("")
             {
@@ -66,7 +66,7 @@ namespace obelisk
              * @param[in] id The ID of the Entity.
              * @param[in] name The name of the Entity.
              */
-            Entity(int id, std::string name) :
+            Entity(sqlite3_int64 id, std::string name) :
                 id_(id),
                 name_(name)
             {
@@ -82,16 +82,16 @@ namespace obelisk
             /**
              * @brief Get the ID of the Entity.
              *
-             * @return int& Returns the ID.
+             * @return sqlite3_int64& Returns the ID.
              */
-            int& getId();
+            sqlite3_int64& getId();
 
             /**
              * @brief Set the ID of the Entity.
              *
              * @param[in] id The ID of the Entity.
              */
-            void setId(int id);
+            void setId(sqlite3_int64 id);
 
             /**
              * @brief Get the name of the Entity.
@@ -119,6 +119,9 @@ namespace obelisk
              * @brief Insert an Entity into the KnowledgeBase based on the
              * object's fields.
              *
+             * If the ID is 0 the database picks one, otherwise the Entity is
+             * inserted with the given ID.
+             *
              * @param[in] dbConnection The database connection to use.
              */
             void insert(sqlite3* dbConnection);
@@ -7,6 +7,7 @@
 #include "models/verb.h"
 
 #include <string>
+#include <vector>
 
 namespace obelisk
 {
@@ -22,7 +23,7 @@ namespace obelisk
              * @brief The ID of the Fact in the KnowledgeBase.
              *
              */
-            int id_;
+            sqlite3_int64 id_;
 
             /**
              * @brief The Entity from the left side of the expression.
@@ -68,7 +69,7 @@ namespace obelisk
              *
              * @param[in] id The ID of the Fact in the KnowledgeBase.
              */
-            Fact(int id) :
+            Fact(sqlite3_int64 id) :
                 id_(id),
                 leftEntity_(),
                 rightEntity_(),
@@ -110,7 +111,7 @@ namespace obelisk
              * @param[in] verb The Verb separating the entities.
              * @param[in] isTrue Whether or not the fact is true.
              */
-            Fact(int id,
+            Fact(sqlite3_int64 id,
                 obelisk::Entity leftEntity,
                 obelisk::Entity rightEntity,
                 obelisk::Verb verb,
@@ -130,19 +131,43 @@ namespace obelisk
              */
             static const char* createTable();
 
+            /**
+             * @brief Create the Fact table in the KnowledgeBase clustered on
+             * its entities and Verb.
+             *
+             * The facts are stored in the order of their left Entity, right
+             * Entity and Verb without a rowid, so looking a Fact up by those
+             * reads a single B-tree. The ID is kept as a unique column for the
+             * tables that refer to facts.
+             *
+             * @return const char* Returns the query used to create the table.
+             */
+            static const char* createClusteredTable();
+
+            /**
+             * @brief Create the indexes used to look facts up by their Verb
+             * and one of their entities.
+             *
+             * The indexes are only created if they don't exist yet, so this
+             * can also be used to add them to an older KnowledgeBase.
+             *
+             * @return const char* Returns the query used to create the indexes.
+             */
+            static const char* createIndexes();
+
             /**
              * @brief Get the ID of the Fact
              *
-             * @return int& Returns the ID.
+             * @return sqlite3_int64& Returns the ID.
              */
-            int& getId();
+            sqlite3_int64& getId();
 
             /**
              * @brief Set the ID of the Fact.
              *
              * @param[in] id Set the ID of the Fact.
              */
-            void setId(int id);
+            void setId(sqlite3_int64 id);
 
             /**
              * @brief Get the left Entity object.
@@ -217,22 +242,80 @@ namespace obelisk
              */
             void selectByName(sqlite3* dbConnection);
 
+            /**
+             * @brief Select the facts that use a Verb, optionally limited to
+             * the ones with the given left and/or right Entity.
+             *
+             * @param[in] dbConnection The database connection to use.
+             * @param[in] verbId The ID of the Verb.
+             * @param[in] leftEntityId The ID of the left Entity or 0 to match
+             * any.
+             * @param[in] rightEntityId The ID of the right Entity or 0 to match
+             * any.
+             * @param[out] facts The facts to fill in from the database.
+             */
+            static void selectByVerb(sqlite3* dbConnection,
+                sqlite3_int64 verbId,
+                sqlite3_int64 leftEntityId,
+                sqlite3_int64 rightEntityId,
+                std::vector<obelisk::Fact>& facts);
+
+            /**
+             * @brief Select the true facts that have an Entity on their left
+             * or right side.
+             *
+             * Either the left or the right Entity has to be given. The lookup
+             * uses the index that starts with that side, so it is cheap enough
+             * to walk the facts as a graph of entities.
+             *
+             * @param[in] dbConnection The database connection to use.
+             * @param[in] leftEntityId The ID of the left Entity or 0 to match
+             * any.
+             * @param[in] rightEntityId The ID of the right Entity or 0 to match
+             * any.
+             * @param[out] facts The facts to fill in from the database.
+             */
+            static void selectByEntity(sqlite3* dbConnection,
+                sqlite3_int64 leftEntityId,
+                sqlite3_int64 rightEntityId,
+                std::vector<obelisk::Fact>& facts);
+
             /**
              * @brief Select an Action from the KnowledgeBase using the provided
              * Fact.
              *
+             * The Action is chosen using the truth currently held by the Fact
+             * object rather than the one stored in the KnowledgeBase.
+             *
              * @param[in] dbConnection The database connection to use.
              * @param[out] action The Action to take based on the provided fact.
              */
             void selectActionByFact(sqlite3* dbConnection,
                 obelisk::Action& action);
 
+            /**
+             * @brief Select the Fact by the names of its entities and Verb
+             * together with the Action it suggests.
+             *
+             * This does the work of selectByName, the closure of transitive
+             * verbs and selectActionByFact in a single statement. The Action
+             * is chosen using the truth stored in the KnowledgeBase.
+             *
+             * @param[in] dbConnection The database connection to use.
+             * @param[out] action The Action to take based on the Fact, its
+             * name is left unchanged if the Fact doesn't suggest one.
+             */
+            void selectActionByName(sqlite3* dbConnection,
+                obelisk::Action& action);
+
             /**
              * @brief Insert the Fact into the KnowledgeBase.
              *
              * @param[in] dbConnection The database connection to use.
+             * @param[in] clustered Whether the table uses the clustered
+             * layout, which has no rowid to read the ID back from.
              */
-            void insert(sqlite3* dbConnection);
+            void insert(sqlite3* dbConnection, bool clustered = false);
 
             /**
              * @brief Update whether or not the fact is true in the
@@ -0,0 +1,288 @@
+#ifndef OBELISK_MODELS_PATTERN_RULE_H
+#define OBELISK_MODELS_PATTERN_RULE_H
+
+#include "models/fact.h"
+
+#include <string>
+#include <vector>
+
+namespace obelisk
+{
+    /**
+     * @brief The PatternRule model represents a truth relation between 2 Fact
+     * patterns. Any entity in the patterns can be a variable which matches
+     * every Entity, so one PatternRule covers all the facts that fit it.
+     *
+     * An entity that is a variable has the name of the variable set and the
+     * Entity in the Fact is ignored.
+     *
+     */
+    class PatternRule
+    {
+        private:
+            /**
+             * @brief The ID of the PatternRule in the KnowledgeBase.
+             *
+             */
+            sqlite3_int64 id_;
+
+            /**
+             * @brief The Fact pattern that depends on the reason being true.
+             *
+             */
+            obelisk::Fact fact_;
+
+            /**
+             * @brief The Fact pattern that makes the other Fact true.
+             *
+             */
+            obelisk::Fact reason_;
+
+            /**
+             * @brief The variable on the left side of the Fact.
+             *
+             */
+            std::string factLeftVariable_;
+
+            /**
+             * @brief The variable on the right side of the Fact.
+             *
+             */
+            std::string factRightVariable_;
+
+            /**
+             * @brief The variable on the left side of the reason.
+             *
+             */
+            std::string reasonLeftVariable_;
+
+            /**
+             * @brief The variable on the right side of the reason.
+             *
+             */
+            std::string reasonRightVariable_;
+
+            /**
+             * @brief How strongly the reason implies the Fact, between 0 and
+             * 1.
+             *
+             */
+            double weight_;
+
+        public:
+            /**
+             * @brief Construct a new PatternRule object.
+             *
+             */
+            PatternRule() :
+                id_(0),
+                fact_(),
+                reason_(),
+                factLeftVariable_(""),
+                factRightVariable_(""),
+                reasonLeftVariable_(""),
+                reasonRightVariable_(""),
+                weight_(1.0)
+            {
+            }
+
+            /**
+             * @brief Construct a new PatternRule object.
+             *
+             * @param[in] id The ID of the PatternRule in the KnowledgeBase.
+             */
+            PatternRule(sqlite3_int64 id) :
+                id_(id),
+                fact_(),
+                reason_(),
+                factLeftVariable_(""),
+                factRightVariable_(""),
+                reasonLeftVariable_(""),
+                reasonRightVariable_(""),
+                weight_(1.0)
+            {
+            }
+
+            /**
+             * @brief Create the PatternRule table in the KnowledgeBase.
+             *
+             * @return const char* Returns the query used to create the table.
+             */
+            static const char* createTable();
+
+            /**
+             * @brief Get the ID of the PatternRule.
+             *
+             * @return sqlite3_int64& The ID.
+             */
+            sqlite3_int64& getId();
+
+            /**
+             * @brief Set the ID of the PatternRule.
+             *
+             * @param[in] id The ID.
+             */
+            void setId(sqlite3_int64 id);
+
+            /**
+             * @brief Get the Fact pattern.
+             *
+             * @return obelisk::Fact& The Fact.
+             */
+            obelisk::Fact& getFact();
+
+            /**
+             * @brief Set the Fact pattern.
+             *
+             * @param[in] fact The Fact.
+             */
+            void setFact(obelisk::Fact fact);
+
+            /**
+             * @brief Get the reason Fact pattern.
+             *
+             * @return obelisk::Fact& The reason Fact.
+             */
+            obelisk::Fact& getReason();
+
+            /**
+             * @brief Set the reason Fact pattern.
+             *
+             * @param[in] reason The reason Fact.
+             */
+            void setReason(obelisk::Fact reason);
+
+            /**
+             * @brief Get the variable on the left side of the Fact.
+             *
+             * @return std::string& The variable or an empty string if the
+             * left side is an Entity.
+             */
+            std::string& getFactLeftVariable();
+
+            /**
+             * @brief Set the variable on the left side of the Fact.
+             *
+             * @param[in] variable The variable.
+             */
+            void setFactLeftVariable(std::string variable);
+
+            /**
+             * @brief Get the variable on the right side of the Fact.
+             *
+             * @return std::string& The variable or an empty string if the
+             * right side is an Entity.
+             */
+            std::string& getFactRightVariable();
+
+            /**
+             * @brief Set the variable on the right side of the Fact.
+             *
+             * @param[in] variable The variable.
+             */
+            void setFactRightVariable(std::string variable);
+
+            /**
+             * @brief Get the variable on the left side of the reason.
+             *
+             * @return std::string& The variable or an empty string if the
+             * left side is an Entity.
+             */
+            std::string& getReasonLeftVariable();
+
+            /**
+             * @brief Set the variable on the left side of the reason.
+             *
+             * @param[in] variable The variable.
+             */
+            void setReasonLeftVariable(std::string variable);
+
+            /**
+             * @brief Get the variable on the right side of the reason.
+             *
+             * @return std::string& The variable or an empty string if the
+             * right side is an Entity.
+             */
+            std::string& getReasonRightVariable();
+
+            /**
+             * @brief Set the variable on the right side of the reason.
+             *
+             * @param[in] variable The variable.
+             */
+            void setReasonRightVariable(std::string variable);
+
+            /**
+             * @brief Get the weight of the PatternRule.
+             *
+             * @return double& The weight.
+             */
+            double& getWeight();
+
+            /**
+             * @brief Set the weight of the PatternRule.
+             *
+             * @param[in] weight The weight, between 0 and 1.
+             */
+            void setWeight(double weight);
+
+            /**
+             * @brief Check if any of the entities are variables.
+             *
+             * @return true If at least one entity is a variable.
+             * @return false If all the entities are concrete.
+             */
+            bool hasVariables();
+
+            /**
+             * @brief Select the PatternRule from the KnowledgeBase by the IDs
+             * and variables of the patterns.
+             *
+             * @param[in] dbConnection The database connection to use.
+             */
+            void selectById(sqlite3* dbConnection);
+
+            /**
+             * @brief Get the pattern rules whose reason uses the Verb.
+             *
+             * @param[in] dbConnection The database connection to use.
+             * @param[in] verbId The ID of the Verb of the reason.
+             * @param[out] patternRules The pattern rules to fill in from the
+             * database.
+             */
+            static void selectByReasonVerb(sqlite3* dbConnection,
+                sqlite3_int64 verbId,
+                std::vector<obelisk::PatternRule>& patternRules);
+
+            /**
+             * @brief Get the pattern rules whose Fact uses the Verb.
+             *
+             * @param[in] dbConnection The database connection to use.
+             * @param[in] verbId The ID of the Verb of the Fact.
+             * @param[out] patternRules The pattern rules to fill in from the
+             * database.
+             */
+            static void selectByVerb(sqlite3* dbConnection,
+                sqlite3_int64 verbId,
+                std::vector<obelisk::PatternRule>& patternRules);
+
+            /**
+             * @brief Get every PatternRule in the KnowledgeBase.
+             *
+             * @param[in] dbConnection The database connection to use.
+             * @param[out] patternRules The pattern rules to fill in from the
+             * database.
+             */
+            static void selectAll(sqlite3* dbConnection,
+                std::vector<obelisk::PatternRule>& patternRules);
+
+            /**
+             * @brief Insert the PatternRule into the KnowledgeBase.
+             *
+             * @param[in] dbConnection The database connection to use.
+             */
+            void insert(sqlite3* dbConnection);
+    };
+} // namespace obelisk
+
+#endif
@@ -19,7 +19,7 @@ namespace obelisk
              * @brief The ID of the Rule in the KnowledgeBase.
              *
              */
-            int id_;
+            sqlite3_int64 id_;
 
             /**
              * @brief The Fact that depends on the Fact reason being true.
@@ -33,6 +33,13 @@ namespace obelisk
              */
             obelisk::Fact reason_;
 
+            /**
+             * @brief How strongly the reason implies the Fact, between 0 and
+             * 1.
+             *
+             */
+            double weight_;
+
         public:
             /**
              * @brief Construct a new Rule object.
@@ -41,7 +48,8 @@ namespace obelisk
             Rule() :
                 id_(0),
                 fact_(),
-                reason_()
+                reason_(),
+                weight_(1.0)
             {
             }
 
@@ -50,10 +58,11 @@ namespace obelisk
              *
              * @param[in] id The ID of the Rule in the KnowledgeBase.
              */
-            Rule(int id) :
+            Rule(sqlite3_int64 id) :
                 id_(id),
                 fact_(),
-                reason_()
+                reason_(),
+                weight_(1.0)
             {
             }
 
@@ -62,11 +71,15 @@ namespace obelisk
              *
              * @param[in] fact The Fact.
              * @param[in] reason The reason Fact.
+             * @param[in] weight How strongly the reason implies the Fact.
              */
-            Rule(obelisk::Fact fact, obelisk::Fact reason) :
+            Rule(obelisk::Fact fact,
+                obelisk::Fact reason,
+                double weight = 1.0) :
                 id_(0),
                 fact_(fact),
-                reason_(reason)
+                reason_(reason),
+                weight_(weight)
             {
             }
 
@@ -76,11 +89,16 @@ namespace obelisk
              * @param[in] id The ID of the Rule.
              * @param[in] fact The Fact.
              * @param[in] reason The reason Fact.
+             * @param[in] weight How strongly the reason implies the Fact.
              */
-            Rule(int id, obelisk::Fact fact, obelisk::Fact reason) :
+            Rule(sqlite3_int64 id,
+                obelisk::Fact fact,
+                obelisk::Fact reason,
+                double weight = 1.0) :
                 id_(id),
                 fact_(fact),
-                reason_(reason)
+                reason_(reason),
+                weight_(weight)
             {
             }
 
@@ -91,19 +109,31 @@ namespace obelisk
              */
             static const char* createTable();
 
+            /**
+             * @brief Create the Rule table in the KnowledgeBase clustered on
+             * its reason and Fact.
+             *
+             * The rules are stored in the order of their reason without a
+             * rowid, so the rules that depend on a Fact are next to each
+             * other.
+             *
+             * @return const char* Returns the query used to create the table.
+             */
+            static const char* createClusteredTable();
+
             /**
              * @brief Get the ID of the Rule.
              *
-             * @return int& The ID.
+             * @return sqlite3_int64& The ID.
              */
-            int& getId();
+            sqlite3_int64& getId();
 
             /**
              * @brief Set the ID of the Rule.
              *
              * @param[in] id The ID.
              */
-            void setId(int id);
+            void setId(sqlite3_int64 id);
 
             /**
              * @brief Get the Fact object.
@@ -133,6 +163,20 @@ namespace obelisk
              */
             void setReason(obelisk::Fact reason);
 
+            /**
+             * @brief Get the weight of the Rule.
+             *
+             * @return double& The weight.
+             */
+            double& getWeight();
+
+            /**
+             * @brief Set the weight of the Rule.
+             *
+             * @param[in] weight The weight, between 0 and 1.
+             */
+            void setWeight(double weight);
+
             /**
              * @brief Select the Rule from the KnowledgeBase by IDs of the
              * sub-objects.
@@ -148,15 +192,40 @@ namespace obelisk
              * @param[out] rules The rules to fill in from the database.
              */
             static void selectByReason(sqlite3* dbConnection,
-                int reasonId,
+                sqlite3_int64 reasonId,
+                std::vector<obelisk::Rule>& rules);
+
+            /**
+             * @brief Get the rules that can make the Fact true.
+             *
+             * @param[in] dbConnection The database connection to use.
+             * @param[in] factId The ID of the Fact the rules conclude.
+             * @param[out] rules The rules to fill in from the database.
+             */
+            static void selectByFact(sqlite3* dbConnection,
+                sqlite3_int64 factId,
+                std::vector<obelisk::Rule>& rules);
+
+            /**
+             * @brief Get every Rule in the KnowledgeBase.
+             *
+             * The Fact and reason of each Rule are filled in with their IDs and
+             * truth.
+             *
+             * @param[in] dbConnection The database connection to use.
+             * @param[out] rules The rules to fill in from the database.
+             */
+            static void selectAll(sqlite3* dbConnection,
                 std::vector<obelisk::Rule>& rules);
 
             /**
              * @brief Insert the Rule into the KnowledgeBase.
              *
              * @param[in] dbConnection The database connection to use.
+             * @param[in] clustered Whether the table uses the clustered
+             * layout, which has no rowid to read the ID back from.
              */
-            void insert(sqlite3* dbConnection);
+            void insert(sqlite3* dbConnection, bool clustered = false);
     };
 } // namespace obelisk
 
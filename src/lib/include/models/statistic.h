@@ -0,0 +1,91 @@
+#ifndef OBELISK_MODELS_STATISTIC_H
+#define OBELISK_MODELS_STATISTIC_H
+
+#include <sqlite3.h>
+
+namespace obelisk
+{
+    /**
+     * @brief The Statistic model holds the number of true and false facts
+     * that use each Verb and mention each Entity.
+     *
+     * The counts are kept up to date by triggers on the Fact table as facts
+     * are inserted, change between true and false, or are deleted, so reading
+     * them never has to scan the facts.
+     *
+     */
+    class Statistic
+    {
+        private:
+            /**
+             * @brief Select the counts of the row with the given ID.
+             *
+             * @param[in] dbConnection The database connection to use.
+             * @param[in] query The query that selects the true and false
+             * counts.
+             * @param[in] id The ID bound to the query.
+             * @param[out] trueFacts The number of true facts, 0 if there is no
+             * row.
+             * @param[out] falseFacts The number of false facts, 0 if there is
+             * no row.
+             */
+            static void selectCounts(sqlite3* dbConnection,
+                const char* query,
+                sqlite3_int64 id,
+                long long& trueFacts,
+                long long& falseFacts);
+
+        public:
+            /**
+             * @brief Create the Statistic tables and their triggers in the
+             * KnowledgeBase.
+             *
+             * The Fact table must already exist.
+             *
+             * @return const char* Returns the query used to create the tables.
+             */
+            static const char* createTable();
+
+            /**
+             * @brief Count the facts that are already in the KnowledgeBase.
+             *
+             * This is used when the Statistic tables are added to a
+             * KnowledgeBase that already has facts, the triggers keep the
+             * counts up to date from then on.
+             *
+             * @return const char* Returns the query used to fill the tables.
+             */
+            static const char* fillTable();
+
+            /**
+             * @brief Select the number of facts that use a Verb.
+             *
+             * @param[in] dbConnection The database connection to use.
+             * @param[in] verbId The ID of the Verb.
+             * @param[out] trueFacts The number of true facts.
+             * @param[out] falseFacts The number of false facts.
+             */
+            static void selectByVerb(sqlite3* dbConnection,
+                sqlite3_int64 verbId,
+                long long& trueFacts,
+                long long& falseFacts);
+
+            /**
+             * @brief Select the number of facts that have an Entity on their
+             * left or right side.
+             *
+             * A Fact that has the Entity on both sides is counted once.
+             *
+             * @param[in] dbConnection The database connection to use.
+             * @param[in] entityId The ID of the Entity.
+             * @param[out] trueFacts The number of true facts.
+             * @param[out] falseFacts The number of false facts.
+             */
+            static void selectByEntity(sqlite3* dbConnection,
+                sqlite3_int64 entityId,
+                long long& trueFacts,
+                long long& falseFacts);
+    };
+} // namespace obelisk
+
+#endif
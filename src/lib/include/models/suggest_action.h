@@ -20,7 +20,7 @@ namespace obelisk
              * @brief The ID of the SuggestAction.
              *
              */
-            int id_;
+            sqlite3_int64 id_;
 
             /**
              * @brief The Fact to check the truth of.
@@ -58,7 +58,7 @@ namespace obelisk
              *
              * @param[in] id The ID of the SuggestAction in the KnowledgeBase.
              */
-            SuggestAction(int id) :
+            SuggestAction(sqlite3_int64 id) :
                 id_(id),
                 fact_(),
                 trueAction_(),
@@ -91,7 +91,7 @@ namespace obelisk
              * @param[in] trueAction The true Action.
              * @param[in] falseAction The false Action.
              */
-            SuggestAction(int id,
+            SuggestAction(sqlite3_int64 id,
                 obelisk::Fact fact,
                 obelisk::Action trueAction,
                 obelisk::Action falseAction) :
@@ -112,16 +112,16 @@ namespace obelisk
             /**
              * @brief Get the ID of the SuggestAction.
              *
-             * @return int& Returns the ID.
+             * @return sqlite3_int64& Returns the ID.
              */
-            int& getId();
+            sqlite3_int64& getId();
 
             /**
              * @brief Set the ID of the SuggestAction.
              *
              * @param[in] id The new ID.
              */
-            void setId(int id);
+            void setId(sqlite3_int64 id);
 
             /**
              * @brief Get the Fact object.
@@ -19,7 +19,7 @@ namespace obelisk
              * @brief The ID of the Verb in the KnowledgeBase.
              *
              */
-            int id_;
+            sqlite3_int64 id_;
 
             /**
              * @brief The name of the Verb.
@@ -27,6 +27,12 @@ namespace obelisk
              */
             std::string name_;
 
+            /**
+             * @brief Whether or not the Verb is transitive.
+             *
+             */
+            bool transitive_;
+
         public:
             /**
              * @brief Construct a new Verb object.
@@ -34,7 +40,8 @@ namespace obelisk
              */
             Verb() :
                 id_(0),
-                name_("")
+                name_(""),
+                transitive_(false)
             {
             }
 
@@ -43,9 +50,10 @@ namespace obelisk
              *
              * @param[in] id The ID of the Verb.
              */
-            Verb(int id) :
+            Verb(sqlite3_int64 id) :
                 id_(id),
-                name_("")
+                name_(""),
+                transitive_(false)
             {
             }
 
@@ -56,7 +64,8 @@ namespace obelisk
              */
             Verb(std::string name) :
                 id_(0),
-                name_(name)
+                name_(name),
+                transitive_(false)
             {
             }
 
@@ -66,9 +75,10 @@ namespace obelisk
              * @param[in] id The ID of the Verb.
              * @param[in] name The name of the Verb.
              */
-            Verb(int id, std::string name) :
+            Verb(sqlite3_int64 id, std::string name) :
                 id_(id),
-                name_(name)
+                name_(name),
+                transitive_(false)
             {
             }
 
@@ -82,16 +92,16 @@ namespace obelisk
             /**
              * @brief Get the ID of the Verb.
              *
-             * @return int& Returns the ID.
+             * @return sqlite3_int64& Returns the ID.
              */
-            int& getId();
+            sqlite3_int64& getId();
 
             /**
              * @brief Set the ID of the Verb.
              *
              * @param[in] id Set the ID of the Verb.
              */
-            void setId(int id);
+            void setId(sqlite3_int64 id);
 
             /**
              * @brief Get the name of the Verb.
@@ -107,6 +117,23 @@ namespace obelisk
              */
             void setName(std::string name);
 
+            /**
+             * @brief Get whether or not the Verb is transitive.
+             *
+             * If a Verb is transitive, a chain of true facts using it makes
+             * the Verb hold between the first and last entities of the chain.
+             *
+             * @return bool& Returns true if the Verb is transitive.
+             */
+            bool& getTransitive();
+
+            /**
+             * @brief Set whether or not the Verb is transitive.
+             *
+             * @param[in] transitive Whether or not the Verb is transitive.
+             */
+            void setTransitive(bool transitive);
+
             /**
              * @brief Select a verb by name from the KnowledgeBase.
              *
@@ -117,9 +144,21 @@ namespace obelisk
             /**
              * @brief Insert a new verb into the KnowledgeBase.
              *
+             * If the ID is 0 the database picks one, otherwise the Verb is
+             * inserted with the given ID. Whether the Verb is transitive is
+             * inserted with it.
+             *
              * @param[in] dbConnection The database connection to use.
              */
             void insert(sqlite3* dbConnection);
+
+            /**
+             * @brief Update whether or not the Verb is transitive in the
+             * KnowledgeBase.
+             *
+             * @param[in] dbConnection The database connection to use.
+             */
+            void updateTransitive(sqlite3* dbConnection);
     };
 } // namespace obelisk
 
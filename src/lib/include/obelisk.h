@@ -2,9 +2,12 @@
 #define OBELISK_INCLUDE_OBELISK_H
 
 #include "knowledge_base.h"
+#include "sharded_knowledge_base.h"
 
+#include <cstddef>
 #include <memory>
 #include <string>
+#include <vector>
 
 /**
  * @brief The obelisk namespace contains everything needed to compile obelisk
@@ -17,12 +20,32 @@ namespace obelisk
      * @brief The obelisk library provides everything needed to consult the
      * KnowledgeBase.
      *
+     * A ShardedKnowledgeBase can be queried for facts, suggested actions and
+     * the IDs of entities, the other queries throw a KnowledgeBaseException
+     * for it.
+     *
      */
     class Obelisk
     {
         private:
             std::unique_ptr<obelisk::KnowledgeBase> kb_;
 
+            /**
+             * @brief The ShardedKnowledgeBase, used instead of kb_ if the
+             * Obelisk was opened with shards.
+             *
+             */
+            std::unique_ptr<obelisk::ShardedKnowledgeBase> shardedKb_;
+
+            /**
+             * @brief Get the KnowledgeBase for the queries that need a single
+             * file.
+             *
+             * @return obelisk::KnowledgeBase& The KnowledgeBase.
+             * @throws KnowledgeBaseException If the KnowledgeBase is sharded.
+             */
+            obelisk::KnowledgeBase& getKnowledgeBase();
+
         public:
             /**
              * @brief Construct a new Obelisk object.
@@ -30,6 +53,26 @@ namespace obelisk
              */
             Obelisk(std::string filename);
 
+            /**
+             * @brief Construct a new Obelisk object.
+             *
+             * @param[in] filename The obelisk KnowledgeBase file to use.
+             * @param[in] storage Where the KnowledgeBase is kept while it is
+             * used, kStorageImage loads the whole file into memory.
+             */
+            Obelisk(std::string filename,
+                obelisk::KnowledgeBase::Storage storage);
+
+            /**
+             * @brief Construct a new Obelisk object that uses a
+             * ShardedKnowledgeBase.
+             *
+             * @param[in] filename The dictionary file of the
+             * ShardedKnowledgeBase, the shards are next to it.
+             * @param[in] shards The number of shards it was compiled with.
+             */
+            Obelisk(std::string filename, std::size_t shards);
+
             /**
              * @brief Destroy the Obelisk object.
              *
@@ -64,6 +107,144 @@ namespace obelisk
                 const std::string& verb,
                 const std::string& rightEntity);
 
+            /**
+             * @brief Query the obelisk KnowledgeBase to see if a Fact is true
+             * or not using the given evaluation.
+             *
+             * @param[in] leftEntity The left entity.
+             * @param[in] verb The verb.
+             * @param[in] rightEntity The right entity.
+             * @param[in] evaluation The evaluation to use for this query.
+             * @return double Returns whether or not the Fact is true.
+             */
+            double query(const std::string& leftEntity,
+                const std::string& verb,
+                const std::string& rightEntity,
+                obelisk::KnowledgeBase::Evaluation evaluation);
+
+            /**
+             * @brief Set the evaluation used by default when querying the
+             * KnowledgeBase.
+             *
+             * @param[in] evaluation The evaluation.
+             */
+            void setEvaluation(obelisk::KnowledgeBase::Evaluation evaluation);
+
+            /**
+             * @brief Set how rule weights combine confidences when querying
+             * with backward evaluation.
+             *
+             * @param[in] combine The combine mode.
+             */
+            void setCombine(obelisk::KnowledgeBase::Combine combine);
+
+            /**
+             * @brief Query the obelisk KnowledgeBase for the true facts that
+             * match a pattern.
+             *
+             * @param[in] leftEntity The left entity or an empty string to
+             * match any.
+             * @param[in] verb The verb or an empty string to match any.
+             * @param[in] rightEntity The right entity or an empty string to
+             * match any.
+             * @return std::unique_ptr<obelisk::FactCursor> Returns a cursor to
+             * step through the matching facts. It must not outlive the Obelisk
+             * object.
+             */
+            std::unique_ptr<obelisk::FactCursor> queryPattern(
+                const std::string& leftEntity,
+                const std::string& verb,
+                const std::string& rightEntity);
+
+            /**
+             * @brief Get the ID of an Entity in the obelisk KnowledgeBase.
+             *
+             * @param[in] entity The name of the Entity.
+             * @return sqlite3_int64 Returns the ID or 0 if the Entity doesn't
+             * exist.
+             */
+            sqlite3_int64 getEntityId(const std::string& entity);
+
+            /**
+             * @brief Get the number of true and false facts that use a verb.
+             *
+             * @param[in] verb The verb.
+             * @param[out] trueFacts The number of true facts.
+             * @param[out] falseFacts The number of false facts.
+             */
+            void getVerbStatistics(const std::string& verb,
+                long long& trueFacts,
+                long long& falseFacts);
+
+            /**
+             * @brief Get the number of true and false facts that mention an
+             * entity.
+             *
+             * @param[in] entity The entity.
+             * @param[out] trueFacts The number of true facts.
+             * @param[out] falseFacts The number of false facts.
+             */
+            void getEntityStatistics(const std::string& entity,
+                long long& trueFacts,
+                long long& falseFacts);
+
+            /**
+             * @brief Enable or disable profiling of the SQL statements run by
+             * the KnowledgeBase.
+             *
+             * @param[in] profiling Whether to profile the statements.
+             */
+            void setProfiling(bool profiling);
+
+            /**
+             * @brief Get a table of what was measured for each SQL statement
+             * since profiling was enabled.
+             *
+             * @return std::string Returns one line for each statement, slowest
+             * first.
+             */
+            std::string getProfile();
+
+            /**
+             * @brief Set whether the edges of the entities are cached in
+             * memory.
+             *
+             * @param[in] adjacencyCache Whether to cache the edges.
+             */
+            void setAdjacencyCache(bool adjacencyCache);
+
+            /**
+             * @brief Get the true facts that have an Entity on their left.
+             *
+             * @param[in] entityId The ID of the Entity.
+             * @return std::vector<obelisk::Fact> Returns the facts with the
+             * IDs of their Verb and right Entity.
+             */
+            std::vector<obelisk::Fact> getOutgoing(sqlite3_int64 entityId);
+
+            /**
+             * @brief Get the true facts that have an Entity on their right.
+             *
+             * @param[in] entityId The ID of the Entity.
+             * @return std::vector<obelisk::Fact> Returns the facts with the
+             * IDs of their left Entity and Verb.
+             */
+            std::vector<obelisk::Fact> getIncoming(sqlite3_int64 entityId);
+
+            /**
+             * @brief Find a shortest path of true facts from one Entity to
+             * another.
+             *
+             * @param[in] fromEntityId The ID of the Entity to start from.
+             * @param[in] toEntityId The ID of the Entity to reach.
+             * @param[in] maxDepth The most facts the path may have.
+             * @return std::vector<obelisk::Fact> Returns the facts along the
+             * path, empty if there is no path within maxDepth facts.
+             */
+            std::vector<obelisk::Fact> findPath(sqlite3_int64 fromEntityId,
+                sqlite3_int64 toEntityId,
+                std::size_t maxDepth);
+
             /**
              * @brief Query the Obelisk KnowledgeBase and return the suggested
              * action to take.
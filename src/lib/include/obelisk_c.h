@@ -1,12 +1,100 @@
 #ifndef OBELISK_INCLUDE_OBELISK_PROGRAM_H
 #define OBELISK_INCLUDE_OBELISK_PROGRAM_H
 
+#include <stddef.h>
+
 /**
  * @brief Struct wrapper around Obelisk class.
  *
  */
 typedef struct CObelisk CObelisk;
 
+/**
+ * @brief Struct wrapper around the FactCursor class.
+ *
+ */
+typedef struct CObeliskCursor CObeliskCursor;
+
+/**
+ * @brief A Fact returned by a cursor.
+ *
+ * The strings belong to the cursor and stay valid until the next step or until
+ * the cursor is closed.
+ *
+ */
+typedef struct CObeliskFact
+{
+        /**
+         * @brief The left entity.
+         *
+         */
+        const char* left_entity;
+
+        /**
+         * @brief The verb.
+         *
+         */
+        const char* verb;
+
+        /**
+         * @brief The right entity.
+         *
+         */
+        const char* right_entity;
+
+        /**
+         * @brief How true the Fact is.
+         *
+         */
+        double is_true;
+} CObeliskFact;
+
+/**
+ * @brief The evaluations that can be used when querying the KnowledgeBase.
+ *
+ */
+enum ObeliskEvaluation
+{
+    /**
+     * @brief Use the truth derived when the KnowledgeBase was compiled.
+     *
+     */
+    OBELISK_EVALUATION_FORWARD = 0,
+
+    /**
+     * @brief Derive the truth by walking the rules back from the query.
+     *
+     */
+    OBELISK_EVALUATION_BACKWARD = 1
+};
+
+/**
+ * @brief How rule weights combine confidences when the KnowledgeBase is
+ * queried with backward evaluation.
+ *
+ */
+enum ObeliskCombine
+{
+    /**
+     * @brief The weaker of the reason and the weight, the strongest rule wins.
+     *
+     */
+    OBELISK_COMBINE_MINIMUM = 0,
+
+    /**
+     * @brief The reason scaled by the weight, the strongest rule wins.
+     *
+     */
+    OBELISK_COMBINE_PRODUCT = 1,
+
+    /**
+     * @brief The reason scaled by the weight, every rule raises the
+     * confidence.
+     *
+     */
+    OBELISK_COMBINE_NOISY_OR = 2
+};
+
 #ifdef __cplusplus
 extern "C"
 {
@@ -20,6 +108,34 @@ extern "C"
      */
     extern CObelisk* obelisk_open(const char* filename);
 
+    /**
+     * @brief Create an obelisk object with the whole KnowledgeBase loaded
+     * into memory.
+     *
+     * Queries never read from the disk, changes are not written back to the
+     * file.
+     *
+     * @param[in] filename The obelisk KnowledgeBase file to load.
+     * @return CObelisk* Returns an obelisk object.
+     */
+    extern CObelisk* obelisk_open_image(const char* filename);
+
+    /**
+     * @brief Create an obelisk object with a KnowledgeBase compiled into
+     * shards.
+     *
+     * Only obelisk_query, obelisk_query_evaluation, obelisk_query_action,
+     * obelisk_set_evaluation, obelisk_set_combine and the versions can be
+     * used with it.
+     *
+     * @param[in] filename The dictionary file of the KnowledgeBase, the
+     * shards are next to it.
+     * @param[in] shards The number of shards it was compiled with.
+     * @return CObelisk* Returns an obelisk object.
+     */
+    extern CObelisk* obelisk_open_sharded(const char* filename,
+        size_t shards);
+
     /**
      * @brief Delete an obelisk object.
      *
@@ -50,6 +166,121 @@ extern "C"
         const char* verb,
         const char* right_entity);
 
+    /**
+     * @brief Query the obelisk KnowledgeBase to see if a Fact is true or false
+     * using the given evaluation.
+     *
+     * @param[in] obelisk The obelisk object.
+     * @param[in] left_entity The left entity.
+     * @param[in] verb The verb.
+     * @param[in] right_entity The right entity.
+     * @param[in] evaluation One of the ObeliskEvaluation values.
+     * @return double Returns whether the Fact is true or false.
+     */
+    extern double obelisk_query_evaluation(CObelisk* obelisk,
+        const char* left_entity,
+        const char* verb,
+        const char* right_entity,
+        int evaluation);
+
+    /**
+     * @brief Set the evaluation used by default when querying the obelisk
+     * KnowledgeBase.
+     *
+     * @param[in] obelisk The obelisk object.
+     * @param[in] evaluation One of the ObeliskEvaluation values.
+     */
+    extern void obelisk_set_evaluation(CObelisk* obelisk, int evaluation);
+
+    /**
+     * @brief Set how rule weights combine confidences.
+     *
+     * @param[in] obelisk The obelisk object.
+     * @param[in] combine One of the ObeliskCombine values.
+     */
+    extern void obelisk_set_combine(CObelisk* obelisk, int combine);
+
+    /**
+     * @brief Get the number of true and false facts that use a verb.
+     *
+     * @param[in] obelisk The obelisk object.
+     * @param[in] verb The verb.
+     * @param[out] true_facts The number of true facts.
+     * @param[out] false_facts The number of false facts.
+     */
+    extern void obelisk_verb_statistics(CObelisk* obelisk,
+        const char* verb,
+        long long* true_facts,
+        long long* false_facts);
+
+    /**
+     * @brief Get the number of true and false facts that mention an entity.
+     *
+     * @param[in] obelisk The obelisk object.
+     * @param[in] entity The entity.
+     * @param[out] true_facts The number of true facts.
+     * @param[out] false_facts The number of false facts.
+     */
+    extern void obelisk_entity_statistics(CObelisk* obelisk,
+        const char* entity,
+        long long* true_facts,
+        long long* false_facts);
+
+    /**
+     * @brief Enable or disable profiling of the SQL statements run by the
+     * KnowledgeBase.
+     *
+     * @param[in] obelisk The obelisk object.
+     * @param[in] profiling Non-zero to enable profiling, 0 to disable it.
+     */
+    extern void obelisk_set_profiling(CObelisk* obelisk, int profiling);
+
+    /**
+     * @brief Dump a table of what was measured for each SQL statement since
+     * profiling was enabled.
+     *
+     * @param[in] obelisk The obelisk object.
+     * @return char* Returns one line for each statement with its count, time
+     * percentiles and counters. This must be freed by the caller.
+     */
+    extern char* obelisk_profile_dump(CObelisk* obelisk);
+
+    /**
+     * @brief Query the obelisk KnowledgeBase for the true facts that match a
+     * pattern.
+     *
+     * @param[in] obelisk The obelisk object.
+     * @param[in] left_entity The left entity or NULL to match any.
+     * @param[in] verb The verb or NULL to match any.
+     * @param[in] right_entity The right entity or NULL to match any.
+     * @return CObeliskCursor* Returns a cursor to step through the facts. It
+     * must be closed with obelisk_cursor_close before the obelisk object is.
+     */
+    extern CObeliskCursor* obelisk_query_pattern(CObelisk* obelisk,
+        const char* left_entity,
+        const char* verb,
+        const char* right_entity);
+
+    /**
+     * @brief Fetch the next chunk of facts from a cursor.
+     *
+     * @param[in] cursor The cursor.
+     * @param[out] facts The array to fill in.
+     * @param[in] max The size of the array.
+     * @return size_t Returns the number of facts filled in, 0 once every fact
+     * has been returned.
+     */
+    extern size_t obelisk_cursor_step(CObeliskCursor* cursor,
+        CObeliskFact* facts,
+        size_t max);
+
+    /**
+     * @brief Close a cursor.
+     *
+     * @param[in] cursor The cursor.
+     */
+    extern void obelisk_cursor_close(CObeliskCursor* cursor);
+
     /**
      * @brief Query the obelisk KnowledgeBase to get a suggested Action to do.
      *
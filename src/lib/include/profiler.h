@@ -0,0 +1,240 @@
+#ifndef OBELISK_PROFILER_H
+#define OBELISK_PROFILER_H
+
+#include <sqlite3.h>
+
+#include <cstddef>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace obelisk
+{
+    /**
+     * @brief The StatementProfile struct holds what was measured for one SQL
+     * statement.
+     *
+     */
+    struct StatementProfile
+    {
+            /**
+             * @brief The SQL of the statement, without its bound values.
+             *
+             */
+            std::string sql;
+
+            /**
+             * @brief The number of times the statement was run.
+             *
+             */
+            std::size_t count = 0;
+
+            /**
+             * @brief The time spent in all the runs in nanoseconds.
+             *
+             */
+            sqlite3_uint64 totalNanoseconds = 0;
+
+            /**
+             * @brief The median time of a run in nanoseconds.
+             *
+             */
+            sqlite3_uint64 p50Nanoseconds = 0;
+
+            /**
+             * @brief The time 90% of the runs stayed under in nanoseconds.
+             *
+             */
+            sqlite3_uint64 p90Nanoseconds = 0;
+
+            /**
+             * @brief The time 99% of the runs stayed under in nanoseconds.
+             *
+             */
+            sqlite3_uint64 p99Nanoseconds = 0;
+
+            /**
+             * @brief The time of the slowest run in nanoseconds.
+             *
+             */
+            sqlite3_uint64 maxNanoseconds = 0;
+
+            /**
+             * @brief The number of rows stepped through by full table scans.
+             *
+             */
+            sqlite3_int64 fullScanSteps = 0;
+
+            /**
+             * @brief The number of sorts that couldn't use an index.
+             *
+             */
+            sqlite3_int64 sorts = 0;
+
+            /**
+             * @brief The number of rows inserted into automatic indexes.
+             *
+             */
+            sqlite3_int64 autoIndexRows = 0;
+
+            /**
+             * @brief The number of virtual machine operations run.
+             *
+             */
+            sqlite3_int64 vmSteps = 0;
+    };
+
+    /**
+     * @brief The Profiler class measures every SQL statement run on a database
+     * connection.
+     *
+     * The Profiler is attached to a connection with sqlite3_trace_v2. A
+     * statement is timed from its first step until it finishes, then its time
+     * and the counters of sqlite3_stmt_status are added to the totals of its
+     * SQL. The time given by SQLite itself is only as precise as the clock of
+     * the VFS, which is often a millisecond, so a steady clock is used
+     * instead. The statements are grouped by their SQL, so a statement that
+     * is prepared again for each call is still counted as one.
+     *
+     */
+    class Profiler
+    {
+        private:
+            /**
+             * @brief What was measured for one SQL statement so far.
+             *
+             */
+            struct Samples
+            {
+                    /**
+                     * @brief The time of each run in nanoseconds.
+                     *
+                     */
+                    std::vector<sqlite3_uint64> nanoseconds;
+
+                    /**
+                     * @brief The rows stepped through by full table scans.
+                     *
+                     */
+                    sqlite3_int64 fullScanSteps = 0;
+
+                    /**
+                     * @brief The sorts that couldn't use an index.
+                     *
+                     */
+                    sqlite3_int64 sorts = 0;
+
+                    /**
+                     * @brief The rows inserted into automatic indexes.
+                     *
+                     */
+                    sqlite3_int64 autoIndexRows = 0;
+
+                    /**
+                     * @brief The virtual machine operations run.
+                     *
+                     */
+                    sqlite3_int64 vmSteps = 0;
+            };
+
+            /**
+             * @brief Protects the samples, statements can finish on several
+             * threads.
+             *
+             */
+            std::mutex mutex_;
+
+            /**
+             * @brief The samples of each statement, indexed by its SQL.
+             *
+             */
+            std::unordered_map<std::string, Samples> statements_;
+
+            /**
+             * @brief When each running statement started, in nanoseconds.
+             *
+             */
+            std::unordered_map<sqlite3_stmt*, sqlite3_uint64> started_;
+
+            /**
+             * @brief The callback given to sqlite3_trace_v2.
+             *
+             * @param[in] type The type of the event, SQLITE_TRACE_STMT when a
+             * statement starts and SQLITE_TRACE_PROFILE when it finishes.
+             * @param[in] context The Profiler.
+             * @param[in] statement The statement.
+             * @param[in] text The SQL of the statement when it starts, or a
+             * comment naming the trigger when it starts running a trigger.
+             * @return int Always returns 0.
+             */
+            static int trace(unsigned int type,
+                void* context,
+                void* statement,
+                void* text);
+
+            /**
+             * @brief Get the time of a steady clock.
+             *
+             * @return sqlite3_uint64 Returns the time in nanoseconds.
+             */
+            static sqlite3_uint64 now();
+
+            /**
+             * @brief Note the time a statement started.
+             *
+             * @param[in] statement The statement.
+             */
+            void start(sqlite3_stmt* statement);
+
+            /**
+             * @brief Add a finished statement to the samples.
+             *
+             * @param[in] statement The statement.
+             */
+            void record(sqlite3_stmt* statement);
+
+        public:
+            /**
+             * @brief Start measuring the statements run on a connection.
+             *
+             * @param[in] dbConnection The database connection to measure.
+             */
+            void attach(sqlite3* dbConnection);
+
+            /**
+             * @brief Stop measuring the statements run on a connection.
+             *
+             * @param[in] dbConnection The database connection to stop
+             * measuring.
+             */
+            void detach(sqlite3* dbConnection);
+
+            /**
+             * @brief Get what was measured for each statement.
+             *
+             * @return std::vector<obelisk::StatementProfile> Returns the
+             * statements sorted by the total time spent in them, slowest
+             * first.
+             */
+            std::vector<obelisk::StatementProfile> getProfile();
+
+            /**
+             * @brief Forget everything measured so far.
+             *
+             */
+            void reset();
+
+            /**
+             * @brief Format a profile as a table that is easy to read.
+             *
+             * @param[in] profile The profile to format.
+             * @return std::string Returns one line for each statement, with
+             * the times in microseconds.
+             */
+            static std::string format(
+                const std::vector<obelisk::StatementProfile>& profile);
+    };
+} // namespace obelisk
+
+#endif
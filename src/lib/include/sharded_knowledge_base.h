@@ -0,0 +1,508 @@
+#ifndef OBELISK_SHARDED_KNOWLEDGE_BASE_H
+#define OBELISK_SHARDED_KNOWLEDGE_BASE_H
+
+#include "fact_cursor.h"
+#include "knowledge_base.h"
+#include "models/action.h"
+#include "models/entity.h"
+#include "models/fact.h"
+#include "models/pattern_rule.h"
+#include "models/rule.h"
+#include "models/suggest_action.h"
+#include "models/verb.h"
+
+#include <sqlite3.h>
+
+#include <cstddef>
+#include <memory>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+namespace obelisk
+{
+    /**
+     * @brief The ShardedKnowledgeBase class splits the facts of a knowledge
+     * base across several files.
+     *
+     * The entities, verbs and actions are kept in a dictionary file that gives
+     * each of them one ID shared by every shard. Each Fact is stored in the
+     * shard picked by a hash of the ID of its left Entity, so a query for a
+     * Fact only has to open one shard. The entities, verbs and actions a shard
+     * uses are copied into it with the same ID as in the dictionary.
+     *
+     * A Rule is stored in the shard of its Fact, so every rule that derives a
+     * Fact is combined in one place. If its reason belongs to another shard,
+     * the reason is also stored there and the shard of the Rule gets a copy
+     * of it. A PatternRule is stored in the shard of the left Entity of its
+     * reason, or in every shard if that side is a variable, and a Fact it
+     * derives for an Entity of another shard is first stored as a copy where
+     * it was derived. The dictionary keeps a copy of every Fact of a
+     * transitive Verb, so its Closure follows the chains that cross shards,
+     * and of every reason that is copied into another shard.
+     *
+     * Propagating the shards exchanges these copies until nothing changes:
+     * a copy derived outside the shard of its Fact raises the Fact, the
+     * dictionary is raised to the facts it keeps a copy of and follows their
+     * chains, and the facts raised in the dictionary raise every copy of
+     * them. With backward evaluation each shard resolves its own rules at
+     * query time, and a copy is as true as its Fact was at the last
+     * propagate.
+     *
+     */
+    class ShardedKnowledgeBase
+    {
+        private:
+            /**
+             * @brief The dictionary of entities, verbs and actions.
+             *
+             */
+            std::unique_ptr<obelisk::KnowledgeBase> dictionary_;
+
+            /**
+             * @brief The shards that hold the facts and rules.
+             *
+             */
+            std::vector<std::unique_ptr<obelisk::KnowledgeBase>> shards_;
+
+            /**
+             * @brief The dictionary IDs of the entities already resolved, by
+             * name.
+             *
+             */
+            std::unordered_map<std::string, sqlite3_int64> entityIds_;
+
+            /**
+             * @brief The dictionary IDs of the verbs already resolved, by
+             * name.
+             *
+             */
+            std::unordered_map<std::string, sqlite3_int64> verbIds_;
+
+            /**
+             * @brief The IDs of the entities already copied into each shard.
+             *
+             */
+            std::vector<std::unordered_set<sqlite3_int64>> shardEntities_;
+
+            /**
+             * @brief The IDs of the verbs already copied into each shard.
+             *
+             */
+            std::vector<std::unordered_set<sqlite3_int64>> shardVerbs_;
+
+            /**
+             * @brief The IDs of the actions already copied into each shard.
+             *
+             */
+            std::vector<std::unordered_set<sqlite3_int64>> shardActions_;
+
+            /**
+             * @brief Whether each Verb is transitive in the dictionary, by ID.
+             *
+             */
+            std::unordered_map<sqlite3_int64, bool> transitiveVerbs_;
+
+            /**
+             * @brief Whether the dictionary keeps a copy of facts of each
+             * Verb, by ID.
+             *
+             */
+            std::unordered_map<sqlite3_int64, bool> exchangedVerbs_;
+
+            /**
+             * @brief The truth each Fact of the dictionary had when its copies
+             * in the shards were last raised, by the ID in the dictionary.
+             *
+             */
+            std::unordered_map<sqlite3_int64, double> pulledFacts_;
+
+            /**
+             * @brief The number of threads used to propagate the shards.
+             *
+             */
+            unsigned int threads_ = std::thread::hardware_concurrency();
+
+            /**
+             * @brief Changes in truth smaller than this are ignored, so that
+             * exchanging the facts between the shards comes to an end.
+             *
+             */
+            static constexpr double kEpsilon = 1e-9;
+
+            /**
+             * @brief Get the name of the file of a shard.
+             *
+             * The number of the shard is put before the extension, so the
+             * shards of "obelisk.kb" are "obelisk.0.kb", "obelisk.1.kb" and so
+             * on.
+             *
+             * @param[in] filename The name of the dictionary file.
+             * @param[in] shard The index of the shard.
+             * @return std::string Returns the name of the file.
+             */
+            std::string getShardFilename(const std::string& filename,
+                std::size_t shard);
+
+            /**
+             * @brief Look up or insert an Entity in the dictionary.
+             *
+             * @param[in,out] entity The Entity, its ID is set to the one in
+             * the dictionary.
+             */
+            void resolveEntity(obelisk::Entity& entity);
+
+            /**
+             * @brief Look up or insert a Verb in the dictionary.
+             *
+             * @param[in,out] verb The Verb, its ID is set to the one in the
+             * dictionary.
+             */
+            void resolveVerb(obelisk::Verb& verb);
+
+            /**
+             * @brief Look up or insert an Action in the dictionary.
+             *
+             * @param[in,out] action The Action, its ID is set to the one in
+             * the dictionary.
+             */
+            void resolveAction(obelisk::Action& action);
+
+            /**
+             * @brief Look up or insert the entities and Verb of a Fact in the
+             * dictionary.
+             *
+             * @param[in,out] fact The Fact, the IDs of its entities and Verb
+             * are set to the ones in the dictionary.
+             */
+            void resolveFact(obelisk::Fact& fact);
+
+            /**
+             * @brief Copy an Entity into a shard if it isn't there yet.
+             *
+             * @param[in] shard The index of the shard.
+             * @param[in] entity The Entity with its dictionary ID.
+             */
+            void copyEntity(std::size_t shard, obelisk::Entity& entity);
+
+            /**
+             * @brief Copy a Verb into a shard if it isn't there yet.
+             *
+             * @param[in] shard The index of the shard.
+             * @param[in] verb The Verb with its dictionary ID.
+             */
+            void copyVerb(std::size_t shard, obelisk::Verb& verb);
+
+            /**
+             * @brief Copy an Action into a shard if it isn't there yet.
+             *
+             * @param[in] shard The index of the shard.
+             * @param[in] action The Action with its dictionary ID.
+             */
+            void copyAction(std::size_t shard, obelisk::Action& action);
+
+            /**
+             * @brief Check if a Verb is transitive in the dictionary.
+             *
+             * @param[in] verb The Verb with its dictionary ID and name.
+             * @return true If the Verb is transitive.
+             * @return false If the Verb isn't transitive.
+             */
+            bool isTransitive(obelisk::Verb& verb);
+
+            /**
+             * @brief Check if the dictionary keeps a copy of facts of a Verb,
+             * because it is transitive or a reason that uses it is copied
+             * into another shard.
+             *
+             * @param[in] verb The Verb with its dictionary ID and name.
+             * @return true If the facts of the Verb may have a copy.
+             * @return false If none of the facts of the Verb have a copy.
+             */
+            bool isExchanged(obelisk::Verb& verb);
+
+            /**
+             * @brief Raise a Fact in a KnowledgeBase to a truth.
+             *
+             * @param[in] knowledgeBase The KnowledgeBase, which already has
+             * the entities and Verb of the Fact.
+             * @param[in,out] fact The resolved Fact with the truth to raise
+             * to. Its ID and truth are set to the ones stored.
+             * @param[in] insert Whether to insert the Fact if it isn't
+             * stored.
+             * @return true If the Fact was inserted or raised.
+             * @return false If the Fact was already as true.
+             */
+            bool raiseFact(obelisk::KnowledgeBase& knowledgeBase,
+                obelisk::Fact& fact,
+                bool insert);
+
+            /**
+             * @brief Insert a Fact into a shard along with its entities and
+             * Verb, or raise it if it is already there.
+             *
+             * @param[in] shard The index of the shard.
+             * @param[in,out] fact The resolved Fact, its ID and truth are set
+             * to the ones in the shard.
+             * @return true If the Fact was inserted or raised.
+             * @return false If the Fact was already as true.
+             */
+            bool insertFact(std::size_t shard, obelisk::Fact& fact);
+
+            /**
+             * @brief Insert a Fact into the shard of its left Entity, and
+             * into the dictionary if its Verb is transitive.
+             *
+             * @param[in,out] fact The resolved Fact, its ID and truth are set
+             * to the ones in its shard.
+             */
+            void insertHomeFact(obelisk::Fact& fact);
+
+            /**
+             * @brief Propagate the rules of every shard on its own, in
+             * parallel.
+             *
+             */
+            void propagateShards();
+
+            /**
+             * @brief Exchange the copies of the facts between the shards and
+             * the dictionary once.
+             *
+             * @return true If a Fact in a shard was inserted or raised.
+             * @return false If the shards didn't change.
+             */
+            bool exchange();
+
+        public:
+            /**
+             * @brief Construct a new ShardedKnowledgeBase object.
+             *
+             * An existing ShardedKnowledgeBase must be opened with the same
+             * number of shards it was created with.
+             *
+             * @param[in] filename The name of the dictionary file, the shards
+             * are saved next to it.
+             * @param[in] shards The number of shards, at least one is always
+             * used.
+             * @param[in] layout The layout of the tables of new shards.
+             */
+            ShardedKnowledgeBase(const char* filename,
+                std::size_t shards,
+                obelisk::KnowledgeBase::Layout layout
+                = obelisk::KnowledgeBase::kLayoutRowid);
+
+            /**
+             * @brief Get the number of shards.
+             *
+             * @return std::size_t The number of shards.
+             */
+            std::size_t getShardCount();
+
+            /**
+             * @brief Get the shard a Fact about an Entity is stored in.
+             *
+             * @param[in] entityId The dictionary ID of the left Entity.
+             * @return std::size_t Returns the index of the shard.
+             */
+            std::size_t getShard(sqlite3_int64 entityId);
+
+            /**
+             * @brief Get one of the shards.
+             *
+             * @param[in] shard The index of the shard.
+             * @return obelisk::KnowledgeBase& The shard.
+             */
+            obelisk::KnowledgeBase& getShardKnowledgeBase(std::size_t shard);
+
+            /**
+             * @brief Look up an Entity in the dictionary.
+             *
+             * @param[in,out] entity The Entity, by its name. Its ID is set to
+             * the one in the dictionary, or 0 if it doesn't exist.
+             */
+            void getEntity(obelisk::Entity& entity);
+
+            /**
+             * @brief Set the way each shard evaluates queries.
+             *
+             * @param[in] evaluation The evaluation to use.
+             */
+            void setEvaluation(obelisk::KnowledgeBase::Evaluation evaluation);
+
+            /**
+             * @brief Set the way each shard combines the truth of rules.
+             *
+             * @param[in] combine The combine to use.
+             */
+            void setCombine(obelisk::KnowledgeBase::Combine combine);
+
+            /**
+             * @brief Get the number of threads used to propagate the shards.
+             *
+             * @return unsigned int The number of threads.
+             */
+            unsigned int getThreads();
+
+            /**
+             * @brief Set the number of threads used to propagate the shards.
+             *
+             * The threads are split between the shards, so each shard
+             * propagates its own rules with its share of them.
+             *
+             * @param[in] threads The number of threads.
+             */
+            void setThreads(unsigned int threads);
+
+            /**
+             * @brief Start a transaction in the dictionary and every shard.
+             *
+             */
+            void beginTransaction();
+
+            /**
+             * @brief Commit the transaction started last in the dictionary
+             * and every shard.
+             *
+             */
+            void commitTransaction();
+
+            /**
+             * @brief Undo the changes of the transaction started last in the
+             * dictionary and every shard.
+             *
+             */
+            void rollbackTransaction();
+
+            /**
+             * @brief Add facts to the shards of their left entities.
+             *
+             * The entities and verbs are added to the dictionary first if they
+             * don't exist yet. A Fact that is already stored is raised to the
+             * given truth.
+             *
+             * @param[in,out] facts The facts to add, the ID of each Fact is
+             * set to its ID in its shard.
+             */
+            void addFacts(std::vector<obelisk::Fact>& facts);
+
+            /**
+             * @brief Add rules to the shards of their facts.
+             *
+             * A reason that belongs to another shard is stored there and
+             * copied into the shard of the Rule, and propagate keeps the copy
+             * as true as the reason.
+             *
+             * @param[in,out] rules The rules to add. If the insert is
+             * successful it will have a row ID in its shard, if not the ID
+             * will be 0.
+             */
+            void addRules(std::vector<obelisk::Rule>& rules);
+
+            /**
+             * @brief Add pattern rules to the shards their reasons can match
+             * facts in.
+             *
+             * A PatternRule whose reason has a left Entity is added to the
+             * shard of that Entity, and one whose reason has a variable on the
+             * left is added to every shard. The facts it derives for the
+             * entities of other shards are moved there by propagate.
+             *
+             * @param[in,out] patternRules The pattern rules to add.
+             */
+            void addPatternRules(
+                std::vector<obelisk::PatternRule>& patternRules);
+
+            /**
+             * @brief Add suggested actions to the shards of their facts.
+             *
+             * @param[in,out] suggestActions The suggested actions to add.
+             */
+            void addSuggestActions(
+                std::vector<obelisk::SuggestAction>& suggestActions);
+
+            /**
+             * @brief Make a Verb transitive in the dictionary and every
+             * shard.
+             *
+             * The Verb is added to the dictionary if it doesn't exist yet and
+             * copied into the shards that don't have it. Each shard adds its
+             * true facts that use the Verb to its Closure, and they are copied
+             * into the dictionary, whose Closure follows the chains across
+             * the shards. A Fact of the Verb that isn't true yet is only
+             * raised by a chain that crosses shards if it was added after the
+             * Verb was made transitive.
+             *
+             * @param[in,out] verb The Verb, by its name. Its ID is set to the
+             * one in the dictionary.
+             */
+            void setTransitive(obelisk::Verb& verb);
+
+            /**
+             * @brief Propagate the rules of every shard and exchange the facts
+             * that cross shards.
+             *
+             * The shards don't share any rules, so they are propagated in
+             * parallel. The copies of the facts are then exchanged, and both
+             * steps are repeated until the exchange doesn't change any shard.
+             * Where pattern rules in several shards derive the same Fact, the
+             * most confident of their results is kept.
+             *
+             */
+            void propagate();
+
+            /**
+             * @brief Query the truth of a Fact in the shard of its left
+             * Entity.
+             *
+             * A Fact of a transitive Verb is also as true as the best chain
+             * in the Closure of the dictionary.
+             *
+             * @param[in,out] fact The Fact to query, by the names of its
+             * entities and Verb.
+             */
+            void queryFact(obelisk::Fact& fact);
+
+            /**
+             * @brief Query the truth of a Fact in the shard of its left Entity
+             * using the given evaluation.
+             *
+             * @param[in,out] fact The Fact to query, by the names of its
+             * entities and Verb.
+             * @param[in] evaluation The evaluation to use for this query.
+             */
+            void queryFact(obelisk::Fact& fact,
+                obelisk::KnowledgeBase::Evaluation evaluation);
+
+            /**
+             * @brief Query the Action suggested by a Fact in the shard of its
+             * left Entity.
+             *
+             * @param[in,out] fact The Fact to query, by the names of its
+             * entities and Verb.
+             * @param[out] action The suggested Action.
+             */
+            void querySuggestAction(obelisk::Fact& fact,
+                obelisk::Action& action);
+
+            /**
+             * @brief Get cursors over the true facts that match a pattern.
+             *
+             * If the left Entity of the pattern is given only its shard is
+             * searched, otherwise there is one cursor for every shard which
+             * skips the copies of the facts of other shards.
+             *
+             * @param[in] pattern The pattern to match. An Entity or Verb with
+             * an empty name matches everything.
+             * @return std::vector<std::unique_ptr<obelisk::FactCursor>>
+             * Returns the cursors, which must be destroyed before the
+             * ShardedKnowledgeBase.
+             */
+            std::vector<std::unique_ptr<obelisk::FactCursor>> queryPattern(
+                obelisk::Fact& pattern);
+    };
+} // namespace obelisk
+
+#endif
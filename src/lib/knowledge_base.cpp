@@ -1,35 +1,115 @@
 #include "knowledge_base.h"
 #include "models/error.h"
+#include "rule_graph.h"
+#include "thread_pool.h"
 
+#include <algorithm>
+#include <atomic>
 #include <cstring>
 #include <filesystem>
+#include <fstream>
 #include <iostream>
 #include <string>
+#include <thread>
 
-obelisk::KnowledgeBase::KnowledgeBase(const char* filename, int flags)
+obelisk::KnowledgeBase::KnowledgeBase(const char* filename,
+    int flags,
+    Layout layout,
+    Storage storage)
 {
-    filename_ = std::move(filename);
+    filename_ = std::string(filename);
     flags_    = std::move(flags);
+    storage_  = storage;
 
     std::filesystem::path path {filename};
     auto dbExists = std::filesystem::exists(path);
 
-    auto result = sqlite3_open_v2(filename, &dbConnection_, flags, NULL);
+    if (storage == kStorageImage && !dbExists)
+    {
+        throw obelisk::KnowledgeBaseException("database file doesn't exist");
+    }
+
+    auto result = sqlite3_open_v2(storage == kStorageFile ? filename
+                                                          : ":memory:",
+        &dbConnection_,
+        flags,
+        NULL);
     if (result != SQLITE_OK)
     {
-        throw new KnowledgeBaseException("database could not be opened");
+        // the handle is allocated even when opening fails
+        sqlite3_close_v2(dbConnection_);
+        dbConnection_ = nullptr;
+        throw obelisk::KnowledgeBaseException("database could not be opened");
+    }
+
+    if (storage != kStorageFile && dbExists)
+    {
+        try
+        {
+            deserialize();
+        }
+        catch (obelisk::KnowledgeBaseException& exception)
+        {
+            sqlite3_close_v2(dbConnection_);
+            throw;
+        }
     }
 
     enableForeignKeys();
 
     if (!dbExists)
     {
+        layout_ = layout;
         createTable(obelisk::Action::createTable);
         createTable(obelisk::Entity::createTable);
         createTable(obelisk::Verb::createTable);
-        createTable(obelisk::Fact::createTable);
-        createTable(obelisk::Rule::createTable);
+        createTable(obelisk::Closure::createTable);
+        if (layout == kLayoutClustered)
+        {
+            createTable(obelisk::Fact::createClusteredTable);
+        }
+        else
+        {
+            createTable(obelisk::Fact::createTable);
+        }
+        createTable(obelisk::Fact::createIndexes);
+        createTable(obelisk::Statistic::createTable);
+        if (layout == kLayoutClustered)
+        {
+            createTable(obelisk::Rule::createClusteredTable);
+        }
+        else
+        {
+            createTable(obelisk::Rule::createTable);
+        }
+        createTable(obelisk::PatternRule::createTable);
         createTable(obelisk::SuggestAction::createTable);
+        createTable(obelisk::ChangeLog::createTable);
+        setSchemaVersion();
+    }
+    else
+    {
+        try
+        {
+            upgradeTables();
+        }
+        catch (obelisk::KnowledgeBaseException& exception)
+        {
+            sqlite3_close_v2(dbConnection_);
+            dbConnection_ = nullptr;
+            throw obelisk::KnowledgeBaseException(
+                std::string("database could not be upgraded: ")
+                + exception.what());
+        }
+
+        // an existing file keeps the layout it was created with
+        if (hasRow(
+                "SELECT 1 FROM sqlite_master WHERE (type='table' AND name=? AND sql LIKE '%WITHOUT ROWID%')",
+                "fact",
+                nullptr))
+        {
+            layout_ = kLayoutClustered;
+        }
     }
 }
 
@@ -41,6 +121,176 @@ obelisk::KnowledgeBase::~KnowledgeBase()
     }
 }
 
+void obelisk::KnowledgeBase::deserialize()
+{
+    std::ifstream file(filename_, std::ios::binary | std::ios::ate);
+    if (!file)
+    {
+        throw obelisk::KnowledgeBaseException("database could not be read");
+    }
+
+    sqlite3_int64 size = file.tellg();
+    file.seekg(0);
+
+    // sqlite takes ownership of the image, so it has to come from its
+    // allocator
+    auto image = static_cast<unsigned char*>(sqlite3_malloc64(size));
+    if (image == nullptr && size > 0)
+    {
+        throw obelisk::KnowledgeBaseException("out of memory");
+    }
+
+    if (!file.read(reinterpret_cast<char*>(image), size))
+    {
+        sqlite3_free(image);
+        throw obelisk::KnowledgeBaseException("database could not be read");
+    }
+
+    // the image is freed by sqlite even if this fails
+    auto result = sqlite3_deserialize(dbConnection_,
+        "main",
+        image,
+        size,
+        size,
+        SQLITE_DESERIALIZE_FREEONCLOSE | SQLITE_DESERIALIZE_RESIZEABLE);
+    if (result != SQLITE_OK)
+    {
+        throw obelisk::KnowledgeBaseException(sqlite3_errmsg(dbConnection_));
+    }
+}
+
+void obelisk::KnowledgeBase::save()
+{
+    if (storage_ != kStorageMemory)
+    {
+        return;
+    }
+
+    sqlite3_int64 size = 0;
+    auto image         = sqlite3_serialize(dbConnection_, "main", &size, 0);
+    if (image == nullptr)
+    {
+        throw obelisk::KnowledgeBaseException(
+            "database could not be serialized");
+    }
+
+    auto temporary = filename_ + ".tmp";
+    std::ofstream file(temporary, std::ios::binary | std::ios::trunc);
+    file.write(reinterpret_cast<char*>(image), size);
+    file.close();
+    sqlite3_free(image);
+    std::error_code error;
+    if (!file)
+    {
+        std::filesystem::remove(temporary, error);
+        throw obelisk::KnowledgeBaseException("database could not be written");
+    }
+
+    std::filesystem::rename(temporary, filename_, error);
+    if (error)
+    {
+        std::filesystem::remove(temporary, error);
+        throw obelisk::KnowledgeBaseException("database could not be written");
+    }
+}
+
+void obelisk::KnowledgeBase::beginTransaction()
+{
+    // a savepoint starts a transaction if none is open, or nests in it
+    execute("SAVEPOINT obelisk;");
+}
+
+void obelisk::KnowledgeBase::commitTransaction()
+{
+    execute("RELEASE SAVEPOINT obelisk;");
+}
+
+void obelisk::KnowledgeBase::rollbackTransaction()
+{
+    execute("ROLLBACK TO SAVEPOINT obelisk; RELEASE SAVEPOINT obelisk;");
+}
+
+std::unique_ptr<obelisk::Backup> obelisk::KnowledgeBase::startBackup(
+    const std::string& filename)
+{
+    return std::make_unique<obelisk::Backup>(dbConnection_, filename);
+}
+
+std::size_t obelisk::KnowledgeBase::backup(const std::string& filename,
+    int pages)
+{
+    auto replica = startBackup(filename);
+    while (!replica->step(pages))
+    {
+        if (replica->getBusy())
+        {
+            // another connection is writing, give it time to finish
+            sqlite3_sleep(10);
+        }
+    }
+
+    return replica->finish();
+}
+
+sqlite3_int64 obelisk::KnowledgeBase::getChangeId()
+{
+    return obelisk::ChangeLog::selectLast(dbConnection_);
+}
+
+bool obelisk::KnowledgeBase::getChangeLog()
+{
+    return hasRow(
+        "SELECT 1 FROM sqlite_master WHERE (type='trigger' AND name=?)",
+        "fact_change_log_insert",
+        nullptr);
+}
+
+void obelisk::KnowledgeBase::setChangeLog(bool enabled)
+{
+    if (enabled)
+    {
+        createTable(obelisk::ChangeLog::createTriggers);
+    }
+    else
+    {
+        createTable(obelisk::ChangeLog::dropTriggers);
+    }
+}
+
+void obelisk::KnowledgeBase::getChanges(sqlite3_int64 after,
+    sqlite3_int64 last,
+    std::vector<obelisk::ChangeLog::Change>& changes)
+{
+    obelisk::ChangeLog::selectRange(dbConnection_, after, last, changes);
+}
+
+void obelisk::KnowledgeBase::truncateChanges(sqlite3_int64 upTo)
+{
+    obelisk::ChangeLog::deleteUpTo(dbConnection_, upTo);
+}
+
+std::size_t obelisk::KnowledgeBase::applyChanges(
+    const std::vector<obelisk::ChangeLog::Change>& changes)
+{
+    clearTable();
+    beginTransaction();
+    try
+    {
+        for (auto& change : changes)
+        {
+            obelisk::ChangeLog::apply(dbConnection_, change);
+        }
+    }
+    catch (obelisk::DatabaseException& exception)
+    {
+        rollbackTransaction();
+        throw;
+    }
+    commitTransaction();
+
+    return changes.size();
+}
+
 void obelisk::KnowledgeBase::enableForeignKeys()
 {
     char* errmsg;
@@ -62,10 +312,160 @@ void obelisk::KnowledgeBase::enableForeignKeys()
     }
 }
 
+void obelisk::KnowledgeBase::upgradeTables()
+{
+    if (getSchemaVersion() >= kSchemaVersion)
+    {
+        return;
+    }
+
+    execute("BEGIN TRANSACTION;");
+    try
+    {
+        if (!hasColumn("verb", "transitive"))
+        {
+            execute(
+                "ALTER TABLE verb ADD COLUMN transitive INTEGER NOT NULL DEFAULT 0;");
+        }
+        if (!hasColumn("rule", "weight"))
+        {
+            execute(
+                "ALTER TABLE rule ADD COLUMN weight REAL NOT NULL DEFAULT 1 CHECK(weight >= 0 AND weight <= 1);");
+        }
+        createTable(obelisk::Fact::createIndexes);
+        if (!hasTable("closure"))
+        {
+            createTable(obelisk::Closure::createTable);
+        }
+        else if (!hasColumn("closure", "is_true"))
+        {
+            // the chains were all taken as certain, and the trigger that logs
+            // them is replaced by one that logs their confidence
+            execute(
+                "ALTER TABLE closure ADD COLUMN is_true REAL NOT NULL DEFAULT 1 CHECK(is_true >= 0 AND is_true <= 1);");
+            execute("DROP TRIGGER IF EXISTS closure_change_log_insert;");
+        }
+        if (!hasTable("verb_statistic"))
+        {
+            createTable(obelisk::Statistic::createTable);
+            createTable(obelisk::Statistic::fillTable);
+        }
+        if (!hasTable("pattern_rule"))
+        {
+            createTable(obelisk::PatternRule::createTable);
+        }
+        auto changeLog = getChangeLog();
+        if (hasTable("change_log") && !hasColumn("change_log", "table_name"))
+        {
+            // the log used to hold SQL, which isn't replayed any more. The
+            // IDs keep counting from the last one, so a replica that applied
+            // every change is still up to date
+            auto last = getChangeId();
+            createTable(obelisk::ChangeLog::dropTriggers);
+            execute("DROP TABLE change_log;");
+            createTable(obelisk::ChangeLog::createTable);
+            execute(("INSERT INTO sqlite_sequence (name, seq) VALUES ('change_log', "
+                     + std::to_string(last) + ");")
+                        .c_str());
+        }
+        createTable(obelisk::ChangeLog::createTable);
+        if (changeLog)
+        {
+            // the log was enabled, add the triggers for the newer tables
+            createTable(obelisk::ChangeLog::createTriggers);
+        }
+        setSchemaVersion();
+    }
+    catch (obelisk::KnowledgeBaseException& exception)
+    {
+        execute("ROLLBACK TRANSACTION;");
+        throw;
+    }
+    execute("COMMIT TRANSACTION;");
+}
+
+int obelisk::KnowledgeBase::getSchemaVersion()
+{
+    sqlite3_stmt* ppStmt = nullptr;
+
+    auto result = sqlite3_prepare_v2(dbConnection_,
+        "PRAGMA user_version;",
+        -1,
+        &ppStmt,
+        nullptr);
+    if (result != SQLITE_OK)
+    {
+        throw obelisk::KnowledgeBaseException(sqlite3_errmsg(dbConnection_));
+    }
+
+    int version = 0;
+    if (sqlite3_step(ppStmt) == SQLITE_ROW)
+    {
+        version = sqlite3_column_int(ppStmt, 0);
+    }
+    sqlite3_finalize(ppStmt);
+
+    return version;
+}
+
+void obelisk::KnowledgeBase::setSchemaVersion()
+{
+    execute(("PRAGMA user_version = " + std::to_string(kSchemaVersion) + ";")
+                .c_str());
+}
+
+bool obelisk::KnowledgeBase::hasTable(const char* table)
+{
+    return hasRow("SELECT 1 FROM sqlite_master WHERE (type='table' AND name=?)",
+        table,
+        nullptr);
+}
+
+bool obelisk::KnowledgeBase::hasColumn(const char* table, const char* column)
+{
+    return hasRow("SELECT 1 FROM pragma_table_info(?) WHERE (name=?)",
+        table,
+        column);
+}
+
+bool obelisk::KnowledgeBase::hasRow(const char* query,
+    const char* first,
+    const char* second)
+{
+    sqlite3_stmt* ppStmt = nullptr;
+
+    auto result
+        = sqlite3_prepare_v2(dbConnection_, query, -1, &ppStmt, nullptr);
+    if (result != SQLITE_OK)
+    {
+        throw obelisk::KnowledgeBaseException(sqlite3_errmsg(dbConnection_));
+    }
+
+    sqlite3_bind_text(ppStmt, 1, first, -1, SQLITE_STATIC);
+    if (second != nullptr)
+    {
+        sqlite3_bind_text(ppStmt, 2, second, -1, SQLITE_STATIC);
+    }
+
+    result = sqlite3_step(ppStmt);
+    sqlite3_finalize(ppStmt);
+    if (result != SQLITE_ROW && result != SQLITE_DONE)
+    {
+        throw obelisk::KnowledgeBaseException(sqlite3_errmsg(dbConnection_));
+    }
+
+    return result == SQLITE_ROW;
+}
+
 void obelisk::KnowledgeBase::createTable(std::function<const char*()> function)
+{
+    execute(function());
+}
+
+void obelisk::KnowledgeBase::execute(const char* query)
 {
     char* errmsg;
-    int result = sqlite3_exec(dbConnection_, function(), NULL, NULL, &errmsg);
+    int result = sqlite3_exec(dbConnection_, query, NULL, NULL, &errmsg);
     if (result != SQLITE_OK)
     {
         if (errmsg)
@@ -144,11 +544,13 @@ void obelisk::KnowledgeBase::addActions(std::vector<obelisk::Action>& actions)
 
 void obelisk::KnowledgeBase::addFacts(std::vector<obelisk::Fact>& facts)
 {
+    clearTable();
     for (auto& fact : facts)
     {
         try
         {
-            fact.insert(dbConnection_);
+            fact.insert(dbConnection_, getLayout() == kLayoutClustered);
+            insertClosure(fact);
         }
         catch (obelisk::DatabaseConstraintException& exception)
         {
@@ -187,17 +589,45 @@ void obelisk::KnowledgeBase::addSuggestActions(
 
 void obelisk::KnowledgeBase::addRules(std::vector<obelisk::Rule>& rules)
 {
+    clearTable();
     for (auto& rule : rules)
     {
         try
         {
-            rule.insert(dbConnection_);
+            rule.insert(dbConnection_, getLayout() == kLayoutClustered);
         }
         catch (obelisk::DatabaseConstraintException& exception)
         {
-            // ignore unique constraint error
+            // ignore unique constraint error, the clustered layout reports
+            // its primary key instead
             if (std::strcmp(exception.what(),
                     "UNIQUE constraint failed: rule.fact, rule.reason")
+                    != 0
+                && std::strcmp(exception.what(),
+                       "UNIQUE constraint failed: rule.reason, rule.fact")
+                       != 0)
+            {
+                throw;
+            }
+        }
+    }
+}
+
+void obelisk::KnowledgeBase::addPatternRules(
+    std::vector<obelisk::PatternRule>& patternRules)
+{
+    clearTable();
+    for (auto& patternRule : patternRules)
+    {
+        try
+        {
+            patternRule.insert(dbConnection_);
+        }
+        catch (obelisk::DatabaseConstraintException& exception)
+        {
+            // ignore unique constraint error
+            if (std::strcmp(exception.what(),
+                    "UNIQUE constraint failed: index 'pattern_rule_unique'")
                 != 0)
             {
                 throw;
@@ -237,38 +667,1019 @@ void obelisk::KnowledgeBase::getRule(obelisk::Rule& rule)
     rule.selectById(dbConnection_);
 }
 
-void obelisk::KnowledgeBase::checkRule(obelisk::Fact& fact)
+void obelisk::KnowledgeBase::getPatternRule(
+    obelisk::PatternRule& patternRule)
 {
-    std::vector<obelisk::Rule> rules;
-    obelisk::Rule::selectByReason(dbConnection_, fact.getId(), rules);
-    for (auto& rule : rules)
+    patternRule.selectById(dbConnection_);
+}
+
+void obelisk::KnowledgeBase::applyPatternRule(
+    obelisk::PatternRule& patternRule)
+{
+    if (getEvaluation() == kEvaluationBackward)
     {
-        auto reason = rule.getReason();
-        getFact(reason);
-        if (reason.getIsTrue() > 0)
+        // derived facts are resolved when they are queried instead
+        return;
+    }
+
+    auto& reason = patternRule.getReason();
+    std::vector<obelisk::Fact> facts;
+    obelisk::Fact::selectByVerb(dbConnection_,
+        reason.getVerb().getId(),
+        patternRule.getReasonLeftVariable() == ""
+            ? reason.getLeftEntity().getId()
+            : 0,
+        patternRule.getReasonRightVariable() == ""
+            ? reason.getRightEntity().getId()
+            : 0,
+        facts);
+
+    for (auto& fact : facts)
+    {
+        obelisk::Fact derivedFact;
+        if (fact.getIsTrue() > 0
+            && derivePatternRule(patternRule, fact, derivedFact))
         {
-            auto updateFact = rule.getFact();
-            updateFact.setIsTrue(1.0);
-            updateFact.updateIsTrue(dbConnection_);
-            checkRule(updateFact);
+            checkRule(derivedFact);
         }
     }
 }
 
-void obelisk::KnowledgeBase::updateIsTrue(obelisk::Fact& fact)
+bool obelisk::KnowledgeBase::bindEntity(const std::string& variable,
+    sqlite3_int64 patternEntityId,
+    sqlite3_int64 entityId,
+    std::unordered_map<std::string, sqlite3_int64>& bindings)
 {
-    fact.updateIsTrue(dbConnection_);
+    if (variable == "")
+    {
+        return patternEntityId == entityId;
+    }
+
+    auto binding = bindings.find(variable);
+    if (binding != bindings.end())
+    {
+        return binding->second == entityId;
+    }
+
+    bindings[variable] = entityId;
+    return true;
 }
 
-void obelisk::KnowledgeBase::queryFact(obelisk::Fact& fact)
+bool obelisk::KnowledgeBase::deriveFact(obelisk::Fact& fact, double isTrue)
 {
-    fact.selectByName(dbConnection_);
+    if (isTrue <= 0)
+    {
+        return false;
+    }
+
+    // look the fact up by its entities and verb
+    fact.setId(0);
+    getFact(fact);
+    if (fact.getId() == 0)
+    {
+        fact.setIsTrue(isTrue);
+        std::vector<obelisk::Fact> facts {fact};
+        addFacts(facts);
+        fact = std::move(facts.front());
+        return true;
+    }
+
+    if (isTrue <= fact.getIsTrue() + kEpsilon)
+    {
+        // already as true, so the rules that depend on it have been checked
+        return false;
+    }
+
+    fact.setIsTrue(isTrue);
+    updateIsTrue(fact);
+    return true;
 }
 
-void obelisk::KnowledgeBase::querySuggestAction(obelisk::Fact& fact,
-    obelisk::Action& action)
+bool obelisk::KnowledgeBase::bindPatternRule(
+    obelisk::PatternRule& patternRule,
+    obelisk::Fact& reason,
+    obelisk::Fact& fact)
 {
-    fact.selectActionByFact(dbConnection_, action);
+    std::unordered_map<std::string, sqlite3_int64> bindings;
+    if (!bindEntity(patternRule.getReasonLeftVariable(),
+            patternRule.getReason().getLeftEntity().getId(),
+            reason.getLeftEntity().getId(),
+            bindings)
+        || !bindEntity(patternRule.getReasonRightVariable(),
+            patternRule.getReason().getRightEntity().getId(),
+            reason.getRightEntity().getId(),
+            bindings))
+    {
+        return false;
+    }
+
+    auto& leftVariable  = patternRule.getFactLeftVariable();
+    auto& rightVariable = patternRule.getFactRightVariable();
+    fact = obelisk::Fact(
+        obelisk::Entity(leftVariable == ""
+                ? patternRule.getFact().getLeftEntity().getId()
+                : bindings[leftVariable]),
+        obelisk::Entity(rightVariable == ""
+                ? patternRule.getFact().getRightEntity().getId()
+                : bindings[rightVariable]),
+        obelisk::Verb(patternRule.getFact().getVerb().getId()));
+    return true;
+}
+
+bool obelisk::KnowledgeBase::derivePatternRule(
+    obelisk::PatternRule& patternRule,
+    obelisk::Fact& reason,
+    obelisk::Fact& fact)
+{
+    return bindPatternRule(patternRule, reason, fact)
+        && deriveFact(fact,
+            combine(patternRule.getWeight(), reason.getIsTrue()));
+}
+
+void obelisk::KnowledgeBase::setTransitive(obelisk::Verb& verb)
+{
+    clearTable();
+    verb.setTransitive(true);
+    verb.updateTransitive(dbConnection_);
+
+    std::vector<obelisk::Fact> facts;
+    obelisk::Fact::selectByVerb(dbConnection_, verb.getId(), 0, 0, facts);
+    for (auto& fact : facts)
+    {
+        insertClosure(fact);
+    }
+}
+
+void obelisk::KnowledgeBase::insertClosure(obelisk::Fact& fact)
+{
+    if (fact.getIsTrue() > 0)
+    {
+        obelisk::Closure::insertFact(dbConnection_,
+            fact,
+            getCombine() == kCombineMinimum);
+    }
+}
+
+void obelisk::KnowledgeBase::rebuildClosure(sqlite3_int64 verbId)
+{
+    // a verb that isn't transitive has no chains to delete
+    if (obelisk::Closure::deleteByVerb(dbConnection_, verbId) == 0)
+    {
+        return;
+    }
+
+    std::vector<obelisk::Fact> facts;
+    obelisk::Fact::selectByVerb(dbConnection_, verbId, 0, 0, facts);
+    for (auto& fact : facts)
+    {
+        insertClosure(fact);
+    }
+}
+
+void obelisk::KnowledgeBase::checkRule(obelisk::Fact& fact)
+{
+    if (getEvaluation() == kEvaluationBackward)
+    {
+        // derived facts are resolved when they are queried instead
+        return;
+    }
+
+    clearTable();
+    std::vector<obelisk::Rule> rules;
+    obelisk::Rule::selectByReason(dbConnection_, fact.getId(), rules);
+    for (auto& rule : rules)
+    {
+        auto updateFact = rule.getFact();
+        getFact(updateFact);
+        if (deriveFact(updateFact, combineRules(updateFact)))
+        {
+            checkRule(updateFact);
+        }
+    }
+
+    if (fact.getIsTrue() > 0)
+    {
+        std::vector<obelisk::PatternRule> patternRules;
+        obelisk::PatternRule::selectByReasonVerb(dbConnection_,
+            fact.getVerb().getId(),
+            patternRules);
+        for (auto& patternRule : patternRules)
+        {
+            obelisk::Fact derivedFact;
+            if (derivePatternRule(patternRule, fact, derivedFact))
+            {
+                checkRule(derivedFact);
+            }
+        }
+    }
+}
+
+double obelisk::KnowledgeBase::combine(double weight, double isTrue)
+{
+    switch (getCombine())
+    {
+        case kCombineMinimum :
+            return std::min(weight, isTrue);
+        case kCombineProduct :
+        case kCombineNoisyOr :
+        default :
+            return weight * isTrue;
+    }
+}
+
+double obelisk::KnowledgeBase::aggregate(double isTrue, double ruleIsTrue)
+{
+    switch (getCombine())
+    {
+        case kCombineNoisyOr :
+            return 1.0 - (1.0 - isTrue) * (1.0 - ruleIsTrue);
+        case kCombineMinimum :
+        case kCombineProduct :
+        default :
+            return std::max(isTrue, ruleIsTrue);
+    }
+}
+
+double obelisk::KnowledgeBase::combineRules(obelisk::Fact& fact)
+{
+    double isTrue = 0;
+    std::vector<obelisk::Rule> rules;
+    obelisk::Rule::selectByFact(dbConnection_, fact.getId(), rules);
+    for (auto& rule : rules)
+    {
+        auto reason = rule.getReason();
+        getFact(reason);
+        if (reason.getIsTrue() > 0)
+        {
+            isTrue = aggregate(isTrue,
+                combine(rule.getWeight(), reason.getIsTrue()));
+        }
+    }
+
+    return isTrue;
+}
+
+void obelisk::KnowledgeBase::propagate()
+{
+    propagationStatistics_ = PropagationStatistics();
+    if (getEvaluation() == kEvaluationBackward)
+    {
+        // derived facts are resolved when they are queried instead
+        return;
+    }
+
+    clearTable();
+
+    // facts derived by pattern rules can be reasons of other rules and of
+    // other pattern rules, and derived facts of a transitive verb extend its
+    // chains, so keep going until a whole round of them changes nothing
+    bool changed {true};
+    while (changed)
+    {
+        changed = propagateClosure();
+        changed = propagateRules() || changed;
+        changed = propagatePatternRules() || changed;
+    }
+}
+
+const obelisk::KnowledgeBase::PropagationStatistics&
+    obelisk::KnowledgeBase::getPropagationStatistics()
+{
+    return propagationStatistics_;
+}
+
+bool obelisk::KnowledgeBase::propagateClosure()
+{
+    auto updated = obelisk::Closure::updateFacts(dbConnection_);
+    if (updated > 0)
+    {
+        propagationStatistics_.derivedFacts += updated;
+        clearTable();
+    }
+
+    return updated > 0;
+}
+
+bool obelisk::KnowledgeBase::propagateRules()
+{
+    std::vector<obelisk::Rule> rules;
+    obelisk::Rule::selectAll(dbConnection_, rules);
+    if (rules.empty())
+    {
+        return false;
+    }
+    propagationStatistics_.rulePasses++;
+
+    // give every fact used by a rule a dense index so the rules can be swept
+    // over flat arrays
+    std::unordered_map<sqlite3_int64, std::size_t> index;
+    std::vector<obelisk::Fact> facts;
+    auto indexOf = [&index, &facts](obelisk::Fact& fact)
+    {
+        auto inserted = index.emplace(fact.getId(), facts.size());
+        if (inserted.second)
+        {
+            facts.push_back(fact);
+        }
+        return inserted.first->second;
+    };
+
+    std::vector<std::size_t> ruleFacts;
+    std::vector<std::size_t> ruleReasons;
+    std::vector<double> ruleWeights;
+    ruleFacts.reserve(rules.size());
+    ruleReasons.reserve(rules.size());
+    ruleWeights.reserve(rules.size());
+    for (auto& rule : rules)
+    {
+        ruleFacts.push_back(indexOf(rule.getFact()));
+        ruleReasons.push_back(indexOf(rule.getReason()));
+        ruleWeights.push_back(rule.getWeight());
+    }
+
+    std::vector<double> stored(facts.size());
+    for (std::size_t i = 0; i < facts.size(); i++)
+    {
+        stored[i] = facts[i].getIsTrue();
+    }
+
+    // visit the components with the reasons first, so every reason outside
+    // of a component is final by the time the component is reached
+    obelisk::RuleGraph ruleGraph(facts.size(), ruleFacts, ruleReasons);
+    std::vector<double> isTrue(stored);
+    std::vector<double> derived(facts.size());
+    std::atomic<std::size_t> componentSweeps {0};
+    auto propagateComponent = [&](std::size_t c)
+    {
+        auto& component      = ruleGraph.getComponent(c);
+        auto& componentRules = ruleGraph.getComponentRules(c);
+
+        std::size_t sweeps = 0;
+        bool changed {true};
+        while (changed)
+        {
+            sweeps++;
+            for (const auto& fact : component)
+            {
+                derived[fact] = 0;
+            }
+
+            for (const auto& rule : componentRules)
+            {
+                double reasonIsTrue = isTrue[ruleReasons[rule]];
+                if (reasonIsTrue > 0)
+                {
+                    derived[ruleFacts[rule]]
+                        = aggregate(derived[ruleFacts[rule]],
+                            combine(ruleWeights[rule], reasonIsTrue));
+                }
+            }
+
+            changed = false;
+            for (const auto& fact : component)
+            {
+                if (derived[fact] > isTrue[fact] + kEpsilon)
+                {
+                    isTrue[fact] = derived[fact];
+                    changed      = true;
+                }
+            }
+
+            // without a cycle nothing in the component can change again
+            changed = changed && ruleGraph.isCyclic(c);
+        }
+        componentSweeps += sweeps;
+    };
+
+    // the partitions don't share any facts, so each one can be propagated on
+    // its own thread without locking
+    auto partitions = ruleGraph.getPartitionCount();
+    if (getThreads() > 1 && partitions > 1)
+    {
+        obelisk::ThreadPool threadPool(
+            std::min<std::size_t>(getThreads(), partitions));
+        for (std::size_t p = 0; p < partitions; p++)
+        {
+            threadPool.submit([&ruleGraph, &propagateComponent, p]
+                {
+                    for (const auto& c : ruleGraph.getPartition(p))
+                    {
+                        propagateComponent(c);
+                    }
+                });
+        }
+        threadPool.wait();
+    }
+    else
+    {
+        for (std::size_t p = 0; p < partitions; p++)
+        {
+            for (const auto& c : ruleGraph.getPartition(p))
+            {
+                propagateComponent(c);
+            }
+        }
+    }
+
+    bool updated {false};
+    beginTransaction();
+    try
+    {
+        for (std::size_t i = 0; i < facts.size(); i++)
+        {
+            if (isTrue[i] > stored[i] + kEpsilon)
+            {
+                facts[i].setIsTrue(isTrue[i]);
+                facts[i].updateIsTrue(dbConnection_);
+                insertClosure(facts[i]);
+                propagationStatistics_.derivedFacts++;
+                updated = true;
+            }
+        }
+    }
+    catch (obelisk::DatabaseException& exception)
+    {
+        rollbackTransaction();
+        throw;
+    }
+    commitTransaction();
+    propagationStatistics_.componentSweeps += componentSweeps;
+
+    if (updated)
+    {
+        clearTable();
+    }
+
+    return updated;
+}
+
+bool obelisk::KnowledgeBase::propagatePatternRules()
+{
+    std::vector<obelisk::PatternRule> patternRules;
+    obelisk::PatternRule::selectAll(dbConnection_, patternRules);
+    if (!patternRules.empty())
+    {
+        propagationStatistics_.patternRulePasses++;
+    }
+
+    // the confidences every pattern rule gives a Fact are aggregated like
+    // the ones given by the rules before the Fact is raised
+    std::map<Goal, double> derived;
+    for (auto& patternRule : patternRules)
+    {
+        auto& reason = patternRule.getReason();
+        std::vector<obelisk::Fact> facts;
+        obelisk::Fact::selectByVerb(dbConnection_,
+            reason.getVerb().getId(),
+            patternRule.getReasonLeftVariable() == ""
+                ? reason.getLeftEntity().getId()
+                : 0,
+            patternRule.getReasonRightVariable() == ""
+                ? reason.getRightEntity().getId()
+                : 0,
+            facts);
+
+        for (auto& fact : facts)
+        {
+            obelisk::Fact derivedFact;
+            if (fact.getIsTrue() > 0
+                && bindPatternRule(patternRule, fact, derivedFact))
+            {
+                auto& isTrue = derived[Goal {
+                    derivedFact.getLeftEntity().getId(),
+                    derivedFact.getVerb().getId(),
+                    derivedFact.getRightEntity().getId()}];
+                isTrue = aggregate(isTrue,
+                    combine(patternRule.getWeight(), fact.getIsTrue()));
+            }
+        }
+    }
+
+    bool updated {false};
+    beginTransaction();
+    try
+    {
+        for (auto& goal : derived)
+        {
+            obelisk::Fact fact(obelisk::Entity(std::get<0>(goal.first)),
+                obelisk::Entity(std::get<2>(goal.first)),
+                obelisk::Verb(std::get<1>(goal.first)));
+            if (deriveFact(fact, goal.second))
+            {
+                propagationStatistics_.derivedPatternFacts++;
+                updated = true;
+            }
+        }
+    }
+    catch (obelisk::DatabaseException& exception)
+    {
+        rollbackTransaction();
+        throw;
+    }
+    commitTransaction();
+
+    return updated;
+}
+
+void obelisk::KnowledgeBase::updateIsTrue(obelisk::Fact& fact)
+{
+    clearTable();
+
+    // the stored truth tells if the chains through the fact have to shrink
+    obelisk::Fact stored;
+    stored.setId(fact.getId());
+    stored.selectById(dbConnection_);
+
+    fact.updateIsTrue(dbConnection_);
+    if (fact.getIsTrue() + kEpsilon < stored.getIsTrue())
+    {
+        rebuildClosure(stored.getVerb().getId());
+    }
+    else
+    {
+        insertClosure(fact);
+    }
+}
+
+obelisk::KnowledgeBase::Evaluation obelisk::KnowledgeBase::getEvaluation()
+{
+    return evaluation_;
+}
+
+void obelisk::KnowledgeBase::setEvaluation(Evaluation evaluation)
+{
+    evaluation_ = evaluation;
+}
+
+obelisk::KnowledgeBase::Layout obelisk::KnowledgeBase::getLayout()
+{
+    return layout_;
+}
+
+obelisk::KnowledgeBase::Combine obelisk::KnowledgeBase::getCombine()
+{
+    return combine_;
+}
+
+void obelisk::KnowledgeBase::setCombine(Combine combine)
+{
+    clearTable();
+    combine_ = combine;
+}
+
+unsigned int obelisk::KnowledgeBase::getThreads()
+{
+    return threads_;
+}
+
+void obelisk::KnowledgeBase::setThreads(unsigned int threads)
+{
+    threads_ = threads;
+}
+
+bool obelisk::KnowledgeBase::getProfiling()
+{
+    return profiler_ != nullptr;
+}
+
+void obelisk::KnowledgeBase::setProfiling(bool profiling)
+{
+    if (profiling && !profiler_)
+    {
+        profiler_ = std::unique_ptr<obelisk::Profiler> {
+            new obelisk::Profiler()};
+        profiler_->attach(dbConnection_);
+    }
+    else if (!profiling && profiler_)
+    {
+        profiler_->detach(dbConnection_);
+        profiler_.reset();
+    }
+}
+
+std::vector<obelisk::StatementProfile> obelisk::KnowledgeBase::getProfile()
+{
+    if (!profiler_)
+    {
+        return {};
+    }
+
+    return profiler_->getProfile();
+}
+
+void obelisk::KnowledgeBase::clearTable()
+{
+    table_.clear();
+    outgoing_.clear();
+    incoming_.clear();
+}
+
+void obelisk::KnowledgeBase::getStatistics(obelisk::Verb& verb,
+    long long& trueFacts,
+    long long& falseFacts)
+{
+    if (verb.getId() == 0)
+    {
+        getVerb(verb);
+    }
+    obelisk::Statistic::selectByVerb(dbConnection_,
+        verb.getId(),
+        trueFacts,
+        falseFacts);
+}
+
+void obelisk::KnowledgeBase::getStatistics(obelisk::Entity& entity,
+    long long& trueFacts,
+    long long& falseFacts)
+{
+    if (entity.getId() == 0)
+    {
+        getEntity(entity);
+    }
+    obelisk::Statistic::selectByEntity(dbConnection_,
+        entity.getId(),
+        trueFacts,
+        falseFacts);
+}
+
+bool obelisk::KnowledgeBase::getAdjacencyCache()
+{
+    return adjacencyCache_;
+}
+
+void obelisk::KnowledgeBase::setAdjacencyCache(bool adjacencyCache)
+{
+    clearTable();
+    adjacencyCache_ = adjacencyCache;
+}
+
+void obelisk::KnowledgeBase::getOutgoing(sqlite3_int64 entityId,
+    std::vector<obelisk::Fact>& facts)
+{
+    if (!adjacencyCache_)
+    {
+        obelisk::Fact::selectByEntity(dbConnection_, entityId, 0, facts);
+        return;
+    }
+
+    auto cached = outgoing_.find(entityId);
+    if (cached == outgoing_.end())
+    {
+        std::vector<obelisk::Fact> edges;
+        obelisk::Fact::selectByEntity(dbConnection_, entityId, 0, edges);
+        cached = outgoing_.emplace(entityId, std::move(edges)).first;
+    }
+    facts.insert(facts.end(), cached->second.begin(), cached->second.end());
+}
+
+void obelisk::KnowledgeBase::getIncoming(sqlite3_int64 entityId,
+    std::vector<obelisk::Fact>& facts)
+{
+    if (!adjacencyCache_)
+    {
+        obelisk::Fact::selectByEntity(dbConnection_, 0, entityId, facts);
+        return;
+    }
+
+    auto cached = incoming_.find(entityId);
+    if (cached == incoming_.end())
+    {
+        std::vector<obelisk::Fact> edges;
+        obelisk::Fact::selectByEntity(dbConnection_, 0, entityId, edges);
+        cached = incoming_.emplace(entityId, std::move(edges)).first;
+    }
+    facts.insert(facts.end(), cached->second.begin(), cached->second.end());
+}
+
+bool obelisk::KnowledgeBase::findPath(sqlite3_int64 fromEntityId,
+    sqlite3_int64 toEntityId,
+    std::size_t maxDepth,
+    std::vector<obelisk::Fact>& path)
+{
+    path.clear();
+    if (fromEntityId == toEntityId)
+    {
+        return true;
+    }
+
+    // the fact each entity was reached by and its distance from the start or
+    // the end, a default fact marks the start and the end themselves
+    std::unordered_map<sqlite3_int64, obelisk::Fact> forwardFacts {
+        {fromEntityId, obelisk::Fact()}
+    };
+    std::unordered_map<sqlite3_int64, obelisk::Fact> backwardFacts {
+        {toEntityId, obelisk::Fact()}
+    };
+    std::unordered_map<sqlite3_int64, std::size_t> forwardDepths {
+        {fromEntityId, 0}
+    };
+    std::unordered_map<sqlite3_int64, std::size_t> backwardDepths {
+        {toEntityId, 0}
+    };
+    std::vector<sqlite3_int64> forwardFrontier {fromEntityId};
+    std::vector<sqlite3_int64> backwardFrontier {toEntityId};
+
+    sqlite3_int64 meeting {0};
+    for (std::size_t depth = 0; depth < maxDepth && meeting == 0; depth++)
+    {
+        if (forwardFrontier.empty() || backwardFrontier.empty())
+        {
+            break;
+        }
+
+        bool isForward     = forwardFrontier.size() <= backwardFrontier.size();
+        auto& frontier     = isForward ? forwardFrontier : backwardFrontier;
+        auto& facts        = isForward ? forwardFacts : backwardFacts;
+        auto& depths       = isForward ? forwardDepths : backwardDepths;
+        auto& otherDepths  = isForward ? backwardDepths : forwardDepths;
+        std::size_t length = 0;
+
+        std::vector<sqlite3_int64> next;
+        std::vector<obelisk::Fact> edges;
+        for (auto entity : frontier)
+        {
+            edges.clear();
+            if (isForward)
+            {
+                getOutgoing(entity, edges);
+            }
+            else
+            {
+                getIncoming(entity, edges);
+            }
+
+            for (auto& edge : edges)
+            {
+                sqlite3_int64 neighbour = isForward
+                                            ? edge.getRightEntity().getId()
+                                            : edge.getLeftEntity().getId();
+                if (depths.count(neighbour) != 0)
+                {
+                    continue;
+                }
+                facts.emplace(neighbour, edge);
+                depths.emplace(neighbour, depths[entity] + 1);
+                next.push_back(neighbour);
+
+                // finish the level so the shortest of the paths that meet
+                // in it is kept
+                auto other = otherDepths.find(neighbour);
+                if (other != otherDepths.end()
+                    && (meeting == 0
+                        || depths[neighbour] + other->second < length))
+                {
+                    meeting = neighbour;
+                    length  = depths[neighbour] + other->second;
+                }
+            }
+        }
+        frontier = std::move(next);
+    }
+
+    if (meeting == 0)
+    {
+        return false;
+    }
+
+    for (sqlite3_int64 entity = meeting; entity != fromEntityId;)
+    {
+        auto& fact = forwardFacts.at(entity);
+        path.push_back(fact);
+        entity = fact.getLeftEntity().getId();
+    }
+    std::reverse(path.begin(), path.end());
+
+    for (sqlite3_int64 entity = meeting; entity != toEntityId;)
+    {
+        auto& fact = backwardFacts.at(entity);
+        path.push_back(fact);
+        entity = fact.getRightEntity().getId();
+    }
+
+    return true;
+}
+
+void obelisk::KnowledgeBase::queryFact(obelisk::Fact& fact)
+{
+    queryFact(fact, getEvaluation());
+}
+
+void obelisk::KnowledgeBase::queryFact(obelisk::Fact& fact,
+    Evaluation evaluation)
+{
+    fact.selectByName(dbConnection_);
+
+    if (evaluation == kEvaluationBackward)
+    {
+        if (fact.getId() == 0)
+        {
+            // the fact isn't stored, but a pattern rule might still derive it
+            getEntity(fact.getLeftEntity());
+            getEntity(fact.getRightEntity());
+            getVerb(fact.getVerb());
+        }
+
+        if (fact.getLeftEntity().getId() != 0
+            && fact.getRightEntity().getId() != 0
+            && fact.getVerb().getId() != 0)
+        {
+            std::set<obelisk::KnowledgeBase::Goal> goals;
+            bool dependent = false;
+            fact.setIsTrue(resolveFact(fact, goals, dependent));
+        }
+    }
+
+    // only the transitive verbs have chains in the closure
+    getVerb(fact.getVerb());
+    if (fact.getVerb().getTransitive())
+    {
+        // a chain can be more confident than the fact itself, the fact is as
+        // true as the best of the two
+        obelisk::Fact chain(fact);
+        chain.setIsTrue(0.0);
+        obelisk::Closure::selectByName(dbConnection_, chain);
+        fact.setIsTrue(std::max(fact.getIsTrue(), chain.getIsTrue()));
+    }
+}
+
+double obelisk::KnowledgeBase::resolveFact(obelisk::Fact& fact,
+    std::set<obelisk::KnowledgeBase::Goal>& goals,
+    bool& dependent)
+{
+    auto goal = std::make_tuple(fact.getLeftEntity().getId(),
+        fact.getVerb().getId(),
+        fact.getRightEntity().getId());
+
+    auto answer = table_.find(goal);
+    if (answer != table_.end())
+    {
+        return answer->second;
+    }
+
+    if (fact.getIsTrue() >= 1.0)
+    {
+        // no rule can make it any more true
+        table_[goal] = fact.getIsTrue();
+        return fact.getIsTrue();
+    }
+
+    if (goals.find(goal) != goals.end())
+    {
+        // the goal is recursive, answer with what is known so far
+        dependent = true;
+        return fact.getIsTrue();
+    }
+
+    goals.insert(goal);
+
+    double derived {0};
+    bool reliesOnGoals {false};
+    if (fact.getId() != 0)
+    {
+        std::vector<obelisk::Rule> rules;
+        obelisk::Rule::selectByFact(dbConnection_, fact.getId(), rules);
+        for (auto& rule : rules)
+        {
+            auto reason = rule.getReason();
+            getFact(reason);
+            double reasonIsTrue = resolveFact(reason, goals, reliesOnGoals);
+            if (reasonIsTrue > 0)
+            {
+                derived = aggregate(derived,
+                    combine(rule.getWeight(), reasonIsTrue));
+            }
+        }
+    }
+
+    std::vector<obelisk::PatternRule> patternRules;
+    obelisk::PatternRule::selectByVerb(dbConnection_,
+        fact.getVerb().getId(),
+        patternRules);
+    for (auto& patternRule : patternRules)
+    {
+        double reasonIsTrue
+            = resolvePatternRule(patternRule, fact, goals, reliesOnGoals);
+        if (reasonIsTrue > 0)
+        {
+            derived = aggregate(derived,
+                combine(patternRule.getWeight(), reasonIsTrue));
+        }
+    }
+
+    double isTrue = std::max(fact.getIsTrue(), derived);
+
+    goals.erase(goal);
+
+    // an answer that relied on an unfinished goal may still rise once that
+    // goal is finished, so only keep it if it is final
+    if (!reliesOnGoals || goals.empty())
+    {
+        table_[goal] = isTrue;
+    }
+    else
+    {
+        dependent = true;
+    }
+
+    return isTrue;
+}
+
+double obelisk::KnowledgeBase::resolvePatternRule(
+    obelisk::PatternRule& patternRule,
+    obelisk::Fact& fact,
+    std::set<obelisk::KnowledgeBase::Goal>& goals,
+    bool& dependent)
+{
+    std::unordered_map<std::string, sqlite3_int64> bindings;
+    if (!bindEntity(patternRule.getFactLeftVariable(),
+            patternRule.getFact().getLeftEntity().getId(),
+            fact.getLeftEntity().getId(),
+            bindings)
+        || !bindEntity(patternRule.getFactRightVariable(),
+            patternRule.getFact().getRightEntity().getId(),
+            fact.getRightEntity().getId(),
+            bindings))
+    {
+        return 0;
+    }
+
+    auto& reasonPattern = patternRule.getReason();
+    auto& leftVariable  = patternRule.getReasonLeftVariable();
+    auto& rightVariable = patternRule.getReasonRightVariable();
+    sqlite3_int64 leftEntityId    = reasonPattern.getLeftEntity().getId();
+    sqlite3_int64 rightEntityId   = reasonPattern.getRightEntity().getId();
+    if (leftVariable != "")
+    {
+        leftEntityId = bindings.count(leftVariable) ? bindings[leftVariable] : 0;
+    }
+    if (rightVariable != "")
+    {
+        rightEntityId
+            = bindings.count(rightVariable) ? bindings[rightVariable] : 0;
+    }
+
+    if (leftEntityId != 0 && rightEntityId != 0)
+    {
+        // the reason is fully bound, it doesn't have to be stored to be true
+        obelisk::Fact reason(obelisk::Entity(leftEntityId),
+            obelisk::Entity(rightEntityId),
+            obelisk::Verb(reasonPattern.getVerb().getId()));
+        getFact(reason);
+        return resolveFact(reason, goals, dependent);
+    }
+
+    // the variables that are left unbound can only be matched with the facts
+    // that are stored
+    double isTrue {0};
+    std::vector<obelisk::Fact> reasons;
+    obelisk::Fact::selectByVerb(dbConnection_,
+        reasonPattern.getVerb().getId(),
+        leftEntityId,
+        rightEntityId,
+        reasons);
+    for (auto& reason : reasons)
+    {
+        auto reasonBindings = bindings;
+        if (bindEntity(leftVariable,
+                leftEntityId,
+                reason.getLeftEntity().getId(),
+                reasonBindings)
+            && bindEntity(rightVariable,
+                rightEntityId,
+                reason.getRightEntity().getId(),
+                reasonBindings))
+        {
+            isTrue = std::max(isTrue, resolveFact(reason, goals, dependent));
+        }
+    }
+
+    return isTrue;
+}
+
+std::unique_ptr<obelisk::FactCursor> obelisk::KnowledgeBase::queryPattern(
+    obelisk::Fact& pattern)
+{
+    return std::unique_ptr<obelisk::FactCursor> {
+        new obelisk::FactCursor(dbConnection_, pattern)};
+}
+
+void obelisk::KnowledgeBase::querySuggestAction(obelisk::Fact& fact,
+    obelisk::Action& action)
+{
+    fact.selectActionByFact(dbConnection_, action);
+}
+
+void obelisk::KnowledgeBase::queryAction(obelisk::Fact& fact,
+    obelisk::Action& action)
+{
+    if (getEvaluation() == kEvaluationBackward)
+    {
+        queryFact(fact);
+        querySuggestAction(fact, action);
+        return;
+    }
+
+    fact.selectActionByName(dbConnection_, action);
 }
 
 void obelisk::KnowledgeBase::getFloat(float& result1,
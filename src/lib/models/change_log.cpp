@@ -0,0 +1,573 @@
+#include "models/change_log.h"
+#include "models/error.h"
+
+const char* obelisk::ChangeLog::createTable()
+{
+    // the values have no type, so each keeps the type it was logged with
+    return R"(
+        CREATE TABLE IF NOT EXISTS "change_log" (
+            "id"         INTEGER NOT NULL UNIQUE,
+            "table_name" TEXT NOT NULL,
+            "operation"  TEXT NOT NULL CHECK("operation" IN ('insert', 'update', 'delete')),
+            "value_1",
+            "value_2",
+            "value_3",
+            "value_4",
+            "value_5",
+            "value_6",
+            "value_7",
+            "value_8",
+            "value_9",
+            "value_10",
+            "value_11",
+            "value_12",
+            PRIMARY KEY("id" AUTOINCREMENT)
+        );
+    )";
+}
+
+const char* obelisk::ChangeLog::createTriggers()
+{
+    // each change logs the values its statement in getStatement is bound to
+    return R"(
+        CREATE TRIGGER IF NOT EXISTS "entity_change_log_insert" AFTER INSERT ON "entity"
+        BEGIN
+            INSERT INTO change_log (table_name, operation, value_1, value_2)
+            VALUES ('entity', 'insert', NEW.id, NEW.name);
+        END;
+        CREATE TRIGGER IF NOT EXISTS "entity_change_log_delete" AFTER DELETE ON "entity"
+        BEGIN
+            INSERT INTO change_log (table_name, operation, value_1)
+            VALUES ('entity', 'delete', OLD.id);
+        END;
+        CREATE TRIGGER IF NOT EXISTS "verb_change_log_insert" AFTER INSERT ON "verb"
+        BEGIN
+            INSERT INTO change_log (table_name, operation, value_1, value_2, value_3)
+            VALUES ('verb', 'insert', NEW.id, NEW.name, NEW.transitive);
+        END;
+        CREATE TRIGGER IF NOT EXISTS "verb_change_log_update" AFTER UPDATE OF "transitive" ON "verb"
+        BEGIN
+            INSERT INTO change_log (table_name, operation, value_1, value_2)
+            VALUES ('verb', 'update', NEW.id, NEW.transitive);
+        END;
+        CREATE TRIGGER IF NOT EXISTS "verb_change_log_delete" AFTER DELETE ON "verb"
+        BEGIN
+            INSERT INTO change_log (table_name, operation, value_1)
+            VALUES ('verb', 'delete', OLD.id);
+        END;
+        CREATE TRIGGER IF NOT EXISTS "action_change_log_insert" AFTER INSERT ON "action"
+        BEGIN
+            INSERT INTO change_log (table_name, operation, value_1, value_2)
+            VALUES ('action', 'insert', NEW.id, NEW.name);
+        END;
+        CREATE TRIGGER IF NOT EXISTS "action_change_log_delete" AFTER DELETE ON "action"
+        BEGIN
+            INSERT INTO change_log (table_name, operation, value_1)
+            VALUES ('action', 'delete', OLD.id);
+        END;
+        CREATE TRIGGER IF NOT EXISTS "fact_change_log_insert" AFTER INSERT ON "fact"
+        BEGIN
+            INSERT INTO change_log (table_name, operation, value_1, value_2, value_3, value_4, value_5)
+            VALUES ('fact', 'insert', NEW.id, NEW.left_entity, NEW.right_entity, NEW.verb, NEW.is_true);
+        END;
+        CREATE TRIGGER IF NOT EXISTS "fact_change_log_update" AFTER UPDATE OF "is_true" ON "fact"
+        BEGIN
+            INSERT INTO change_log (table_name, operation, value_1, value_2)
+            VALUES ('fact', 'update', NEW.id, NEW.is_true);
+        END;
+        CREATE TRIGGER IF NOT EXISTS "fact_change_log_delete" AFTER DELETE ON "fact"
+        BEGIN
+            INSERT INTO change_log (table_name, operation, value_1)
+            VALUES ('fact', 'delete', OLD.id);
+        END;
+        CREATE TRIGGER IF NOT EXISTS "closure_change_log_insert" AFTER INSERT ON "closure"
+        BEGIN
+            INSERT INTO change_log (table_name, operation, value_1, value_2, value_3, value_4)
+            VALUES ('closure', 'insert', NEW.verb, NEW.left_entity, NEW.right_entity, NEW.is_true);
+        END;
+        CREATE TRIGGER IF NOT EXISTS "closure_change_log_update" AFTER UPDATE OF "is_true" ON "closure"
+        BEGIN
+            INSERT INTO change_log (table_name, operation, value_1, value_2, value_3, value_4)
+            VALUES ('closure', 'update', NEW.verb, NEW.left_entity, NEW.right_entity, NEW.is_true);
+        END;
+        CREATE TRIGGER IF NOT EXISTS "closure_change_log_delete" AFTER DELETE ON "closure"
+        BEGIN
+            INSERT INTO change_log (table_name, operation, value_1, value_2, value_3)
+            VALUES ('closure', 'delete', OLD.verb, OLD.left_entity, OLD.right_entity);
+        END;
+        CREATE TRIGGER IF NOT EXISTS "rule_change_log_insert" AFTER INSERT ON "rule"
+        BEGIN
+            INSERT INTO change_log (table_name, operation, value_1, value_2, value_3, value_4)
+            VALUES ('rule', 'insert', NEW.id, NEW.fact, NEW.reason, NEW.weight);
+        END;
+        CREATE TRIGGER IF NOT EXISTS "rule_change_log_delete" AFTER DELETE ON "rule"
+        BEGIN
+            INSERT INTO change_log (table_name, operation, value_1)
+            VALUES ('rule', 'delete', OLD.id);
+        END;
+        CREATE TRIGGER IF NOT EXISTS "pattern_rule_change_log_insert" AFTER INSERT ON "pattern_rule"
+        BEGIN
+            INSERT INTO change_log (table_name, operation, value_1, value_2, value_3, value_4, value_5, value_6, value_7, value_8, value_9, value_10, value_11, value_12)
+            VALUES ('pattern_rule', 'insert', NEW.id, NEW.left_entity, NEW.left_variable, NEW.verb, NEW.right_entity, NEW.right_variable, NEW.reason_left_entity, NEW.reason_left_variable, NEW.reason_verb, NEW.reason_right_entity, NEW.reason_right_variable, NEW.weight);
+        END;
+        CREATE TRIGGER IF NOT EXISTS "pattern_rule_change_log_delete" AFTER DELETE ON "pattern_rule"
+        BEGIN
+            INSERT INTO change_log (table_name, operation, value_1)
+            VALUES ('pattern_rule', 'delete', OLD.id);
+        END;
+        CREATE TRIGGER IF NOT EXISTS "suggest_action_change_log_insert" AFTER INSERT ON "suggest_action"
+        BEGIN
+            INSERT INTO change_log (table_name, operation, value_1, value_2, value_3, value_4)
+            VALUES ('suggest_action', 'insert', NEW.id, NEW.fact, NEW.true_action, NEW.false_action);
+        END;
+        CREATE TRIGGER IF NOT EXISTS "suggest_action_change_log_delete" AFTER DELETE ON "suggest_action"
+        BEGIN
+            INSERT INTO change_log (table_name, operation, value_1)
+            VALUES ('suggest_action', 'delete', OLD.id);
+        END;
+    )";
+}
+
+const char* obelisk::ChangeLog::dropTriggers()
+{
+    return R"(
+        DROP TRIGGER IF EXISTS "entity_change_log_insert";
+        DROP TRIGGER IF EXISTS "entity_change_log_delete";
+        DROP TRIGGER IF EXISTS "verb_change_log_insert";
+        DROP TRIGGER IF EXISTS "verb_change_log_update";
+        DROP TRIGGER IF EXISTS "verb_change_log_delete";
+        DROP TRIGGER IF EXISTS "action_change_log_insert";
+        DROP TRIGGER IF EXISTS "action_change_log_delete";
+        DROP TRIGGER IF EXISTS "fact_change_log_insert";
+        DROP TRIGGER IF EXISTS "fact_change_log_update";
+        DROP TRIGGER IF EXISTS "fact_change_log_delete";
+        DROP TRIGGER IF EXISTS "closure_change_log_insert";
+        DROP TRIGGER IF EXISTS "closure_change_log_update";
+        DROP TRIGGER IF EXISTS "closure_change_log_delete";
+        DROP TRIGGER IF EXISTS "rule_change_log_insert";
+        DROP TRIGGER IF EXISTS "rule_change_log_delete";
+        DROP TRIGGER IF EXISTS "pattern_rule_change_log_insert";
+        DROP TRIGGER IF EXISTS "pattern_rule_change_log_delete";
+        DROP TRIGGER IF EXISTS "suggest_action_change_log_insert";
+        DROP TRIGGER IF EXISTS "suggest_action_change_log_delete";
+    )";
+}
+
+sqlite3_int64 obelisk::ChangeLog::selectLast(sqlite3* dbConnection)
+{
+    if (dbConnection == nullptr)
+    {
+        throw obelisk::DatabaseException("database isn't open");
+    }
+
+    sqlite3_stmt* ppStmt = nullptr;
+
+    auto result = sqlite3_prepare_v2(dbConnection,
+        "SELECT IFNULL((SELECT seq FROM sqlite_sequence WHERE name='change_log'), 0)",
+        -1,
+        &ppStmt,
+        nullptr);
+    if (result != SQLITE_OK)
+    {
+        throw obelisk::DatabaseException(sqlite3_errmsg(dbConnection));
+    }
+
+    sqlite3_int64 last = 0;
+
+    result = sqlite3_step(ppStmt);
+    switch (result)
+    {
+        case SQLITE_DONE :
+            // no rows in the database
+            break;
+        case SQLITE_ROW :
+            last = sqlite3_column_int64(ppStmt, 0);
+            break;
+        case SQLITE_BUSY :
+            throw obelisk::DatabaseBusyException();
+            break;
+        case SQLITE_MISUSE :
+            throw obelisk::DatabaseMisuseException();
+            break;
+        default :
+            throw obelisk::DatabaseException(sqlite3_errmsg(dbConnection));
+            break;
+    }
+
+    result = sqlite3_finalize(ppStmt);
+    if (result != SQLITE_OK)
+    {
+        throw obelisk::DatabaseException(sqlite3_errmsg(dbConnection));
+    }
+
+    return last;
+}
+
+void obelisk::ChangeLog::selectRange(sqlite3* dbConnection,
+    sqlite3_int64 after,
+    sqlite3_int64 last,
+    std::vector<obelisk::ChangeLog::Change>& changes)
+{
+    if (dbConnection == nullptr)
+    {
+        throw obelisk::DatabaseException("database isn't open");
+    }
+
+    sqlite3_stmt* ppStmt = nullptr;
+
+    auto result = sqlite3_prepare_v2(dbConnection,
+        "SELECT id, table_name, operation, value_1, value_2, value_3, value_4, value_5, value_6, value_7, value_8, value_9, value_10, value_11, value_12 FROM change_log WHERE (id > ? AND id <= ?) ORDER BY id",
+        -1,
+        &ppStmt,
+        nullptr);
+    if (result != SQLITE_OK)
+    {
+        throw obelisk::DatabaseException(sqlite3_errmsg(dbConnection));
+    }
+
+    result = sqlite3_bind_int64(ppStmt, 1, after);
+    switch (result)
+    {
+        case SQLITE_OK :
+            break;
+        case SQLITE_TOOBIG :
+            throw obelisk::DatabaseSizeException();
+            break;
+        case SQLITE_RANGE :
+            throw obelisk::DatabaseRangeException();
+            break;
+        case SQLITE_NOMEM :
+            throw obelisk::DatabaseMemoryException();
+            break;
+        default :
+            throw obelisk::DatabaseException(sqlite3_errmsg(dbConnection));
+            break;
+    }
+
+    result = sqlite3_bind_int64(ppStmt, 2, last);
+    switch (result)
+    {
+        case SQLITE_OK :
+            break;
+        case SQLITE_TOOBIG :
+            throw obelisk::DatabaseSizeException();
+            break;
+        case SQLITE_RANGE :
+            throw obelisk::DatabaseRangeException();
+            break;
+        case SQLITE_NOMEM :
+            throw obelisk::DatabaseMemoryException();
+            break;
+        default :
+            throw obelisk::DatabaseException(sqlite3_errmsg(dbConnection));
+            break;
+    }
+
+    while ((result = sqlite3_step(ppStmt)) != SQLITE_DONE)
+    {
+        switch (result)
+        {
+            case SQLITE_ROW :
+            {
+                obelisk::ChangeLog::Change change;
+                change.id        = sqlite3_column_int64(ppStmt, 0);
+                change.table     = (char*) sqlite3_column_text(ppStmt, 1);
+                change.operation = (char*) sqlite3_column_text(ppStmt, 2);
+                for (int column = 3; column < 3 + (int) kValues; column++)
+                {
+                    obelisk::ChangeLog::Value value;
+                    value.type = sqlite3_column_type(ppStmt, column);
+                    switch (value.type)
+                    {
+                        case SQLITE_INTEGER :
+                            value.integer
+                                = sqlite3_column_int64(ppStmt, column);
+                            break;
+                        case SQLITE_FLOAT :
+                            value.real = sqlite3_column_double(ppStmt, column);
+                            break;
+                        case SQLITE_TEXT :
+                            value.text
+                                = (char*) sqlite3_column_text(ppStmt, column);
+                            break;
+                        default :
+                            // only integers, reals, text and null are logged
+                            value.type = SQLITE_NULL;
+                            break;
+                    }
+                    change.values.push_back(value);
+                }
+                changes.push_back(change);
+                break;
+            }
+            case SQLITE_BUSY :
+                throw obelisk::DatabaseBusyException();
+                break;
+            case SQLITE_MISUSE :
+                throw obelisk::DatabaseMisuseException();
+                break;
+            default :
+                throw obelisk::DatabaseException(sqlite3_errmsg(dbConnection));
+                break;
+        }
+    }
+
+    result = sqlite3_finalize(ppStmt);
+    if (result != SQLITE_OK)
+    {
+        throw obelisk::DatabaseException(sqlite3_errmsg(dbConnection));
+    }
+}
+
+void obelisk::ChangeLog::deleteUpTo(sqlite3* dbConnection, sqlite3_int64 last)
+{
+    if (dbConnection == nullptr)
+    {
+        throw obelisk::DatabaseException("database isn't open");
+    }
+
+    sqlite3_stmt* ppStmt = nullptr;
+
+    auto result = sqlite3_prepare_v2(dbConnection,
+        "DELETE FROM change_log WHERE (id <= ?)",
+        -1,
+        &ppStmt,
+        nullptr);
+    if (result != SQLITE_OK)
+    {
+        throw obelisk::DatabaseException(sqlite3_errmsg(dbConnection));
+    }
+
+    result = sqlite3_bind_int64(ppStmt, 1, last);
+    switch (result)
+    {
+        case SQLITE_OK :
+            break;
+        case SQLITE_TOOBIG :
+            throw obelisk::DatabaseSizeException();
+            break;
+        case SQLITE_RANGE :
+            throw obelisk::DatabaseRangeException();
+            break;
+        case SQLITE_NOMEM :
+            throw obelisk::DatabaseMemoryException();
+            break;
+        default :
+            throw obelisk::DatabaseException(sqlite3_errmsg(dbConnection));
+            break;
+    }
+
+    result = sqlite3_step(ppStmt);
+    switch (result)
+    {
+        case SQLITE_DONE :
+            // rows deleted
+            break;
+        case SQLITE_CONSTRAINT :
+            throw obelisk::DatabaseConstraintException(
+                sqlite3_errmsg(dbConnection));
+        case SQLITE_BUSY :
+            throw obelisk::DatabaseBusyException();
+            break;
+        case SQLITE_MISUSE :
+            throw obelisk::DatabaseMisuseException();
+            break;
+        default :
+            throw obelisk::DatabaseException(sqlite3_errmsg(dbConnection));
+            break;
+    }
+
+    result = sqlite3_finalize(ppStmt);
+    if (result != SQLITE_OK)
+    {
+        throw obelisk::DatabaseException(sqlite3_errmsg(dbConnection));
+    }
+}
+
+void obelisk::ChangeLog::apply(sqlite3* dbConnection,
+    const obelisk::ChangeLog::Change& change)
+{
+    if (dbConnection == nullptr)
+    {
+        throw obelisk::DatabaseException("database isn't open");
+    }
+
+    auto query = getStatement(change.table, change.operation);
+    if (query == nullptr)
+    {
+        throw obelisk::DatabaseException("change log can't replay "
+                                         + change.operation + " on "
+                                         + change.table);
+    }
+
+    sqlite3_stmt* ppStmt = nullptr;
+
+    auto result = sqlite3_prepare_v2(dbConnection, query, -1, &ppStmt, nullptr);
+    if (result != SQLITE_OK)
+    {
+        throw obelisk::DatabaseException(sqlite3_errmsg(dbConnection));
+    }
+
+    // the values past the parameters of the statement must be empty, so a
+    // change is only replayed if it has the shape its trigger logs
+    std::size_t parameters = sqlite3_bind_parameter_count(ppStmt);
+    auto valid             = change.values.size() >= parameters;
+    for (auto i = parameters; valid && i < change.values.size(); i++)
+    {
+        valid = change.values[i].type == SQLITE_NULL;
+    }
+    if (!valid)
+    {
+        sqlite3_finalize(ppStmt);
+        throw obelisk::DatabaseException("change log can't replay "
+                                         + change.operation + " on "
+                                         + change.table
+                                         + " with these values");
+    }
+
+    for (std::size_t i = 0; i < parameters; i++)
+    {
+        auto& value = change.values[i];
+        switch (value.type)
+        {
+            case SQLITE_INTEGER :
+                result = sqlite3_bind_int64(ppStmt, i + 1, value.integer);
+                break;
+            case SQLITE_FLOAT :
+                result = sqlite3_bind_double(ppStmt, i + 1, value.real);
+                break;
+            case SQLITE_TEXT :
+                result = sqlite3_bind_text(ppStmt,
+                    i + 1,
+                    value.text.c_str(),
+                    -1,
+                    SQLITE_STATIC);
+                break;
+            default :
+                result = sqlite3_bind_null(ppStmt, i + 1);
+                break;
+        }
+        switch (result)
+        {
+            case SQLITE_OK :
+                break;
+            case SQLITE_TOOBIG :
+                throw obelisk::DatabaseSizeException();
+                break;
+            case SQLITE_RANGE :
+                throw obelisk::DatabaseRangeException();
+                break;
+            case SQLITE_NOMEM :
+                throw obelisk::DatabaseMemoryException();
+                break;
+            default :
+                throw obelisk::DatabaseException(sqlite3_errmsg(dbConnection));
+                break;
+        }
+    }
+
+    result = sqlite3_step(ppStmt);
+    switch (result)
+    {
+        case SQLITE_DONE :
+            // change replayed
+            break;
+        case SQLITE_CONSTRAINT :
+            throw obelisk::DatabaseConstraintException(
+                sqlite3_errmsg(dbConnection));
+        case SQLITE_BUSY :
+            throw obelisk::DatabaseBusyException();
+            break;
+        case SQLITE_MISUSE :
+            throw obelisk::DatabaseMisuseException();
+            break;
+        default :
+            throw obelisk::DatabaseException(sqlite3_errmsg(dbConnection));
+            break;
+    }
+
+    result = sqlite3_finalize(ppStmt);
+    if (result != SQLITE_OK)
+    {
+        throw obelisk::DatabaseException(sqlite3_errmsg(dbConnection));
+    }
+}
+
+const char* obelisk::ChangeLog::getStatement(const std::string& table,
+    const std::string& operation)
+{
+    // the parameters are in the order createTriggers logs the values
+    static const struct
+    {
+            const char* table;
+            const char* operation;
+            const char* query;
+    } statements[] = {
+        {"entity",
+            "insert",
+            "INSERT INTO entity (id, name) VALUES (?, ?)"},
+        {"entity",
+            "delete",
+            "DELETE FROM entity WHERE id=?"},
+        {"verb",
+            "insert",
+            "INSERT INTO verb (id, name, transitive) VALUES (?, ?, ?)"},
+        {"verb",
+            "update",
+            "UPDATE verb SET transitive=?2 WHERE id=?1"},
+        {"verb",
+            "delete",
+            "DELETE FROM verb WHERE id=?"},
+        {"action",
+            "insert",
+            "INSERT INTO action (id, name) VALUES (?, ?)"},
+        {"action",
+            "delete",
+            "DELETE FROM action WHERE id=?"},
+        {"fact",
+            "insert",
+            "INSERT INTO fact (id, left_entity, right_entity, verb, is_true) VALUES (?, ?, ?, ?, ?)"},
+        {"fact",
+            "update",
+            "UPDATE fact SET is_true=?2 WHERE id=?1"},
+        {"fact",
+            "delete",
+            "DELETE FROM fact WHERE id=?"},
+        {"closure",
+            "insert",
+            "INSERT INTO closure (verb, left_entity, right_entity, is_true) VALUES (?, ?, ?, ?)"},
+        {"closure",
+            "update",
+            "UPDATE closure SET is_true=?4 WHERE (verb=?1 AND left_entity=?2 AND right_entity=?3)"},
+        {"closure",
+            "delete",
+            "DELETE FROM closure WHERE (verb=? AND left_entity=? AND right_entity=?)"},
+        {"rule",
+            "insert",
+            "INSERT INTO rule (id, fact, reason, weight) VALUES (?, ?, ?, ?)"},
+        {"rule",
+            "delete",
+            "DELETE FROM rule WHERE id=?"},
+        {"pattern_rule",
+            "insert",
+            "INSERT INTO pattern_rule (id, left_entity, left_variable, verb, right_entity, right_variable, reason_left_entity, reason_left_variable, reason_verb, reason_right_entity, reason_right_variable, weight) VALUES (?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?)"},
+        {"pattern_rule",
+            "delete",
+            "DELETE FROM pattern_rule WHERE id=?"},
+        {"suggest_action",
+            "insert",
+            "INSERT INTO suggest_action (id, fact, true_action, false_action) VALUES (?, ?, ?, ?)"},
+        {"suggest_action",
+            "delete",
+            "DELETE FROM suggest_action WHERE id=?"}
+    };
+
+    for (auto& statement : statements)
+    {
+        if (table == statement.table && operation == statement.operation)
+        {
+            return statement.query;
+        }
+    }
+    return nullptr;
+}
@@ -0,0 +1,385 @@
+#include "models/closure.h"
+#include "models/error.h"
+
+const char* obelisk::Closure::createTable()
+{
+    return R"(
+        CREATE TABLE "closure" (
+            "verb"         INTEGER NOT NULL,
+            "left_entity"  INTEGER NOT NULL,
+            "right_entity" INTEGER NOT NULL,
+            "is_true"      REAL NOT NULL DEFAULT 1 CHECK("is_true" >= 0 AND "is_true" <= 1),
+            PRIMARY KEY("verb", "left_entity", "right_entity"),
+            FOREIGN KEY("verb") REFERENCES "verb"("id") ON DELETE RESTRICT,
+            FOREIGN KEY("left_entity") REFERENCES "entity"("id") ON DELETE RESTRICT,
+            FOREIGN KEY("right_entity") REFERENCES "entity"("id") ON DELETE RESTRICT
+        ) WITHOUT ROWID;
+        CREATE INDEX "closure_verb_right" ON "closure" ("verb", "right_entity");
+    )";
+}
+
+void obelisk::Closure::insertFact(sqlite3* dbConnection,
+    obelisk::Fact& fact,
+    bool minimum)
+{
+    if (dbConnection == nullptr)
+    {
+        throw obelisk::DatabaseException("database isn't open");
+    }
+
+    sqlite3_stmt* ppStmt = nullptr;
+
+    // a chain is only raised if the Fact gives it a higher confidence than
+    // the one it already has
+    const char* query;
+    if (minimum)
+    {
+        query
+            = "INSERT INTO closure (verb, left_entity, right_entity, is_true) SELECT ?1, a.entity, d.entity, MIN(a.is_true, ?4, d.is_true) FROM (SELECT ?2 AS entity, 1.0 AS is_true UNION ALL SELECT left_entity, is_true FROM closure WHERE verb=?1 AND right_entity=?2) a, (SELECT ?3 AS entity, 1.0 AS is_true UNION ALL SELECT right_entity, is_true FROM closure WHERE verb=?1 AND left_entity=?3) d WHERE EXISTS (SELECT 1 FROM verb WHERE id=?1 AND transitive=1) ON CONFLICT (verb, left_entity, right_entity) DO UPDATE SET is_true=excluded.is_true WHERE excluded.is_true > closure.is_true";
+    }
+    else
+    {
+        query
+            = "INSERT INTO closure (verb, left_entity, right_entity, is_true) SELECT ?1, a.entity, d.entity, a.is_true * ?4 * d.is_true FROM (SELECT ?2 AS entity, 1.0 AS is_true UNION ALL SELECT left_entity, is_true FROM closure WHERE verb=?1 AND right_entity=?2) a, (SELECT ?3 AS entity, 1.0 AS is_true UNION ALL SELECT right_entity, is_true FROM closure WHERE verb=?1 AND left_entity=?3) d WHERE EXISTS (SELECT 1 FROM verb WHERE id=?1 AND transitive=1) ON CONFLICT (verb, left_entity, right_entity) DO UPDATE SET is_true=excluded.is_true WHERE excluded.is_true > closure.is_true";
+    }
+    auto result = sqlite3_prepare_v2(dbConnection, query, -1, &ppStmt, nullptr);
+    if (result != SQLITE_OK)
+    {
+        throw obelisk::DatabaseException(sqlite3_errmsg(dbConnection));
+    }
+
+    result = sqlite3_bind_int64(ppStmt, 1, fact.getVerb().getId());
+    switch (result)
+    {
+        case SQLITE_OK :
+            break;
+        case SQLITE_TOOBIG :
+            throw obelisk::DatabaseSizeException();
+            break;
+        case SQLITE_RANGE :
+            throw obelisk::DatabaseRangeException();
+            break;
+        case SQLITE_NOMEM :
+            throw obelisk::DatabaseMemoryException();
+            break;
+        default :
+            throw obelisk::DatabaseException(sqlite3_errmsg(dbConnection));
+            break;
+    }
+
+    result = sqlite3_bind_int64(ppStmt, 2, fact.getLeftEntity().getId());
+    switch (result)
+    {
+        case SQLITE_OK :
+            break;
+        case SQLITE_TOOBIG :
+            throw obelisk::DatabaseSizeException();
+            break;
+        case SQLITE_RANGE :
+            throw obelisk::DatabaseRangeException();
+            break;
+        case SQLITE_NOMEM :
+            throw obelisk::DatabaseMemoryException();
+            break;
+        default :
+            throw obelisk::DatabaseException(sqlite3_errmsg(dbConnection));
+            break;
+    }
+
+    result = sqlite3_bind_int64(ppStmt, 3, fact.getRightEntity().getId());
+    switch (result)
+    {
+        case SQLITE_OK :
+            break;
+        case SQLITE_TOOBIG :
+            throw obelisk::DatabaseSizeException();
+            break;
+        case SQLITE_RANGE :
+            throw obelisk::DatabaseRangeException();
+            break;
+        case SQLITE_NOMEM :
+            throw obelisk::DatabaseMemoryException();
+            break;
+        default :
+            throw obelisk::DatabaseException(sqlite3_errmsg(dbConnection));
+            break;
+    }
+
+    result = sqlite3_bind_double(ppStmt, 4, fact.getIsTrue());
+    switch (result)
+    {
+        case SQLITE_OK :
+            break;
+        case SQLITE_TOOBIG :
+            throw obelisk::DatabaseSizeException();
+            break;
+        case SQLITE_RANGE :
+            throw obelisk::DatabaseRangeException();
+            break;
+        case SQLITE_NOMEM :
+            throw obelisk::DatabaseMemoryException();
+            break;
+        default :
+            throw obelisk::DatabaseException(sqlite3_errmsg(dbConnection));
+            break;
+    }
+
+    result = sqlite3_step(ppStmt);
+    switch (result)
+    {
+        case SQLITE_DONE :
+            // rows inserted
+            break;
+        case SQLITE_CONSTRAINT :
+            throw obelisk::DatabaseConstraintException(
+                sqlite3_errmsg(dbConnection));
+        case SQLITE_BUSY :
+            throw obelisk::DatabaseBusyException();
+            break;
+        case SQLITE_MISUSE :
+            throw obelisk::DatabaseMisuseException();
+            break;
+        default :
+            throw obelisk::DatabaseException(sqlite3_errmsg(dbConnection));
+            break;
+    }
+
+    result = sqlite3_finalize(ppStmt);
+    if (result != SQLITE_OK)
+    {
+        throw obelisk::DatabaseException(sqlite3_errmsg(dbConnection));
+    }
+}
+
+int obelisk::Closure::deleteByVerb(sqlite3* dbConnection,
+    sqlite3_int64 verbId)
+{
+    if (dbConnection == nullptr)
+    {
+        throw obelisk::DatabaseException("database isn't open");
+    }
+
+    sqlite3_stmt* ppStmt = nullptr;
+
+    auto result = sqlite3_prepare_v2(dbConnection,
+        "DELETE FROM closure WHERE verb=?",
+        -1,
+        &ppStmt,
+        nullptr);
+    if (result != SQLITE_OK)
+    {
+        throw obelisk::DatabaseException(sqlite3_errmsg(dbConnection));
+    }
+
+    result = sqlite3_bind_int64(ppStmt, 1, verbId);
+    switch (result)
+    {
+        case SQLITE_OK :
+            break;
+        case SQLITE_TOOBIG :
+            throw obelisk::DatabaseSizeException();
+            break;
+        case SQLITE_RANGE :
+            throw obelisk::DatabaseRangeException();
+            break;
+        case SQLITE_NOMEM :
+            throw obelisk::DatabaseMemoryException();
+            break;
+        default :
+            throw obelisk::DatabaseException(sqlite3_errmsg(dbConnection));
+            break;
+    }
+
+    result = sqlite3_step(ppStmt);
+    switch (result)
+    {
+        case SQLITE_DONE :
+            // rows deleted
+            break;
+        case SQLITE_CONSTRAINT :
+            throw obelisk::DatabaseConstraintException(
+                sqlite3_errmsg(dbConnection));
+        case SQLITE_BUSY :
+            throw obelisk::DatabaseBusyException();
+            break;
+        case SQLITE_MISUSE :
+            throw obelisk::DatabaseMisuseException();
+            break;
+        default :
+            throw obelisk::DatabaseException(sqlite3_errmsg(dbConnection));
+            break;
+    }
+
+    result = sqlite3_finalize(ppStmt);
+    if (result != SQLITE_OK)
+    {
+        throw obelisk::DatabaseException(sqlite3_errmsg(dbConnection));
+    }
+
+    return sqlite3_changes(dbConnection);
+}
+
+void obelisk::Closure::selectByName(sqlite3* dbConnection, obelisk::Fact& fact)
+{
+    if (dbConnection == nullptr)
+    {
+        throw obelisk::DatabaseException("database isn't open");
+    }
+
+    sqlite3_stmt* ppStmt = nullptr;
+
+    auto result = sqlite3_prepare_v2(dbConnection,
+        "SELECT c.is_true FROM closure c JOIN verb v ON v.id = c.verb JOIN entity le ON le.id = c.left_entity JOIN entity re ON re.id = c.right_entity WHERE (le.name=? AND v.name=? AND re.name=?)",
+        -1,
+        &ppStmt,
+        nullptr);
+    if (result != SQLITE_OK)
+    {
+        throw obelisk::DatabaseException(sqlite3_errmsg(dbConnection));
+    }
+
+    result = sqlite3_bind_text(ppStmt,
+        1,
+        fact.getLeftEntity().getName().c_str(),
+        -1,
+        SQLITE_STATIC);
+    switch (result)
+    {
+        case SQLITE_OK :
+            break;
+        case SQLITE_TOOBIG :
+            throw obelisk::DatabaseSizeException();
+            break;
+        case SQLITE_RANGE :
+            throw obelisk::DatabaseRangeException();
+            break;
+        case SQLITE_NOMEM :
+            throw obelisk::DatabaseMemoryException();
+            break;
+        default :
+            throw obelisk::DatabaseException(sqlite3_errmsg(dbConnection));
+            break;
+    }
+
+    result = sqlite3_bind_text(ppStmt,
+        2,
+        fact.getVerb().getName().c_str(),
+        -1,
+        SQLITE_STATIC);
+    switch (result)
+    {
+        case SQLITE_OK :
+            break;
+        case SQLITE_TOOBIG :
+            throw obelisk::DatabaseSizeException();
+            break;
+        case SQLITE_RANGE :
+            throw obelisk::DatabaseRangeException();
+            break;
+        case SQLITE_NOMEM :
+            throw obelisk::DatabaseMemoryException();
+            break;
+        default :
+            throw obelisk::DatabaseException(sqlite3_errmsg(dbConnection));
+            break;
+    }
+
+    result = sqlite3_bind_text(ppStmt,
+        3,
+        fact.getRightEntity().getName().c_str(),
+        -1,
+        SQLITE_STATIC);
+    switch (result)
+    {
+        case SQLITE_OK :
+            break;
+        case SQLITE_TOOBIG :
+            throw obelisk::DatabaseSizeException();
+            break;
+        case SQLITE_RANGE :
+            throw obelisk::DatabaseRangeException();
+            break;
+        case SQLITE_NOMEM :
+            throw obelisk::DatabaseMemoryException();
+            break;
+        default :
+            throw obelisk::DatabaseException(sqlite3_errmsg(dbConnection));
+            break;
+    }
+
+    result = sqlite3_step(ppStmt);
+    switch (result)
+    {
+        case SQLITE_DONE :
+            // no chain connects the entities
+            break;
+        case SQLITE_ROW :
+            fact.setIsTrue(sqlite3_column_double(ppStmt, 0));
+            break;
+        case SQLITE_BUSY :
+            throw obelisk::DatabaseBusyException();
+            break;
+        case SQLITE_MISUSE :
+            throw obelisk::DatabaseMisuseException();
+            break;
+        default :
+            throw obelisk::DatabaseException(sqlite3_errmsg(dbConnection));
+            break;
+    }
+
+    result = sqlite3_finalize(ppStmt);
+    if (result != SQLITE_OK)
+    {
+        throw obelisk::DatabaseException(sqlite3_errmsg(dbConnection));
+    }
+}
+
+int obelisk::Closure::updateFacts(sqlite3* dbConnection)
+{
+    if (dbConnection == nullptr)
+    {
+        throw obelisk::DatabaseException("database isn't open");
+    }
+
+    sqlite3_stmt* ppStmt = nullptr;
+
+    // the facts are found from the closure so a KnowledgeBase without
+    // transitive verbs doesn't scan its facts
+    auto result = sqlite3_prepare_v2(dbConnection,
+        "UPDATE fact SET is_true = (SELECT c.is_true FROM closure c WHERE c.verb = fact.verb AND c.left_entity = fact.left_entity AND c.right_entity = fact.right_entity) WHERE id IN (SELECT f.id FROM closure c JOIN fact f ON f.left_entity = c.left_entity AND f.right_entity = c.right_entity AND f.verb = c.verb WHERE c.is_true > f.is_true + 1e-9)",
+        -1,
+        &ppStmt,
+        nullptr);
+    if (result != SQLITE_OK)
+    {
+        throw obelisk::DatabaseException(sqlite3_errmsg(dbConnection));
+    }
+
+    result = sqlite3_step(ppStmt);
+    switch (result)
+    {
+        case SQLITE_DONE :
+            // rows updated
+            break;
+        case SQLITE_CONSTRAINT :
+            throw obelisk::DatabaseConstraintException(
+                sqlite3_errmsg(dbConnection));
+        case SQLITE_BUSY :
+            throw obelisk::DatabaseBusyException();
+            break;
+        case SQLITE_MISUSE :
+            throw obelisk::DatabaseMisuseException();
+            break;
+        default :
+            throw obelisk::DatabaseException(sqlite3_errmsg(dbConnection));
+            break;
+    }
+
+    result = sqlite3_finalize(ppStmt);
+    if (result != SQLITE_OK)
+    {
+        throw obelisk::DatabaseException(sqlite3_errmsg(dbConnection));
+    }
+
+    return sqlite3_changes(dbConnection);
+}
@@ -58,7 +58,7 @@ void obelisk::Entity::selectByName(sqlite3* dbConnection)
             // no rows in the database
             break;
         case SQLITE_ROW :
-            setId(sqlite3_column_int(ppStmt, 0));
+            setId(sqlite3_column_int64(ppStmt, 0));
             setName((char*) sqlite3_column_text(ppStmt, 1));
             break;
         case SQLITE_BUSY :
@@ -90,7 +90,7 @@ void obelisk::Entity::insert(sqlite3* dbConnection)
     sqlite3_stmt* ppStmt = nullptr;
 
     auto result = sqlite3_prepare_v2(dbConnection,
-        "INSERT INTO entity (name) VALUES (?)",
+        "INSERT INTO entity (id, name) VALUES (NULLIF(?, 0), ?)",
         -1,
         &ppStmt,
         nullptr);
@@ -99,8 +99,28 @@ void obelisk::Entity::insert(sqlite3* dbConnection)
         throw obelisk::DatabaseException(sqlite3_errmsg(dbConnection));
     }
 
+    // an ID of 0 lets the database pick one
+    result = sqlite3_bind_int64(ppStmt, 1, getId());
+    switch (result)
+    {
+        case SQLITE_OK :
+            break;
+        case SQLITE_TOOBIG :
+            throw obelisk::DatabaseSizeException();
+            break;
+        case SQLITE_RANGE :
+            throw obelisk::DatabaseRangeException();
+            break;
+        case SQLITE_NOMEM :
+            throw obelisk::DatabaseMemoryException();
+            break;
+        default :
+            throw obelisk::DatabaseException(sqlite3_errmsg(dbConnection));
+            break;
+    }
+
     result
-        = sqlite3_bind_text(ppStmt, 1, getName().c_str(), -1, SQLITE_TRANSIENT);
+        = sqlite3_bind_text(ppStmt, 2, getName().c_str(), -1, SQLITE_TRANSIENT);
     switch (result)
     {
         case SQLITE_OK :
@@ -123,7 +143,7 @@ void obelisk::Entity::insert(sqlite3* dbConnection)
     switch (result)
     {
         case SQLITE_DONE :
-            setId((int) sqlite3_last_insert_rowid(dbConnection));
+            setId(sqlite3_last_insert_rowid(dbConnection));
             sqlite3_set_last_insert_rowid(dbConnection, 0);
             break;
         case SQLITE_CONSTRAINT :
@@ -147,12 +167,12 @@ void obelisk::Entity::insert(sqlite3* dbConnection)
     }
 }
 
-int& obelisk::Entity::getId()
+sqlite3_int64& obelisk::Entity::getId()
 {
     return id_;
 }
 
-void obelisk::Entity::setId(int id)
+void obelisk::Entity::setId(sqlite3_int64 id)
 {
     id_ = id;
 }
@@ -9,7 +9,7 @@ const char* obelisk::Fact::createTable()
             "left_entity"  INTEGER NOT NULL,
             "verb"         INTEGER NOT NULL,
             "right_entity" INTEGER NOT NULL,
-            "is_true"      INTEGER NOT NULL DEFAULT 0,
+            "is_true"      REAL NOT NULL DEFAULT 0 CHECK("is_true" >= 0 AND "is_true" <= 1),
             PRIMARY KEY("id" AUTOINCREMENT),
             UNIQUE("left_entity", "right_entity", "verb")
             FOREIGN KEY("verb") REFERENCES "verb"("id") ON DELETE RESTRICT,
@@ -19,6 +19,32 @@ const char* obelisk::Fact::createTable()
     )";
 }
 
+const char* obelisk::Fact::createClusteredTable()
+{
+    return R"(
+        CREATE TABLE "fact" (
+            "id"           INTEGER NOT NULL UNIQUE,
+            "left_entity"  INTEGER NOT NULL,
+            "verb"         INTEGER NOT NULL,
+            "right_entity" INTEGER NOT NULL,
+            "is_true"      REAL NOT NULL DEFAULT 0 CHECK("is_true" >= 0 AND "is_true" <= 1),
+            PRIMARY KEY("left_entity", "right_entity", "verb"),
+            FOREIGN KEY("verb") REFERENCES "verb"("id") ON DELETE RESTRICT,
+            FOREIGN KEY("right_entity") REFERENCES "entity"("id") ON DELETE RESTRICT,
+            FOREIGN KEY("left_entity") REFERENCES "entity"("id") ON DELETE RESTRICT
+        ) WITHOUT ROWID;
+    )";
+}
+
+const char* obelisk::Fact::createIndexes()
+{
+    return R"(
+        CREATE INDEX IF NOT EXISTS "fact_verb_left" ON "fact" ("verb", "left_entity");
+        CREATE INDEX IF NOT EXISTS "fact_verb_right" ON "fact" ("verb", "right_entity");
+        CREATE INDEX IF NOT EXISTS "fact_right" ON "fact" ("right_entity");
+    )";
+}
+
 void obelisk::Fact::selectById(sqlite3* dbConnection)
 {
     if (dbConnection == nullptr)
@@ -47,7 +73,7 @@ void obelisk::Fact::selectById(sqlite3* dbConnection)
 
     if (getId() == 0)
     {
-        result = sqlite3_bind_int(ppStmt, 1, getLeftEntity().getId());
+        result = sqlite3_bind_int64(ppStmt, 1, getLeftEntity().getId());
         switch (result)
         {
             case SQLITE_OK :
@@ -66,7 +92,7 @@ void obelisk::Fact::selectById(sqlite3* dbConnection)
                 break;
         }
 
-        result = sqlite3_bind_int(ppStmt, 2, getRightEntity().getId());
+        result = sqlite3_bind_int64(ppStmt, 2, getRightEntity().getId());
         switch (result)
         {
             case SQLITE_OK :
@@ -85,7 +111,7 @@ void obelisk::Fact::selectById(sqlite3* dbConnection)
                 break;
         }
 
-        result = sqlite3_bind_int(ppStmt, 3, getVerb().getId());
+        result = sqlite3_bind_int64(ppStmt, 3, getVerb().getId());
         switch (result)
         {
             case SQLITE_OK :
@@ -106,7 +132,7 @@ void obelisk::Fact::selectById(sqlite3* dbConnection)
     }
     else
     {
-        result = sqlite3_bind_int(ppStmt, 1, getId());
+        result = sqlite3_bind_int64(ppStmt, 1, getId());
         switch (result)
         {
             case SQLITE_OK :
@@ -133,11 +159,11 @@ void obelisk::Fact::selectById(sqlite3* dbConnection)
             // no rows in the database
             break;
         case SQLITE_ROW :
-            setId(sqlite3_column_int(ppStmt, 0));
-            getLeftEntity().setId(sqlite3_column_int(ppStmt, 1));
-            getRightEntity().setId(sqlite3_column_int(ppStmt, 2));
-            getVerb().setId(sqlite3_column_int(ppStmt, 3));
-            setIsTrue(sqlite3_column_int(ppStmt, 4));
+            setId(sqlite3_column_int64(ppStmt, 0));
+            getLeftEntity().setId(sqlite3_column_int64(ppStmt, 1));
+            getRightEntity().setId(sqlite3_column_int64(ppStmt, 2));
+            getVerb().setId(sqlite3_column_int64(ppStmt, 3));
+            setIsTrue(sqlite3_column_double(ppStmt, 4));
             break;
         case SQLITE_BUSY :
             throw obelisk::DatabaseBusyException();
@@ -252,11 +278,11 @@ void obelisk::Fact::selectByName(sqlite3* dbConnection)
             // no rows in the database
             break;
         case SQLITE_ROW :
-            setId(sqlite3_column_int(ppStmt, 0));
-            getLeftEntity().setId(sqlite3_column_int(ppStmt, 1));
-            getRightEntity().setId(sqlite3_column_int(ppStmt, 2));
-            getVerb().setId(sqlite3_column_int(ppStmt, 3));
-            setIsTrue(sqlite3_column_int(ppStmt, 4));
+            setId(sqlite3_column_int64(ppStmt, 0));
+            getLeftEntity().setId(sqlite3_column_int64(ppStmt, 1));
+            getRightEntity().setId(sqlite3_column_int64(ppStmt, 2));
+            getVerb().setId(sqlite3_column_int64(ppStmt, 3));
+            setIsTrue(sqlite3_column_double(ppStmt, 4));
             break;
         case SQLITE_BUSY :
             throw obelisk::DatabaseBusyException();
@@ -276,6 +302,258 @@ void obelisk::Fact::selectByName(sqlite3* dbConnection)
     }
 }
 
+void obelisk::Fact::selectByVerb(sqlite3* dbConnection,
+    sqlite3_int64 verbId,
+    sqlite3_int64 leftEntityId,
+    sqlite3_int64 rightEntityId,
+    std::vector<obelisk::Fact>& facts)
+{
+    if (dbConnection == nullptr)
+    {
+        throw obelisk::DatabaseException("database isn't open");
+    }
+
+    sqlite3_stmt* ppStmt = nullptr;
+
+    // each shape of the pattern gets its own query so that the matching index
+    // on (verb, left_entity) or (verb, right_entity) is used
+    const char* query;
+    if (leftEntityId != 0 && rightEntityId != 0)
+    {
+        query
+            = "SELECT id, left_entity, right_entity, verb, is_true FROM fact WHERE (verb=? AND left_entity=? AND right_entity=?)";
+    }
+    else if (leftEntityId != 0)
+    {
+        query
+            = "SELECT id, left_entity, right_entity, verb, is_true FROM fact WHERE (verb=? AND left_entity=?)";
+    }
+    else if (rightEntityId != 0)
+    {
+        query
+            = "SELECT id, left_entity, right_entity, verb, is_true FROM fact WHERE (verb=? AND right_entity=?)";
+    }
+    else
+    {
+        query
+            = "SELECT id, left_entity, right_entity, verb, is_true FROM fact WHERE (verb=?)";
+    }
+    auto result = sqlite3_prepare_v2(dbConnection, query, -1, &ppStmt, nullptr);
+    if (result != SQLITE_OK)
+    {
+        throw obelisk::DatabaseException(sqlite3_errmsg(dbConnection));
+    }
+
+    int parameter = 1;
+    result        = sqlite3_bind_int64(ppStmt, parameter++, verbId);
+    switch (result)
+    {
+        case SQLITE_OK :
+            break;
+        case SQLITE_TOOBIG :
+            throw obelisk::DatabaseSizeException();
+            break;
+        case SQLITE_RANGE :
+            throw obelisk::DatabaseRangeException();
+            break;
+        case SQLITE_NOMEM :
+            throw obelisk::DatabaseMemoryException();
+            break;
+        default :
+            throw obelisk::DatabaseException(sqlite3_errmsg(dbConnection));
+            break;
+    }
+
+    if (leftEntityId != 0)
+    {
+        result = sqlite3_bind_int64(ppStmt, parameter++, leftEntityId);
+        switch (result)
+        {
+            case SQLITE_OK :
+                break;
+            case SQLITE_TOOBIG :
+                throw obelisk::DatabaseSizeException();
+                break;
+            case SQLITE_RANGE :
+                throw obelisk::DatabaseRangeException();
+                break;
+            case SQLITE_NOMEM :
+                throw obelisk::DatabaseMemoryException();
+                break;
+            default :
+                throw obelisk::DatabaseException(sqlite3_errmsg(dbConnection));
+                break;
+        }
+    }
+
+    if (rightEntityId != 0)
+    {
+        result = sqlite3_bind_int64(ppStmt, parameter++, rightEntityId);
+        switch (result)
+        {
+            case SQLITE_OK :
+                break;
+            case SQLITE_TOOBIG :
+                throw obelisk::DatabaseSizeException();
+                break;
+            case SQLITE_RANGE :
+                throw obelisk::DatabaseRangeException();
+                break;
+            case SQLITE_NOMEM :
+                throw obelisk::DatabaseMemoryException();
+                break;
+            default :
+                throw obelisk::DatabaseException(sqlite3_errmsg(dbConnection));
+                break;
+        }
+    }
+
+    while ((result = sqlite3_step(ppStmt)) != SQLITE_DONE)
+    {
+        switch (result)
+        {
+            case SQLITE_ROW :
+                facts.push_back(obelisk::Fact(sqlite3_column_int64(ppStmt, 0),
+                    obelisk::Entity(sqlite3_column_int64(ppStmt, 1)),
+                    obelisk::Entity(sqlite3_column_int64(ppStmt, 2)),
+                    obelisk::Verb(sqlite3_column_int64(ppStmt, 3)),
+                    sqlite3_column_double(ppStmt, 4)));
+                break;
+            case SQLITE_BUSY :
+                throw obelisk::DatabaseBusyException();
+                break;
+            case SQLITE_MISUSE :
+                throw obelisk::DatabaseMisuseException();
+                break;
+            default :
+                throw obelisk::DatabaseException(sqlite3_errmsg(dbConnection));
+                break;
+        }
+    }
+
+    result = sqlite3_finalize(ppStmt);
+    if (result != SQLITE_OK)
+    {
+        throw obelisk::DatabaseException(sqlite3_errmsg(dbConnection));
+    }
+}
+
+void obelisk::Fact::selectByEntity(sqlite3* dbConnection,
+    sqlite3_int64 leftEntityId,
+    sqlite3_int64 rightEntityId,
+    std::vector<obelisk::Fact>& facts)
+{
+    if (dbConnection == nullptr)
+    {
+        throw obelisk::DatabaseException("database isn't open");
+    }
+
+    if (leftEntityId == 0 && rightEntityId == 0)
+    {
+        throw obelisk::DatabaseException("an entity is required");
+    }
+
+    sqlite3_stmt* ppStmt = nullptr;
+
+    // the unique constraint indexes the facts by their left entity first and
+    // fact_right indexes them by their right entity
+    const char* query;
+    if (leftEntityId != 0 && rightEntityId != 0)
+    {
+        query
+            = "SELECT id, left_entity, right_entity, verb, is_true FROM fact WHERE (left_entity=? AND right_entity=? AND is_true > 0)";
+    }
+    else if (leftEntityId != 0)
+    {
+        query
+            = "SELECT id, left_entity, right_entity, verb, is_true FROM fact WHERE (left_entity=? AND is_true > 0)";
+    }
+    else
+    {
+        query
+            = "SELECT id, left_entity, right_entity, verb, is_true FROM fact WHERE (right_entity=? AND is_true > 0)";
+    }
+    auto result = sqlite3_prepare_v2(dbConnection, query, -1, &ppStmt, nullptr);
+    if (result != SQLITE_OK)
+    {
+        throw obelisk::DatabaseException(sqlite3_errmsg(dbConnection));
+    }
+
+    int parameter = 1;
+    if (leftEntityId != 0)
+    {
+        result = sqlite3_bind_int64(ppStmt, parameter++, leftEntityId);
+        switch (result)
+        {
+            case SQLITE_OK :
+                break;
+            case SQLITE_TOOBIG :
+                throw obelisk::DatabaseSizeException();
+                break;
+            case SQLITE_RANGE :
+                throw obelisk::DatabaseRangeException();
+                break;
+            case SQLITE_NOMEM :
+                throw obelisk::DatabaseMemoryException();
+                break;
+            default :
+                throw obelisk::DatabaseException(sqlite3_errmsg(dbConnection));
+                break;
+        }
+    }
+
+    if (rightEntityId != 0)
+    {
+        result = sqlite3_bind_int64(ppStmt, parameter++, rightEntityId);
+        switch (result)
+        {
+            case SQLITE_OK :
+                break;
+            case SQLITE_TOOBIG :
+                throw obelisk::DatabaseSizeException();
+                break;
+            case SQLITE_RANGE :
+                throw obelisk::DatabaseRangeException();
+                break;
+            case SQLITE_NOMEM :
+                throw obelisk::DatabaseMemoryException();
+                break;
+            default :
+                throw obelisk::DatabaseException(sqlite3_errmsg(dbConnection));
+                break;
+        }
+    }
+
+    while ((result = sqlite3_step(ppStmt)) != SQLITE_DONE)
+    {
+        switch (result)
+        {
+            case SQLITE_ROW :
+                facts.push_back(obelisk::Fact(sqlite3_column_int64(ppStmt, 0),
+                    obelisk::Entity(sqlite3_column_int64(ppStmt, 1)),
+                    obelisk::Entity(sqlite3_column_int64(ppStmt, 2)),
+                    obelisk::Verb(sqlite3_column_int64(ppStmt, 3)),
+                    sqlite3_column_double(ppStmt, 4)));
+                break;
+            case SQLITE_BUSY :
+                throw obelisk::DatabaseBusyException();
+                break;
+            case SQLITE_MISUSE :
+                throw obelisk::DatabaseMisuseException();
+                break;
+            default :
+                throw obelisk::DatabaseException(sqlite3_errmsg(dbConnection));
+                break;
+        }
+    }
+
+    result = sqlite3_finalize(ppStmt);
+    if (result != SQLITE_OK)
+    {
+        throw obelisk::DatabaseException(sqlite3_errmsg(dbConnection));
+    }
+}
+
 void obelisk::Fact::selectActionByFact(sqlite3* dbConnection,
     obelisk::Action& action)
 {
@@ -287,7 +565,7 @@ void obelisk::Fact::selectActionByFact(sqlite3* dbConnection,
     sqlite3_stmt* ppStmt = nullptr;
 
     auto result = sqlite3_prepare_v2(dbConnection,
-        "SELECT CASE f.is_true WHEN 0 THEN (SELECT name FROM action WHERE id = fa.id) WHEN 1 THEN (SELECT name from action WHERE id = ta.id) END action FROM suggest_action LEFT JOIN action ta ON ta.id = suggest_action.true_action LEFT JOIN action fa ON fa.id = suggest_action.false_action LEFT JOIN fact f ON f.id = suggest_action.fact WHERE (f.id = ?)",
+        "SELECT CASE WHEN ? > 0 THEN (SELECT name from action WHERE id = ta.id) ELSE (SELECT name FROM action WHERE id = fa.id) END action FROM suggest_action LEFT JOIN action ta ON ta.id = suggest_action.true_action LEFT JOIN action fa ON fa.id = suggest_action.false_action LEFT JOIN fact f ON f.id = suggest_action.fact WHERE (f.id = ?)",
         -1,
         &ppStmt,
         nullptr);
@@ -296,7 +574,26 @@ void obelisk::Fact::selectActionByFact(sqlite3* dbConnection,
         throw obelisk::DatabaseException(sqlite3_errmsg(dbConnection));
     }
 
-    result = sqlite3_bind_int(ppStmt, 1, getId());
+    result = sqlite3_bind_double(ppStmt, 1, getIsTrue());
+    switch (result)
+    {
+        case SQLITE_OK :
+            break;
+        case SQLITE_TOOBIG :
+            throw obelisk::DatabaseSizeException();
+            break;
+        case SQLITE_RANGE :
+            throw obelisk::DatabaseRangeException();
+            break;
+        case SQLITE_NOMEM :
+            throw obelisk::DatabaseMemoryException();
+            break;
+        default :
+            throw obelisk::DatabaseException(sqlite3_errmsg(dbConnection));
+            break;
+    }
+
+    result = sqlite3_bind_int64(ppStmt, 2, getId());
     switch (result)
     {
         case SQLITE_OK :
@@ -342,7 +639,8 @@ void obelisk::Fact::selectActionByFact(sqlite3* dbConnection,
     }
 }
 
-void obelisk::Fact::insert(sqlite3* dbConnection)
+void obelisk::Fact::selectActionByName(sqlite3* dbConnection,
+    obelisk::Action& action)
 {
     if (dbConnection == nullptr)
     {
@@ -351,8 +649,10 @@ void obelisk::Fact::insert(sqlite3* dbConnection)
 
     sqlite3_stmt* ppStmt = nullptr;
 
+    // the fact is found through the unique names and the suggested action
+    // through the index on suggest_action, so there is one round trip
     auto result = sqlite3_prepare_v2(dbConnection,
-        "INSERT INTO fact (left_entity, right_entity, verb, is_true) VALUES (?, ?, ?, ?)",
+        "SELECT t.id, t.left_entity, t.right_entity, t.verb, t.is_true, a.name FROM (SELECT f.id, f.left_entity, f.right_entity, f.verb, MAX(f.is_true, IFNULL((SELECT c.is_true FROM closure c WHERE c.verb = f.verb AND c.left_entity = f.left_entity AND c.right_entity = f.right_entity), 0)) is_true FROM entity le JOIN verb v ON v.name=?2 JOIN entity re ON re.name=?3 JOIN fact f ON f.left_entity = le.id AND f.right_entity = re.id AND f.verb = v.id WHERE (le.name=?1)) t LEFT JOIN suggest_action sa ON sa.fact = t.id LEFT JOIN action a ON a.id = CASE WHEN t.is_true > 0 THEN sa.true_action ELSE sa.false_action END LIMIT 1",
         -1,
         &ppStmt,
         nullptr);
@@ -361,7 +661,11 @@ void obelisk::Fact::insert(sqlite3* dbConnection)
         throw obelisk::DatabaseException(sqlite3_errmsg(dbConnection));
     }
 
-    result = sqlite3_bind_int(ppStmt, 1, getLeftEntity().getId());
+    result = sqlite3_bind_text(ppStmt,
+        1,
+        getLeftEntity().getName().c_str(),
+        -1,
+        SQLITE_STATIC);
     switch (result)
     {
         case SQLITE_OK :
@@ -380,7 +684,11 @@ void obelisk::Fact::insert(sqlite3* dbConnection)
             break;
     }
 
-    result = sqlite3_bind_int(ppStmt, 2, getRightEntity().getId());
+    result = sqlite3_bind_text(ppStmt,
+        2,
+        getVerb().getName().c_str(),
+        -1,
+        SQLITE_STATIC);
     switch (result)
     {
         case SQLITE_OK :
@@ -399,7 +707,11 @@ void obelisk::Fact::insert(sqlite3* dbConnection)
             break;
     }
 
-    result = sqlite3_bind_int(ppStmt, 3, getVerb().getId());
+    result = sqlite3_bind_text(ppStmt,
+        3,
+        getRightEntity().getName().c_str(),
+        -1,
+        SQLITE_STATIC);
     switch (result)
     {
         case SQLITE_OK :
@@ -418,7 +730,122 @@ void obelisk::Fact::insert(sqlite3* dbConnection)
             break;
     }
 
-    result = sqlite3_bind_int(ppStmt, 4, getIsTrue());
+    result = sqlite3_step(ppStmt);
+    switch (result)
+    {
+        case SQLITE_DONE :
+            // no rows in the database
+            break;
+        case SQLITE_ROW :
+            setId(sqlite3_column_int64(ppStmt, 0));
+            getLeftEntity().setId(sqlite3_column_int64(ppStmt, 1));
+            getRightEntity().setId(sqlite3_column_int64(ppStmt, 2));
+            getVerb().setId(sqlite3_column_int64(ppStmt, 3));
+            setIsTrue(sqlite3_column_double(ppStmt, 4));
+            if (sqlite3_column_type(ppStmt, 5) != SQLITE_NULL)
+            {
+                action.setName((char*) sqlite3_column_text(ppStmt, 5));
+            }
+            break;
+        case SQLITE_BUSY :
+            throw obelisk::DatabaseBusyException();
+            break;
+        case SQLITE_MISUSE :
+            throw obelisk::DatabaseMisuseException();
+            break;
+        default :
+            throw obelisk::DatabaseException(sqlite3_errmsg(dbConnection));
+            break;
+    }
+
+    result = sqlite3_finalize(ppStmt);
+    if (result != SQLITE_OK)
+    {
+        throw obelisk::DatabaseException(sqlite3_errmsg(dbConnection));
+    }
+}
+
+void obelisk::Fact::insert(sqlite3* dbConnection, bool clustered)
+{
+    if (dbConnection == nullptr)
+    {
+        throw obelisk::DatabaseException("database isn't open");
+    }
+
+    sqlite3_stmt* ppStmt = nullptr;
+
+    // a clustered table has no rowid to read the ID back from, so the ID is
+    // assigned by the query instead
+    auto result = sqlite3_prepare_v2(dbConnection,
+        clustered
+            ? "INSERT INTO fact (id, left_entity, right_entity, verb, is_true) VALUES ((SELECT IFNULL(MAX(id), 0) + 1 FROM fact), ?, ?, ?, ?) RETURNING id"
+            : "INSERT INTO fact (left_entity, right_entity, verb, is_true) VALUES (?, ?, ?, ?)",
+        -1,
+        &ppStmt,
+        nullptr);
+    if (result != SQLITE_OK)
+    {
+        throw obelisk::DatabaseException(sqlite3_errmsg(dbConnection));
+    }
+
+    result = sqlite3_bind_int64(ppStmt, 1, getLeftEntity().getId());
+    switch (result)
+    {
+        case SQLITE_OK :
+            break;
+        case SQLITE_TOOBIG :
+            throw obelisk::DatabaseSizeException();
+            break;
+        case SQLITE_RANGE :
+            throw obelisk::DatabaseRangeException();
+            break;
+        case SQLITE_NOMEM :
+            throw obelisk::DatabaseMemoryException();
+            break;
+        default :
+            throw obelisk::DatabaseException(sqlite3_errmsg(dbConnection));
+            break;
+    }
+
+    result = sqlite3_bind_int64(ppStmt, 2, getRightEntity().getId());
+    switch (result)
+    {
+        case SQLITE_OK :
+            break;
+        case SQLITE_TOOBIG :
+            throw obelisk::DatabaseSizeException();
+            break;
+        case SQLITE_RANGE :
+            throw obelisk::DatabaseRangeException();
+            break;
+        case SQLITE_NOMEM :
+            throw obelisk::DatabaseMemoryException();
+            break;
+        default :
+            throw obelisk::DatabaseException(sqlite3_errmsg(dbConnection));
+            break;
+    }
+
+    result = sqlite3_bind_int64(ppStmt, 3, getVerb().getId());
+    switch (result)
+    {
+        case SQLITE_OK :
+            break;
+        case SQLITE_TOOBIG :
+            throw obelisk::DatabaseSizeException();
+            break;
+        case SQLITE_RANGE :
+            throw obelisk::DatabaseRangeException();
+            break;
+        case SQLITE_NOMEM :
+            throw obelisk::DatabaseMemoryException();
+            break;
+        default :
+            throw obelisk::DatabaseException(sqlite3_errmsg(dbConnection));
+            break;
+    }
+
+    result = sqlite3_bind_double(ppStmt, 4, getIsTrue());
     switch (result)
     {
         case SQLITE_OK :
@@ -440,8 +867,11 @@ void obelisk::Fact::insert(sqlite3* dbConnection)
     result = sqlite3_step(ppStmt);
     switch (result)
     {
+        case SQLITE_ROW :
+            setId(sqlite3_column_int64(ppStmt, 0));
+            break;
         case SQLITE_DONE :
-            setId((int) sqlite3_last_insert_rowid(dbConnection));
+            setId(sqlite3_last_insert_rowid(dbConnection));
             sqlite3_set_last_insert_rowid(dbConnection, 0);
             break;
         case SQLITE_CONSTRAINT :
@@ -484,7 +914,7 @@ void obelisk::Fact::updateIsTrue(sqlite3* dbConnection)
         throw obelisk::DatabaseException(sqlite3_errmsg(dbConnection));
     }
 
-    result = sqlite3_bind_int(ppStmt, 1, getIsTrue());
+    result = sqlite3_bind_double(ppStmt, 1, getIsTrue());
     switch (result)
     {
         case SQLITE_OK :
@@ -503,7 +933,7 @@ void obelisk::Fact::updateIsTrue(sqlite3* dbConnection)
             break;
     }
 
-    result = sqlite3_bind_int(ppStmt, 2, getId());
+    result = sqlite3_bind_int64(ppStmt, 2, getId());
     switch (result)
     {
         case SQLITE_OK :
@@ -549,12 +979,12 @@ void obelisk::Fact::updateIsTrue(sqlite3* dbConnection)
     }
 }
 
-int& obelisk::Fact::getId()
+sqlite3_int64& obelisk::Fact::getId()
 {
     return id_;
 }
 
-void obelisk::Fact::setId(int id)
+void obelisk::Fact::setId(sqlite3_int64 id)
 {
     id_ = id;
 }
@@ -0,0 +1,972 @@
+#include "models/error.h"
+#include "models/pattern_rule.h"
+
+const char* obelisk::PatternRule::createTable()
+{
+    return R"(
+        CREATE TABLE "pattern_rule" (
+            "id"                    INTEGER NOT NULL UNIQUE,
+            "left_entity"           INTEGER,
+            "left_variable"         TEXT NOT NULL DEFAULT '',
+            "verb"                  INTEGER NOT NULL,
+            "right_entity"          INTEGER,
+            "right_variable"        TEXT NOT NULL DEFAULT '',
+            "reason_left_entity"    INTEGER,
+            "reason_left_variable"  TEXT NOT NULL DEFAULT '',
+            "reason_verb"           INTEGER NOT NULL,
+            "reason_right_entity"   INTEGER,
+            "reason_right_variable" TEXT NOT NULL DEFAULT '',
+            "weight"                REAL NOT NULL DEFAULT 1 CHECK("weight" >= 0 AND "weight" <= 1),
+            PRIMARY KEY("id" AUTOINCREMENT),
+            CHECK(("left_entity" IS NULL) = ("left_variable" != '')),
+            CHECK(("right_entity" IS NULL) = ("right_variable" != '')),
+            CHECK(("reason_left_entity" IS NULL) = ("reason_left_variable" != '')),
+            CHECK(("reason_right_entity" IS NULL) = ("reason_right_variable" != '')),
+            FOREIGN KEY("left_entity") REFERENCES "entity"("id") ON DELETE RESTRICT,
+            FOREIGN KEY("verb") REFERENCES "verb"("id") ON DELETE RESTRICT,
+            FOREIGN KEY("right_entity") REFERENCES "entity"("id") ON DELETE RESTRICT,
+            FOREIGN KEY("reason_left_entity") REFERENCES "entity"("id") ON DELETE RESTRICT,
+            FOREIGN KEY("reason_verb") REFERENCES "verb"("id") ON DELETE RESTRICT,
+            FOREIGN KEY("reason_right_entity") REFERENCES "entity"("id") ON DELETE RESTRICT
+        );
+        CREATE UNIQUE INDEX "pattern_rule_unique" ON "pattern_rule" (
+            IFNULL("left_entity", 0), "left_variable", "verb",
+            IFNULL("right_entity", 0), "right_variable",
+            IFNULL("reason_left_entity", 0), "reason_left_variable", "reason_verb",
+            IFNULL("reason_right_entity", 0), "reason_right_variable"
+        );
+        CREATE INDEX "pattern_rule_verb" ON "pattern_rule" ("verb");
+        CREATE INDEX "pattern_rule_reason_verb" ON "pattern_rule" ("reason_verb");
+    )";
+}
+
+void obelisk::PatternRule::selectById(sqlite3* dbConnection)
+{
+    if (dbConnection == nullptr)
+    {
+        throw obelisk::DatabaseException("database isn't open");
+    }
+
+    sqlite3_stmt* ppStmt = nullptr;
+
+    auto result = sqlite3_prepare_v2(dbConnection,
+        "SELECT id FROM pattern_rule WHERE (left_entity IS ? AND left_variable=? AND verb=? AND right_entity IS ? AND right_variable=? AND reason_left_entity IS ? AND reason_left_variable=? AND reason_verb=? AND reason_right_entity IS ? AND reason_right_variable=?)",
+        -1,
+        &ppStmt,
+        nullptr);
+    if (result != SQLITE_OK)
+    {
+        throw obelisk::DatabaseException(sqlite3_errmsg(dbConnection));
+    }
+
+    if (getFactLeftVariable() == "")
+    {
+        result
+            = sqlite3_bind_int64(ppStmt, 1, getFact().getLeftEntity().getId());
+    }
+    else
+    {
+        result = sqlite3_bind_null(ppStmt, 1);
+    }
+    switch (result)
+    {
+        case SQLITE_OK :
+            break;
+        case SQLITE_TOOBIG :
+            throw obelisk::DatabaseSizeException();
+            break;
+        case SQLITE_RANGE :
+            throw obelisk::DatabaseRangeException();
+            break;
+        case SQLITE_NOMEM :
+            throw obelisk::DatabaseMemoryException();
+            break;
+        default :
+            throw obelisk::DatabaseException(sqlite3_errmsg(dbConnection));
+            break;
+    }
+
+    result = sqlite3_bind_text(ppStmt,
+        2,
+        getFactLeftVariable().c_str(),
+        -1,
+        SQLITE_STATIC);
+    switch (result)
+    {
+        case SQLITE_OK :
+            break;
+        case SQLITE_TOOBIG :
+            throw obelisk::DatabaseSizeException();
+            break;
+        case SQLITE_RANGE :
+            throw obelisk::DatabaseRangeException();
+            break;
+        case SQLITE_NOMEM :
+            throw obelisk::DatabaseMemoryException();
+            break;
+        default :
+            throw obelisk::DatabaseException(sqlite3_errmsg(dbConnection));
+            break;
+    }
+
+    result = sqlite3_bind_int64(ppStmt, 3, getFact().getVerb().getId());
+    switch (result)
+    {
+        case SQLITE_OK :
+            break;
+        case SQLITE_TOOBIG :
+            throw obelisk::DatabaseSizeException();
+            break;
+        case SQLITE_RANGE :
+            throw obelisk::DatabaseRangeException();
+            break;
+        case SQLITE_NOMEM :
+            throw obelisk::DatabaseMemoryException();
+            break;
+        default :
+            throw obelisk::DatabaseException(sqlite3_errmsg(dbConnection));
+            break;
+    }
+
+    if (getFactRightVariable() == "")
+    {
+        result
+            = sqlite3_bind_int64(ppStmt, 4, getFact().getRightEntity().getId());
+    }
+    else
+    {
+        result = sqlite3_bind_null(ppStmt, 4);
+    }
+    switch (result)
+    {
+        case SQLITE_OK :
+            break;
+        case SQLITE_TOOBIG :
+            throw obelisk::DatabaseSizeException();
+            break;
+        case SQLITE_RANGE :
+            throw obelisk::DatabaseRangeException();
+            break;
+        case SQLITE_NOMEM :
+            throw obelisk::DatabaseMemoryException();
+            break;
+        default :
+            throw obelisk::DatabaseException(sqlite3_errmsg(dbConnection));
+            break;
+    }
+
+    result = sqlite3_bind_text(ppStmt,
+        5,
+        getFactRightVariable().c_str(),
+        -1,
+        SQLITE_STATIC);
+    switch (result)
+    {
+        case SQLITE_OK :
+            break;
+        case SQLITE_TOOBIG :
+            throw obelisk::DatabaseSizeException();
+            break;
+        case SQLITE_RANGE :
+            throw obelisk::DatabaseRangeException();
+            break;
+        case SQLITE_NOMEM :
+            throw obelisk::DatabaseMemoryException();
+            break;
+        default :
+            throw obelisk::DatabaseException(sqlite3_errmsg(dbConnection));
+            break;
+    }
+
+    if (getReasonLeftVariable() == "")
+    {
+        result = sqlite3_bind_int64(ppStmt,
+            6,
+            getReason().getLeftEntity().getId());
+    }
+    else
+    {
+        result = sqlite3_bind_null(ppStmt, 6);
+    }
+    switch (result)
+    {
+        case SQLITE_OK :
+            break;
+        case SQLITE_TOOBIG :
+            throw obelisk::DatabaseSizeException();
+            break;
+        case SQLITE_RANGE :
+            throw obelisk::DatabaseRangeException();
+            break;
+        case SQLITE_NOMEM :
+            throw obelisk::DatabaseMemoryException();
+            break;
+        default :
+            throw obelisk::DatabaseException(sqlite3_errmsg(dbConnection));
+            break;
+    }
+
+    result = sqlite3_bind_text(ppStmt,
+        7,
+        getReasonLeftVariable().c_str(),
+        -1,
+        SQLITE_STATIC);
+    switch (result)
+    {
+        case SQLITE_OK :
+            break;
+        case SQLITE_TOOBIG :
+            throw obelisk::DatabaseSizeException();
+            break;
+        case SQLITE_RANGE :
+            throw obelisk::DatabaseRangeException();
+            break;
+        case SQLITE_NOMEM :
+            throw obelisk::DatabaseMemoryException();
+            break;
+        default :
+            throw obelisk::DatabaseException(sqlite3_errmsg(dbConnection));
+            break;
+    }
+
+    result = sqlite3_bind_int64(ppStmt, 8, getReason().getVerb().getId());
+    switch (result)
+    {
+        case SQLITE_OK :
+            break;
+        case SQLITE_TOOBIG :
+            throw obelisk::DatabaseSizeException();
+            break;
+        case SQLITE_RANGE :
+            throw obelisk::DatabaseRangeException();
+            break;
+        case SQLITE_NOMEM :
+            throw obelisk::DatabaseMemoryException();
+            break;
+        default :
+            throw obelisk::DatabaseException(sqlite3_errmsg(dbConnection));
+            break;
+    }
+
+    if (getReasonRightVariable() == "")
+    {
+        result = sqlite3_bind_int64(ppStmt,
+            9,
+            getReason().getRightEntity().getId());
+    }
+    else
+    {
+        result = sqlite3_bind_null(ppStmt, 9);
+    }
+    switch (result)
+    {
+        case SQLITE_OK :
+            break;
+        case SQLITE_TOOBIG :
+            throw obelisk::DatabaseSizeException();
+            break;
+        case SQLITE_RANGE :
+            throw obelisk::DatabaseRangeException();
+            break;
+        case SQLITE_NOMEM :
+            throw obelisk::DatabaseMemoryException();
+            break;
+        default :
+            throw obelisk::DatabaseException(sqlite3_errmsg(dbConnection));
+            break;
+    }
+
+    result = sqlite3_bind_text(ppStmt,
+        10,
+        getReasonRightVariable().c_str(),
+        -1,
+        SQLITE_STATIC);
+    switch (result)
+    {
+        case SQLITE_OK :
+            break;
+        case SQLITE_TOOBIG :
+            throw obelisk::DatabaseSizeException();
+            break;
+        case SQLITE_RANGE :
+            throw obelisk::DatabaseRangeException();
+            break;
+        case SQLITE_NOMEM :
+            throw obelisk::DatabaseMemoryException();
+            break;
+        default :
+            throw obelisk::DatabaseException(sqlite3_errmsg(dbConnection));
+            break;
+    }
+
+    result = sqlite3_step(ppStmt);
+    switch (result)
+    {
+        case SQLITE_DONE :
+            // no rows in the database
+            break;
+        case SQLITE_ROW :
+            setId(sqlite3_column_int64(ppStmt, 0));
+            break;
+        case SQLITE_BUSY :
+            throw obelisk::DatabaseBusyException();
+            break;
+        case SQLITE_MISUSE :
+            throw obelisk::DatabaseMisuseException();
+            break;
+        default :
+            throw obelisk::DatabaseException(sqlite3_errmsg(dbConnection));
+            break;
+    }
+
+    result = sqlite3_finalize(ppStmt);
+    if (result != SQLITE_OK)
+    {
+        throw obelisk::DatabaseException(sqlite3_errmsg(dbConnection));
+    }
+}
+
+void obelisk::PatternRule::selectByReasonVerb(sqlite3* dbConnection,
+    sqlite3_int64 verbId,
+    std::vector<obelisk::PatternRule>& patternRules)
+{
+    if (dbConnection == nullptr)
+    {
+        throw obelisk::DatabaseException("database isn't open");
+    }
+
+    sqlite3_stmt* ppStmt = nullptr;
+
+    auto result = sqlite3_prepare_v2(dbConnection,
+        "SELECT id, left_entity, left_variable, verb, right_entity, right_variable, reason_left_entity, reason_left_variable, reason_verb, reason_right_entity, reason_right_variable, weight FROM pattern_rule WHERE (reason_verb=?)",
+        -1,
+        &ppStmt,
+        nullptr);
+    if (result != SQLITE_OK)
+    {
+        throw obelisk::DatabaseException(sqlite3_errmsg(dbConnection));
+    }
+
+    result = sqlite3_bind_int64(ppStmt, 1, verbId);
+    switch (result)
+    {
+        case SQLITE_OK :
+            break;
+        case SQLITE_TOOBIG :
+            throw obelisk::DatabaseSizeException();
+            break;
+        case SQLITE_RANGE :
+            throw obelisk::DatabaseRangeException();
+            break;
+        case SQLITE_NOMEM :
+            throw obelisk::DatabaseMemoryException();
+            break;
+        default :
+            throw obelisk::DatabaseException(sqlite3_errmsg(dbConnection));
+            break;
+    }
+
+    while ((result = sqlite3_step(ppStmt)) != SQLITE_DONE)
+    {
+        switch (result)
+        {
+            case SQLITE_ROW :
+                {
+                    obelisk::PatternRule patternRule(
+                        sqlite3_column_int64(ppStmt, 0));
+                    patternRule.getFact().getLeftEntity().setId(
+                        sqlite3_column_int64(ppStmt, 1));
+                    patternRule.setFactLeftVariable(
+                        (char*) sqlite3_column_text(ppStmt, 2));
+                    patternRule.getFact().getVerb().setId(
+                        sqlite3_column_int64(ppStmt, 3));
+                    patternRule.getFact().getRightEntity().setId(
+                        sqlite3_column_int64(ppStmt, 4));
+                    patternRule.setFactRightVariable(
+                        (char*) sqlite3_column_text(ppStmt, 5));
+                    patternRule.getReason().getLeftEntity().setId(
+                        sqlite3_column_int64(ppStmt, 6));
+                    patternRule.setReasonLeftVariable(
+                        (char*) sqlite3_column_text(ppStmt, 7));
+                    patternRule.getReason().getVerb().setId(
+                        sqlite3_column_int64(ppStmt, 8));
+                    patternRule.getReason().getRightEntity().setId(
+                        sqlite3_column_int64(ppStmt, 9));
+                    patternRule.setReasonRightVariable(
+                        (char*) sqlite3_column_text(ppStmt, 10));
+                    patternRule.setWeight(sqlite3_column_double(ppStmt, 11));
+                    patternRules.push_back(patternRule);
+                }
+                break;
+            case SQLITE_BUSY :
+                throw obelisk::DatabaseBusyException();
+                break;
+            case SQLITE_MISUSE :
+                throw obelisk::DatabaseMisuseException();
+                break;
+            default :
+                throw obelisk::DatabaseException(sqlite3_errmsg(dbConnection));
+                break;
+        }
+    }
+
+    result = sqlite3_finalize(ppStmt);
+    if (result != SQLITE_OK)
+    {
+        throw obelisk::DatabaseException(sqlite3_errmsg(dbConnection));
+    }
+}
+
+void obelisk::PatternRule::selectByVerb(sqlite3* dbConnection,
+    sqlite3_int64 verbId,
+    std::vector<obelisk::PatternRule>& patternRules)
+{
+    if (dbConnection == nullptr)
+    {
+        throw obelisk::DatabaseException("database isn't open");
+    }
+
+    sqlite3_stmt* ppStmt = nullptr;
+
+    auto result = sqlite3_prepare_v2(dbConnection,
+        "SELECT id, left_entity, left_variable, verb, right_entity, right_variable, reason_left_entity, reason_left_variable, reason_verb, reason_right_entity, reason_right_variable, weight FROM pattern_rule WHERE (verb=?)",
+        -1,
+        &ppStmt,
+        nullptr);
+    if (result != SQLITE_OK)
+    {
+        throw obelisk::DatabaseException(sqlite3_errmsg(dbConnection));
+    }
+
+    result = sqlite3_bind_int64(ppStmt, 1, verbId);
+    switch (result)
+    {
+        case SQLITE_OK :
+            break;
+        case SQLITE_TOOBIG :
+            throw obelisk::DatabaseSizeException();
+            break;
+        case SQLITE_RANGE :
+            throw obelisk::DatabaseRangeException();
+            break;
+        case SQLITE_NOMEM :
+            throw obelisk::DatabaseMemoryException();
+            break;
+        default :
+            throw obelisk::DatabaseException(sqlite3_errmsg(dbConnection));
+            break;
+    }
+
+    while ((result = sqlite3_step(ppStmt)) != SQLITE_DONE)
+    {
+        switch (result)
+        {
+            case SQLITE_ROW :
+                {
+                    obelisk::PatternRule patternRule(
+                        sqlite3_column_int64(ppStmt, 0));
+                    patternRule.getFact().getLeftEntity().setId(
+                        sqlite3_column_int64(ppStmt, 1));
+                    patternRule.setFactLeftVariable(
+                        (char*) sqlite3_column_text(ppStmt, 2));
+                    patternRule.getFact().getVerb().setId(
+                        sqlite3_column_int64(ppStmt, 3));
+                    patternRule.getFact().getRightEntity().setId(
+                        sqlite3_column_int64(ppStmt, 4));
+                    patternRule.setFactRightVariable(
+                        (char*) sqlite3_column_text(ppStmt, 5));
+                    patternRule.getReason().getLeftEntity().setId(
+                        sqlite3_column_int64(ppStmt, 6));
+                    patternRule.setReasonLeftVariable(
+                        (char*) sqlite3_column_text(ppStmt, 7));
+                    patternRule.getReason().getVerb().setId(
+                        sqlite3_column_int64(ppStmt, 8));
+                    patternRule.getReason().getRightEntity().setId(
+                        sqlite3_column_int64(ppStmt, 9));
+                    patternRule.setReasonRightVariable(
+                        (char*) sqlite3_column_text(ppStmt, 10));
+                    patternRule.setWeight(sqlite3_column_double(ppStmt, 11));
+                    patternRules.push_back(patternRule);
+                }
+                break;
+            case SQLITE_BUSY :
+                throw obelisk::DatabaseBusyException();
+                break;
+            case SQLITE_MISUSE :
+                throw obelisk::DatabaseMisuseException();
+                break;
+            default :
+                throw obelisk::DatabaseException(sqlite3_errmsg(dbConnection));
+                break;
+        }
+    }
+
+    result = sqlite3_finalize(ppStmt);
+    if (result != SQLITE_OK)
+    {
+        throw obelisk::DatabaseException(sqlite3_errmsg(dbConnection));
+    }
+}
+
+void obelisk::PatternRule::selectAll(sqlite3* dbConnection,
+    std::vector<obelisk::PatternRule>& patternRules)
+{
+    if (dbConnection == nullptr)
+    {
+        throw obelisk::DatabaseException("database isn't open");
+    }
+
+    sqlite3_stmt* ppStmt = nullptr;
+
+    auto result = sqlite3_prepare_v2(dbConnection,
+        "SELECT id, left_entity, left_variable, verb, right_entity, right_variable, reason_left_entity, reason_left_variable, reason_verb, reason_right_entity, reason_right_variable, weight FROM pattern_rule",
+        -1,
+        &ppStmt,
+        nullptr);
+    if (result != SQLITE_OK)
+    {
+        throw obelisk::DatabaseException(sqlite3_errmsg(dbConnection));
+    }
+
+    while ((result = sqlite3_step(ppStmt)) != SQLITE_DONE)
+    {
+        switch (result)
+        {
+            case SQLITE_ROW :
+                {
+                    obelisk::PatternRule patternRule(
+                        sqlite3_column_int64(ppStmt, 0));
+                    patternRule.getFact().getLeftEntity().setId(
+                        sqlite3_column_int64(ppStmt, 1));
+                    patternRule.setFactLeftVariable(
+                        (char*) sqlite3_column_text(ppStmt, 2));
+                    patternRule.getFact().getVerb().setId(
+                        sqlite3_column_int64(ppStmt, 3));
+                    patternRule.getFact().getRightEntity().setId(
+                        sqlite3_column_int64(ppStmt, 4));
+                    patternRule.setFactRightVariable(
+                        (char*) sqlite3_column_text(ppStmt, 5));
+                    patternRule.getReason().getLeftEntity().setId(
+                        sqlite3_column_int64(ppStmt, 6));
+                    patternRule.setReasonLeftVariable(
+                        (char*) sqlite3_column_text(ppStmt, 7));
+                    patternRule.getReason().getVerb().setId(
+                        sqlite3_column_int64(ppStmt, 8));
+                    patternRule.getReason().getRightEntity().setId(
+                        sqlite3_column_int64(ppStmt, 9));
+                    patternRule.setReasonRightVariable(
+                        (char*) sqlite3_column_text(ppStmt, 10));
+                    patternRule.setWeight(sqlite3_column_double(ppStmt, 11));
+                    patternRules.push_back(patternRule);
+                }
+                break;
+            case SQLITE_BUSY :
+                throw obelisk::DatabaseBusyException();
+                break;
+            case SQLITE_MISUSE :
+                throw obelisk::DatabaseMisuseException();
+                break;
+            default :
+                throw obelisk::DatabaseException(sqlite3_errmsg(dbConnection));
+                break;
+        }
+    }
+
+    result = sqlite3_finalize(ppStmt);
+    if (result != SQLITE_OK)
+    {
+        throw obelisk::DatabaseException(sqlite3_errmsg(dbConnection));
+    }
+}
+
+void obelisk::PatternRule::insert(sqlite3* dbConnection)
+{
+    if (dbConnection == nullptr)
+    {
+        throw obelisk::DatabaseException("database isn't open");
+    }
+
+    sqlite3_stmt* ppStmt = nullptr;
+
+    auto result = sqlite3_prepare_v2(dbConnection,
+        "INSERT INTO pattern_rule (left_entity, left_variable, verb, right_entity, right_variable, reason_left_entity, reason_left_variable, reason_verb, reason_right_entity, reason_right_variable, weight) VALUES (?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?)",
+        -1,
+        &ppStmt,
+        nullptr);
+    if (result != SQLITE_OK)
+    {
+        throw obelisk::DatabaseException(sqlite3_errmsg(dbConnection));
+    }
+
+    if (getFactLeftVariable() == "")
+    {
+        result
+            = sqlite3_bind_int64(ppStmt, 1, getFact().getLeftEntity().getId());
+    }
+    else
+    {
+        result = sqlite3_bind_null(ppStmt, 1);
+    }
+    switch (result)
+    {
+        case SQLITE_OK :
+            break;
+        case SQLITE_TOOBIG :
+            throw obelisk::DatabaseSizeException();
+            break;
+        case SQLITE_RANGE :
+            throw obelisk::DatabaseRangeException();
+            break;
+        case SQLITE_NOMEM :
+            throw obelisk::DatabaseMemoryException();
+            break;
+        default :
+            throw obelisk::DatabaseException(sqlite3_errmsg(dbConnection));
+            break;
+    }
+
+    result = sqlite3_bind_text(ppStmt,
+        2,
+        getFactLeftVariable().c_str(),
+        -1,
+        SQLITE_STATIC);
+    switch (result)
+    {
+        case SQLITE_OK :
+            break;
+        case SQLITE_TOOBIG :
+            throw obelisk::DatabaseSizeException();
+            break;
+        case SQLITE_RANGE :
+            throw obelisk::DatabaseRangeException();
+            break;
+        case SQLITE_NOMEM :
+            throw obelisk::DatabaseMemoryException();
+            break;
+        default :
+            throw obelisk::DatabaseException(sqlite3_errmsg(dbConnection));
+            break;
+    }
+
+    result = sqlite3_bind_int64(ppStmt, 3, getFact().getVerb().getId());
+    switch (result)
+    {
+        case SQLITE_OK :
+            break;
+        case SQLITE_TOOBIG :
+            throw obelisk::DatabaseSizeException();
+            break;
+        case SQLITE_RANGE :
+            throw obelisk::DatabaseRangeException();
+            break;
+        case SQLITE_NOMEM :
+            throw obelisk::DatabaseMemoryException();
+            break;
+        default :
+            throw obelisk::DatabaseException(sqlite3_errmsg(dbConnection));
+            break;
+    }
+
+    if (getFactRightVariable() == "")
+    {
+        result
+            = sqlite3_bind_int64(ppStmt, 4, getFact().getRightEntity().getId());
+    }
+    else
+    {
+        result = sqlite3_bind_null(ppStmt, 4);
+    }
+    switch (result)
+    {
+        case SQLITE_OK :
+            break;
+        case SQLITE_TOOBIG :
+            throw obelisk::DatabaseSizeException();
+            break;
+        case SQLITE_RANGE :
+            throw obelisk::DatabaseRangeException();
+            break;
+        case SQLITE_NOMEM :
+            throw obelisk::DatabaseMemoryException();
+            break;
+        default :
+            throw obelisk::DatabaseException(sqlite3_errmsg(dbConnection));
+            break;
+    }
+
+    result = sqlite3_bind_text(ppStmt,
+        5,
+        getFactRightVariable().c_str(),
+        -1,
+        SQLITE_STATIC);
+    switch (result)
+    {
+        case SQLITE_OK :
+            break;
+        case SQLITE_TOOBIG :
+            throw obelisk::DatabaseSizeException();
+            break;
+        case SQLITE_RANGE :
+            throw obelisk::DatabaseRangeException();
+            break;
+        case SQLITE_NOMEM :
+            throw obelisk::DatabaseMemoryException();
+            break;
+        default :
+            throw obelisk::DatabaseException(sqlite3_errmsg(dbConnection));
+            break;
+    }
+
+    if (getReasonLeftVariable() == "")
+    {
+        result = sqlite3_bind_int64(ppStmt,
+            6,
+            getReason().getLeftEntity().getId());
+    }
+    else
+    {
+        result = sqlite3_bind_null(ppStmt, 6);
+    }
+    switch (result)
+    {
+        case SQLITE_OK :
+            break;
+        case SQLITE_TOOBIG :
+            throw obelisk::DatabaseSizeException();
+            break;
+        case SQLITE_RANGE :
+            throw obelisk::DatabaseRangeException();
+            break;
+        case SQLITE_NOMEM :
+            throw obelisk::DatabaseMemoryException();
+            break;
+        default :
+            throw obelisk::DatabaseException(sqlite3_errmsg(dbConnection));
+            break;
+    }
+
+    result = sqlite3_bind_text(ppStmt,
+        7,
+        getReasonLeftVariable().c_str(),
+        -1,
+        SQLITE_STATIC);
+    switch (result)
+    {
+        case SQLITE_OK :
+            break;
+        case SQLITE_TOOBIG :
+            throw obelisk::DatabaseSizeException();
+            break;
+        case SQLITE_RANGE :
+            throw obelisk::DatabaseRangeException();
+            break;
+        case SQLITE_NOMEM :
+            throw obelisk::DatabaseMemoryException();
+            break;
+        default :
+            throw obelisk::DatabaseException(sqlite3_errmsg(dbConnection));
+            break;
+    }
+
+    result = sqlite3_bind_int64(ppStmt, 8, getReason().getVerb().getId());
+    switch (result)
+    {
+        case SQLITE_OK :
+            break;
+        case SQLITE_TOOBIG :
+            throw obelisk::DatabaseSizeException();
+            break;
+        case SQLITE_RANGE :
+            throw obelisk::DatabaseRangeException();
+            break;
+        case SQLITE_NOMEM :
+            throw obelisk::DatabaseMemoryException();
+            break;
+        default :
+            throw obelisk::DatabaseException(sqlite3_errmsg(dbConnection));
+            break;
+    }
+
+    if (getReasonRightVariable() == "")
+    {
+        result = sqlite3_bind_int64(ppStmt,
+            9,
+            getReason().getRightEntity().getId());
+    }
+    else
+    {
+        result = sqlite3_bind_null(ppStmt, 9);
+    }
+    switch (result)
+    {
+        case SQLITE_OK :
+            break;
+        case SQLITE_TOOBIG :
+            throw obelisk::DatabaseSizeException();
+            break;
+        case SQLITE_RANGE :
+            throw obelisk::DatabaseRangeException();
+            break;
+        case SQLITE_NOMEM :
+            throw obelisk::DatabaseMemoryException();
+            break;
+        default :
+            throw obelisk::DatabaseException(sqlite3_errmsg(dbConnection));
+            break;
+    }
+
+    result = sqlite3_bind_text(ppStmt,
+        10,
+        getReasonRightVariable().c_str(),
+        -1,
+        SQLITE_STATIC);
+    switch (result)
+    {
+        case SQLITE_OK :
+            break;
+        case SQLITE_TOOBIG :
+            throw obelisk::DatabaseSizeException();
+            break;
+        case SQLITE_RANGE :
+            throw obelisk::DatabaseRangeException();
+            break;
+        case SQLITE_NOMEM :
+            throw obelisk::DatabaseMemoryException();
+            break;
+        default :
+            throw obelisk::DatabaseException(sqlite3_errmsg(dbConnection));
+            break;
+    }
+
+    result = sqlite3_bind_double(ppStmt, 11, getWeight());
+    switch (result)
+    {
+        case SQLITE_OK :
+            break;
+        case SQLITE_TOOBIG :
+            throw obelisk::DatabaseSizeException();
+            break;
+        case SQLITE_RANGE :
+            throw obelisk::DatabaseRangeException();
+            break;
+        case SQLITE_NOMEM :
+            throw obelisk::DatabaseMemoryException();
+            break;
+        default :
+            throw obelisk::DatabaseException(sqlite3_errmsg(dbConnection));
+            break;
+    }
+
+    result = sqlite3_step(ppStmt);
+    switch (result)
+    {
+        case SQLITE_DONE :
+            setId(sqlite3_last_insert_rowid(dbConnection));
+            sqlite3_set_last_insert_rowid(dbConnection, 0);
+            break;
+        case SQLITE_CONSTRAINT :
+            throw obelisk::DatabaseConstraintException(
+                sqlite3_errmsg(dbConnection));
+        case SQLITE_BUSY :
+            throw obelisk::DatabaseBusyException();
+            break;
+        case SQLITE_MISUSE :
+            throw obelisk::DatabaseMisuseException();
+            break;
+        default :
+            throw obelisk::DatabaseException(sqlite3_errmsg(dbConnection));
+            break;
+    }
+
+    result = sqlite3_finalize(ppStmt);
+    if (result != SQLITE_OK)
+    {
+        throw obelisk::DatabaseException(sqlite3_errmsg(dbConnection));
+    }
+}
+
+sqlite3_int64& obelisk::PatternRule::getId()
+{
+    return id_;
+}
+
+void obelisk::PatternRule::setId(sqlite3_int64 id)
+{
+    id_ = id;
+}
+
+obelisk::Fact& obelisk::PatternRule::getFact()
+{
+    return fact_;
+}
+
+void obelisk::PatternRule::setFact(obelisk::Fact fact)
+{
+    fact_ = fact;
+}
+
+obelisk::Fact& obelisk::PatternRule::getReason()
+{
+    return reason_;
+}
+
+void obelisk::PatternRule::setReason(obelisk::Fact reason)
+{
+    reason_ = reason;
+}
+
+std::string& obelisk::PatternRule::getFactLeftVariable()
+{
+    return factLeftVariable_;
+}
+
+void obelisk::PatternRule::setFactLeftVariable(std::string variable)
+{
+    factLeftVariable_ = variable;
+}
+
+std::string& obelisk::PatternRule::getFactRightVariable()
+{
+    return factRightVariable_;
+}
+
+void obelisk::PatternRule::setFactRightVariable(std::string variable)
+{
+    factRightVariable_ = variable;
+}
+
+std::string& obelisk::PatternRule::getReasonLeftVariable()
+{
+    return reasonLeftVariable_;
+}
+
+void obelisk::PatternRule::setReasonLeftVariable(std::string variable)
+{
+    reasonLeftVariable_ = variable;
+}
+
+std::string& obelisk::PatternRule::getReasonRightVariable()
+{
+    return reasonRightVariable_;
+}
+
+void obelisk::PatternRule::setReasonRightVariable(std::string variable)
+{
+    reasonRightVariable_ = variable;
+}
+
+double& obelisk::PatternRule::getWeight()
+{
+    return weight_;
+}
+
+void obelisk::PatternRule::setWeight(double weight)
+{
+    weight_ = weight;
+}
+
+bool obelisk::PatternRule::hasVariables()
+{
+    return getFactLeftVariable() != "" || getFactRightVariable() != ""
+        || getReasonLeftVariable() != "" || getReasonRightVariable() != "";
+}
@@ -8,6 +8,7 @@ const char* obelisk::Rule::createTable()
             "id"     INTEGER NOT NULL UNIQUE,
             "fact"   INTEGER NOT NULL,
             "reason" INTEGER NOT NULL CHECK("reason" != "fact"),
+            "weight" REAL NOT NULL DEFAULT 1 CHECK("weight" >= 0 AND "weight" <= 1),
             PRIMARY KEY("id" AUTOINCREMENT),
             UNIQUE("fact", "reason"),
             FOREIGN KEY("fact") REFERENCES "fact"("id") ON DELETE RESTRICT,
@@ -16,6 +17,22 @@ const char* obelisk::Rule::createTable()
     )";
 }
 
+const char* obelisk::Rule::createClusteredTable()
+{
+    return R"(
+        CREATE TABLE "rule" (
+            "id"     INTEGER NOT NULL UNIQUE,
+            "fact"   INTEGER NOT NULL,
+            "reason" INTEGER NOT NULL CHECK("reason" != "fact"),
+            "weight" REAL NOT NULL DEFAULT 1 CHECK("weight" >= 0 AND "weight" <= 1),
+            PRIMARY KEY("reason", "fact"),
+            FOREIGN KEY("fact") REFERENCES "fact"("id") ON DELETE RESTRICT,
+            FOREIGN KEY("reason") REFERENCES "fact"("id") ON DELETE RESTRICT
+        ) WITHOUT ROWID;
+        CREATE INDEX "rule_fact" ON "rule" ("fact");
+    )";
+}
+
 void obelisk::Rule::selectById(sqlite3* dbConnection)
 {
     if (dbConnection == nullptr)
@@ -26,7 +43,7 @@ void obelisk::Rule::selectById(sqlite3* dbConnection)
     sqlite3_stmt* ppStmt = nullptr;
 
     auto result = sqlite3_prepare_v2(dbConnection,
-        "SELECT id, fact, reason FROM rule WHERE (fact=? AND reason=?)",
+        "SELECT id, fact, reason, weight FROM rule WHERE (fact=? AND reason=?)",
         -1,
         &ppStmt,
         nullptr);
@@ -35,7 +52,7 @@ void obelisk::Rule::selectById(sqlite3* dbConnection)
         throw obelisk::DatabaseException(sqlite3_errmsg(dbConnection));
     }
 
-    result = sqlite3_bind_int(ppStmt, 1, getFact().getId());
+    result = sqlite3_bind_int64(ppStmt, 1, getFact().getId());
     switch (result)
     {
         case SQLITE_OK :
@@ -54,7 +71,7 @@ void obelisk::Rule::selectById(sqlite3* dbConnection)
             break;
     }
 
-    result = sqlite3_bind_int(ppStmt, 2, getReason().getId());
+    result = sqlite3_bind_int64(ppStmt, 2, getReason().getId());
     switch (result)
     {
         case SQLITE_OK :
@@ -80,9 +97,10 @@ void obelisk::Rule::selectById(sqlite3* dbConnection)
             // no rows in the database
             break;
         case SQLITE_ROW :
-            setId(sqlite3_column_int(ppStmt, 0));
-            getFact().setId(sqlite3_column_int(ppStmt, 1));
-            getReason().setId(sqlite3_column_int(ppStmt, 2));
+            setId(sqlite3_column_int64(ppStmt, 0));
+            getFact().setId(sqlite3_column_int64(ppStmt, 1));
+            getReason().setId(sqlite3_column_int64(ppStmt, 2));
+            setWeight(sqlite3_column_double(ppStmt, 3));
             break;
         case SQLITE_BUSY :
             throw obelisk::DatabaseBusyException();
@@ -102,7 +120,7 @@ void obelisk::Rule::selectById(sqlite3* dbConnection)
     }
 }
 
-void obelisk::Rule::insert(sqlite3* dbConnection)
+void obelisk::Rule::insert(sqlite3* dbConnection, bool clustered)
 {
     if (dbConnection == nullptr)
     {
@@ -111,8 +129,12 @@ void obelisk::Rule::insert(sqlite3* dbConnection)
 
     sqlite3_stmt* ppStmt = nullptr;
 
+    // a clustered table has no rowid to read the ID back from, so the ID is
+    // assigned by the query instead
     auto result = sqlite3_prepare_v2(dbConnection,
-        "INSERT INTO rule (fact, reason) VALUES (?, ?)",
+        clustered
+            ? "INSERT INTO rule (id, fact, reason, weight) VALUES ((SELECT IFNULL(MAX(id), 0) + 1 FROM rule), ?, ?, ?) RETURNING id"
+            : "INSERT INTO rule (fact, reason, weight) VALUES (?, ?, ?)",
         -1,
         &ppStmt,
         nullptr);
@@ -121,7 +143,26 @@ void obelisk::Rule::insert(sqlite3* dbConnection)
         throw obelisk::DatabaseException(sqlite3_errmsg(dbConnection));
     }
 
-    result = sqlite3_bind_int(ppStmt, 1, getFact().getId());
+    result = sqlite3_bind_int64(ppStmt, 1, getFact().getId());
+    switch (result)
+    {
+        case SQLITE_OK :
+            break;
+        case SQLITE_TOOBIG :
+            throw obelisk::DatabaseSizeException();
+            break;
+        case SQLITE_RANGE :
+            throw obelisk::DatabaseRangeException();
+            break;
+        case SQLITE_NOMEM :
+            throw obelisk::DatabaseMemoryException();
+            break;
+        default :
+            throw obelisk::DatabaseException(sqlite3_errmsg(dbConnection));
+            break;
+    }
+
+    result = sqlite3_bind_int64(ppStmt, 2, getReason().getId());
     switch (result)
     {
         case SQLITE_OK :
@@ -140,7 +181,7 @@ void obelisk::Rule::insert(sqlite3* dbConnection)
             break;
     }
 
-    result = sqlite3_bind_int(ppStmt, 2, getReason().getId());
+    result = sqlite3_bind_double(ppStmt, 3, getWeight());
     switch (result)
     {
         case SQLITE_OK :
@@ -162,8 +203,11 @@ void obelisk::Rule::insert(sqlite3* dbConnection)
     result = sqlite3_step(ppStmt);
     switch (result)
     {
+        case SQLITE_ROW :
+            setId(sqlite3_column_int64(ppStmt, 0));
+            break;
         case SQLITE_DONE :
-            setId((int) sqlite3_last_insert_rowid(dbConnection));
+            setId(sqlite3_last_insert_rowid(dbConnection));
             sqlite3_set_last_insert_rowid(dbConnection, 0);
             break;
         case SQLITE_CONSTRAINT :
@@ -188,7 +232,7 @@ void obelisk::Rule::insert(sqlite3* dbConnection)
 }
 
 void obelisk::Rule::selectByReason(sqlite3* dbConnection,
-    int reasonId,
+    sqlite3_int64 reasonId,
     std::vector<obelisk::Rule>& rules)
 {
     if (dbConnection == nullptr)
@@ -199,7 +243,7 @@ void obelisk::Rule::selectByReason(sqlite3* dbConnection,
     sqlite3_stmt* ppStmt = nullptr;
 
     auto result = sqlite3_prepare_v2(dbConnection,
-        "SELECT id, fact, reason FROM rule WHERE (reason=?)",
+        "SELECT id, fact, reason, weight FROM rule WHERE (reason=?)",
         -1,
         &ppStmt,
         nullptr);
@@ -208,7 +252,7 @@ void obelisk::Rule::selectByReason(sqlite3* dbConnection,
         throw obelisk::DatabaseException(sqlite3_errmsg(dbConnection));
     }
 
-    result = sqlite3_bind_int(ppStmt, 1, reasonId);
+    result = sqlite3_bind_int64(ppStmt, 1, reasonId);
     switch (result)
     {
         case SQLITE_OK :
@@ -232,9 +276,10 @@ void obelisk::Rule::selectByReason(sqlite3* dbConnection,
         switch (result)
         {
             case SQLITE_ROW :
-                rules.push_back(obelisk::Rule(sqlite3_column_int(ppStmt, 0),
-                    obelisk::Fact(sqlite3_column_int(ppStmt, 1)),
-                    obelisk::Fact(sqlite3_column_int(ppStmt, 2))));
+                rules.push_back(obelisk::Rule(sqlite3_column_int64(ppStmt, 0),
+                    obelisk::Fact(sqlite3_column_int64(ppStmt, 1)),
+                    obelisk::Fact(sqlite3_column_int64(ppStmt, 2)),
+                    sqlite3_column_double(ppStmt, 3)));
                 break;
             case SQLITE_BUSY :
                 throw obelisk::DatabaseBusyException();
@@ -255,12 +300,138 @@ void obelisk::Rule::selectByReason(sqlite3* dbConnection,
     }
 }
 
-int& obelisk::Rule::getId()
+void obelisk::Rule::selectByFact(sqlite3* dbConnection,
+    sqlite3_int64 factId,
+    std::vector<obelisk::Rule>& rules)
+{
+    if (dbConnection == nullptr)
+    {
+        throw obelisk::DatabaseException("database isn't open");
+    }
+
+    sqlite3_stmt* ppStmt = nullptr;
+
+    auto result = sqlite3_prepare_v2(dbConnection,
+        "SELECT id, fact, reason, weight FROM rule WHERE (fact=?)",
+        -1,
+        &ppStmt,
+        nullptr);
+    if (result != SQLITE_OK)
+    {
+        throw obelisk::DatabaseException(sqlite3_errmsg(dbConnection));
+    }
+
+    result = sqlite3_bind_int64(ppStmt, 1, factId);
+    switch (result)
+    {
+        case SQLITE_OK :
+            break;
+        case SQLITE_TOOBIG :
+            throw obelisk::DatabaseSizeException();
+            break;
+        case SQLITE_RANGE :
+            throw obelisk::DatabaseRangeException();
+            break;
+        case SQLITE_NOMEM :
+            throw obelisk::DatabaseMemoryException();
+            break;
+        default :
+            throw obelisk::DatabaseException(sqlite3_errmsg(dbConnection));
+            break;
+    }
+
+    while ((result = sqlite3_step(ppStmt)) != SQLITE_DONE)
+    {
+        switch (result)
+        {
+            case SQLITE_ROW :
+                rules.push_back(obelisk::Rule(sqlite3_column_int64(ppStmt, 0),
+                    obelisk::Fact(sqlite3_column_int64(ppStmt, 1)),
+                    obelisk::Fact(sqlite3_column_int64(ppStmt, 2)),
+                    sqlite3_column_double(ppStmt, 3)));
+                break;
+            case SQLITE_BUSY :
+                throw obelisk::DatabaseBusyException();
+                break;
+            case SQLITE_MISUSE :
+                throw obelisk::DatabaseMisuseException();
+                break;
+            default :
+                throw obelisk::DatabaseException(sqlite3_errmsg(dbConnection));
+                break;
+        }
+    }
+
+    result = sqlite3_finalize(ppStmt);
+    if (result != SQLITE_OK)
+    {
+        throw obelisk::DatabaseException(sqlite3_errmsg(dbConnection));
+    }
+}
+
+void obelisk::Rule::selectAll(sqlite3* dbConnection,
+    std::vector<obelisk::Rule>& rules)
+{
+    if (dbConnection == nullptr)
+    {
+        throw obelisk::DatabaseException("database isn't open");
+    }
+
+    sqlite3_stmt* ppStmt = nullptr;
+
+    auto result = sqlite3_prepare_v2(dbConnection,
+        "SELECT rule.id, rule.fact, f.left_entity, f.right_entity, f.verb, f.is_true, rule.reason, r.left_entity, r.right_entity, r.verb, r.is_true, rule.weight FROM rule LEFT JOIN fact f ON f.id = rule.fact LEFT JOIN fact r ON r.id = rule.reason",
+        -1,
+        &ppStmt,
+        nullptr);
+    if (result != SQLITE_OK)
+    {
+        throw obelisk::DatabaseException(sqlite3_errmsg(dbConnection));
+    }
+
+    while ((result = sqlite3_step(ppStmt)) != SQLITE_DONE)
+    {
+        switch (result)
+        {
+            case SQLITE_ROW :
+                rules.push_back(obelisk::Rule(sqlite3_column_int64(ppStmt, 0),
+                    obelisk::Fact(sqlite3_column_int64(ppStmt, 1),
+                        obelisk::Entity(sqlite3_column_int64(ppStmt, 2)),
+                        obelisk::Entity(sqlite3_column_int64(ppStmt, 3)),
+                        obelisk::Verb(sqlite3_column_int64(ppStmt, 4)),
+                        sqlite3_column_double(ppStmt, 5)),
+                    obelisk::Fact(sqlite3_column_int64(ppStmt, 6),
+                        obelisk::Entity(sqlite3_column_int64(ppStmt, 7)),
+                        obelisk::Entity(sqlite3_column_int64(ppStmt, 8)),
+                        obelisk::Verb(sqlite3_column_int64(ppStmt, 9)),
+                        sqlite3_column_double(ppStmt, 10)),
+                    sqlite3_column_double(ppStmt, 11)));
+                break;
+            case SQLITE_BUSY :
+                throw obelisk::DatabaseBusyException();
+                break;
+            case SQLITE_MISUSE :
+                throw obelisk::DatabaseMisuseException();
+                break;
+            default :
+                throw obelisk::DatabaseException(sqlite3_errmsg(dbConnection));
+                break;
+        }
+    }
+
+    result = sqlite3_finalize(ppStmt);
+    if (result != SQLITE_OK)
+    {
+        throw obelisk::DatabaseException(sqlite3_errmsg(dbConnection));
+    }
+}
+
+sqlite3_int64& obelisk::Rule::getId()
 {
     return id_;
 }
 
-void obelisk::Rule::setId(int id)
+void obelisk::Rule::setId(sqlite3_int64 id)
 {
     id_ = id;
 }
@@ -284,3 +455,13 @@ void obelisk::Rule::setReason(obelisk::Fact reason)
 {
     reason_ = reason;
 }
+
+double& obelisk::Rule::getWeight()
+{
+    return weight_;
+}
+
+void obelisk::Rule::setWeight(double weight)
+{
+    weight_ = weight;
+}
@@ -0,0 +1,165 @@
+#include "models/error.h"
+#include "models/statistic.h"
+
+void obelisk::Statistic::selectCounts(sqlite3* dbConnection,
+    const char* query,
+    sqlite3_int64 id,
+    long long& trueFacts,
+    long long& falseFacts)
+{
+    if (dbConnection == nullptr)
+    {
+        throw obelisk::DatabaseException("database isn't open");
+    }
+
+    sqlite3_stmt* ppStmt = nullptr;
+
+    auto result = sqlite3_prepare_v2(dbConnection, query, -1, &ppStmt, nullptr);
+    if (result != SQLITE_OK)
+    {
+        throw obelisk::DatabaseException(sqlite3_errmsg(dbConnection));
+    }
+
+    result = sqlite3_bind_int64(ppStmt, 1, id);
+    switch (result)
+    {
+        case SQLITE_OK :
+            break;
+        case SQLITE_TOOBIG :
+            throw obelisk::DatabaseSizeException();
+            break;
+        case SQLITE_RANGE :
+            throw obelisk::DatabaseRangeException();
+            break;
+        case SQLITE_NOMEM :
+            throw obelisk::DatabaseMemoryException();
+            break;
+        default :
+            throw obelisk::DatabaseException(sqlite3_errmsg(dbConnection));
+            break;
+    }
+
+    // nothing has used it yet if there is no row
+    trueFacts  = 0;
+    falseFacts = 0;
+
+    result = sqlite3_step(ppStmt);
+    switch (result)
+    {
+        case SQLITE_DONE :
+            // no rows in the database
+            break;
+        case SQLITE_ROW :
+            trueFacts  = sqlite3_column_int64(ppStmt, 0);
+            falseFacts = sqlite3_column_int64(ppStmt, 1);
+            break;
+        case SQLITE_BUSY :
+            throw obelisk::DatabaseBusyException();
+            break;
+        case SQLITE_MISUSE :
+            throw obelisk::DatabaseMisuseException();
+            break;
+        default :
+            throw obelisk::DatabaseException(sqlite3_errmsg(dbConnection));
+            break;
+    }
+
+    result = sqlite3_finalize(ppStmt);
+    if (result != SQLITE_OK)
+    {
+        throw obelisk::DatabaseException(sqlite3_errmsg(dbConnection));
+    }
+}
+
+const char* obelisk::Statistic::createTable()
+{
+    return R"(
+        CREATE TABLE "verb_statistic" (
+            "verb"        INTEGER NOT NULL,
+            "true_facts"  INTEGER NOT NULL DEFAULT 0,
+            "false_facts" INTEGER NOT NULL DEFAULT 0,
+            PRIMARY KEY("verb"),
+            FOREIGN KEY("verb") REFERENCES "verb"("id") ON DELETE CASCADE
+        );
+        CREATE TABLE "entity_statistic" (
+            "entity"      INTEGER NOT NULL,
+            "true_facts"  INTEGER NOT NULL DEFAULT 0,
+            "false_facts" INTEGER NOT NULL DEFAULT 0,
+            PRIMARY KEY("entity"),
+            FOREIGN KEY("entity") REFERENCES "entity"("id") ON DELETE CASCADE
+        );
+        CREATE TRIGGER "fact_statistic_insert" AFTER INSERT ON "fact"
+        BEGIN
+            INSERT INTO verb_statistic (verb, true_facts, false_facts)
+                VALUES (NEW.verb, NEW.is_true > 0, NEW.is_true <= 0)
+                ON CONFLICT (verb) DO UPDATE SET
+                    true_facts = true_facts + excluded.true_facts,
+                    false_facts = false_facts + excluded.false_facts;
+            INSERT INTO entity_statistic (entity, true_facts, false_facts)
+                SELECT entity, NEW.is_true > 0, NEW.is_true <= 0
+                FROM (SELECT NEW.left_entity AS entity UNION SELECT NEW.right_entity) WHERE true
+                ON CONFLICT (entity) DO UPDATE SET
+                    true_facts = true_facts + excluded.true_facts,
+                    false_facts = false_facts + excluded.false_facts;
+        END;
+        CREATE TRIGGER "fact_statistic_update" AFTER UPDATE OF "is_true" ON "fact"
+        WHEN (OLD.is_true > 0) != (NEW.is_true > 0)
+        BEGIN
+            UPDATE verb_statistic SET
+                true_facts = true_facts + (NEW.is_true > 0) - (OLD.is_true > 0),
+                false_facts = false_facts + (NEW.is_true <= 0) - (OLD.is_true <= 0)
+                WHERE verb = NEW.verb;
+            UPDATE entity_statistic SET
+                true_facts = true_facts + (NEW.is_true > 0) - (OLD.is_true > 0),
+                false_facts = false_facts + (NEW.is_true <= 0) - (OLD.is_true <= 0)
+                WHERE entity IN (NEW.left_entity, NEW.right_entity);
+        END;
+        CREATE TRIGGER "fact_statistic_delete" AFTER DELETE ON "fact"
+        BEGIN
+            UPDATE verb_statistic SET
+                true_facts = true_facts - (OLD.is_true > 0),
+                false_facts = false_facts - (OLD.is_true <= 0)
+                WHERE verb = OLD.verb;
+            UPDATE entity_statistic SET
+                true_facts = true_facts - (OLD.is_true > 0),
+                false_facts = false_facts - (OLD.is_true <= 0)
+                WHERE entity IN (OLD.left_entity, OLD.right_entity);
+        END;
+    )";
+}
+
+const char* obelisk::Statistic::fillTable()
+{
+    return R"(
+        INSERT INTO verb_statistic (verb, true_facts, false_facts)
+            SELECT verb, SUM(is_true > 0), SUM(is_true <= 0) FROM fact GROUP BY verb;
+        INSERT INTO entity_statistic (entity, true_facts, false_facts)
+            SELECT entity, SUM(is_true > 0), SUM(is_true <= 0)
+            FROM (SELECT id, left_entity AS entity, is_true FROM fact UNION SELECT id, right_entity, is_true FROM fact)
+            GROUP BY entity;
+    )";
+}
+
+void obelisk::Statistic::selectByVerb(sqlite3* dbConnection,
+    sqlite3_int64 verbId,
+    long long& trueFacts,
+    long long& falseFacts)
+{
+    selectCounts(dbConnection,
+        "SELECT true_facts, false_facts FROM verb_statistic WHERE (verb=?)",
+        verbId,
+        trueFacts,
+        falseFacts);
+}
+
+void obelisk::Statistic::selectByEntity(sqlite3* dbConnection,
+    sqlite3_int64 entityId,
+    long long& trueFacts,
+    long long& falseFacts)
+{
+    selectCounts(dbConnection,
+        "SELECT true_facts, false_facts FROM entity_statistic WHERE (entity=?)",
+        entityId,
+        trueFacts,
+        falseFacts);
+}
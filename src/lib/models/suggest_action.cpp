@@ -37,7 +37,7 @@ void obelisk::SuggestAction::selectById(sqlite3* dbConnection)
         throw obelisk::DatabaseException(sqlite3_errmsg(dbConnection));
     }
 
-    result = sqlite3_bind_int(ppStmt, 1, getFact().getId());
+    result = sqlite3_bind_int64(ppStmt, 1, getFact().getId());
     switch (result)
     {
         case SQLITE_OK :
@@ -56,7 +56,7 @@ void obelisk::SuggestAction::selectById(sqlite3* dbConnection)
             break;
     }
 
-    result = sqlite3_bind_int(ppStmt, 2, getTrueAction().getId());
+    result = sqlite3_bind_int64(ppStmt, 2, getTrueAction().getId());
     switch (result)
     {
         case SQLITE_OK :
@@ -75,7 +75,7 @@ void obelisk::SuggestAction::selectById(sqlite3* dbConnection)
             break;
     }
 
-    result = sqlite3_bind_int(ppStmt, 3, getFalseAction().getId());
+    result = sqlite3_bind_int64(ppStmt, 3, getFalseAction().getId());
     switch (result)
     {
         case SQLITE_OK :
@@ -101,10 +101,10 @@ void obelisk::SuggestAction::selectById(sqlite3* dbConnection)
             // no rows in the database
             break;
         case SQLITE_ROW :
-            setId(sqlite3_column_int(ppStmt, 0));
-            getFact().setId(sqlite3_column_int(ppStmt, 1));
-            getTrueAction().setId(sqlite3_column_int(ppStmt, 2));
-            getFalseAction().setId(sqlite3_column_int(ppStmt, 3));
+            setId(sqlite3_column_int64(ppStmt, 0));
+            getFact().setId(sqlite3_column_int64(ppStmt, 1));
+            getTrueAction().setId(sqlite3_column_int64(ppStmt, 2));
+            getFalseAction().setId(sqlite3_column_int64(ppStmt, 3));
             break;
         case SQLITE_BUSY :
             throw obelisk::DatabaseBusyException();
@@ -143,7 +143,7 @@ void obelisk::SuggestAction::insert(sqlite3* dbConnection)
         throw obelisk::DatabaseException(sqlite3_errmsg(dbConnection));
     }
 
-    result = sqlite3_bind_int(ppStmt, 1, getFact().getId());
+    result = sqlite3_bind_int64(ppStmt, 1, getFact().getId());
     switch (result)
     {
         case SQLITE_OK :
@@ -162,7 +162,7 @@ void obelisk::SuggestAction::insert(sqlite3* dbConnection)
             break;
     }
 
-    result = sqlite3_bind_int(ppStmt, 2, getTrueAction().getId());
+    result = sqlite3_bind_int64(ppStmt, 2, getTrueAction().getId());
     switch (result)
     {
         case SQLITE_OK :
@@ -181,7 +181,7 @@ void obelisk::SuggestAction::insert(sqlite3* dbConnection)
             break;
     }
 
-    result = sqlite3_bind_int(ppStmt, 3, getFalseAction().getId());
+    result = sqlite3_bind_int64(ppStmt, 3, getFalseAction().getId());
     switch (result)
     {
         case SQLITE_OK :
@@ -204,7 +204,7 @@ void obelisk::SuggestAction::insert(sqlite3* dbConnection)
     switch (result)
     {
         case SQLITE_DONE :
-            setId((int) sqlite3_last_insert_rowid(dbConnection));
+            setId(sqlite3_last_insert_rowid(dbConnection));
             sqlite3_set_last_insert_rowid(dbConnection, 0);
             break;
         case SQLITE_CONSTRAINT :
@@ -228,12 +228,12 @@ void obelisk::SuggestAction::insert(sqlite3* dbConnection)
     }
 }
 
-int& obelisk::SuggestAction::getId()
+sqlite3_int64& obelisk::SuggestAction::getId()
 {
     return id_;
 }
 
-void obelisk::SuggestAction::setId(int id)
+void obelisk::SuggestAction::setId(sqlite3_int64 id)
 {
     id_ = id;
 }
@@ -7,8 +7,9 @@ const char* obelisk::Verb::createTable()
 {
     return R"(
         CREATE TABLE "verb" (
-            "id"   INTEGER NOT NULL UNIQUE,
-            "name" TEXT NOT NULL CHECK(trim(name) != "") UNIQUE,
+            "id"         INTEGER NOT NULL UNIQUE,
+            "name"       TEXT NOT NULL CHECK(trim(name) != "") UNIQUE,
+            "transitive" INTEGER NOT NULL DEFAULT 0,
             PRIMARY KEY("id" AUTOINCREMENT)
         );
     )";
@@ -24,7 +25,7 @@ void obelisk::Verb::selectByName(sqlite3* dbConnection)
     sqlite3_stmt* ppStmt = nullptr;
 
     auto result = sqlite3_prepare_v2(dbConnection,
-        "SELECT id, name FROM verb WHERE name=?",
+        "SELECT id, name, transitive FROM verb WHERE name=?",
         -1,
         &ppStmt,
         nullptr);
@@ -59,8 +60,9 @@ void obelisk::Verb::selectByName(sqlite3* dbConnection)
             // no rows in the database
             break;
         case SQLITE_ROW :
-            setId(sqlite3_column_int(ppStmt, 0));
+            setId(sqlite3_column_int64(ppStmt, 0));
             setName((char*) sqlite3_column_text(ppStmt, 1));
+            setTransitive(sqlite3_column_int(ppStmt, 2));
             break;
         case SQLITE_BUSY :
             throw obelisk::DatabaseBusyException();
@@ -90,7 +92,7 @@ void obelisk::Verb::insert(sqlite3* dbConnection)
     sqlite3_stmt* ppStmt = nullptr;
 
     auto result = sqlite3_prepare_v2(dbConnection,
-        "INSERT INTO verb (name) VALUES (?)",
+        "INSERT INTO verb (id, name, transitive) VALUES (NULLIF(?, 0), ?, ?)",
         -1,
         &ppStmt,
         nullptr);
@@ -99,8 +101,47 @@ void obelisk::Verb::insert(sqlite3* dbConnection)
         throw obelisk::DatabaseException(sqlite3_errmsg(dbConnection));
     }
 
+    // an ID of 0 lets the database pick one
+    result = sqlite3_bind_int64(ppStmt, 1, getId());
+    switch (result)
+    {
+        case SQLITE_OK :
+            break;
+        case SQLITE_TOOBIG :
+            throw obelisk::DatabaseSizeException();
+            break;
+        case SQLITE_RANGE :
+            throw obelisk::DatabaseRangeException();
+            break;
+        case SQLITE_NOMEM :
+            throw obelisk::DatabaseMemoryException();
+            break;
+        default :
+            throw obelisk::DatabaseException(sqlite3_errmsg(dbConnection));
+            break;
+    }
+
     result
-        = sqlite3_bind_text(ppStmt, 1, getName().c_str(), -1, SQLITE_TRANSIENT);
+        = sqlite3_bind_text(ppStmt, 2, getName().c_str(), -1, SQLITE_TRANSIENT);
+    switch (result)
+    {
+        case SQLITE_OK :
+            break;
+        case SQLITE_TOOBIG :
+            throw obelisk::DatabaseSizeException();
+            break;
+        case SQLITE_RANGE :
+            throw obelisk::DatabaseRangeException();
+            break;
+        case SQLITE_NOMEM :
+            throw obelisk::DatabaseMemoryException();
+            break;
+        default :
+            throw obelisk::DatabaseException(sqlite3_errmsg(dbConnection));
+            break;
+    }
+
+    result = sqlite3_bind_int(ppStmt, 3, getTransitive());
     switch (result)
     {
         case SQLITE_OK :
@@ -123,7 +164,7 @@ void obelisk::Verb::insert(sqlite3* dbConnection)
     switch (result)
     {
         case SQLITE_DONE :
-            setId((int) sqlite3_last_insert_rowid(dbConnection));
+            setId(sqlite3_last_insert_rowid(dbConnection));
             sqlite3_set_last_insert_rowid(dbConnection, 0);
             break;
         case SQLITE_CONSTRAINT :
@@ -147,12 +188,96 @@ void obelisk::Verb::insert(sqlite3* dbConnection)
     }
 }
 
-int& obelisk::Verb::getId()
+void obelisk::Verb::updateTransitive(sqlite3* dbConnection)
+{
+    if (dbConnection == nullptr)
+    {
+        throw obelisk::DatabaseException("database isn't open");
+    }
+
+    sqlite3_stmt* ppStmt = nullptr;
+
+    auto result = sqlite3_prepare_v2(dbConnection,
+        "UPDATE verb SET transitive=? WHERE id=?",
+        -1,
+        &ppStmt,
+        nullptr);
+    if (result != SQLITE_OK)
+    {
+        throw obelisk::DatabaseException(sqlite3_errmsg(dbConnection));
+    }
+
+    result = sqlite3_bind_int(ppStmt, 1, getTransitive());
+    switch (result)
+    {
+        case SQLITE_OK :
+            break;
+        case SQLITE_TOOBIG :
+            throw obelisk::DatabaseSizeException();
+            break;
+        case SQLITE_RANGE :
+            throw obelisk::DatabaseRangeException();
+            break;
+        case SQLITE_NOMEM :
+            throw obelisk::DatabaseMemoryException();
+            break;
+        default :
+            throw obelisk::DatabaseException(sqlite3_errmsg(dbConnection));
+            break;
+    }
+
+    result = sqlite3_bind_int64(ppStmt, 2, getId());
+    switch (result)
+    {
+        case SQLITE_OK :
+            break;
+        case SQLITE_TOOBIG :
+            throw obelisk::DatabaseSizeException();
+            break;
+        case SQLITE_RANGE :
+            throw obelisk::DatabaseRangeException();
+            break;
+        case SQLITE_NOMEM :
+            throw obelisk::DatabaseMemoryException();
+            break;
+        default :
+            throw obelisk::DatabaseException(sqlite3_errmsg(dbConnection));
+            break;
+    }
+
+    result = sqlite3_step(ppStmt);
+    switch (result)
+    {
+        case SQLITE_DONE :
+            // Row updated
+            break;
+        case SQLITE_CONSTRAINT :
+            throw obelisk::DatabaseConstraintException(
+                sqlite3_errmsg(dbConnection));
+        case SQLITE_BUSY :
+            throw obelisk::DatabaseBusyException();
+            break;
+        case SQLITE_MISUSE :
+            throw obelisk::DatabaseMisuseException();
+            break;
+        default :
+            throw obelisk::DatabaseException(sqlite3_errmsg(dbConnection));
+            break;
+    }
+
+    result = sqlite3_finalize(ppStmt);
+    if (result != SQLITE_OK)
+    {
+        throw obelisk::DatabaseException(sqlite3_errmsg(dbConnection));
+    }
+}
+
+sqlite3_int64& obelisk::Verb::getId()
 {
     return id_;
 }
 
-void obelisk::Verb::setId(int id)
+void obelisk::Verb::setId(sqlite3_int64 id)
 {
     id_ = id;
 }
@@ -166,3 +291,13 @@ void obelisk::Verb::setName(std::string name)
 {
     name_ = name;
 }
+
+bool& obelisk::Verb::getTransitive()
+{
+    return transitive_;
+}
+
+void obelisk::Verb::setTransitive(bool transitive)
+{
+    transitive_ = transitive;
+}
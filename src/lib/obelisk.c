@@ -9,6 +9,16 @@ CObelisk* obelisk_open(const char* filename)
     return create_obelisk(filename);
 }
 
+CObelisk* obelisk_open_image(const char* filename)
+{
+    return create_obelisk_image(filename);
+}
+
+CObelisk* obelisk_open_sharded(const char* filename, size_t shards)
+{
+    return create_obelisk_sharded(filename, shards);
+}
+
 void obelisk_close(CObelisk* obelisk)
 {
     destroy_obelisk(obelisk);
@@ -32,6 +42,75 @@ double obelisk_query(CObelisk* obelisk,
     return call_obelisk_query(obelisk, left_entity, verb, right_entity);
 }
 
+double obelisk_query_evaluation(CObelisk* obelisk,
+    const char* left_entity,
+    const char* verb,
+    const char* right_entity,
+    int evaluation)
+{
+    return call_obelisk_queryEvaluation(obelisk,
+        left_entity,
+        verb,
+        right_entity,
+        evaluation);
+}
+
+void obelisk_set_evaluation(CObelisk* obelisk, int evaluation)
+{
+    call_obelisk_setEvaluation(obelisk, evaluation);
+}
+
+void obelisk_set_combine(CObelisk* obelisk, int combine)
+{
+    call_obelisk_setCombine(obelisk, combine);
+}
+
+void obelisk_verb_statistics(CObelisk* obelisk,
+    const char* verb,
+    long long* true_facts,
+    long long* false_facts)
+{
+    call_obelisk_getVerbStatistics(obelisk, verb, true_facts, false_facts);
+}
+
+void obelisk_entity_statistics(CObelisk* obelisk,
+    const char* entity,
+    long long* true_facts,
+    long long* false_facts)
+{
+    call_obelisk_getEntityStatistics(obelisk, entity, true_facts, false_facts);
+}
+
+void obelisk_set_profiling(CObelisk* obelisk, int profiling)
+{
+    call_obelisk_setProfiling(obelisk, profiling);
+}
+
+char* obelisk_profile_dump(CObelisk* obelisk)
+{
+    return call_obelisk_getProfile(obelisk);
+}
+
+CObeliskCursor* obelisk_query_pattern(CObelisk* obelisk,
+    const char* left_entity,
+    const char* verb,
+    const char* right_entity)
+{
+    return call_obelisk_queryPattern(obelisk, left_entity, verb, right_entity);
+}
+
+size_t obelisk_cursor_step(CObeliskCursor* cursor,
+    CObeliskFact* facts,
+    size_t max)
+{
+    return call_obelisk_cursorStep(cursor, facts, max);
+}
+
+void obelisk_cursor_close(CObeliskCursor* cursor)
+{
+    call_obelisk_cursorClose(cursor);
+}
+
 char* obelisk_query_action(CObelisk* obelisk,
     const char* left_entity,
     const char* verb,
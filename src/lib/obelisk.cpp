@@ -7,6 +7,32 @@ obelisk::Obelisk::Obelisk(std::string filename)
         new obelisk::KnowledgeBase(filename.c_str())};
 }
 
+obelisk::Obelisk::Obelisk(std::string filename,
+    obelisk::KnowledgeBase::Storage storage)
+{
+    kb_ = std::unique_ptr<obelisk::KnowledgeBase> {
+        new obelisk::KnowledgeBase(filename.c_str(),
+            obelisk::KnowledgeBase::kLayoutRowid,
+            storage)};
+}
+
+obelisk::Obelisk::Obelisk(std::string filename, std::size_t shards)
+{
+    shardedKb_ = std::unique_ptr<obelisk::ShardedKnowledgeBase> {
+        new obelisk::ShardedKnowledgeBase(filename.c_str(), shards)};
+}
+
+obelisk::KnowledgeBase& obelisk::Obelisk::getKnowledgeBase()
+{
+    if (!kb_)
+    {
+        throw obelisk::KnowledgeBaseException(
+            "query isn't supported by a sharded knowledge base");
+    }
+
+    return *kb_;
+}
+
 std::string obelisk::Obelisk::getVersion()
 {
     return obelisk::version;
@@ -25,11 +51,149 @@ double obelisk::Obelisk::query(const std::string& leftEntity,
         obelisk::Entity(rightEntity),
         obelisk::Verb(verb));
 
-    kb_->queryFact(fact);
+    if (shardedKb_)
+    {
+        shardedKb_->queryFact(fact);
+    }
+    else
+    {
+        kb_->queryFact(fact);
+    }
+
+    return fact.getIsTrue();
+}
+
+double obelisk::Obelisk::query(const std::string& leftEntity,
+    const std::string& verb,
+    const std::string& rightEntity,
+    obelisk::KnowledgeBase::Evaluation evaluation)
+{
+    obelisk::Fact fact = obelisk::Fact(obelisk::Entity(leftEntity),
+        obelisk::Entity(rightEntity),
+        obelisk::Verb(verb));
+
+    if (shardedKb_)
+    {
+        shardedKb_->queryFact(fact, evaluation);
+    }
+    else
+    {
+        kb_->queryFact(fact, evaluation);
+    }
 
     return fact.getIsTrue();
 }
 
+void obelisk::Obelisk::setEvaluation(
+    obelisk::KnowledgeBase::Evaluation evaluation)
+{
+    if (shardedKb_)
+    {
+        shardedKb_->setEvaluation(evaluation);
+    }
+    else
+    {
+        kb_->setEvaluation(evaluation);
+    }
+}
+
+void obelisk::Obelisk::setCombine(obelisk::KnowledgeBase::Combine combine)
+{
+    if (shardedKb_)
+    {
+        shardedKb_->setCombine(combine);
+    }
+    else
+    {
+        kb_->setCombine(combine);
+    }
+}
+
+void obelisk::Obelisk::setProfiling(bool profiling)
+{
+    getKnowledgeBase().setProfiling(profiling);
+}
+
+std::string obelisk::Obelisk::getProfile()
+{
+    return obelisk::Profiler::format(getKnowledgeBase().getProfile());
+}
+
+std::unique_ptr<obelisk::FactCursor> obelisk::Obelisk::queryPattern(
+    const std::string& leftEntity,
+    const std::string& verb,
+    const std::string& rightEntity)
+{
+    obelisk::Fact pattern = obelisk::Fact(obelisk::Entity(leftEntity),
+        obelisk::Entity(rightEntity),
+        obelisk::Verb(verb));
+
+    return getKnowledgeBase().queryPattern(pattern);
+}
+
+sqlite3_int64 obelisk::Obelisk::getEntityId(const std::string& entity)
+{
+    obelisk::Entity result = obelisk::Entity(entity);
+
+    if (shardedKb_)
+    {
+        shardedKb_->getEntity(result);
+    }
+    else
+    {
+        kb_->getEntity(result);
+    }
+
+    return result.getId();
+}
+
+void obelisk::Obelisk::getVerbStatistics(const std::string& verb,
+    long long& trueFacts,
+    long long& falseFacts)
+{
+    obelisk::Verb result = obelisk::Verb(verb);
+
+    getKnowledgeBase().getStatistics(result, trueFacts, falseFacts);
+}
+
+void obelisk::Obelisk::getEntityStatistics(const std::string& entity,
+    long long& trueFacts,
+    long long& falseFacts)
+{
+    obelisk::Entity result = obelisk::Entity(entity);
+
+    getKnowledgeBase().getStatistics(result, trueFacts, falseFacts);
+}
+
+void obelisk::Obelisk::setAdjacencyCache(bool adjacencyCache)
+{
+    getKnowledgeBase().setAdjacencyCache(adjacencyCache);
+}
+
+std::vector<obelisk::Fact> obelisk::Obelisk::getOutgoing(sqlite3_int64 entityId)
+{
+    std::vector<obelisk::Fact> facts;
+    getKnowledgeBase().getOutgoing(entityId, facts);
+    return facts;
+}
+
+std::vector<obelisk::Fact> obelisk::Obelisk::getIncoming(sqlite3_int64 entityId)
+{
+    std::vector<obelisk::Fact> facts;
+    getKnowledgeBase().getIncoming(entityId, facts);
+    return facts;
+}
+
+std::vector<obelisk::Fact> obelisk::Obelisk::findPath(
+    sqlite3_int64 fromEntityId,
+    sqlite3_int64 toEntityId,
+    std::size_t maxDepth)
+{
+    std::vector<obelisk::Fact> path;
+    getKnowledgeBase().findPath(fromEntityId, toEntityId, maxDepth, path);
+    return path;
+}
+
 std::string obelisk::Obelisk::queryAction(const std::string& leftEntity,
     const std::string& verb,
     const std::string& rightEntity)
@@ -38,10 +202,15 @@ std::string obelisk::Obelisk::queryAction(const std::string& leftEntity,
         obelisk::Entity(rightEntity),
         obelisk::Verb(verb));
 
-    kb_->queryFact(fact);
-
     obelisk::Action action;
-    kb_->querySuggestAction(fact, action);
+    if (shardedKb_)
+    {
+        shardedKb_->querySuggestAction(fact, action);
+    }
+    else
+    {
+        kb_->queryAction(fact, action);
+    }
 
     return action.getName();
 }
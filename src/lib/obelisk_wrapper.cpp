@@ -3,6 +3,26 @@
 
 #include <string.h>
 
+/**
+ * @brief A FactCursor along with the facts of its last chunk, which own the
+ * strings handed out to C.
+ *
+ */
+struct CObeliskCursor
+{
+        /**
+         * @brief The cursor.
+         *
+         */
+        std::unique_ptr<obelisk::FactCursor> cursor;
+
+        /**
+         * @brief The facts of the last chunk.
+         *
+         */
+        std::vector<obelisk::Fact> facts;
+};
+
 extern "C"
 {
     CObelisk* create_obelisk(const char* filename)
@@ -11,6 +31,19 @@ extern "C"
         return reinterpret_cast<CObelisk*>(obelisk);
     }
 
+    CObelisk* create_obelisk_image(const char* filename)
+    {
+        obelisk::Obelisk* obelisk = new obelisk::Obelisk(filename,
+            obelisk::KnowledgeBase::kStorageImage);
+        return reinterpret_cast<CObelisk*>(obelisk);
+    }
+
+    CObelisk* create_obelisk_sharded(const char* filename, size_t shards)
+    {
+        obelisk::Obelisk* obelisk = new obelisk::Obelisk(filename, shards);
+        return reinterpret_cast<CObelisk*>(obelisk);
+    }
+
     char* call_obelisk_getVersion(CObelisk* p_obelisk)
     {
         obelisk::Obelisk* obelisk
@@ -38,6 +71,112 @@ extern "C"
             std::string(right_entity));
     }
 
+    double call_obelisk_queryEvaluation(CObelisk* p_obelisk,
+        const char* left_entity,
+        const char* verb,
+        const char* right_entity,
+        int evaluation)
+    {
+        obelisk::Obelisk* obelisk
+            = reinterpret_cast<obelisk::Obelisk*>(p_obelisk);
+        return obelisk->query(std::string(left_entity),
+            std::string(verb),
+            std::string(right_entity),
+            static_cast<obelisk::KnowledgeBase::Evaluation>(evaluation));
+    }
+
+    void call_obelisk_setEvaluation(CObelisk* p_obelisk, int evaluation)
+    {
+        obelisk::Obelisk* obelisk
+            = reinterpret_cast<obelisk::Obelisk*>(p_obelisk);
+        obelisk->setEvaluation(
+            static_cast<obelisk::KnowledgeBase::Evaluation>(evaluation));
+    }
+
+    void call_obelisk_setCombine(CObelisk* p_obelisk, int combine)
+    {
+        obelisk::Obelisk* obelisk
+            = reinterpret_cast<obelisk::Obelisk*>(p_obelisk);
+        obelisk->setCombine(
+            static_cast<obelisk::KnowledgeBase::Combine>(combine));
+    }
+
+    void call_obelisk_getVerbStatistics(CObelisk* p_obelisk,
+        const char* verb,
+        long long* true_facts,
+        long long* false_facts)
+    {
+        obelisk::Obelisk* obelisk
+            = reinterpret_cast<obelisk::Obelisk*>(p_obelisk);
+        obelisk->getVerbStatistics(std::string(verb),
+            *true_facts,
+            *false_facts);
+    }
+
+    void call_obelisk_getEntityStatistics(CObelisk* p_obelisk,
+        const char* entity,
+        long long* true_facts,
+        long long* false_facts)
+    {
+        obelisk::Obelisk* obelisk
+            = reinterpret_cast<obelisk::Obelisk*>(p_obelisk);
+        obelisk->getEntityStatistics(std::string(entity),
+            *true_facts,
+            *false_facts);
+    }
+
+    void call_obelisk_setProfiling(CObelisk* p_obelisk, int profiling)
+    {
+        obelisk::Obelisk* obelisk
+            = reinterpret_cast<obelisk::Obelisk*>(p_obelisk);
+        obelisk->setProfiling(profiling != 0);
+    }
+
+    char* call_obelisk_getProfile(CObelisk* p_obelisk)
+    {
+        obelisk::Obelisk* obelisk
+            = reinterpret_cast<obelisk::Obelisk*>(p_obelisk);
+        auto profile = strdup(obelisk->getProfile().c_str());
+        return profile;
+    }
+
+    CObeliskCursor* call_obelisk_queryPattern(CObelisk* p_obelisk,
+        const char* left_entity,
+        const char* verb,
+        const char* right_entity)
+    {
+        obelisk::Obelisk* obelisk
+            = reinterpret_cast<obelisk::Obelisk*>(p_obelisk);
+        auto cursor    = new CObeliskCursor();
+        cursor->cursor = obelisk->queryPattern(
+            std::string(left_entity ? left_entity : ""),
+            std::string(verb ? verb : ""),
+            std::string(right_entity ? right_entity : ""));
+        return cursor;
+    }
+
+    size_t call_obelisk_cursorStep(CObeliskCursor* p_cursor,
+        CObeliskFact* facts,
+        size_t max)
+    {
+        p_cursor->facts.clear();
+        auto count = p_cursor->cursor->step(p_cursor->facts, max);
+        for (size_t i = 0; i < count; i++)
+        {
+            auto& fact            = p_cursor->facts[i];
+            facts[i].left_entity  = fact.getLeftEntity().getName().c_str();
+            facts[i].verb         = fact.getVerb().getName().c_str();
+            facts[i].right_entity = fact.getRightEntity().getName().c_str();
+            facts[i].is_true      = fact.getIsTrue();
+        }
+        return count;
+    }
+
+    void call_obelisk_cursorClose(CObeliskCursor* p_cursor)
+    {
+        delete p_cursor;
+    }
+
     char* call_obelisk_queryAction(CObelisk* p_obelisk,
         const char* left_entity,
         const char* verb,
@@ -16,6 +16,26 @@ extern "C"
      */
     CObelisk *create_obelisk(const char *filename);
 
+    /**
+     * @brief Create a obelisk object with its KnowledgeBase loaded into
+     * memory.
+     *
+     * @param[in] filename The name of the obelisk KnowledgeBase file to load.
+     * @return CObelisk* Returns the obelisk object.
+     */
+    CObelisk *create_obelisk_image(const char *filename);
+
+    /**
+     * @brief Create a obelisk object with a KnowledgeBase compiled into
+     * shards.
+     *
+     * @param[in] filename The name of the dictionary file of the
+     * KnowledgeBase.
+     * @param[in] shards The number of shards.
+     * @return CObelisk* Returns the obelisk object.
+     */
+    CObelisk *create_obelisk_sharded(const char *filename, size_t shards);
+
     /**
      * @brief Calls the obelisk method getVersion.
      *
@@ -47,6 +67,114 @@ extern "C"
         const char *verb,
         const char *right_entity);
 
+    /**
+     * @brief Calls the obelisk method query with an evaluation.
+     *
+     * @param[in] p_obelisk The obelisk object pointer.
+     * @param[in] left_entity The left entity.
+     * @param[in] verb The verb.
+     * @param[in] right_entity The right entity.
+     * @param[in] evaluation The evaluation to use.
+     * @return double Returns whether or not the Fact is true.
+     */
+    double call_obelisk_queryEvaluation(CObelisk *p_obelisk,
+        const char *left_entity,
+        const char *verb,
+        const char *right_entity,
+        int evaluation);
+
+    /**
+     * @brief Calls the obelisk method setEvaluation.
+     *
+     * @param[in] p_obelisk The obelisk object pointer.
+     * @param[in] evaluation The evaluation to use.
+     */
+    void call_obelisk_setEvaluation(CObelisk *p_obelisk, int evaluation);
+
+    /**
+     * @brief Calls the obelisk method setCombine.
+     *
+     * @param[in] p_obelisk The obelisk object pointer.
+     * @param[in] combine The combine mode to use.
+     */
+    void call_obelisk_setCombine(CObelisk *p_obelisk, int combine);
+
+    /**
+     * @brief Calls the obelisk method getVerbStatistics.
+     *
+     * @param[in] p_obelisk The obelisk object pointer.
+     * @param[in] verb The verb.
+     * @param[out] true_facts The number of true facts.
+     * @param[out] false_facts The number of false facts.
+     */
+    void call_obelisk_getVerbStatistics(CObelisk *p_obelisk,
+        const char *verb,
+        long long *true_facts,
+        long long *false_facts);
+
+    /**
+     * @brief Calls the obelisk method getEntityStatistics.
+     *
+     * @param[in] p_obelisk The obelisk object pointer.
+     * @param[in] entity The entity.
+     * @param[out] true_facts The number of true facts.
+     * @param[out] false_facts The number of false facts.
+     */
+    void call_obelisk_getEntityStatistics(CObelisk *p_obelisk,
+        const char *entity,
+        long long *true_facts,
+        long long *false_facts);
+
+    /**
+     * @brief Calls the obelisk method setProfiling.
+     *
+     * @param[in] p_obelisk The obelisk object pointer.
+     * @param[in] profiling Non-zero to enable profiling.
+     */
+    void call_obelisk_setProfiling(CObelisk *p_obelisk, int profiling);
+
+    /**
+     * @brief Calls the obelisk method getProfile.
+     *
+     * @param[in] p_obelisk The obelisk object pointer.
+     * @return char* Returns the profile table. This must be freed by the
+     * caller.
+     */
+    char *call_obelisk_getProfile(CObelisk *p_obelisk);
+
+    /**
+     * @brief Calls the obelisk method queryPattern.
+     *
+     * @param[in] p_obelisk The obelisk object pointer.
+     * @param[in] left_entity The left entity or NULL to match any.
+     * @param[in] verb The verb or NULL to match any.
+     * @param[in] right_entity The right entity or NULL to match any.
+     * @return CObeliskCursor* Returns the cursor.
+     */
+    CObeliskCursor *call_obelisk_queryPattern(CObelisk *p_obelisk,
+        const char *left_entity,
+        const char *verb,
+        const char *right_entity);
+
+    /**
+     * @brief Calls the cursor method step.
+     *
+     * @param[in] p_cursor The cursor pointer.
+     * @param[out] facts The array to fill in.
+     * @param[in] max The size of the array.
+     * @return size_t Returns the number of facts filled in.
+     */
+    size_t call_obelisk_cursorStep(CObeliskCursor *p_cursor,
+        CObeliskFact *facts,
+        size_t max);
+
+    /**
+     * @brief Deletes a cursor.
+     *
+     * @param[in] p_cursor The cursor pointer.
+     */
+    void call_obelisk_cursorClose(CObeliskCursor *p_cursor);
+
     /**
      * @brief Calls the obelisk method queryAction.
      *
@@ -0,0 +1,178 @@
+#include "profiler.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <iomanip>
+#include <sstream>
+
+int obelisk::Profiler::trace(unsigned int type,
+    void* context,
+    void* statement,
+    void* text)
+{
+    auto profiler = static_cast<obelisk::Profiler*>(context);
+    switch (type)
+    {
+        case SQLITE_TRACE_STMT :
+            // each trigger the statement fires is reported with a comment
+            // instead of the SQL, the statement is still the one running
+            if (std::strncmp(static_cast<const char*>(text), "--", 2) != 0)
+            {
+                profiler->start(static_cast<sqlite3_stmt*>(statement));
+            }
+            break;
+        case SQLITE_TRACE_PROFILE :
+            profiler->record(static_cast<sqlite3_stmt*>(statement));
+            break;
+        default :
+            break;
+    }
+
+    return 0;
+}
+
+sqlite3_uint64 obelisk::Profiler::now()
+{
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch())
+        .count();
+}
+
+void obelisk::Profiler::start(sqlite3_stmt* statement)
+{
+    auto time = now();
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    started_[statement] = time;
+}
+
+void obelisk::Profiler::record(sqlite3_stmt* statement)
+{
+    auto time = now();
+
+    auto sql = sqlite3_sql(statement);
+    if (sql == nullptr)
+    {
+        return;
+    }
+
+    // reset the counters so a statement that is stepped again isn't counted
+    // twice
+    auto fullScanSteps
+        = sqlite3_stmt_status(statement, SQLITE_STMTSTATUS_FULLSCAN_STEP, 1);
+    auto sorts = sqlite3_stmt_status(statement, SQLITE_STMTSTATUS_SORT, 1);
+    auto autoIndexRows
+        = sqlite3_stmt_status(statement, SQLITE_STMTSTATUS_AUTOINDEX, 1);
+    auto vmSteps = sqlite3_stmt_status(statement, SQLITE_STMTSTATUS_VM_STEP, 1);
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto started = started_.find(statement);
+    if (started == started_.end())
+    {
+        return;
+    }
+
+    auto& samples = statements_[sql];
+    samples.nanoseconds.push_back(time - started->second);
+    started_.erase(started);
+
+    samples.fullScanSteps += fullScanSteps;
+    samples.sorts += sorts;
+    samples.autoIndexRows += autoIndexRows;
+    samples.vmSteps += vmSteps;
+}
+
+void obelisk::Profiler::attach(sqlite3* dbConnection)
+{
+    sqlite3_trace_v2(dbConnection,
+        SQLITE_TRACE_STMT | SQLITE_TRACE_PROFILE,
+        &obelisk::Profiler::trace,
+        this);
+}
+
+void obelisk::Profiler::detach(sqlite3* dbConnection)
+{
+    sqlite3_trace_v2(dbConnection, 0, nullptr, nullptr);
+}
+
+std::vector<obelisk::StatementProfile> obelisk::Profiler::getProfile()
+{
+    std::vector<obelisk::StatementProfile> profile;
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    for (auto& statement : statements_)
+    {
+        auto nanoseconds = statement.second.nanoseconds;
+        std::sort(nanoseconds.begin(), nanoseconds.end());
+
+        auto percentile = [&nanoseconds](std::size_t percent)
+        {
+            return nanoseconds[(nanoseconds.size() - 1) * percent / 100];
+        };
+
+        obelisk::StatementProfile statementProfile;
+        statementProfile.sql   = statement.first;
+        statementProfile.count = nanoseconds.size();
+        for (auto time : nanoseconds)
+        {
+            statementProfile.totalNanoseconds += time;
+        }
+        statementProfile.p50Nanoseconds = percentile(50);
+        statementProfile.p90Nanoseconds = percentile(90);
+        statementProfile.p99Nanoseconds = percentile(99);
+        statementProfile.maxNanoseconds = nanoseconds.back();
+        statementProfile.fullScanSteps  = statement.second.fullScanSteps;
+        statementProfile.sorts          = statement.second.sorts;
+        statementProfile.autoIndexRows  = statement.second.autoIndexRows;
+        statementProfile.vmSteps        = statement.second.vmSteps;
+        profile.push_back(std::move(statementProfile));
+    }
+
+    std::sort(profile.begin(),
+        profile.end(),
+        [](const obelisk::StatementProfile& a,
+            const obelisk::StatementProfile& b)
+        {
+            return a.totalNanoseconds > b.totalNanoseconds;
+        });
+
+    return profile;
+}
+
+void obelisk::Profiler::reset()
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    started_.clear();
+    statements_.clear();
+}
+
+std::string obelisk::Profiler::format(
+    const std::vector<obelisk::StatementProfile>& profile)
+{
+    std::ostringstream output;
+    output << std::setw(10) << "count" << std::setw(12) << "total us"
+           << std::setw(10) << "p50 us" << std::setw(10) << "p90 us"
+           << std::setw(10) << "p99 us" << std::setw(10) << "max us"
+           << std::setw(12) << "scan rows" << std::setw(8) << "sorts"
+           << std::setw(12) << "auto index" << "  sql\n";
+
+    for (auto& statement : profile)
+    {
+        // the SQL is kept on one line so each statement is one row
+        auto sql = statement.sql;
+        std::replace(sql.begin(), sql.end(), '\n', ' ');
+
+        output << std::setw(10) << statement.count << std::setw(12)
+               << statement.totalNanoseconds / 1000 << std::setw(10)
+               << statement.p50Nanoseconds / 1000 << std::setw(10)
+               << statement.p90Nanoseconds / 1000 << std::setw(10)
+               << statement.p99Nanoseconds / 1000 << std::setw(10)
+               << statement.maxNanoseconds / 1000 << std::setw(12)
+               << statement.fullScanSteps << std::setw(8) << statement.sorts
+               << std::setw(12) << statement.autoIndexRows << "  " << sql
+               << "\n";
+    }
+
+    return output.str();
+}
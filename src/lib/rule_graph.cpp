@@ -0,0 +1,226 @@
+#include "rule_graph.h"
+
+#include <algorithm>
+#include <limits>
+#include <utility>
+
+obelisk::RuleGraph::RuleGraph(std::size_t factCount,
+    const std::vector<std::size_t>& ruleFacts,
+    const std::vector<std::size_t>& ruleReasons)
+{
+    // store the edges of each reason next to each other
+    std::vector<std::size_t> successors(factCount + 1, 0);
+    for (const auto& reason : ruleReasons)
+    {
+        successors[reason + 1]++;
+    }
+    for (std::size_t i = 0; i < factCount; i++)
+    {
+        successors[i + 1] += successors[i];
+    }
+
+    std::vector<std::size_t> targets(ruleFacts.size());
+    std::vector<std::size_t> next(successors.begin(), successors.end() - 1);
+    for (std::size_t i = 0; i < ruleFacts.size(); i++)
+    {
+        targets[next[ruleReasons[i]]++] = ruleFacts[i];
+    }
+
+    std::vector<std::size_t> component;
+    findComponents(factCount, successors, targets, component);
+
+    componentRules_.resize(components_.size());
+    cyclic_.resize(components_.size());
+    for (std::size_t i = 0; i < components_.size(); i++)
+    {
+        cyclic_[i] = components_[i].size() > 1;
+    }
+
+    for (std::size_t i = 0; i < ruleFacts.size(); i++)
+    {
+        auto factComponent = component[ruleFacts[i]];
+        componentRules_[factComponent].push_back(i);
+        if (factComponent == component[ruleReasons[i]])
+        {
+            cyclic_[factComponent] = true;
+        }
+    }
+
+    findPartitions(factCount, ruleFacts, ruleReasons);
+}
+
+void obelisk::RuleGraph::findComponents(std::size_t factCount,
+    const std::vector<std::size_t>& successors,
+    const std::vector<std::size_t>& targets,
+    std::vector<std::size_t>& component)
+{
+    const auto unvisited = std::numeric_limits<std::size_t>::max();
+
+    std::vector<std::size_t> index(factCount, unvisited);
+    std::vector<std::size_t> lowLink(factCount, 0);
+    std::vector<bool> onStack(factCount, false);
+    std::vector<std::size_t> stack;
+    std::size_t nextIndex = 0;
+
+    // each frame holds a fact and the next of its edges to follow
+    std::vector<std::pair<std::size_t, std::size_t>> frames;
+
+    auto visit = [&](std::size_t fact)
+    {
+        index[fact]   = nextIndex;
+        lowLink[fact] = nextIndex;
+        nextIndex++;
+        stack.push_back(fact);
+        onStack[fact] = true;
+        frames.push_back(std::make_pair(fact, successors[fact]));
+    };
+
+    component.assign(factCount, unvisited);
+    for (std::size_t start = 0; start < factCount; start++)
+    {
+        if (index[start] != unvisited)
+        {
+            continue;
+        }
+
+        visit(start);
+        while (!frames.empty())
+        {
+            auto fact = frames.back().first;
+            auto edge = frames.back().second;
+            if (edge < successors[fact + 1])
+            {
+                frames.back().second++;
+                auto target = targets[edge];
+                if (index[target] == unvisited)
+                {
+                    visit(target);
+                }
+                else if (onStack[target])
+                {
+                    lowLink[fact] = std::min(lowLink[fact], index[target]);
+                }
+                continue;
+            }
+
+            if (lowLink[fact] == index[fact])
+            {
+                // the fact is the root of a component, everything above it on
+                // the stack belongs to the component
+                std::vector<std::size_t> facts;
+                std::size_t member;
+                do
+                {
+                    member = stack.back();
+                    stack.pop_back();
+                    onStack[member]   = false;
+                    component[member] = components_.size();
+                    facts.push_back(member);
+                }
+                while (member != fact);
+                components_.push_back(std::move(facts));
+            }
+
+            frames.pop_back();
+            if (!frames.empty())
+            {
+                auto parent     = frames.back().first;
+                lowLink[parent] = std::min(lowLink[parent], lowLink[fact]);
+            }
+        }
+    }
+
+    // a component is found after every component that depends on it, so
+    // reverse them to put the reasons first
+    std::reverse(components_.begin(), components_.end());
+    for (auto& id : component)
+    {
+        id = components_.size() - 1 - id;
+    }
+}
+
+void obelisk::RuleGraph::findPartitions(std::size_t factCount,
+    const std::vector<std::size_t>& ruleFacts,
+    const std::vector<std::size_t>& ruleReasons)
+{
+    // union the fact and reason of every rule, ignoring the direction
+    std::vector<std::size_t> parent(factCount);
+    for (std::size_t i = 0; i < factCount; i++)
+    {
+        parent[i] = i;
+    }
+
+    auto find = [&parent](std::size_t fact)
+    {
+        while (parent[fact] != fact)
+        {
+            parent[fact] = parent[parent[fact]];
+            fact         = parent[fact];
+        }
+        return fact;
+    };
+
+    for (std::size_t i = 0; i < ruleFacts.size(); i++)
+    {
+        auto factRoot   = find(ruleFacts[i]);
+        auto reasonRoot = find(ruleReasons[i]);
+        if (factRoot != reasonRoot)
+        {
+            parent[std::max(factRoot, reasonRoot)]
+                = std::min(factRoot, reasonRoot);
+        }
+    }
+
+    // the components are already in dependency order, so adding them in order
+    // keeps each partition in dependency order too
+    const auto none = std::numeric_limits<std::size_t>::max();
+    std::vector<std::size_t> partition(factCount, none);
+    for (std::size_t c = 0; c < components_.size(); c++)
+    {
+        if (componentRules_[c].empty())
+        {
+            continue;
+        }
+
+        auto root = find(components_[c].front());
+        if (partition[root] == none)
+        {
+            partition[root] = partitions_.size();
+            partitions_.emplace_back();
+        }
+        partitions_[partition[root]].push_back(c);
+    }
+}
+
+std::size_t obelisk::RuleGraph::getComponentCount()
+{
+    return components_.size();
+}
+
+std::vector<std::size_t>& obelisk::RuleGraph::getComponent(
+    std::size_t component)
+{
+    return components_[component];
+}
+
+std::vector<std::size_t>& obelisk::RuleGraph::getComponentRules(
+    std::size_t component)
+{
+    return componentRules_[component];
+}
+
+bool obelisk::RuleGraph::isCyclic(std::size_t component)
+{
+    return cyclic_[component];
+}
+
+std::size_t obelisk::RuleGraph::getPartitionCount()
+{
+    return partitions_.size();
+}
+
+std::vector<std::size_t>& obelisk::RuleGraph::getPartition(
+    std::size_t partition)
+{
+    return partitions_[partition];
+}
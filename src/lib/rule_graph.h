@@ -0,0 +1,149 @@
+#ifndef OBELISK_RULE_GRAPH_H
+#define OBELISK_RULE_GRAPH_H
+
+#include <cstddef>
+#include <vector>
+
+namespace obelisk
+{
+    /**
+     * @brief The RuleGraph class is the dependency graph of the rules. Every
+     * Fact used by a rule is a node and every rule is an edge from its reason
+     * to its Fact.
+     *
+     * The graph is split into its strongly connected components which are
+     * ordered so that a component only depends on the components before it.
+     * Propagating the components in order visits the acyclic parts of the
+     * graph once, and only the components that contain a cycle of rules have
+     * to be repeated until they stop changing.
+     *
+     * The components are also grouped into partitions that are not connected
+     * to each other, so they can be propagated in parallel.
+     *
+     */
+    class RuleGraph
+    {
+        private:
+            /**
+             * @brief The facts in each component, in dependency order.
+             *
+             */
+            std::vector<std::vector<std::size_t>> components_;
+
+            /**
+             * @brief The rules that derive a Fact in each component.
+             *
+             */
+            std::vector<std::vector<std::size_t>> componentRules_;
+
+            /**
+             * @brief Whether each component contains a cycle of rules.
+             *
+             */
+            std::vector<bool> cyclic_;
+
+            /**
+             * @brief The components of each partition, in dependency order.
+             *
+             */
+            std::vector<std::vector<std::size_t>> partitions_;
+
+            /**
+             * @brief Find the strongly connected components with Tarjan's
+             * algorithm.
+             *
+             * The search uses its own stack so that long chains of rules can't
+             * overflow the call stack.
+             *
+             * @param[in] factCount The number of facts in the graph.
+             * @param[in] successors The start of the edges of each Fact in
+             * targets, with one extra entry marking the end.
+             * @param[in] targets The facts each Fact is a reason for.
+             * @param[out] component The component of each Fact.
+             */
+            void findComponents(std::size_t factCount,
+                const std::vector<std::size_t>& successors,
+                const std::vector<std::size_t>& targets,
+                std::vector<std::size_t>& component);
+
+            /**
+             * @brief Group the components into partitions that don't share
+             * any rules.
+             *
+             * @param[in] factCount The number of facts in the graph.
+             * @param[in] ruleFacts The index of the Fact of each rule.
+             * @param[in] ruleReasons The index of the reason of each rule.
+             */
+            void findPartitions(std::size_t factCount,
+                const std::vector<std::size_t>& ruleFacts,
+                const std::vector<std::size_t>& ruleReasons);
+
+        public:
+            /**
+             * @brief Construct a new RuleGraph object.
+             *
+             * @param[in] factCount The number of facts, each Fact is referred
+             * to by an index below this.
+             * @param[in] ruleFacts The index of the Fact of each rule.
+             * @param[in] ruleReasons The index of the reason of each rule.
+             */
+            RuleGraph(std::size_t factCount,
+                const std::vector<std::size_t>& ruleFacts,
+                const std::vector<std::size_t>& ruleReasons);
+
+            /**
+             * @brief Get the number of components.
+             *
+             * @return std::size_t The number of components.
+             */
+            std::size_t getComponentCount();
+
+            /**
+             * @brief Get the facts in a component.
+             *
+             * @param[in] component The index of the component.
+             * @return std::vector<std::size_t>& The indexes of the facts.
+             */
+            std::vector<std::size_t>& getComponent(std::size_t component);
+
+            /**
+             * @brief Get the rules that derive the facts in a component.
+             *
+             * @param[in] component The index of the component.
+             * @return std::vector<std::size_t>& The indexes of the rules.
+             */
+            std::vector<std::size_t>& getComponentRules(std::size_t component);
+
+            /**
+             * @brief Check if a component contains a cycle of rules.
+             *
+             * @param[in] component The index of the component.
+             * @return true If the facts in the component depend on each other.
+             * @return false If the component is a single Fact that doesn't
+             * depend on itself.
+             */
+            bool isCyclic(std::size_t component);
+
+            /**
+             * @brief Get the number of partitions.
+             *
+             * Facts in different partitions are never connected by a rule, so
+             * the partitions can be propagated independently of each other.
+             *
+             * @return std::size_t The number of partitions.
+             */
+            std::size_t getPartitionCount();
+
+            /**
+             * @brief Get the components in a partition that have rules
+             * deriving their facts.
+             *
+             * @param[in] partition The index of the partition.
+             * @return std::vector<std::size_t>& The indexes of the components
+             * in dependency order.
+             */
+            std::vector<std::size_t>& getPartition(std::size_t partition);
+    };
+} // namespace obelisk
+
+#endif
@@ -0,0 +1,741 @@
+#include "sharded_knowledge_base.h"
+#include "thread_pool.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <filesystem>
+
+obelisk::ShardedKnowledgeBase::ShardedKnowledgeBase(const char* filename,
+    std::size_t shards,
+    obelisk::KnowledgeBase::Layout layout)
+{
+    if (shards == 0)
+    {
+        shards = 1;
+    }
+
+    std::error_code error;
+    if (std::filesystem::exists(filename, error))
+    {
+        // the hash of each fact depends on the number of shards, so opening
+        // with a different number would lose track of the stored facts
+        std::size_t existing = 0;
+        while (std::filesystem::exists(getShardFilename(filename, existing),
+            error))
+        {
+            existing++;
+        }
+
+        if (existing != shards)
+        {
+            throw obelisk::KnowledgeBaseException("knowledge base has "
+                + std::to_string(existing) + " shards, not "
+                + std::to_string(shards));
+        }
+    }
+
+    dictionary_ = std::unique_ptr<obelisk::KnowledgeBase> {
+        new obelisk::KnowledgeBase(filename, layout)};
+
+    for (std::size_t i = 0; i < shards; i++)
+    {
+        shards_.push_back(std::unique_ptr<obelisk::KnowledgeBase> {
+            new obelisk::KnowledgeBase(getShardFilename(filename, i).c_str(),
+                layout)});
+    }
+
+    shardEntities_.resize(shards);
+    shardVerbs_.resize(shards);
+    shardActions_.resize(shards);
+
+    setThreads(threads_);
+}
+
+std::string obelisk::ShardedKnowledgeBase::getShardFilename(
+    const std::string& filename,
+    std::size_t shard)
+{
+    std::filesystem::path path(filename);
+    auto extension = path.extension();
+    path.replace_extension(std::to_string(shard));
+    path += extension;
+    return path.string();
+}
+
+std::size_t obelisk::ShardedKnowledgeBase::getShardCount()
+{
+    return shards_.size();
+}
+
+std::size_t obelisk::ShardedKnowledgeBase::getShard(sqlite3_int64 entityId)
+{
+    // mix the bits of the ID so entities created in a row are spread over the
+    // shards instead of taking turns
+    auto hash = static_cast<std::uint64_t>(entityId);
+    hash      = (hash ^ (hash >> 30)) * 0xbf58476d1ce4e5b9ULL;
+    hash      = (hash ^ (hash >> 27)) * 0x94d049bb133111ebULL;
+    hash      = hash ^ (hash >> 31);
+    return hash % shards_.size();
+}
+
+obelisk::KnowledgeBase& obelisk::ShardedKnowledgeBase::getShardKnowledgeBase(
+    std::size_t shard)
+{
+    return *shards_.at(shard);
+}
+
+void obelisk::ShardedKnowledgeBase::getEntity(obelisk::Entity& entity)
+{
+    dictionary_->getEntity(entity);
+}
+
+void obelisk::ShardedKnowledgeBase::setEvaluation(
+    obelisk::KnowledgeBase::Evaluation evaluation)
+{
+    for (auto& shard : shards_)
+    {
+        shard->setEvaluation(evaluation);
+    }
+}
+
+void obelisk::ShardedKnowledgeBase::setCombine(
+    obelisk::KnowledgeBase::Combine combine)
+{
+    // the chains across the shards are combined in the dictionary
+    dictionary_->setCombine(combine);
+    for (auto& shard : shards_)
+    {
+        shard->setCombine(combine);
+    }
+}
+
+unsigned int obelisk::ShardedKnowledgeBase::getThreads()
+{
+    return threads_;
+}
+
+void obelisk::ShardedKnowledgeBase::setThreads(unsigned int threads)
+{
+    threads_ = threads;
+
+    auto shardThreads = std::max<std::size_t>(1, threads / shards_.size());
+    for (auto& shard : shards_)
+    {
+        shard->setThreads(shardThreads);
+    }
+}
+
+void obelisk::ShardedKnowledgeBase::beginTransaction()
+{
+    dictionary_->beginTransaction();
+    for (auto& shard : shards_)
+    {
+        shard->beginTransaction();
+    }
+}
+
+void obelisk::ShardedKnowledgeBase::commitTransaction()
+{
+    dictionary_->commitTransaction();
+    for (auto& shard : shards_)
+    {
+        shard->commitTransaction();
+    }
+}
+
+void obelisk::ShardedKnowledgeBase::rollbackTransaction()
+{
+    dictionary_->rollbackTransaction();
+    for (auto& shard : shards_)
+    {
+        shard->rollbackTransaction();
+    }
+
+    // the rows written since the transaction started are gone, so nothing
+    // cached about them can be trusted
+    entityIds_.clear();
+    verbIds_.clear();
+    for (std::size_t shard = 0; shard < shards_.size(); shard++)
+    {
+        shardEntities_[shard].clear();
+        shardVerbs_[shard].clear();
+        shardActions_[shard].clear();
+    }
+    transitiveVerbs_.clear();
+    exchangedVerbs_.clear();
+    pulledFacts_.clear();
+}
+
+void obelisk::ShardedKnowledgeBase::resolveEntity(obelisk::Entity& entity)
+{
+    auto found = entityIds_.find(entity.getName());
+    if (found != entityIds_.end())
+    {
+        entity.setId(found->second);
+        return;
+    }
+
+    std::vector<obelisk::Entity> entities {entity};
+    dictionary_->addEntities(entities);
+    entity = std::move(entities.front());
+
+    // the id was not inserted, so check if it exists in the dictionary
+    if (entity.getId() == 0)
+    {
+        dictionary_->getEntity(entity);
+        if (entity.getId() == 0)
+        {
+            throw obelisk::KnowledgeBaseException(
+                "entity could not be inserted into the dictionary");
+        }
+    }
+    entityIds_.emplace(entity.getName(), entity.getId());
+}
+
+void obelisk::ShardedKnowledgeBase::resolveVerb(obelisk::Verb& verb)
+{
+    auto found = verbIds_.find(verb.getName());
+    if (found != verbIds_.end())
+    {
+        verb.setId(found->second);
+        return;
+    }
+
+    std::vector<obelisk::Verb> verbs {verb};
+    dictionary_->addVerbs(verbs);
+    verb = std::move(verbs.front());
+
+    // the id was not inserted, so check if it exists in the dictionary
+    if (verb.getId() == 0)
+    {
+        dictionary_->getVerb(verb);
+        if (verb.getId() == 0)
+        {
+            throw obelisk::KnowledgeBaseException(
+                "verb could not be inserted into the dictionary");
+        }
+    }
+    verbIds_.emplace(verb.getName(), verb.getId());
+}
+
+void obelisk::ShardedKnowledgeBase::resolveAction(obelisk::Action& action)
+{
+    std::vector<obelisk::Action> actions {action};
+    dictionary_->addActions(actions);
+    action = std::move(actions.front());
+
+    // the id was not inserted, so check if it exists in the dictionary
+    if (action.getId() == 0)
+    {
+        dictionary_->getAction(action);
+        if (action.getId() == 0)
+        {
+            throw obelisk::KnowledgeBaseException(
+                "action could not be inserted into the dictionary");
+        }
+    }
+}
+
+void obelisk::ShardedKnowledgeBase::resolveFact(obelisk::Fact& fact)
+{
+    resolveEntity(fact.getLeftEntity());
+    resolveEntity(fact.getRightEntity());
+    resolveVerb(fact.getVerb());
+}
+
+void obelisk::ShardedKnowledgeBase::copyEntity(std::size_t shard,
+    obelisk::Entity& entity)
+{
+    if (shardEntities_[shard].count(entity.getId()) > 0)
+    {
+        return;
+    }
+
+    // the shard may have been filled before it was opened
+    obelisk::Entity existing(entity.getName());
+    shards_[shard]->getEntity(existing);
+    if (existing.getId() == 0)
+    {
+        std::vector<obelisk::Entity> entities {entity};
+        shards_[shard]->addEntities(entities);
+    }
+    else if (existing.getId() != entity.getId())
+    {
+        throw obelisk::KnowledgeBaseException(
+            "entity in shard doesn't match the dictionary");
+    }
+
+    shardEntities_[shard].insert(entity.getId());
+}
+
+void obelisk::ShardedKnowledgeBase::copyVerb(std::size_t shard,
+    obelisk::Verb& verb)
+{
+    if (shardVerbs_[shard].count(verb.getId()) > 0)
+    {
+        return;
+    }
+
+    obelisk::Verb existing(verb.getName());
+    shards_[shard]->getVerb(existing);
+    if (existing.getId() == 0)
+    {
+        std::vector<obelisk::Verb> verbs {verb};
+        shards_[shard]->addVerbs(verbs);
+    }
+    else if (existing.getId() != verb.getId())
+    {
+        throw obelisk::KnowledgeBaseException(
+            "verb in shard doesn't match the dictionary");
+    }
+
+    shardVerbs_[shard].insert(verb.getId());
+}
+
+void obelisk::ShardedKnowledgeBase::copyAction(std::size_t shard,
+    obelisk::Action& action)
+{
+    if (shardActions_[shard].count(action.getId()) > 0)
+    {
+        return;
+    }
+
+    obelisk::Action existing(action.getName());
+    shards_[shard]->getAction(existing);
+    if (existing.getId() == 0)
+    {
+        std::vector<obelisk::Action> actions {action};
+        shards_[shard]->addActions(actions);
+    }
+    else if (existing.getId() != action.getId())
+    {
+        throw obelisk::KnowledgeBaseException(
+            "action in shard doesn't match the dictionary");
+    }
+
+    shardActions_[shard].insert(action.getId());
+}
+
+bool obelisk::ShardedKnowledgeBase::isTransitive(obelisk::Verb& verb)
+{
+    auto found = transitiveVerbs_.find(verb.getId());
+    if (found != transitiveVerbs_.end())
+    {
+        return found->second;
+    }
+
+    obelisk::Verb stored(verb.getName());
+    dictionary_->getVerb(stored);
+    transitiveVerbs_.emplace(verb.getId(), stored.getTransitive());
+    return stored.getTransitive();
+}
+
+bool obelisk::ShardedKnowledgeBase::isExchanged(obelisk::Verb& verb)
+{
+    auto found = exchangedVerbs_.find(verb.getId());
+    if (found != exchangedVerbs_.end())
+    {
+        return found->second;
+    }
+
+    // the dictionary only has facts of the verbs that have copies
+    long long trueFacts  = 0;
+    long long falseFacts = 0;
+    obelisk::Verb stored(verb.getId(), verb.getName());
+    dictionary_->getStatistics(stored, trueFacts, falseFacts);
+    auto exchanged = isTransitive(verb) || trueFacts + falseFacts > 0;
+    exchangedVerbs_.emplace(verb.getId(), exchanged);
+    return exchanged;
+}
+
+bool obelisk::ShardedKnowledgeBase::raiseFact(
+    obelisk::KnowledgeBase& knowledgeBase,
+    obelisk::Fact& fact,
+    bool insert)
+{
+    obelisk::Fact stored(fact.getLeftEntity(),
+        fact.getRightEntity(),
+        fact.getVerb());
+    knowledgeBase.getFact(stored);
+    if (stored.getId() == 0)
+    {
+        if (!insert)
+        {
+            return false;
+        }
+
+        std::vector<obelisk::Fact> facts {fact};
+        facts.front().setId(0);
+        knowledgeBase.addFacts(facts);
+        if (facts.front().getId() == 0)
+        {
+            throw obelisk::KnowledgeBaseException(
+                "fact could not be inserted into the knowledge base");
+        }
+        fact.setId(facts.front().getId());
+        return true;
+    }
+
+    fact.setId(stored.getId());
+    if (fact.getIsTrue() > stored.getIsTrue() + kEpsilon)
+    {
+        stored.setIsTrue(fact.getIsTrue());
+        knowledgeBase.updateIsTrue(stored);
+        return true;
+    }
+
+    fact.setIsTrue(stored.getIsTrue());
+    return false;
+}
+
+bool obelisk::ShardedKnowledgeBase::insertFact(std::size_t shard,
+    obelisk::Fact& fact)
+{
+    copyEntity(shard, fact.getLeftEntity());
+    copyEntity(shard, fact.getRightEntity());
+    copyVerb(shard, fact.getVerb());
+
+    return raiseFact(*shards_[shard], fact, true);
+}
+
+void obelisk::ShardedKnowledgeBase::insertHomeFact(obelisk::Fact& fact)
+{
+    insertFact(getShard(fact.getLeftEntity().getId()), fact);
+
+    // the dictionary follows the chains of a transitive verb across shards
+    if (isTransitive(fact.getVerb()))
+    {
+        auto copy = fact;
+        raiseFact(*dictionary_, copy, true);
+    }
+}
+
+void obelisk::ShardedKnowledgeBase::addFacts(std::vector<obelisk::Fact>& facts)
+{
+    for (auto& fact : facts)
+    {
+        resolveFact(fact);
+        insertHomeFact(fact);
+    }
+}
+
+void obelisk::ShardedKnowledgeBase::addRules(std::vector<obelisk::Rule>& rules)
+{
+    for (auto& rule : rules)
+    {
+        resolveFact(rule.getFact());
+        resolveFact(rule.getReason());
+
+        auto& reason = rule.getReason();
+        insertHomeFact(reason);
+
+        // the rule is kept with every other rule that derives its fact, and
+        // reads a copy of a reason that belongs to another shard
+        auto shard = getShard(rule.getFact().getLeftEntity().getId());
+        if (getShard(reason.getLeftEntity().getId()) != shard)
+        {
+            auto copy = reason;
+            raiseFact(*dictionary_, copy, true);
+            exchangedVerbs_[reason.getVerb().getId()] = true;
+
+            insertFact(shard, reason);
+        }
+        insertHomeFact(rule.getFact());
+
+        std::vector<obelisk::Rule> shardRules {rule};
+        shards_[shard]->addRules(shardRules);
+        rule = std::move(shardRules.front());
+    }
+}
+
+void obelisk::ShardedKnowledgeBase::addPatternRules(
+    std::vector<obelisk::PatternRule>& patternRules)
+{
+    for (auto& patternRule : patternRules)
+    {
+        auto& fact   = patternRule.getFact();
+        auto& reason = patternRule.getReason();
+
+        if (patternRule.getFactLeftVariable() == "")
+        {
+            resolveEntity(fact.getLeftEntity());
+        }
+        if (patternRule.getFactRightVariable() == "")
+        {
+            resolveEntity(fact.getRightEntity());
+        }
+        resolveVerb(fact.getVerb());
+
+        if (patternRule.getReasonLeftVariable() == "")
+        {
+            resolveEntity(reason.getLeftEntity());
+        }
+        if (patternRule.getReasonRightVariable() == "")
+        {
+            resolveEntity(reason.getRightEntity());
+        }
+        resolveVerb(reason.getVerb());
+
+        // the reason can only match the facts of the shard of its left
+        // entity, a variable matches facts in every shard
+        std::size_t first = 0;
+        std::size_t last  = shards_.size();
+        if (patternRule.getReasonLeftVariable() == "")
+        {
+            first = getShard(reason.getLeftEntity().getId());
+            last  = first + 1;
+        }
+
+        obelisk::PatternRule result;
+        for (auto shard = first; shard < last; shard++)
+        {
+            if (patternRule.getFactLeftVariable() == "")
+            {
+                copyEntity(shard, fact.getLeftEntity());
+            }
+            if (patternRule.getFactRightVariable() == "")
+            {
+                copyEntity(shard, fact.getRightEntity());
+            }
+            copyVerb(shard, fact.getVerb());
+
+            if (patternRule.getReasonLeftVariable() == "")
+            {
+                copyEntity(shard, reason.getLeftEntity());
+            }
+            if (patternRule.getReasonRightVariable() == "")
+            {
+                copyEntity(shard, reason.getRightEntity());
+            }
+            copyVerb(shard, reason.getVerb());
+
+            std::vector<obelisk::PatternRule> shardPatternRules {patternRule};
+            shards_[shard]->addPatternRules(shardPatternRules);
+            result = std::move(shardPatternRules.front());
+        }
+        patternRule = std::move(result);
+    }
+}
+
+void obelisk::ShardedKnowledgeBase::addSuggestActions(
+    std::vector<obelisk::SuggestAction>& suggestActions)
+{
+    for (auto& suggestAction : suggestActions)
+    {
+        resolveFact(suggestAction.getFact());
+        resolveAction(suggestAction.getTrueAction());
+        resolveAction(suggestAction.getFalseAction());
+
+        auto shard
+            = getShard(suggestAction.getFact().getLeftEntity().getId());
+        insertHomeFact(suggestAction.getFact());
+        copyAction(shard, suggestAction.getTrueAction());
+        copyAction(shard, suggestAction.getFalseAction());
+
+        std::vector<obelisk::SuggestAction> shardSuggestActions {
+            suggestAction};
+        shards_[shard]->addSuggestActions(shardSuggestActions);
+        suggestAction = std::move(shardSuggestActions.front());
+    }
+}
+
+void obelisk::ShardedKnowledgeBase::setTransitive(obelisk::Verb& verb)
+{
+    resolveVerb(verb);
+    dictionary_->setTransitive(verb);
+    transitiveVerbs_[verb.getId()] = true;
+    exchangedVerbs_[verb.getId()]  = true;
+
+    // a shard that already has the Verb builds the Closure of its facts, and
+    // the dictionary joins the chains of all the shards
+    for (std::size_t shard = 0; shard < shards_.size(); shard++)
+    {
+        copyVerb(shard, verb);
+        shards_[shard]->setTransitive(verb);
+
+        obelisk::Fact pattern(obelisk::Entity(),
+            obelisk::Entity(),
+            obelisk::Verb(verb.getName()));
+        auto cursor = shards_[shard]->queryPattern(pattern);
+        obelisk::Fact fact;
+        while (cursor->step(fact))
+        {
+            if (getShard(fact.getLeftEntity().getId()) == shard)
+            {
+                raiseFact(*dictionary_, fact, true);
+            }
+        }
+    }
+}
+
+void obelisk::ShardedKnowledgeBase::propagate()
+{
+    bool changed {true};
+    while (changed)
+    {
+        propagateShards();
+
+        beginTransaction();
+        try
+        {
+            changed = exchange();
+        }
+        catch (std::exception& exception)
+        {
+            rollbackTransaction();
+            throw;
+        }
+        commitTransaction();
+    }
+}
+
+void obelisk::ShardedKnowledgeBase::propagateShards()
+{
+    if (getThreads() > 1 && shards_.size() > 1)
+    {
+        obelisk::ThreadPool threadPool(
+            std::min<std::size_t>(getThreads(), shards_.size()));
+        for (auto& shard : shards_)
+        {
+            auto knowledgeBase = shard.get();
+            threadPool.submit([knowledgeBase]
+                {
+                    knowledgeBase->propagate();
+                });
+        }
+        threadPool.wait();
+    }
+    else
+    {
+        for (auto& shard : shards_)
+        {
+            shard->propagate();
+        }
+    }
+}
+
+bool obelisk::ShardedKnowledgeBase::exchange()
+{
+    bool changed {false};
+
+    // a copy derived in another shard raises its fact, and the dictionary is
+    // raised to the facts it keeps a copy of
+    for (std::size_t shard = 0; shard < shards_.size(); shard++)
+    {
+        obelisk::Fact pattern;
+        auto cursor = shards_[shard]->queryPattern(pattern);
+        obelisk::Fact fact;
+        while (cursor->step(fact))
+        {
+            auto home = getShard(fact.getLeftEntity().getId());
+            if (home != shard)
+            {
+                changed = insertFact(home, fact) || changed;
+            }
+            else if (isExchanged(fact.getVerb()))
+            {
+                raiseFact(*dictionary_, fact, isTransitive(fact.getVerb()));
+            }
+        }
+    }
+
+    // the chains that cross shards raise the facts they connect, then every
+    // fact raised in the dictionary raises its copies
+    dictionary_->propagate();
+    obelisk::Fact pattern;
+    auto cursor = dictionary_->queryPattern(pattern);
+    obelisk::Fact fact;
+    while (cursor->step(fact))
+    {
+        auto pulled = pulledFacts_.find(fact.getId());
+        if (pulled != pulledFacts_.end()
+            && fact.getIsTrue() <= pulled->second + kEpsilon)
+        {
+            continue;
+        }
+        pulledFacts_[fact.getId()] = fact.getIsTrue();
+
+        for (auto& shard : shards_)
+        {
+            auto copy = fact;
+            changed   = raiseFact(*shard, copy, false) || changed;
+        }
+    }
+
+    return changed;
+}
+
+void obelisk::ShardedKnowledgeBase::queryFact(obelisk::Fact& fact)
+{
+    queryFact(fact, shards_.front()->getEvaluation());
+}
+
+void obelisk::ShardedKnowledgeBase::queryFact(obelisk::Fact& fact,
+    obelisk::KnowledgeBase::Evaluation evaluation)
+{
+    obelisk::Entity leftEntity(fact.getLeftEntity().getName());
+    dictionary_->getEntity(leftEntity);
+    if (leftEntity.getId() == 0)
+    {
+        // nothing is known about an entity that isn't in the dictionary
+        fact.setIsTrue(0);
+        return;
+    }
+
+    shards_[getShard(leftEntity.getId())]->queryFact(fact, evaluation);
+
+    // a chain through other shards is only in the dictionary
+    if (fact.getVerb().getTransitive())
+    {
+        obelisk::Fact chain(obelisk::Entity(fact.getLeftEntity().getName()),
+            obelisk::Entity(fact.getRightEntity().getName()),
+            obelisk::Verb(fact.getVerb().getName()));
+        dictionary_->queryFact(chain,
+            obelisk::KnowledgeBase::kEvaluationForward);
+        fact.setIsTrue(std::max(fact.getIsTrue(), chain.getIsTrue()));
+    }
+}
+
+void obelisk::ShardedKnowledgeBase::querySuggestAction(obelisk::Fact& fact,
+    obelisk::Action& action)
+{
+    obelisk::Entity leftEntity(fact.getLeftEntity().getName());
+    dictionary_->getEntity(leftEntity);
+    if (leftEntity.getId() == 0)
+    {
+        return;
+    }
+
+    shards_[getShard(leftEntity.getId())]->queryAction(fact, action);
+}
+
+std::vector<std::unique_ptr<obelisk::FactCursor>>
+    obelisk::ShardedKnowledgeBase::queryPattern(obelisk::Fact& pattern)
+{
+    std::vector<std::unique_ptr<obelisk::FactCursor>> cursors;
+
+    if (pattern.getLeftEntity().getName() != "")
+    {
+        obelisk::Entity leftEntity(pattern.getLeftEntity().getName());
+        dictionary_->getEntity(leftEntity);
+        if (leftEntity.getId() != 0)
+        {
+            cursors.push_back(
+                shards_[getShard(leftEntity.getId())]->queryPattern(pattern));
+        }
+        return cursors;
+    }
+
+    for (std::size_t shard = 0; shard < shards_.size(); shard++)
+    {
+        // each cursor looks the names up again in its own shard, and skips
+        // the copies so every fact is returned once
+        auto shardPattern = pattern;
+        cursors.push_back(shards_[shard]->queryPattern(shardPattern));
+        cursors.back()->setFilter([this, shard](obelisk::Fact& fact)
+            {
+                return getShard(fact.getLeftEntity().getId()) == shard;
+            });
+    }
+    return cursors;
+}
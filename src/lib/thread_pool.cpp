@@ -0,0 +1,140 @@
+#include "thread_pool.h"
+
+obelisk::ThreadPool::ThreadPool(std::size_t threads)
+{
+    if (threads == 0)
+    {
+        threads = 1;
+    }
+
+    for (std::size_t i = 0; i < threads; i++)
+    {
+        queues_.push_back(std::unique_ptr<Queue> {new Queue()});
+    }
+
+    for (std::size_t i = 0; i < threads; i++)
+    {
+        threads_.push_back(std::thread(&obelisk::ThreadPool::work, this, i));
+    }
+}
+
+obelisk::ThreadPool::~ThreadPool()
+{
+    {
+        std::unique_lock<std::mutex> lock(mutex_);
+        finished_.wait(lock, [this] { return pending_ == 0; });
+        stop_ = true;
+    }
+    queued_.notify_all();
+
+    for (auto& thread : threads_)
+    {
+        thread.join();
+    }
+}
+
+void obelisk::ThreadPool::submit(std::function<void()> task)
+{
+    {
+        // the task is counted in the same step it is queued, so it can't be
+        // taken before it is counted
+        std::lock_guard<std::mutex> lock(mutex_);
+        auto& queue = queues_[next_++ % queues_.size()];
+        {
+            std::lock_guard<std::mutex> queueLock(queue->mutex);
+            queue->tasks.push_back(std::move(task));
+        }
+        waiting_++;
+        pending_++;
+    }
+    queued_.notify_one();
+}
+
+void obelisk::ThreadPool::wait()
+{
+    std::unique_lock<std::mutex> lock(mutex_);
+    finished_.wait(lock, [this] { return pending_ == 0; });
+
+    if (exception_)
+    {
+        auto exception = exception_;
+        exception_     = nullptr;
+        std::rethrow_exception(exception);
+    }
+}
+
+bool obelisk::ThreadPool::takeTask(std::size_t thread,
+    std::function<void()>& task)
+{
+    for (std::size_t i = 0; i < queues_.size(); i++)
+    {
+        auto& queue = queues_[(thread + i) % queues_.size()];
+        std::lock_guard<std::mutex> queueLock(queue->mutex);
+        if (queue->tasks.empty())
+        {
+            continue;
+        }
+
+        if (i == 0)
+        {
+            // the newest task in its own queue is the most likely to still
+            // be in the cache
+            task = std::move(queue->tasks.back());
+            queue->tasks.pop_back();
+        }
+        else
+        {
+            task = std::move(queue->tasks.front());
+            queue->tasks.pop_front();
+        }
+        return true;
+    }
+
+    return false;
+}
+
+void obelisk::ThreadPool::work(std::size_t thread)
+{
+    while (true)
+    {
+        std::function<void()> task;
+        if (takeTask(thread, task))
+        {
+            {
+                std::lock_guard<std::mutex> lock(mutex_);
+                waiting_--;
+            }
+
+            try
+            {
+                task();
+            }
+            catch (...)
+            {
+                std::lock_guard<std::mutex> lock(mutex_);
+                if (!exception_)
+                {
+                    exception_ = std::current_exception();
+                }
+            }
+
+            bool finished {false};
+            {
+                std::lock_guard<std::mutex> lock(mutex_);
+                finished = --pending_ == 0;
+            }
+            if (finished)
+            {
+                finished_.notify_all();
+            }
+            continue;
+        }
+
+        std::unique_lock<std::mutex> lock(mutex_);
+        queued_.wait(lock, [this] { return stop_ || waiting_ > 0; });
+        if (stop_ && waiting_ == 0)
+        {
+            return;
+        }
+    }
+}
@@ -0,0 +1,157 @@
+#ifndef OBELISK_THREAD_POOL_H
+#define OBELISK_THREAD_POOL_H
+
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace obelisk
+{
+    /**
+     * @brief The ThreadPool class runs tasks on a fixed number of threads.
+     *
+     * Every thread has its own queue of tasks. A thread takes the newest task
+     * from its own queue and when that is empty it steals the oldest task
+     * from another queue, so uneven tasks still keep every thread busy.
+     *
+     */
+    class ThreadPool
+    {
+        private:
+            /**
+             * @brief The queue of tasks belonging to one thread.
+             *
+             */
+            struct Queue
+            {
+                    /**
+                     * @brief Protects the tasks.
+                     *
+                     */
+                    std::mutex mutex;
+
+                    /**
+                     * @brief The tasks waiting to run.
+                     *
+                     */
+                    std::deque<std::function<void()>> tasks;
+            };
+
+            /**
+             * @brief The queue of each thread.
+             *
+             */
+            std::vector<std::unique_ptr<Queue>> queues_;
+
+            /**
+             * @brief The threads running the tasks.
+             *
+             */
+            std::vector<std::thread> threads_;
+
+            /**
+             * @brief Protects the counters and the first exception.
+             *
+             */
+            std::mutex mutex_;
+
+            /**
+             * @brief Signaled when a task is queued or the pool is stopped.
+             *
+             */
+            std::condition_variable queued_;
+
+            /**
+             * @brief Signaled when every task has finished.
+             *
+             */
+            std::condition_variable finished_;
+
+            /**
+             * @brief The number of tasks waiting in the queues.
+             *
+             */
+            std::size_t waiting_ = 0;
+
+            /**
+             * @brief The number of tasks that haven't finished yet.
+             *
+             */
+            std::size_t pending_ = 0;
+
+            /**
+             * @brief The queue the next task is added to.
+             *
+             */
+            std::size_t next_ = 0;
+
+            /**
+             * @brief Set when the pool is being destroyed.
+             *
+             */
+            bool stop_ = false;
+
+            /**
+             * @brief The first exception thrown by a task.
+             *
+             */
+            std::exception_ptr exception_;
+
+            /**
+             * @brief Take a task from the thread's own queue or steal one
+             * from another queue.
+             *
+             * @param[in] thread The index of the thread.
+             * @param[out] task The task that was taken.
+             * @return true If a task was taken.
+             * @return false If every queue is empty.
+             */
+            bool takeTask(std::size_t thread, std::function<void()>& task);
+
+            /**
+             * @brief Run tasks until the pool is stopped.
+             *
+             * @param[in] thread The index of the thread.
+             */
+            void work(std::size_t thread);
+
+        public:
+            /**
+             * @brief Construct a new ThreadPool object.
+             *
+             * @param[in] threads The number of threads to start, at least one
+             * is always started.
+             */
+            ThreadPool(std::size_t threads);
+
+            /**
+             * @brief Destroy the ThreadPool object.
+             *
+             * The tasks that are still queued are finished before the threads
+             * are stopped.
+             */
+            ~ThreadPool();
+
+            /**
+             * @brief Queue a task to run on the pool.
+             *
+             * @param[in] task The task.
+             */
+            void submit(std::function<void()> task);
+
+            /**
+             * @brief Wait for every queued task to finish.
+             *
+             * If a task threw an exception the first one is thrown again here.
+             */
+            void wait();
+    };
+} // namespace obelisk
+
+#endif
@@ -1,49 +1,404 @@
 #include "knowledge_base.h"
 #include "lexer.h"
 #include "main.h"
+#include "models/error.h"
 #include "obelisk.h"
 #include "parser.h"
+#include "sharded_knowledge_base.h"
+#include "statement.h"
 #include "version.h"
 
+#include <algorithm>
+#include <chrono>
+#include <ctime>
+#include <filesystem>
+#include <fstream>
 #include <iomanip>
 #include <iostream>
 #include <limits>
 #include <memory>
+#include <thread>
 
 int obelisk::mainLoop(const std::vector<std::string>& sourceFiles,
-    const std::string& kbFile)
+    const std::string& kbFile,
+    obelisk::KnowledgeBase::Evaluation evaluation,
+    obelisk::KnowledgeBase::Combine combine,
+    unsigned int threads,
+    obelisk::KnowledgeBase::Layout layout,
+    obelisk::KnowledgeBase::Storage storage,
+    const std::string& replicaFile,
+    bool profile,
+    const std::string& emitFile,
+    bool stats,
+    std::size_t shards)
 {
     std::unique_ptr<obelisk::KnowledgeBase> kb;
+    auto parser
+        = std::unique_ptr<obelisk::Parser> {new obelisk::Parser(nullptr)};
+
+    if (shards > 0
+        && (emitFile != "" || storage == obelisk::KnowledgeBase::kStorageMemory
+            || replicaFile != "" || profile || stats))
+    {
+        std::cout << "Error: --shards can't be used with --emit, --memory, "
+                     "--profile, --replica or --stats"
+                  << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    if (emitFile != "" || shards > 0)
+    {
+        // only parse the source code, the statements are kept to be written
+        // to the compiled file or split into the shards at the end
+        parser->setRetainStatements(true);
+    }
+    else
+    {
+        try
+        {
+            kb = std::unique_ptr<obelisk::KnowledgeBase> {
+                new obelisk::KnowledgeBase(kbFile.c_str(), layout, storage)};
+        }
+        catch (obelisk::KnowledgeBaseException& exception)
+        {
+            std::cout << exception.what() << std::endl;
+            return EXIT_FAILURE;
+        }
+
+        kb->setEvaluation(evaluation);
+        kb->setCombine(combine);
+        kb->setThreads(threads);
+        kb->setProfiling(profile);
+    }
+
+    std::vector<obelisk::SourceStatistics> sourceStatistics;
+    for (auto& sourceFile : sourceFiles)
+    {
+        obelisk::SourceStatistics statistics;
+        obelisk::SourceStatistics before;
+        if (stats)
+        {
+            statistics.name = sourceFile;
+            std::error_code error;
+            statistics.bytes = std::filesystem::file_size(sourceFile, error);
+            if (error)
+            {
+                statistics.bytes = 0;
+            }
+            before = obelisk::getParserCounts(*parser);
+        }
+
+        auto start  = obelisk::getTime();
+        auto result = EXIT_SUCCESS;
+        if (obelisk::isCompiled(sourceFile))
+        {
+            result = obelisk::loadCompiled(*parser, kb, sourceFile);
+        }
+        else
+        {
+            result = obelisk::compileSource(*parser, kb, sourceFile, stats);
+        }
+        if (result != EXIT_SUCCESS)
+        {
+            return result;
+        }
+
+        if (stats)
+        {
+            // the rest of the batch is inserted so its rows and time belong
+            // to this source file
+            if (kb)
+            {
+                try
+                {
+                    parser->insertStatements(kb);
+                }
+                catch (obelisk::ParserException& exception)
+                {
+                    std::cout << "Error: " << exception.what() << std::endl;
+                    return EXIT_FAILURE;
+                }
+                catch (obelisk::DatabaseException& exception)
+                {
+                    std::cout << "Error: " << exception.what() << std::endl;
+                    return EXIT_FAILURE;
+                }
+            }
+
+            auto elapsed = obelisk::getTimeSince(start);
+            obelisk::setParserCounts(*parser, before, statistics);
+            if (!obelisk::isCompiled(sourceFile))
+            {
+                auto lexer                 = parser->getLexer();
+                statistics.tokens          = lexer->getTokenCount();
+                statistics.lex.wallSeconds = lexer->getWallSeconds();
+                statistics.lex.cpuSeconds  = lexer->getCpuSeconds();
+            }
+
+            // the parser lexes as it parses, so the time the lexer spent on
+            // its tokens is taken out of the time of parsing
+            statistics.parse.wallSeconds = std::max(elapsed.wallSeconds
+                    - statistics.insert.wallSeconds
+                    - statistics.lex.wallSeconds,
+                0.0);
+            statistics.parse.cpuSeconds  = std::max(elapsed.cpuSeconds
+                    - statistics.insert.cpuSeconds
+                    - statistics.lex.cpuSeconds,
+                0.0);
+            sourceStatistics.push_back(statistics);
+        }
+    }
+
+    obelisk::SourceStatistics totalStatistics;
+    totalStatistics.name = "total";
+    for (auto& statistics : sourceStatistics)
+    {
+        obelisk::addStatistics(totalStatistics, statistics);
+    }
+
+    if (emitFile != "")
+    {
+        try
+        {
+            std::ofstream stream(emitFile, std::ios::binary);
+            if (!stream)
+            {
+                throw obelisk::StatementArenaException(
+                    "could not open " + emitFile);
+            }
+            parser->getArena().write(stream);
+        }
+        catch (obelisk::StatementArenaException& exception)
+        {
+            std::cout << "Error: " << exception.what() << std::endl;
+            return EXIT_FAILURE;
+        }
+        if (stats)
+        {
+            for (auto& statistics : sourceStatistics)
+            {
+                obelisk::printStatistics(statistics);
+            }
+            obelisk::printStatistics(totalStatistics);
+        }
+        return EXIT_SUCCESS;
+    }
+
+    if (shards > 0)
+    {
+        return obelisk::compileSharded(*parser,
+            kbFile,
+            shards,
+            evaluation,
+            combine,
+            threads,
+            layout);
+    }
 
     try
     {
-        kb = std::unique_ptr<obelisk::KnowledgeBase> {
-            new obelisk::KnowledgeBase(kbFile.c_str())};
+        parser->insertStatements(kb);
+    }
+    catch (obelisk::ParserException& exception)
+    {
+        std::cout << "Error: " << exception.what() << std::endl;
+        return EXIT_FAILURE;
+    }
+    catch (obelisk::DatabaseException& exception)
+    {
+        std::cout << "Error: " << exception.what() << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    // everything is loaded, derive the facts in one pass
+    obelisk::PhaseTime propagateTime;
+    try
+    {
+        auto start = obelisk::getTime();
+        kb->propagate();
+        propagateTime = obelisk::getTimeSince(start);
+        kb->save();
+        if (replicaFile != "")
+        {
+            kb->backup(replicaFile);
+        }
     }
     catch (obelisk::KnowledgeBaseException& exception)
     {
-        std::cout << exception.what() << std::endl;
+        std::cout << "Error: " << exception.what() << std::endl;
+        return EXIT_FAILURE;
+    }
+    catch (obelisk::DatabaseException& exception)
+    {
+        std::cout << "Error: " << exception.what() << std::endl;
         return EXIT_FAILURE;
     }
+    if (profile)
+    {
+        std::cout << obelisk::Profiler::format(kb->getProfile());
+    }
+    if (stats)
+    {
+        for (auto& statistics : sourceStatistics)
+        {
+            obelisk::printStatistics(statistics);
+        }
+        obelisk::printStatistics(totalStatistics);
+
+        auto& propagation = kb->getPropagationStatistics();
+        obelisk::printPhaseTime("propagate", propagateTime);
+        std::cout << "  " << std::left << std::setw(12) << "steps"
+                  << propagation.rulePasses << " rule passes, "
+                  << propagation.componentSweeps << " component sweeps, "
+                  << propagation.patternRulePasses << " pattern rule passes"
+                  << std::endl;
+        std::cout << "  " << std::setw(12) << "derived"
+                  << propagation.derivedFacts << " facts by rules, "
+                  << propagation.derivedPatternFacts
+                  << " facts by pattern rules" << std::right << std::endl;
+    }
+
+    return EXIT_SUCCESS;
+}
 
-    size_t file = 0;
-    std::shared_ptr<obelisk::Lexer> lexer;
+static obelisk::PhaseTime obelisk::getTime()
+{
+    std::chrono::duration<double> wall
+        = std::chrono::steady_clock::now().time_since_epoch();
+
+    obelisk::PhaseTime time;
+    time.wallSeconds = wall.count();
+    time.cpuSeconds  = static_cast<double>(std::clock()) / CLOCKS_PER_SEC;
+    return time;
+}
+
+static obelisk::PhaseTime obelisk::getTimeSince(
+    const obelisk::PhaseTime& start)
+{
+    auto time = obelisk::getTime();
+    time.wallSeconds -= start.wallSeconds;
+    time.cpuSeconds  -= start.cpuSeconds;
+    return time;
+}
+
+static obelisk::SourceStatistics obelisk::getParserCounts(
+    obelisk::Parser& parser)
+{
+    auto& arena      = parser.getArena();
+    auto& statistics = parser.getStatistics();
+
+    obelisk::SourceStatistics counts;
+    counts.facts  = arena.getAddedCount(obelisk::Statement::kStatementFact);
+    counts.rules  = arena.getAddedCount(obelisk::Statement::kStatementRule);
+    counts.actions
+        = arena.getAddedCount(obelisk::Statement::kStatementAction);
+    counts.transitives
+        = arena.getAddedCount(obelisk::Statement::kStatementTransitive);
+    counts.rowsInserted       = statistics.rowsInserted;
+    counts.rowsDeduplicated   = statistics.rowsDeduplicated;
+    counts.insert.wallSeconds = statistics.insertWallSeconds;
+    counts.insert.cpuSeconds  = statistics.insertCpuSeconds;
+    return counts;
+}
+
+static void obelisk::setParserCounts(obelisk::Parser& parser,
+    const obelisk::SourceStatistics& before,
+    obelisk::SourceStatistics& statistics)
+{
+    auto after = obelisk::getParserCounts(parser);
+
+    statistics.facts              = after.facts - before.facts;
+    statistics.rules              = after.rules - before.rules;
+    statistics.actions            = after.actions - before.actions;
+    statistics.transitives        = after.transitives - before.transitives;
+    statistics.rowsInserted       = after.rowsInserted - before.rowsInserted;
+    statistics.rowsDeduplicated   = after.rowsDeduplicated
+                                  - before.rowsDeduplicated;
+    statistics.insert.wallSeconds = after.insert.wallSeconds
+                                  - before.insert.wallSeconds;
+    statistics.insert.cpuSeconds  = after.insert.cpuSeconds
+                                  - before.insert.cpuSeconds;
+}
+
+static void obelisk::addStatistics(obelisk::SourceStatistics& total,
+    const obelisk::SourceStatistics& statistics)
+{
+    total.bytes              += statistics.bytes;
+    total.tokens             += statistics.tokens;
+    total.facts              += statistics.facts;
+    total.rules              += statistics.rules;
+    total.actions            += statistics.actions;
+    total.transitives        += statistics.transitives;
+    total.rowsInserted       += statistics.rowsInserted;
+    total.rowsDeduplicated   += statistics.rowsDeduplicated;
+    total.lex.wallSeconds    += statistics.lex.wallSeconds;
+    total.lex.cpuSeconds     += statistics.lex.cpuSeconds;
+    total.parse.wallSeconds  += statistics.parse.wallSeconds;
+    total.parse.cpuSeconds   += statistics.parse.cpuSeconds;
+    total.insert.wallSeconds += statistics.insert.wallSeconds;
+    total.insert.cpuSeconds  += statistics.insert.cpuSeconds;
+}
+
+static void obelisk::printStatistics(
+    const obelisk::SourceStatistics& statistics)
+{
+    std::cout << statistics.name << std::endl;
+    std::cout << "  " << std::left << std::setw(12) << "read"
+              << statistics.bytes << " bytes, " << statistics.tokens
+              << " tokens" << std::endl;
+    std::cout << "  " << std::setw(12) << "statements" << statistics.facts
+              << " facts, " << statistics.rules << " rules, "
+              << statistics.actions << " actions, " << statistics.transitives
+              << " transitive" << std::endl;
+    std::cout << "  " << std::setw(12) << "rows" << statistics.rowsInserted
+              << " inserted, " << statistics.rowsDeduplicated
+              << " deduplicated" << std::right << std::endl;
+    obelisk::printPhaseTime("lex", statistics.lex);
+    obelisk::printPhaseTime("parse", statistics.parse);
+    obelisk::printPhaseTime("insert", statistics.insert);
+}
+
+static void obelisk::printPhaseTime(const std::string& phase,
+    const obelisk::PhaseTime& time)
+{
+    std::cout << "  " << std::left << std::setw(12) << phase << std::right
+              << std::fixed << std::setprecision(6) << time.wallSeconds
+              << " s wall, " << time.cpuSeconds << " s cpu" << std::endl;
+}
+
+static bool obelisk::isCompiled(const std::string& sourceFile)
+{
+    const std::string extension = ".obkc";
+    if (sourceFile.size() < extension.size())
+    {
+        return false;
+    }
+
+    auto start = sourceFile.size() - extension.size();
+    return sourceFile.compare(start, std::string::npos, extension) == 0;
+}
+
+static int obelisk::compileSource(obelisk::Parser& parser,
+    std::unique_ptr<obelisk::KnowledgeBase>& kb,
+    const std::string& sourceFile,
+    bool timing)
+{
     try
     {
-        lexer = std::shared_ptr<obelisk::Lexer> {
-            new obelisk::Lexer(sourceFiles[file++])};
+        parser.setLexer(std::shared_ptr<obelisk::Lexer> {
+            new obelisk::Lexer(sourceFile)});
+        parser.getLexer()->setTiming(timing);
     }
     catch (obelisk::LexerException& exception)
     {
         std::cout << exception.what() << std::endl;
         return EXIT_FAILURE;
     }
-    auto parser = std::unique_ptr<obelisk::Parser> {new obelisk::Parser(lexer)};
 
     // prime the first token
     try
     {
-        parser->getNextToken();
+        parser.getNextToken();
     }
     catch (obelisk::LexerException& exception)
     {
@@ -53,76 +408,109 @@ int obelisk::mainLoop(const std::vector<std::string>& sourceFiles,
 
     while (true)
     {
-        switch (parser->getCurrentToken())
+        switch (parser.getCurrentToken())
         {
             case obelisk::Lexer::kTokenEof :
-                // end of source file found, create a new lexer and pass it to
-                // the parser to use
-                if (file >= sourceFiles.size())
-                {
-                    return EXIT_SUCCESS;
-                }
+                // end of source file found
+                return EXIT_SUCCESS;
+            case ';' :
+                // semicolon found, the end of a statement
                 try
                 {
-                    lexer = std::shared_ptr<obelisk::Lexer> {
-                        new obelisk::Lexer(sourceFiles[file++])};
-                    parser->setLexer(lexer);
-                    // prime the first token in the parser
-                    parser->getNextToken();
+                    parser.getNextToken();
                 }
                 catch (obelisk::LexerException& exception)
                 {
-                    std::cout << exception.what() << std::endl;
+                    std::cout << "Error: " << exception.what() << std::endl;
                     return EXIT_FAILURE;
                 }
                 break;
-            case ';' :
-                // semicolon found, the end of a statement
+            case obelisk::Lexer::kTokenFact :
                 try
                 {
-                    parser->getNextToken();
+                    parser.handleFact(kb);
+                }
+                catch (obelisk::ParserException& exception)
+                {
+                    std::cout << "Error: " << exception.what() << std::endl;
+                    return EXIT_FAILURE;
                 }
                 catch (obelisk::LexerException& exception)
                 {
                     std::cout << "Error: " << exception.what() << std::endl;
                     return EXIT_FAILURE;
                 }
+                catch (obelisk::DatabaseException& exception)
+                {
+                    std::cout << "Error: " << exception.what() << std::endl;
+                    return EXIT_FAILURE;
+                }
                 break;
-            case obelisk::Lexer::kTokenFact :
+            case obelisk::Lexer::kTokenRule :
                 try
                 {
-                    parser->handleFact(kb);
+                    parser.handleRule(kb);
                 }
                 catch (obelisk::ParserException& exception)
                 {
                     std::cout << "Error: " << exception.what() << std::endl;
                     return EXIT_FAILURE;
                 }
+                catch (obelisk::LexerException& exception)
+                {
+                    std::cout << "Error: " << exception.what() << std::endl;
+                    return EXIT_FAILURE;
+                }
+                catch (obelisk::DatabaseException& exception)
+                {
+                    std::cout << "Error: " << exception.what() << std::endl;
+                    return EXIT_FAILURE;
+                }
                 break;
-            case obelisk::Lexer::kTokenRule :
+            case obelisk::Lexer::kTokenAction :
                 try
                 {
-                    parser->handleRule(kb);
+                    parser.handleAction(kb);
                 }
                 catch (obelisk::ParserException& exception)
                 {
                     std::cout << "Error: " << exception.what() << std::endl;
                     return EXIT_FAILURE;
                 }
+                catch (obelisk::LexerException& exception)
+                {
+                    std::cout << "Error: " << exception.what() << std::endl;
+                    return EXIT_FAILURE;
+                }
+                catch (obelisk::DatabaseException& exception)
+                {
+                    std::cout << "Error: " << exception.what() << std::endl;
+                    return EXIT_FAILURE;
+                }
                 break;
-            case obelisk::Lexer::kTokenAction :
+            case obelisk::Lexer::kTokenTransitive :
                 try
                 {
-                    parser->handleAction(kb);
+                    parser.handleTransitive(kb);
                 }
                 catch (obelisk::ParserException& exception)
                 {
                     std::cout << "Error: " << exception.what() << std::endl;
                     return EXIT_FAILURE;
                 }
+                catch (obelisk::LexerException& exception)
+                {
+                    std::cout << "Error: " << exception.what() << std::endl;
+                    return EXIT_FAILURE;
+                }
+                catch (obelisk::DatabaseException& exception)
+                {
+                    std::cout << "Error: " << exception.what() << std::endl;
+                    return EXIT_FAILURE;
+                }
                 break;
             default :
-                parser->getNextToken();
+                parser.getNextToken();
                 break;
         }
     }
@@ -130,6 +518,84 @@ int obelisk::mainLoop(const std::vector<std::string>& sourceFiles,
     return EXIT_SUCCESS;
 }
 
+static int obelisk::loadCompiled(obelisk::Parser& parser,
+    std::unique_ptr<obelisk::KnowledgeBase>& kb,
+    const std::string& sourceFile)
+{
+    std::ifstream stream(sourceFile, std::ios::binary);
+    if (!stream)
+    {
+        std::cout << "Error: could not open " << sourceFile << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    try
+    {
+        // the statements are added to the batch of the ones already parsed
+        parser.getArena().read(stream);
+        if (kb)
+        {
+            parser.insertStatements(kb);
+        }
+    }
+    catch (obelisk::StatementArenaException& exception)
+    {
+        std::cout << "Error: " << sourceFile << ": " << exception.what()
+                  << std::endl;
+        return EXIT_FAILURE;
+    }
+    catch (obelisk::ParserException& exception)
+    {
+        std::cout << "Error: " << exception.what() << std::endl;
+        return EXIT_FAILURE;
+    }
+    catch (obelisk::DatabaseException& exception)
+    {
+        std::cout << "Error: " << exception.what() << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    return EXIT_SUCCESS;
+}
+
+static int obelisk::compileSharded(obelisk::Parser& parser,
+    const std::string& kbFile,
+    std::size_t shards,
+    obelisk::KnowledgeBase::Evaluation evaluation,
+    obelisk::KnowledgeBase::Combine combine,
+    unsigned int threads,
+    obelisk::KnowledgeBase::Layout layout)
+{
+    try
+    {
+        auto kb = std::unique_ptr<obelisk::ShardedKnowledgeBase> {
+            new obelisk::ShardedKnowledgeBase(kbFile.c_str(), shards, layout)};
+        kb->setEvaluation(evaluation);
+        kb->setCombine(combine);
+        kb->setThreads(threads);
+
+        parser.insertStatements(kb);
+        kb->propagate();
+    }
+    catch (obelisk::KnowledgeBaseException& exception)
+    {
+        std::cout << "Error: " << exception.what() << std::endl;
+        return EXIT_FAILURE;
+    }
+    catch (obelisk::ParserException& exception)
+    {
+        std::cout << "Error: " << exception.what() << std::endl;
+        return EXIT_FAILURE;
+    }
+    catch (obelisk::DatabaseException& exception)
+    {
+        std::cout << "Error: " << exception.what() << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    return EXIT_SUCCESS;
+}
+
 static void obelisk::showUsage()
 {
     std::cout << obelisk::usageMessage << std::endl;
@@ -139,19 +605,103 @@ int main(int argc, char** argv)
 {
     std::vector<std::string> sourceFiles;
     std::string kbFile = "obelisk.kb";
+    std::string replicaFile;
+    std::string emitFile;
+    auto evaluation    = obelisk::KnowledgeBase::kEvaluationForward;
+    auto combine       = obelisk::KnowledgeBase::kCombineProduct;
+    auto threads       = std::thread::hardware_concurrency();
+    auto layout        = obelisk::KnowledgeBase::kLayoutRowid;
+    auto storage       = obelisk::KnowledgeBase::kStorageFile;
+    auto profile       = false;
+    auto stats         = false;
+    std::size_t shards = 0;
 
     while (true)
     {
         int option_index = 0;
         switch (getopt_long(argc,
             argv,
-            "k:hv",
+            "bc:e:hj:k:l:mn:pr:sv",
             obelisk::long_options,
             &option_index))
         {
+            case 'b' :
+                evaluation = obelisk::KnowledgeBase::kEvaluationBackward;
+                continue;
+            case 'c' :
+                if (std::string(optarg) == "min")
+                {
+                    combine = obelisk::KnowledgeBase::kCombineMinimum;
+                }
+                else if (std::string(optarg) == "product")
+                {
+                    combine = obelisk::KnowledgeBase::kCombineProduct;
+                }
+                else if (std::string(optarg) == "noisy-or")
+                {
+                    combine = obelisk::KnowledgeBase::kCombineNoisyOr;
+                }
+                else
+                {
+                    obelisk::showUsage();
+                    return EXIT_FAILURE;
+                }
+                continue;
+            case 'e' :
+                emitFile = std::string(optarg);
+                continue;
+            case 'j' :
+                try
+                {
+                    threads = std::stoul(optarg);
+                }
+                catch (std::exception& exception)
+                {
+                    obelisk::showUsage();
+                    return EXIT_FAILURE;
+                }
+                continue;
             case 'k' :
                 kbFile = std::string(optarg);
                 continue;
+            case 'l' :
+                if (std::string(optarg) == "rowid")
+                {
+                    layout = obelisk::KnowledgeBase::kLayoutRowid;
+                }
+                else if (std::string(optarg) == "clustered")
+                {
+                    layout = obelisk::KnowledgeBase::kLayoutClustered;
+                }
+                else
+                {
+                    obelisk::showUsage();
+                    return EXIT_FAILURE;
+                }
+                continue;
+            case 'm' :
+                storage = obelisk::KnowledgeBase::kStorageMemory;
+                continue;
+            case 'n' :
+                try
+                {
+                    shards = std::stoul(optarg);
+                }
+                catch (std::exception& exception)
+                {
+                    obelisk::showUsage();
+                    return EXIT_FAILURE;
+                }
+                continue;
+            case 'p' :
+                profile = true;
+                continue;
+            case 'r' :
+                replicaFile = std::string(optarg);
+                continue;
+            case 's' :
+                stats = true;
+                continue;
             case 'h' :
                 obelisk::showUsage();
                 return EXIT_SUCCESS;
@@ -186,5 +736,16 @@ int main(int argc, char** argv)
         return EXIT_FAILURE;
     }
 
-    return obelisk::mainLoop(sourceFiles, kbFile);
+    return obelisk::mainLoop(sourceFiles,
+        kbFile,
+        evaluation,
+        combine,
+        threads,
+        layout,
+        storage,
+        replicaFile,
+        profile,
+        emitFile,
+        stats,
+        shards);
 }
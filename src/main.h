@@ -1,8 +1,14 @@
 #ifndef OBELISK_MAIN_H
 #define OBELISK_MAIN_H
 
+#include "parser.h"
+
 #include <getopt.h>
 
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
 /**
  * @brief The obelisk namespace contains everything needed to compile obelisk
  * code.
@@ -15,11 +21,33 @@ namespace obelisk
      *
      */
     std::string usageMessage = R"(Usage: obelisk [OPTION]... [FILE]...
-Compile the obelisk source FILE(s) into knowledge base and library.
+Compile the obelisk source FILE(s) into knowledge base and library. FILE(s)
+ending in .obkc are already compiled and are loaded without being parsed.
 
 Options:
+  -b, --backward        resolve derived facts at query time instead of
+                        storing them in the knowledge base
+  -c, --combine=MODE    how rule weights combine confidences: min,
+                        product (default) or noisy-or
+  -e, --emit=FILENAME   compile the FILE(s) into a FILENAME .obkc file
+                        instead of a knowledge base
   -h, --help            shows this help/usage message
+  -j, --threads=N       number of threads used to propagate the rules
   -k, --kb=FILENAME     output knowldege base filename
+  -l, --layout=LAYOUT   how a new knowledge base stores facts and rules:
+                        rowid (default) or clustered
+  -m, --memory          build the knowledge base in memory and write it to
+                        the file once at the end
+  -n, --shards=N        split the facts of the knowledge base into N shard
+                        files next to it, can't be used with --emit,
+                        --memory, --profile, --replica or --stats
+  -p, --profile         print how long each SQL statement took after
+                        compiling
+  -r, --replica=FILENAME
+                        copy the compiled knowledge base to a replica file,
+                        writing only the pages that changed
+  -s, --stats           print the bytes, tokens, statements, rows and the time
+                        of each phase for each FILE after compiling
   -v, --version         shows the version of obelisk)";
 
     /**
@@ -27,10 +55,124 @@ Options:
      *
      */
     static struct option long_options[] = {
-        {"help",    no_argument,       0, 'h'},
-        {"kb",      required_argument, 0, 'k'},
-        {"version", no_argument,       0, 'v'},
-        {0,         0,                 0, 0  }
+        {"backward", no_argument,       0, 'b'},
+        {"combine",  required_argument, 0, 'c'},
+        {"emit",     required_argument, 0, 'e'},
+        {"help",     no_argument,       0, 'h'},
+        {"threads",  required_argument, 0, 'j'},
+        {"kb",       required_argument, 0, 'k'},
+        {"layout",   required_argument, 0, 'l'},
+        {"memory",   no_argument,       0, 'm'},
+        {"shards",   required_argument, 0, 'n'},
+        {"profile",  no_argument,       0, 'p'},
+        {"replica",  required_argument, 0, 'r'},
+        {"stats",    no_argument,       0, 's'},
+        {"version",  no_argument,       0, 'v'},
+        {0,          0,                 0, 0  }
+    };
+
+    /**
+     * @brief The PhaseTime struct is the wall clock and processor time of a
+     * phase of compiling.
+     *
+     */
+    struct PhaseTime
+    {
+            /**
+             * @brief The wall clock time in seconds.
+             *
+             */
+            double wallSeconds = 0;
+
+            /**
+             * @brief The processor time in seconds, by every thread of the
+             * process.
+             *
+             */
+            double cpuSeconds = 0;
+    };
+
+    /**
+     * @brief The SourceStatistics struct holds what was measured while
+     * compiling one source file, or all of them.
+     *
+     */
+    struct SourceStatistics
+    {
+            /**
+             * @brief The name of the source file.
+             *
+             */
+            std::string name;
+
+            /**
+             * @brief The size of the source file in bytes.
+             *
+             */
+            std::uintmax_t bytes = 0;
+
+            /**
+             * @brief The number of tokens in the source file, compiled files
+             * are not lexed and have none.
+             *
+             */
+            std::size_t tokens = 0;
+
+            /**
+             * @brief The number of fact statements.
+             *
+             */
+            std::size_t facts = 0;
+
+            /**
+             * @brief The number of rule statements.
+             *
+             */
+            std::size_t rules = 0;
+
+            /**
+             * @brief The number of action statements.
+             *
+             */
+            std::size_t actions = 0;
+
+            /**
+             * @brief The number of transitive statements.
+             *
+             */
+            std::size_t transitives = 0;
+
+            /**
+             * @brief The number of rows added to the KnowledgeBase.
+             *
+             */
+            std::size_t rowsInserted = 0;
+
+            /**
+             * @brief The number of rows that were not added because they were
+             * duplicates.
+             *
+             */
+            std::size_t rowsDeduplicated = 0;
+
+            /**
+             * @brief The time spent lexing.
+             *
+             */
+            obelisk::PhaseTime lex;
+
+            /**
+             * @brief The time spent parsing, or reading a compiled file,
+             * without lexing.
+             *
+             */
+            obelisk::PhaseTime parse;
+
+            /**
+             * @brief The time spent inserting into the KnowledgeBase.
+             *
+             */
+            obelisk::PhaseTime insert;
     };
 
     /**
@@ -44,10 +186,161 @@ Options:
      *
      * This loop handles lexing and parsing of obelisk source code.
      *
+     * @param[in] sourceFiles The obelisk source files to compile.
+     * @param[in] kbFile The KnowledgeBase file to compile into.
+     * @param[in] evaluation The evaluation the KnowledgeBase is compiled for.
+     * @param[in] combine How rule weights combine confidences.
+     * @param[in] threads The number of threads used to propagate the rules.
+     * @param[in] layout The layout of the tables if the KnowledgeBase is
+     * created.
+     * @param[in] storage Where the KnowledgeBase is kept while compiling.
+     * @param[in] replicaFile The replica file to copy the KnowledgeBase to,
+     * or empty for none.
+     * @param[in] profile Whether to print the SQL statement profile after
+     * compiling.
+     * @param[in] emitFile The .obkc file to write the parsed statements to
+     * instead of compiling a KnowledgeBase, or empty for none.
+     * @param[in] stats Whether to print what was measured for each source
+     * file and for propagating after compiling.
+     * @param[in] shards The number of shards to split the KnowledgeBase into,
+     * or 0 for a single file.
      * @return int Returns EXIT_SUCCESS or EXIT_FAILURE.
      */
     int mainLoop(const std::vector<std::string> &sourceFiles,
-        const std::string &kbFile);
+        const std::string &kbFile,
+        obelisk::KnowledgeBase::Evaluation evaluation,
+        obelisk::KnowledgeBase::Combine combine,
+        unsigned int threads,
+        obelisk::KnowledgeBase::Layout layout,
+        obelisk::KnowledgeBase::Storage storage,
+        const std::string &replicaFile,
+        bool profile,
+        const std::string &emitFile,
+        bool stats,
+        std::size_t shards);
+
+    /**
+     * @brief Check if a source file is an already compiled .obkc file.
+     *
+     * @param[in] sourceFile The source file.
+     * @return true The source file is compiled.
+     * @return false The source file is obelisk source code.
+     */
+    static bool isCompiled(const std::string &sourceFile);
+
+    /**
+     * @brief Lex and parse an obelisk source file.
+     *
+     * @param[in] parser The Parser to use.
+     * @param[in] kb The KnowledgeBase to insert the statements into, or null
+     * to keep them in the Parser.
+     * @param[in] sourceFile The source file.
+     * @param[in] timing Whether the Lexer measures the time spent reading
+     * tokens.
+     * @return int Returns EXIT_SUCCESS or EXIT_FAILURE.
+     */
+    static int compileSource(obelisk::Parser &parser,
+        std::unique_ptr<obelisk::KnowledgeBase> &kb,
+        const std::string &sourceFile,
+        bool timing);
+
+    /**
+     * @brief Load the statements of a compiled .obkc file without lexing or
+     * parsing it.
+     *
+     * @param[in] parser The Parser whose arena the statements are read into.
+     * @param[in] kb The KnowledgeBase to insert the statements into, or null
+     * to keep them in the Parser.
+     * @param[in] sourceFile The compiled file.
+     * @return int Returns EXIT_SUCCESS or EXIT_FAILURE.
+     */
+    static int loadCompiled(obelisk::Parser &parser,
+        std::unique_ptr<obelisk::KnowledgeBase> &kb,
+        const std::string &sourceFile);
+
+    /**
+     * @brief Insert the statements kept in the Parser into a
+     * ShardedKnowledgeBase and propagate it.
+     *
+     * @param[in] parser The Parser holding the statements.
+     * @param[in] kbFile The dictionary file of the ShardedKnowledgeBase.
+     * @param[in] shards The number of shards.
+     * @param[in] evaluation The evaluation the shards are compiled for.
+     * @param[in] combine How rule weights combine confidences.
+     * @param[in] threads The number of threads used to propagate the shards.
+     * @param[in] layout The layout of the tables if the shards are created.
+     * @return int Returns EXIT_SUCCESS or EXIT_FAILURE.
+     */
+    static int compileSharded(obelisk::Parser &parser,
+        const std::string &kbFile,
+        std::size_t shards,
+        obelisk::KnowledgeBase::Evaluation evaluation,
+        obelisk::KnowledgeBase::Combine combine,
+        unsigned int threads,
+        obelisk::KnowledgeBase::Layout layout);
+
+    /**
+     * @brief Get the current wall clock and processor time, to measure a
+     * phase from.
+     *
+     * @return obelisk::PhaseTime Returns the current time.
+     */
+    static obelisk::PhaseTime getTime();
+
+    /**
+     * @brief Get the time elapsed since a time returned by getTime.
+     *
+     * @param[in] start The time the phase started.
+     * @return obelisk::PhaseTime Returns the elapsed time.
+     */
+    static obelisk::PhaseTime getTimeSince(const obelisk::PhaseTime &start);
+
+    /**
+     * @brief Get the statements the Parser has added to its arena and what it
+     * has inserted so far, to be subtracted from what it has after a source
+     * file is compiled.
+     *
+     * @param[in] parser The Parser.
+     * @return obelisk::SourceStatistics Returns the counts.
+     */
+    static obelisk::SourceStatistics getParserCounts(obelisk::Parser &parser);
+
+    /**
+     * @brief Store in the statistics of a source file the statements the
+     * Parser added and what it inserted since the counts were taken.
+     *
+     * @param[in] parser The Parser.
+     * @param[in] before The counts taken before the source file was compiled.
+     * @param[out] statistics The statistics of the source file.
+     */
+    static void setParserCounts(obelisk::Parser &parser,
+        const obelisk::SourceStatistics &before,
+        obelisk::SourceStatistics &statistics);
+
+    /**
+     * @brief Add what was measured for a source file to the total.
+     *
+     * @param[in,out] total The total.
+     * @param[in] statistics The statistics of the source file.
+     */
+    static void addStatistics(obelisk::SourceStatistics &total,
+        const obelisk::SourceStatistics &statistics);
+
+    /**
+     * @brief Print what was measured for a source file, or for all of them.
+     *
+     * @param[in] statistics The statistics.
+     */
+    static void printStatistics(const obelisk::SourceStatistics &statistics);
+
+    /**
+     * @brief Print the time of a phase.
+     *
+     * @param[in] phase The name of the phase.
+     * @param[in] time The time of the phase.
+     */
+    static void printPhaseTime(const std::string &phase,
+        const obelisk::PhaseTime &time);
 } // namespace obelisk
 
 #endif
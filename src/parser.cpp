@@ -3,9 +3,14 @@
 #include "ast/variable_expression_ast.h"
 #include "parser.h"
 
+#include <algorithm>
+#include <chrono>
+#include <ctime>
+#include <exception>
 #include <memory>
-#include <stack>
 #include <string>
+#include <tuple>
+#include <utility>
 #include <vector>
 
 std::shared_ptr<obelisk::Lexer> obelisk::Parser::getLexer()
@@ -19,6 +24,21 @@ void obelisk::Parser::setLexer(std::shared_ptr<obelisk::Lexer> lexer)
     currentToken_ = 0;
 }
 
+obelisk::StatementArena& obelisk::Parser::getArena()
+{
+    return arena_;
+}
+
+void obelisk::Parser::setRetainStatements(bool retainStatements)
+{
+    retainStatements_ = retainStatements;
+}
+
+const obelisk::ParserStatistics& obelisk::Parser::getStatistics()
+{
+    return statistics_;
+}
+
 int obelisk::Parser::getNextToken()
 {
     try
@@ -220,665 +240,1072 @@ std::unique_ptr<obelisk::PrototypeAST> obelisk::Parser::parseExtern()
     return parsePrototype();
 }
 
-void obelisk::Parser::parseAction(obelisk::SuggestAction& suggestAction)
+std::string obelisk::Parser::describeToken()
+{
+    switch (getCurrentToken())
+    {
+        case obelisk::Lexer::kTokenEof :
+            return "end of file";
+        case obelisk::Lexer::kTokenNumber :
+            return "a number";
+        case obelisk::Lexer::kTokenString :
+            return "\"" + getLexer()->getStringValue() + "\"";
+        case obelisk::Lexer::kTokenFact :
+        case obelisk::Lexer::kTokenRule :
+        case obelisk::Lexer::kTokenAction :
+        case obelisk::Lexer::kTokenDef :
+        case obelisk::Lexer::kTokenExtern :
+        case obelisk::Lexer::kTokenIdentifier :
+        case obelisk::Lexer::kTokenTransitive :
+            return "'" + getLexer()->getIdentifier() + "'";
+        default :
+            return "'" + std::string(1, (char) getCurrentToken()) + "'";
+    }
+}
+
+bool obelisk::Parser::isKeyword(const char* keyword)
 {
-    std::stack<char> syntax;
+    return getCurrentToken() == obelisk::Lexer::kTokenIdentifier
+        && getLexer()->getIdentifier() == keyword;
+}
 
+void obelisk::Parser::expectToken(int token)
+{
+    if (getCurrentToken() != token)
+    {
+        throw obelisk::ParserException("expected '"
+            + std::string(1, (char) token) + "' but got " + describeToken());
+    }
     getNextToken();
-    if (getCurrentToken() != '(')
+}
+
+void obelisk::Parser::expectKeyword(const char* keyword)
+{
+    if (!isKeyword(keyword))
     {
-        throw obelisk::ParserException(
-            "expected '(' but got '" + std::to_string(getCurrentToken()) + "'");
+        throw obelisk::ParserException("expected '" + std::string(keyword)
+            + "' but got " + describeToken());
     }
+    getNextToken();
+}
 
-    syntax.push('(');
+void obelisk::Parser::expectEnd()
+{
+    expectToken(')');
+    if (getCurrentToken() != ';')
+    {
+        throw obelisk::ParserException("missing ';'");
+    }
+}
 
-    getNextToken();
-    if (getLexer()->getIdentifier() != "if")
+std::uint32_t obelisk::Parser::parseName()
+{
+    if (getCurrentToken() != obelisk::Lexer::kTokenString)
     {
         throw obelisk::ParserException(
-            "expected 'if' but got '" + getLexer()->getIdentifier() + "'");
+            "expected a name but got " + describeToken());
+    }
+
+    if (getLexer()->getStringValue().empty())
+    {
+        throw obelisk::ParserException("names can't be empty");
     }
 
-    bool getEntity {true};
-    std::string leftEntity {""};
-    std::string rightEntity {""};
-    std::string trueAction {""};
-    std::string falseAction {""};
-    std::string entityName {""};
-    std::string verb {""};
+    auto name = arena_.getStrings().intern(getLexer()->getStringValue());
     getNextToken();
+    return name;
+}
 
-    // get the entity side of statement
-    while (true)
+std::uint32_t obelisk::Parser::parseVerb()
+{
+    if (getCurrentToken() != obelisk::Lexer::kTokenIdentifier)
     {
-        if (getEntity)
-        {
-            if (getCurrentToken() == '"')
-            {
-                if (syntax.top() != '"')
-                {
-                    // open a double quote
-                    syntax.push('"');
-                    getNextToken();
-                }
-                else if (syntax.top() == '"')
-                {
-                    // close a double quote
-                    syntax.pop();
-                    if (verb == "")
-                    {
-                        leftEntity = std::move(entityName);
-                    }
-                    else
-                    {
-                        rightEntity = std::move(entityName);
-                    }
-                    getEntity = false;
-                    getNextToken();
-                    continue;
-                }
-            }
+        throw obelisk::ParserException(
+            "expected a verb but got " + describeToken());
+    }
 
-            if (syntax.top() == '"')
-            {
-                if (entityName != "")
-                {
-                    entityName += " ";
-                }
-                entityName += getLexer()->getIdentifier();
-            }
-            getNextToken();
-        }
-        else
+    for (const auto& letter : getLexer()->getIdentifier())
+    {
+        if (!isalpha(letter))
         {
-            if (getCurrentToken() == ')')
-            {
-                throw obelisk::ParserException("unexpected ')'");
-            }
+            throw obelisk::ParserException("non alphabetic symbol in verb");
+        }
+    }
 
-            if (getCurrentToken() == '"')
-            {
-                throw obelisk::ParserException("unexpected '\"'");
-            }
+    auto verb = arena_.getStrings().intern(getLexer()->getIdentifier());
+    getNextToken();
+    return verb;
+}
 
-            if (getLexer()->getIdentifier() == "then")
-            {
-                break;
-            }
-            else
-            {
-                verb = getLexer()->getIdentifier();
-                for (const auto& letter : verb)
-                {
-                    if (!isalpha(letter))
-                    {
-                        throw new obelisk::ParserException(
-                            "non alphabetic symbol in verb");
-                    }
-                }
-                getEntity = true;
-                continue;
-            }
-        }
+void obelisk::Parser::parseTerm(std::uint32_t& entity, std::uint32_t& variable)
+{
+    if (getCurrentToken() == obelisk::Lexer::kTokenString)
+    {
+        entity = parseName();
+        return;
+    }
+
+    if (getCurrentToken() == obelisk::Lexer::kTokenIdentifier)
+    {
+        // an unquoted name in place of an entity is a variable
+        variable = arena_.getStrings().intern(getLexer()->getIdentifier());
+        getNextToken();
+        return;
     }
 
-    // get the action side of statement
-    bool getAction {true};
+    throw obelisk::ParserException(
+        "expected an entity or a variable but got " + describeToken());
+}
+
+void obelisk::Parser::parseEntities(std::uint32_t& count)
+{
     while (true)
     {
-        if (getAction)
-        {
-            if (getCurrentToken() == '"')
-            {
-                if (syntax.top() != '"')
-                {
-                    // open a double quote
-                    syntax.push('"');
-                    getNextToken();
-                }
-                else if (syntax.top() == '"')
-                {
-                    // close a double quote
-                    syntax.pop();
-                    if (trueAction == "")
-                    {
-                        trueAction = std::move(entityName);
-                    }
-                    else
-                    {
-                        falseAction = std::move(entityName);
-                    }
-                    getAction = false;
-                    getNextToken();
-                    continue;
-                }
-            }
+        arena_.addName(parseName());
+        count++;
 
-            if (syntax.top() == '"')
-            {
-                if (entityName != "")
-                {
-                    entityName += " ";
-                }
-                entityName += getLexer()->getIdentifier();
-            }
-            getNextToken();
-        }
-        else
+        if (!isKeyword("and"))
         {
-            if (getCurrentToken() == ')')
-            {
-                // closing parenthesis found, make sure we have everything
-                // needed
-                if (syntax.top() != '(')
-                {
-                    throw obelisk::ParserException("unexpected ')'");
-                }
-                else
-                {
-                    syntax.pop();
-                }
+            break;
+        }
+        getNextToken();
+    }
+}
 
-                if (leftEntity == "")
-                {
-                    throw obelisk::ParserException("missing left entity");
-                }
+obelisk::Statement& obelisk::Parser::parseFact()
+{
+    getNextToken();
+    expectToken('(');
 
-                if (rightEntity == "")
-                {
-                    throw obelisk::ParserException("missing left entity");
-                }
+    auto& statement = arena_.addStatement(obelisk::Statement::kStatementFact);
+    statement.first = arena_.getNameCount();
+    parseEntities(statement.leftCount);
+    statement.verb = parseVerb();
+    parseEntities(statement.rightCount);
+    expectEnd();
 
-                if (verb == "")
-                {
-                    throw obelisk::ParserException("missing verb");
-                }
+    return statement;
+}
 
-                if (trueAction == "")
-                {
-                    throw obelisk::ParserException("missing true action");
-                }
+obelisk::Statement& obelisk::Parser::parseRule()
+{
+    getNextToken();
+    expectToken('(');
 
-                if (falseAction == "")
-                {
-                    throw obelisk::ParserException("missing false action");
-                }
+    auto& statement = arena_.addStatement(obelisk::Statement::kStatementRule);
+    parseTerm(statement.leftEntity, statement.leftVariable);
+    statement.verb = parseVerb();
+    parseTerm(statement.rightEntity, statement.rightVariable);
 
-                getNextToken();
-                if (getCurrentToken() != ';')
-                {
-                    throw obelisk::ParserException("missing ';'");
-                }
+    expectKeyword("if");
+    parseTerm(statement.reasonLeftEntity, statement.reasonLeftVariable);
+    statement.reasonVerb = parseVerb();
+    parseTerm(statement.reasonRightEntity, statement.reasonRightVariable);
 
-                break;
-            }
+    if (isKeyword("with"))
+    {
+        // the weight of the rule follows the reason
+        getNextToken();
+        if (getCurrentToken() != obelisk::Lexer::kTokenNumber)
+        {
+            throw obelisk::ParserException("missing rule weight");
+        }
 
-            if (getCurrentToken() == '"')
-            {
-                throw obelisk::ParserException("unexpected '\"'");
-                break;
-            }
+        statement.weight = getLexer()->getNumberValue();
+        if (statement.weight > 1.0)
+        {
+            throw obelisk::ParserException(
+                "rule weight must be between 0 and 1");
+        }
+        getNextToken();
+    }
+    expectEnd();
 
-            if (getLexer()->getIdentifier() == "else")
-            {
-                getNextToken();
-                getAction = true;
-                continue;
-            }
-            else
-            {
-                getAction = true;
-                continue;
-            }
+    // every variable in the fact has to be bound by the reason
+    for (auto variable : {statement.leftVariable, statement.rightVariable})
+    {
+        if (variable != 0 && variable != statement.reasonLeftVariable
+            && variable != statement.reasonRightVariable)
+        {
+            throw obelisk::ParserException("variable '"
+                + arena_.getStrings().get(variable)
+                + "' is not used in the reason");
         }
     }
 
-    suggestAction.setFact(obelisk::Fact(obelisk::Entity(leftEntity),
-        obelisk::Entity(rightEntity),
-        obelisk::Verb(verb)));
-    suggestAction.setTrueAction(obelisk::Action(trueAction));
-    suggestAction.setFalseAction(obelisk::Action(falseAction));
+    return statement;
 }
 
-void obelisk::Parser::parseRule(obelisk::Rule& rule)
+obelisk::Statement& obelisk::Parser::parseAction()
 {
-    std::stack<char> syntax;
-
     getNextToken();
-    if (getCurrentToken() != '(')
+    expectToken('(');
+    expectKeyword("if");
+
+    auto& statement
+        = arena_.addStatement(obelisk::Statement::kStatementAction);
+    statement.leftEntity  = parseName();
+    statement.verb        = parseVerb();
+    statement.rightEntity = parseName();
+
+    expectKeyword("then");
+    statement.trueAction = parseName();
+    if (isKeyword("else"))
     {
-        throw obelisk::ParserException(
-            "expected '(' but got '" + std::to_string(getCurrentToken()) + "'");
+        getNextToken();
     }
+    statement.falseAction = parseName();
+    expectEnd();
 
-    syntax.push('(');
+    return statement;
+}
 
-    bool getEntity {true};
-    bool getReason {false};
-    std::string leftEntity {""};
-    std::string rightEntity {""};
-    std::string verb {""};
-    std::string leftReasonEntity {""};
-    std::string rightReasonEntity {""};
-    std::string reasonVerb {""};
-    std::string entityName {""};
+obelisk::Statement& obelisk::Parser::parseTransitive()
+{
     getNextToken();
+    expectToken('(');
 
-    // get the entity side of statement
-    while (true)
+    auto& statement
+        = arena_.addStatement(obelisk::Statement::kStatementTransitive);
+    statement.verb = parseVerb();
+    expectEnd();
+
+    return statement;
+}
+
+obelisk::Entity obelisk::Parser::getEntity(
+    std::unique_ptr<obelisk::KnowledgeBase>& kb,
+    std::uint32_t name)
+{
+    if (entityIds_.size() <= name)
     {
-        if (getEntity)
-        {
-            if (getCurrentToken() == '"')
-            {
-                if (syntax.top() != '"')
-                {
-                    // open a double quote
-                    syntax.push('"');
-                    getNextToken();
-                }
-                else if (syntax.top() == '"')
-                {
-                    // close a double quote
-                    syntax.pop();
-                    if (!getReason)
-                    {
-                        if (verb == "")
-                        {
-                            leftEntity = std::move(entityName);
-                        }
-                        else
-                        {
-                            rightEntity = std::move(entityName);
-                        }
-                    }
-                    else
-                    {
-                        if (reasonVerb == "")
-                        {
-                            leftReasonEntity = std::move(entityName);
-                        }
-                        else
-                        {
-                            rightReasonEntity = std::move(entityName);
-                        }
-                    }
-                    getEntity = false;
-                    getNextToken();
-                    continue;
-                }
-            }
+        entityIds_.resize(arena_.getStrings().size(), 0);
+    }
 
-            if (syntax.top() == '"')
-            {
-                if (entityName != "")
-                {
-                    entityName += " ";
-                }
-                entityName += getLexer()->getIdentifier();
-            }
-            getNextToken();
-        }
-        else
-        {
-            if (getCurrentToken() == ')')
-            {
-                // closing parenthesis found, make sure we have everything
-                // needed
-                if (syntax.top() != '(')
-                {
-                    throw obelisk::ParserException("unexpected ')'");
-                }
-                else
-                {
-                    syntax.pop();
-                }
+    obelisk::Entity entity(entityIds_[name], arena_.getStrings().get(name));
+    if (entity.getId() == 0)
+    {
+        insertEntity(kb, entity);
+        entityIds_[name] = entity.getId();
+    }
+    return entity;
+}
 
-                if (leftEntity == "")
-                {
-                    throw obelisk::ParserException("missing left entity");
-                }
+obelisk::Verb obelisk::Parser::getVerb(
+    std::unique_ptr<obelisk::KnowledgeBase>& kb,
+    std::uint32_t name)
+{
+    if (verbIds_.size() <= name)
+    {
+        verbIds_.resize(arena_.getStrings().size(), 0);
+    }
 
-                if (rightEntity == "")
-                {
-                    throw obelisk::ParserException("missing right entity");
-                }
+    obelisk::Verb verb(verbIds_[name], arena_.getStrings().get(name));
+    if (verb.getId() == 0)
+    {
+        insertVerb(kb, verb);
+        verbIds_[name] = verb.getId();
+    }
+    return verb;
+}
 
-                if (verb == "")
-                {
-                    throw obelisk::ParserException("missing verb");
-                }
+obelisk::Action obelisk::Parser::getAction(
+    std::unique_ptr<obelisk::KnowledgeBase>& kb,
+    std::uint32_t name)
+{
+    if (actionIds_.size() <= name)
+    {
+        actionIds_.resize(arena_.getStrings().size(), 0);
+    }
 
-                if (leftReasonEntity == "")
-                {
-                    throw obelisk::ParserException(
-                        "missing left reason entity");
-                }
+    obelisk::Action action(actionIds_[name], arena_.getStrings().get(name));
+    if (action.getId() == 0)
+    {
+        insertAction(kb, action);
+        actionIds_[name] = action.getId();
+    }
+    return action;
+}
 
-                if (rightReasonEntity == "")
-                {
-                    throw obelisk::ParserException(
-                        "missing right reason entity");
-                }
+bool obelisk::Parser::FactKey::operator==(const FactKey& other) const
+{
+    return leftEntity == other.leftEntity && rightEntity == other.rightEntity
+        && verb == other.verb;
+}
 
-                if (reasonVerb == "")
-                {
-                    throw obelisk::ParserException("missing reason verb");
-                }
+bool obelisk::Parser::FactKey::operator<(const FactKey& other) const
+{
+    // the order of the unique index on the fact table
+    return std::tie(leftEntity, rightEntity, verb)
+         < std::tie(other.leftEntity, other.rightEntity, other.verb);
+}
 
-                getNextToken();
-                if (getCurrentToken() != ';')
-                {
-                    throw obelisk::ParserException("missing ';'");
-                }
+std::size_t obelisk::Parser::FactKeyHash::operator()(
+    const FactKey& key) const
+{
+    std::hash<sqlite3_int64> hash;
+    std::size_t seed = hash(key.leftEntity);
+    seed ^= hash(key.rightEntity) + 0x9e3779b97f4a7c15ULL + (seed << 6)
+          + (seed >> 2);
+    seed ^= hash(key.verb) + 0x9e3779b97f4a7c15ULL + (seed << 6) + (seed >> 2);
+    return seed;
+}
 
-                break;
-            }
+bool obelisk::Parser::isPatternRule(const obelisk::Statement& statement)
+{
+    return statement.kind == obelisk::Statement::kStatementRule
+        && (statement.leftVariable != 0 || statement.rightVariable != 0
+            || statement.reasonLeftVariable != 0
+            || statement.reasonRightVariable != 0);
+}
 
-            if (getCurrentToken() == '"')
-            {
-                throw obelisk::ParserException("unexpected '\"'");
-            }
+obelisk::Parser::FactKey obelisk::Parser::getFactKey(std::uint32_t leftEntity,
+    std::uint32_t verb,
+    std::uint32_t rightEntity)
+{
+    return FactKey {entityIds_[leftEntity],
+        entityIds_[rightEntity],
+        verbIds_[verb]};
+}
 
-            if (getLexer()->getIdentifier() == "if")
-            {
-                getReason = true;
-                getEntity = true;
-                getNextToken();
-                continue;
-            }
-            else
+void obelisk::Parser::insertEntityNames(
+    std::unique_ptr<obelisk::KnowledgeBase>& kb,
+    const std::unordered_set<std::uint32_t>& names)
+{
+    auto& strings = arena_.getStrings();
+    entityIds_.resize(strings.size(), 0);
+
+    std::vector<std::uint32_t> missing;
+    for (auto name : names)
+    {
+        if (entityIds_[name] == 0)
+        {
+            missing.push_back(name);
+        }
+    }
+    std::sort(missing.begin(),
+        missing.end(),
+        [&strings](std::uint32_t a, std::uint32_t b)
+        {
+            return strings.get(a) < strings.get(b);
+        });
+
+    std::vector<obelisk::Entity> entities;
+    entities.reserve(missing.size());
+    for (auto name : missing)
+    {
+        entities.emplace_back(strings.get(name));
+    }
+    kb->addEntities(entities);
+
+    for (std::size_t i = 0; i < entities.size(); i++)
+    {
+        // the id was not inserted, so check if it exists in the database
+        if (entities[i].getId() == 0)
+        {
+            kb->getEntity(entities[i]);
+            if (entities[i].getId() == 0)
             {
-                if (!getReason)
-                {
-                    verb = getLexer()->getIdentifier();
-                    for (const auto& letter : verb)
-                    {
-                        if (!isalpha(letter))
-                        {
-                            throw new obelisk::ParserException(
-                                "non alphabetic symbol in verb");
-                        }
-                    }
-                    getEntity = true;
-                    continue;
-                }
-                else
-                {
-                    reasonVerb = getLexer()->getIdentifier();
-                    for (const auto& letter : reasonVerb)
-                    {
-                        if (!isalpha(letter))
-                        {
-                            throw new obelisk::ParserException(
-                                "non alphabetic symbol in verb");
-                        }
-                    }
-                    getEntity = true;
-                    continue;
-                }
+                throw obelisk::ParserException(
+                    "entity could not be inserted into the database");
             }
+            statistics_.rowsDeduplicated++;
+        }
+        else
+        {
+            statistics_.rowsInserted++;
         }
+        entityIds_[missing[i]] = entities[i].getId();
     }
-
-    rule.setFact(obelisk::Fact(obelisk::Entity(leftEntity),
-        obelisk::Entity(rightEntity),
-        obelisk::Verb(verb)));
-    rule.setReason(obelisk::Fact(obelisk::Entity(leftReasonEntity),
-        obelisk::Entity(rightReasonEntity),
-        obelisk::Verb(reasonVerb)));
 }
 
-void obelisk::Parser::parseFact(std::vector<obelisk::Fact>& facts)
+void obelisk::Parser::insertVerbNames(
+    std::unique_ptr<obelisk::KnowledgeBase>& kb,
+    const std::unordered_set<std::uint32_t>& names)
 {
-    std::stack<char> syntax;
+    auto& strings = arena_.getStrings();
+    verbIds_.resize(strings.size(), 0);
 
-    getNextToken();
-    if (getCurrentToken() != '(')
+    std::vector<std::uint32_t> missing;
+    for (auto name : names)
     {
-        throw obelisk::ParserException(
-            "expected '(' but got '" + std::to_string(getCurrentToken()) + "'");
+        if (verbIds_[name] == 0)
+        {
+            missing.push_back(name);
+        }
     }
+    std::sort(missing.begin(),
+        missing.end(),
+        [&strings](std::uint32_t a, std::uint32_t b)
+        {
+            return strings.get(a) < strings.get(b);
+        });
 
-    syntax.push('(');
+    std::vector<obelisk::Verb> verbs;
+    verbs.reserve(missing.size());
+    for (auto name : missing)
+    {
+        verbs.emplace_back(strings.get(name));
+    }
+    kb->addVerbs(verbs);
 
-    bool getEntity {true};
-    std::vector<std::string> leftEntities;
-    std::vector<std::string> rightEntities;
-    std::string entityName {""};
-    std::string verb {""};
-    getNextToken();
-    while (true)
+    for (std::size_t i = 0; i < verbs.size(); i++)
     {
-        if (getEntity)
+        // the id was not inserted, so check if it exists in the database
+        if (verbs[i].getId() == 0)
         {
-            if (getCurrentToken() == '"')
+            kb->getVerb(verbs[i]);
+            if (verbs[i].getId() == 0)
             {
-                if (syntax.top() != '"')
-                {
-                    // open a double quote
-                    syntax.push('"');
-                    getNextToken();
-                }
-                else if (syntax.top() == '"')
-                {
-                    // close a double quote
-                    syntax.pop();
-                    if (verb == "")
-                    {
-                        leftEntities.push_back(entityName);
-                    }
-                    else
-                    {
-                        rightEntities.push_back(entityName);
-                    }
-                    entityName = "";
-                    getEntity  = false;
-                    getNextToken();
-                    continue;
-                }
+                throw obelisk::ParserException(
+                    "verb could not be inserted into the database");
             }
+            statistics_.rowsDeduplicated++;
+        }
+        else
+        {
+            statistics_.rowsInserted++;
+        }
+        verbIds_[missing[i]] = verbs[i].getId();
+    }
+}
 
-            if (syntax.top() == '"')
+void obelisk::Parser::insertActionNames(
+    std::unique_ptr<obelisk::KnowledgeBase>& kb,
+    const std::unordered_set<std::uint32_t>& names)
+{
+    auto& strings = arena_.getStrings();
+    actionIds_.resize(strings.size(), 0);
+
+    std::vector<std::uint32_t> missing;
+    for (auto name : names)
+    {
+        if (actionIds_[name] == 0)
+        {
+            missing.push_back(name);
+        }
+    }
+    std::sort(missing.begin(),
+        missing.end(),
+        [&strings](std::uint32_t a, std::uint32_t b)
+        {
+            return strings.get(a) < strings.get(b);
+        });
+
+    std::vector<obelisk::Action> actions;
+    actions.reserve(missing.size());
+    for (auto name : missing)
+    {
+        actions.emplace_back(strings.get(name));
+    }
+    kb->addActions(actions);
+
+    for (std::size_t i = 0; i < actions.size(); i++)
+    {
+        // the id was not inserted, so check if it exists in the database
+        if (actions[i].getId() == 0)
+        {
+            kb->getAction(actions[i]);
+            if (actions[i].getId() == 0)
             {
-                if (entityName != "")
-                {
-                    entityName += " ";
-                }
-                entityName += getLexer()->getIdentifier();
+                throw obelisk::ParserException(
+                    "action could not be inserted into the database");
             }
-            getNextToken();
+            statistics_.rowsDeduplicated++;
         }
         else
         {
-            if (getCurrentToken() == ')')
-            {
-                // closing parenthesis found, make sure we have everything
-                // needed
-                if (syntax.top() != '(')
-                {
-                    throw obelisk::ParserException("unexpected ')'");
-                }
-                else
-                {
-                    syntax.pop();
-                }
-
-                if (verb == "")
-                {
-                    throw obelisk::ParserException("verb is empty");
-                }
+            statistics_.rowsInserted++;
+        }
+        actionIds_[missing[i]] = actions[i].getId();
+    }
+}
 
-                if (leftEntities.size() == 0)
-                {
-                    throw obelisk::ParserException(
-                        "missing left side entities");
-                }
+obelisk::PatternRule obelisk::Parser::getPatternRule(
+    std::unique_ptr<obelisk::KnowledgeBase>& kb,
+    const obelisk::Statement& statement)
+{
+    auto& strings = arena_.getStrings();
 
-                if (rightEntities.size() == 0)
-                {
-                    throw obelisk::ParserException(
-                        "missing right side entities");
-                }
+    // the sides that are variables have no entity
+    obelisk::Entity reasonLeftEntity;
+    if (statement.reasonLeftEntity != 0)
+    {
+        reasonLeftEntity = getEntity(kb, statement.reasonLeftEntity);
+    }
+    obelisk::Entity reasonRightEntity;
+    if (statement.reasonRightEntity != 0)
+    {
+        reasonRightEntity = getEntity(kb, statement.reasonRightEntity);
+    }
+    auto reasonVerb = getVerb(kb, statement.reasonVerb);
 
-                getNextToken();
-                if (getCurrentToken() != ';')
-                {
-                    throw obelisk::ParserException("missing ';'");
-                }
+    obelisk::Entity leftEntity;
+    if (statement.leftEntity != 0)
+    {
+        leftEntity = getEntity(kb, statement.leftEntity);
+    }
+    obelisk::Entity rightEntity;
+    if (statement.rightEntity != 0)
+    {
+        rightEntity = getEntity(kb, statement.rightEntity);
+    }
+    auto verb = getVerb(kb, statement.verb);
+
+    obelisk::PatternRule patternRule;
+    patternRule.setReason(obelisk::Fact(std::move(reasonLeftEntity),
+        std::move(reasonRightEntity),
+        std::move(reasonVerb)));
+    patternRule.setFact(obelisk::Fact(std::move(leftEntity),
+        std::move(rightEntity),
+        std::move(verb)));
+    patternRule.setFactLeftVariable(strings.get(statement.leftVariable));
+    patternRule.setFactRightVariable(strings.get(statement.rightVariable));
+    patternRule.setReasonLeftVariable(
+        strings.get(statement.reasonLeftVariable));
+    patternRule.setReasonRightVariable(
+        strings.get(statement.reasonRightVariable));
+    patternRule.setWeight(statement.weight);
+    return patternRule;
+}
 
-                break;
-            }
+void obelisk::Parser::insertFactKeys(
+    std::unique_ptr<obelisk::KnowledgeBase>& kb,
+    std::vector<FactKey>& keys,
+    double isTrue,
+    std::vector<sqlite3_int64>& factIds)
+{
+    // the facts are inserted in the order of their unique index
+    std::sort(keys.begin(), keys.end());
 
-            if (getCurrentToken() == '"')
-            {
-                throw obelisk::ParserException("unexpected '\"'");
-            }
+    std::vector<obelisk::Fact> facts;
+    facts.reserve(keys.size());
+    for (auto& key : keys)
+    {
+        facts.emplace_back(obelisk::Entity(key.leftEntity),
+            obelisk::Entity(key.rightEntity),
+            obelisk::Verb(key.verb),
+            isTrue);
+    }
+    kb->addFacts(facts);
 
-            if (getLexer()->getIdentifier() == "and")
+    factIds.clear();
+    factIds.reserve(facts.size());
+    for (auto& fact : facts)
+    {
+        // the id was not inserted, so check if it exists in the database
+        if (fact.getId() == 0)
+        {
+            kb->getFact(fact);
+            if (fact.getId() == 0)
             {
-                getNextToken();
-                getEntity = true;
-                continue;
+                throw obelisk::ParserException(
+                    "fact could not be inserted into the database");
             }
-            else
+            if (isTrue > 0 && fact.getIsTrue() != isTrue)
             {
-                verb = getLexer()->getIdentifier();
-                for (const auto& letter : verb)
-                {
-                    if (!isalpha(letter))
-                    {
-                        throw new obelisk::ParserException(
-                            "non alphabetic symbol in verb");
-                    }
-                }
-                getEntity = true;
-                continue;
+                fact.setIsTrue(isTrue);
+                kb->updateIsTrue(fact);
             }
+            statistics_.rowsDeduplicated++;
         }
+        else
+        {
+            statistics_.rowsInserted++;
+        }
+        factIds.push_back(fact.getId());
     }
+}
 
-    for (auto& leftEntity : leftEntities)
+void obelisk::Parser::insertFullBatch(
+    std::unique_ptr<obelisk::KnowledgeBase>& kb)
+{
+    if (!retainStatements_ && arena_.getStatements().size() >= kBatchSize)
     {
-        for (auto& rightEntity : rightEntities)
-        {
-            facts.push_back(obelisk::Fact(obelisk::Entity(leftEntity),
-                obelisk::Entity(rightEntity),
-                obelisk::Verb(verb),
-                true));
-        }
+        insertStatements(kb);
     }
 }
 
-void obelisk::Parser::handleAction(std::unique_ptr<obelisk::KnowledgeBase>& kb)
+void obelisk::Parser::insertStatements(
+    std::unique_ptr<obelisk::KnowledgeBase>& kb)
 {
-    obelisk::SuggestAction suggestAction;
+    auto wallStart = std::chrono::steady_clock::now();
+    auto cpuStart  = std::clock();
 
+    if (kb.get() != cachedKb_)
+    {
+        // the cached IDs belong to the KnowledgeBase they were inserted into
+        entityIds_.clear();
+        verbIds_.clear();
+        actionIds_.clear();
+        cachedKb_ = kb.get();
+    }
+
+    kb->beginTransaction();
     try
     {
-        parseAction(suggestAction);
-        insertEntity(kb, suggestAction.getFact().getLeftEntity());
-        insertEntity(kb, suggestAction.getFact().getRightEntity());
-        insertVerb(kb, suggestAction.getFact().getVerb());
-        insertFact(kb, suggestAction.getFact());
-        insertAction(kb, suggestAction.getTrueAction());
-        insertAction(kb, suggestAction.getFalseAction());
-        insertSuggestAction(kb, suggestAction);
+        insertBatch(kb);
     }
-    catch (obelisk::ParserException& exception)
+    catch (std::exception& exception)
     {
+        kb->rollbackTransaction();
+        // the IDs cached while inserting the batch were rolled back with it
+        entityIds_.clear();
+        verbIds_.clear();
+        actionIds_.clear();
         throw;
     }
+    kb->commitTransaction();
+
+    arena_.clear();
+
+    std::chrono::duration<double> wallSeconds
+        = std::chrono::steady_clock::now() - wallStart;
+    statistics_.insertWallSeconds += wallSeconds.count();
+    statistics_.insertCpuSeconds
+        += static_cast<double>(std::clock() - cpuStart) / CLOCKS_PER_SEC;
 }
 
-void obelisk::Parser::handleRule(std::unique_ptr<obelisk::KnowledgeBase>& kb)
+void obelisk::Parser::insertStatements(
+    std::unique_ptr<obelisk::ShardedKnowledgeBase>& kb)
 {
-    obelisk::Rule rule;
+    auto wallStart = std::chrono::steady_clock::now();
+    auto cpuStart  = std::clock();
+
+    auto& statements = arena_.getStatements();
+    auto& strings    = arena_.getStrings();
+
+    // the sharded knowledge base gives the names their IDs, so the facts are
+    // given to it by name
+    auto getFact = [&strings](std::uint32_t leftEntity,
+                       std::uint32_t verb,
+                       std::uint32_t rightEntity,
+                       double isTrue)
+    {
+        return obelisk::Fact(obelisk::Entity(strings.get(leftEntity)),
+            obelisk::Entity(strings.get(rightEntity)),
+            obelisk::Verb(strings.get(verb)),
+            isTrue);
+    };
 
+    kb->beginTransaction();
     try
     {
-        parseRule(rule);
-
-        insertEntity(kb, rule.getReason().getLeftEntity());
-        insertEntity(kb, rule.getReason().getRightEntity());
-        insertVerb(kb, rule.getReason().getVerb());
-        insertFact(kb, rule.getReason());
+        for (auto& statement : statements)
+        {
+            if (statement.kind == obelisk::Statement::kStatementTransitive)
+            {
+                obelisk::Verb verb(strings.get(statement.verb));
+                kb->setTransitive(verb);
+            }
+        }
 
-        // The rule is true, so the fact must be true to.
-        if (rule.getReason().getIsTrue() > 0)
+        std::vector<obelisk::Fact> facts;
+        for (auto& statement : statements)
         {
-            rule.getFact().setIsTrue(1.0);
+            if (statement.kind != obelisk::Statement::kStatementFact)
+            {
+                continue;
+            }
+
+            auto left  = statement.first;
+            auto right = statement.first + statement.leftCount;
+            for (std::uint32_t l = 0; l < statement.leftCount; l++)
+            {
+                for (std::uint32_t r = 0; r < statement.rightCount; r++)
+                {
+                    facts.push_back(getFact(arena_.getName(left + l),
+                        statement.verb,
+                        arena_.getName(right + r),
+                        1.0));
+                    if (facts.size() >= kFactChunkSize)
+                    {
+                        kb->addFacts(facts);
+                        facts.clear();
+                    }
+                }
+            }
         }
+        kb->addFacts(facts);
+
+        std::vector<obelisk::Rule> rules;
+        std::vector<obelisk::PatternRule> patternRules;
+        std::vector<obelisk::SuggestAction> suggestActions;
+        for (auto& statement : statements)
+        {
+            switch (statement.kind)
+            {
+                case obelisk::Statement::kStatementRule :
+                {
+                    if (!isPatternRule(statement))
+                    {
+                        rules.emplace_back(getFact(statement.leftEntity,
+                                               statement.verb,
+                                               statement.rightEntity,
+                                               0.0),
+                            getFact(statement.reasonLeftEntity,
+                                statement.reasonVerb,
+                                statement.reasonRightEntity,
+                                0.0),
+                            statement.weight);
+                        break;
+                    }
 
-        insertEntity(kb, rule.getFact().getLeftEntity());
-        insertEntity(kb, rule.getFact().getRightEntity());
-        insertVerb(kb, rule.getFact().getVerb());
-        insertFact(kb, rule.getFact());
+                    // the sides that are variables have no entity
+                    auto getEntity = [&strings](std::uint32_t name)
+                    {
+                        return name == 0
+                                 ? obelisk::Entity()
+                                 : obelisk::Entity(strings.get(name));
+                    };
+                    obelisk::PatternRule patternRule;
+                    patternRule.setReason(
+                        obelisk::Fact(getEntity(statement.reasonLeftEntity),
+                            getEntity(statement.reasonRightEntity),
+                            obelisk::Verb(strings.get(statement.reasonVerb))));
+                    patternRule.setFact(
+                        obelisk::Fact(getEntity(statement.leftEntity),
+                            getEntity(statement.rightEntity),
+                            obelisk::Verb(strings.get(statement.verb))));
+                    patternRule.setFactLeftVariable(
+                        strings.get(statement.leftVariable));
+                    patternRule.setFactRightVariable(
+                        strings.get(statement.rightVariable));
+                    patternRule.setReasonLeftVariable(
+                        strings.get(statement.reasonLeftVariable));
+                    patternRule.setReasonRightVariable(
+                        strings.get(statement.reasonRightVariable));
+                    patternRule.setWeight(statement.weight);
+                    patternRules.push_back(std::move(patternRule));
+                    break;
+                }
+                case obelisk::Statement::kStatementAction :
+                    suggestActions.emplace_back(getFact(statement.leftEntity,
+                                                    statement.verb,
+                                                    statement.rightEntity,
+                                                    0.0),
+                        obelisk::Action(strings.get(statement.trueAction)),
+                        obelisk::Action(strings.get(statement.falseAction)));
+                    break;
+                default :
+                    break;
+            }
+        }
 
-        insertRule(kb, rule);
+        kb->addRules(rules);
+        kb->addPatternRules(patternRules);
+        kb->addSuggestActions(suggestActions);
     }
-    catch (obelisk::ParserException& exception)
+    catch (std::exception& exception)
     {
+        kb->rollbackTransaction();
         throw;
     }
+    kb->commitTransaction();
+
+    arena_.clear();
+
+    std::chrono::duration<double> wallSeconds
+        = std::chrono::steady_clock::now() - wallStart;
+    statistics_.insertWallSeconds += wallSeconds.count();
+    statistics_.insertCpuSeconds
+        += static_cast<double>(std::clock() - cpuStart) / CLOCKS_PER_SEC;
 }
 
-void obelisk::Parser::handleFact(std::unique_ptr<obelisk::KnowledgeBase>& kb)
+void obelisk::Parser::insertBatch(std::unique_ptr<obelisk::KnowledgeBase>& kb)
 {
-    std::vector<obelisk::Fact> facts;
-    try
+    auto& statements = arena_.getStatements();
+
+    // every name used by the batch is inserted once
+    std::unordered_set<std::uint32_t> entityNames;
+    std::unordered_set<std::uint32_t> verbNames;
+    std::unordered_set<std::uint32_t> actionNames;
+    std::vector<std::uint32_t> transitiveVerbs;
+    for (auto& statement : statements)
     {
-        parseFact(facts);
+        verbNames.insert(statement.verb);
+        switch (statement.kind)
+        {
+            case obelisk::Statement::kStatementFact :
+            {
+                auto end = statement.first + statement.leftCount
+                         + statement.rightCount;
+                for (auto name = statement.first; name < end; name++)
+                {
+                    entityNames.insert(arena_.getName(name));
+                }
+                break;
+            }
+            case obelisk::Statement::kStatementRule :
+                entityNames.insert(statement.leftEntity);
+                entityNames.insert(statement.rightEntity);
+                entityNames.insert(statement.reasonLeftEntity);
+                entityNames.insert(statement.reasonRightEntity);
+                verbNames.insert(statement.reasonVerb);
+                break;
+            case obelisk::Statement::kStatementAction :
+                entityNames.insert(statement.leftEntity);
+                entityNames.insert(statement.rightEntity);
+                actionNames.insert(statement.trueAction);
+                actionNames.insert(statement.falseAction);
+                break;
+            case obelisk::Statement::kStatementTransitive :
+                transitiveVerbs.push_back(statement.verb);
+                break;
+        }
     }
-    catch (obelisk::ParserException& exception)
+    // a side of a pattern rule that is a variable has no entity
+    entityNames.erase(0);
+
+    insertEntityNames(kb, entityNames);
+    insertVerbNames(kb, verbNames);
+    insertActionNames(kb, actionNames);
+
+    std::sort(transitiveVerbs.begin(), transitiveVerbs.end());
+    transitiveVerbs.erase(
+        std::unique(transitiveVerbs.begin(), transitiveVerbs.end()),
+        transitiveVerbs.end());
+    for (auto name : transitiveVerbs)
     {
-        throw;
+        auto verb = getVerb(kb, name);
+        kb->setTransitive(verb);
     }
 
-    int verbId = 0;
-    for (auto& fact : facts)
+    // the cross products of the fact statements are streamed in chunks of
+    // unique facts, so a fact with thousands of entities on each side never
+    // has all of its facts in memory at once
+    std::unordered_set<FactKey, FactKeyHash> uniqueFacts;
+    uniqueFacts.reserve(kFactChunkSize);
+    auto addUniqueFact = [this, &uniqueFacts](const FactKey& key)
     {
-        try
+        if (!uniqueFacts.insert(key).second)
         {
-            insertEntity(kb, fact.getLeftEntity());
-            insertEntity(kb, fact.getRightEntity());
+            statistics_.rowsDeduplicated++;
         }
-        catch (obelisk::ParserException& exception)
+    };
+    std::vector<FactKey> factKeys;
+    std::vector<sqlite3_int64> factIds;
+    for (auto& statement : statements)
+    {
+        if (statement.kind != obelisk::Statement::kStatementFact)
         {
-            throw;
+            continue;
         }
 
-        if (verbId == 0)
+        auto left  = statement.first;
+        auto right = statement.first + statement.leftCount;
+        for (std::uint32_t l = 0; l < statement.leftCount; l++)
         {
-            try
-            {
-                insertVerb(kb, fact.getVerb());
-            }
-            catch (obelisk::ParserException& exception)
+            for (std::uint32_t r = 0; r < statement.rightCount; r++)
             {
-                throw;
+                addUniqueFact(getFactKey(arena_.getName(left + l),
+                    statement.verb,
+                    arena_.getName(right + r)));
+                if (uniqueFacts.size() >= kFactChunkSize)
+                {
+                    factKeys.assign(uniqueFacts.begin(), uniqueFacts.end());
+                    uniqueFacts.clear();
+                    insertFactKeys(kb, factKeys, 1.0, factIds);
+                    // each full chunk is committed, so the journal only ever
+                    // holds the rows of one chunk
+                    kb->commitTransaction();
+                    kb->beginTransaction();
+                }
             }
-            verbId = fact.getVerb().getId();
         }
-        else
+    }
+    if (!uniqueFacts.empty())
+    {
+        factKeys.assign(uniqueFacts.begin(), uniqueFacts.end());
+        uniqueFacts.clear();
+        insertFactKeys(kb, factKeys, 1.0, factIds);
+    }
+
+    // the facts of the rules and actions are inserted after the stated ones,
+    // their truth is derived when the knowledge base is propagated after
+    // loading
+    for (auto& statement : statements)
+    {
+        switch (statement.kind)
         {
-            fact.getVerb().setId(verbId);
+            case obelisk::Statement::kStatementRule :
+                if (isPatternRule(statement))
+                {
+                    break;
+                }
+
+                addUniqueFact(getFactKey(statement.reasonLeftEntity,
+                    statement.reasonVerb,
+                    statement.reasonRightEntity));
+                addUniqueFact(getFactKey(statement.leftEntity,
+                    statement.verb,
+                    statement.rightEntity));
+                break;
+            case obelisk::Statement::kStatementAction :
+                addUniqueFact(getFactKey(statement.leftEntity,
+                    statement.verb,
+                    statement.rightEntity));
+                break;
+            default :
+                break;
         }
+    }
+    factKeys.assign(uniqueFacts.begin(), uniqueFacts.end());
+    insertFactKeys(kb, factKeys, 0.0, factIds);
 
-        try
+    auto getFactId = [&factKeys, &factIds](const FactKey& key)
+    {
+        auto index
+            = std::lower_bound(factKeys.begin(), factKeys.end(), key)
+            - factKeys.begin();
+        return factIds[index];
+    };
+
+    // a row that already existed comes back without an ID
+    auto countInsert = [this](sqlite3_int64 id)
+    {
+        if (id == 0)
         {
-            insertFact(kb, fact, true);
+            statistics_.rowsDeduplicated++;
         }
-        catch (obelisk::ParserException& exception)
+        else
         {
-            throw;
+            statistics_.rowsInserted++;
         }
+    };
+
+    // the rules and suggested actions are collected by the IDs of their
+    // rows to be deduplicated and sorted
+    using RuleRow = std::tuple<sqlite3_int64, sqlite3_int64, double>;
+    using SuggestActionRow
+        = std::tuple<sqlite3_int64, sqlite3_int64, sqlite3_int64>;
+    std::vector<RuleRow> ruleRows;
+    std::vector<SuggestActionRow> suggestActionRows;
+    std::vector<obelisk::PatternRule> patternRules;
+    for (auto& statement : statements)
+    {
+        switch (statement.kind)
+        {
+            case obelisk::Statement::kStatementRule :
+            {
+                if (isPatternRule(statement))
+                {
+                    patternRules.push_back(getPatternRule(kb, statement));
+                    break;
+                }
+
+                auto factId   = getFactId(getFactKey(statement.leftEntity,
+                    statement.verb,
+                    statement.rightEntity));
+                auto reasonId = getFactId(getFactKey(statement.reasonLeftEntity,
+                    statement.reasonVerb,
+                    statement.reasonRightEntity));
+                ruleRows.emplace_back(factId, reasonId, statement.weight);
+                break;
+            }
+            case obelisk::Statement::kStatementAction :
+            {
+                auto factId = getFactId(getFactKey(statement.leftEntity,
+                    statement.verb,
+                    statement.rightEntity));
+                suggestActionRows.emplace_back(factId,
+                    actionIds_[statement.trueAction],
+                    actionIds_[statement.falseAction]);
+                break;
+            }
+            default :
+                break;
+        }
+    }
+
+    // the weight of the first of the duplicate rules is kept, like when they
+    // were inserted one at a time
+    auto sameRule = [](const RuleRow& a, const RuleRow& b)
+    {
+        return std::get<0>(a) == std::get<0>(b)
+            && std::get<1>(a) == std::get<1>(b);
+    };
+    std::stable_sort(ruleRows.begin(),
+        ruleRows.end(),
+        [](const RuleRow& a, const RuleRow& b)
+        {
+            return std::tie(std::get<0>(a), std::get<1>(a))
+                 < std::tie(std::get<0>(b), std::get<1>(b));
+        });
+    auto ruleRowCount = ruleRows.size();
+    ruleRows.erase(std::unique(ruleRows.begin(), ruleRows.end(), sameRule),
+        ruleRows.end());
+    statistics_.rowsDeduplicated += ruleRowCount - ruleRows.size();
+
+    std::vector<obelisk::Rule> rules;
+    rules.reserve(ruleRows.size());
+    for (auto& ruleRow : ruleRows)
+    {
+        rules.emplace_back(obelisk::Fact(std::get<0>(ruleRow)),
+            obelisk::Fact(std::get<1>(ruleRow)),
+            std::get<2>(ruleRow));
+    }
+    kb->addRules(rules);
+    for (auto& rule : rules)
+    {
+        countInsert(rule.getId());
+    }
+
+    kb->addPatternRules(patternRules);
+    for (auto& patternRule : patternRules)
+    {
+        countInsert(patternRule.getId());
+    }
 
-        kb->checkRule(fact);
+    std::sort(suggestActionRows.begin(), suggestActionRows.end());
+    auto suggestActionRowCount = suggestActionRows.size();
+    suggestActionRows.erase(
+        std::unique(suggestActionRows.begin(), suggestActionRows.end()),
+        suggestActionRows.end());
+    statistics_.rowsDeduplicated
+        += suggestActionRowCount - suggestActionRows.size();
+
+    std::vector<obelisk::SuggestAction> suggestActions;
+    suggestActions.reserve(suggestActionRows.size());
+    for (auto& suggestActionRow : suggestActionRows)
+    {
+        suggestActions.emplace_back(
+            obelisk::Fact(std::get<0>(suggestActionRow)),
+            obelisk::Action(std::get<1>(suggestActionRow)),
+            obelisk::Action(std::get<2>(suggestActionRow)));
+    }
+    kb->addSuggestActions(suggestActions);
+    for (auto& suggestAction : suggestActions)
+    {
+        countInsert(suggestAction.getId());
     }
 }
 
+void obelisk::Parser::handleAction(std::unique_ptr<obelisk::KnowledgeBase>& kb)
+{
+    parseAction();
+    insertFullBatch(kb);
+}
+
+void obelisk::Parser::handleRule(std::unique_ptr<obelisk::KnowledgeBase>& kb)
+{
+    parseRule();
+    insertFullBatch(kb);
+}
+
+void obelisk::Parser::handleFact(std::unique_ptr<obelisk::KnowledgeBase>& kb)
+{
+    parseFact();
+    insertFullBatch(kb);
+}
+
+void obelisk::Parser::handleTransitive(
+    std::unique_ptr<obelisk::KnowledgeBase>& kb)
+{
+    parseTransitive();
+    insertFullBatch(kb);
+}
+
 void obelisk::Parser::insertEntity(std::unique_ptr<obelisk::KnowledgeBase>& kb,
     obelisk::Entity& entity)
 {
@@ -1002,3 +1429,23 @@ void obelisk::Parser::insertRule(std::unique_ptr<obelisk::KnowledgeBase>& kb,
         }
     }
 }
+
+void obelisk::Parser::insertPatternRule(
+    std::unique_ptr<obelisk::KnowledgeBase>& kb,
+    obelisk::PatternRule& patternRule)
+{
+    std::vector<obelisk::PatternRule> patternRules {patternRule};
+    kb->addPatternRules(patternRules);
+    patternRule = std::move(patternRules.front());
+
+    // the id was not inserted, so check if it exists in the database
+    if (patternRule.getId() == 0)
+    {
+        kb->getPatternRule(patternRule);
+        if (patternRule.getId() == 0)
+        {
+            throw obelisk::ParserException(
+                "pattern_rule could not be inserted into the database");
+        }
+    }
+}
@@ -9,14 +9,58 @@
 #include "models/action.h"
 #include "models/entity.h"
 #include "models/fact.h"
+#include "models/pattern_rule.h"
 #include "models/rule.h"
 #include "models/suggest_action.h"
 #include "models/verb.h"
+#include "sharded_knowledge_base.h"
+#include "statement.h"
 
+#include <cstddef>
+#include <cstdint>
 #include <memory>
+#include <string>
+#include <unordered_set>
+#include <vector>
 
 namespace obelisk
 {
+    /**
+     * @brief The ParserStatistics struct holds what the Parser inserted into
+     * the KnowledgeBase and how long it took.
+     *
+     */
+    struct ParserStatistics
+    {
+            /**
+             * @brief The number of rows added to the KnowledgeBase.
+             *
+             */
+            std::size_t rowsInserted = 0;
+
+            /**
+             * @brief The number of facts, rules and suggested actions that
+             * were not added because they were repeated in the source code or
+             * were already in the KnowledgeBase, and of names that were
+             * already in the KnowledgeBase.
+             *
+             */
+            std::size_t rowsDeduplicated = 0;
+
+            /**
+             * @brief The wall clock time spent inserting in seconds.
+             *
+             */
+            double insertWallSeconds = 0;
+
+            /**
+             * @brief The processor time spent inserting in seconds, by every
+             * thread of the process.
+             *
+             */
+            double insertCpuSeconds = 0;
+    };
+
     /**
      * @brief The Parser is responsible for analyzing the language's key words
      * and taking action based on its analysis.
@@ -38,6 +82,127 @@ namespace obelisk
              */
             int currentToken_ = 0;
 
+            /**
+             * @brief The statements being parsed and the names they use.
+             *
+             */
+            obelisk::StatementArena arena_;
+
+            /**
+             * @brief Whether the parsed statements are kept in the arena
+             * instead of being inserted into the KnowledgeBase.
+             *
+             */
+            bool retainStatements_ = false;
+
+            /**
+             * @brief What was inserted into the KnowledgeBase so far.
+             *
+             */
+            obelisk::ParserStatistics statistics_;
+
+            /**
+             * @brief The KnowledgeBase the cached IDs were inserted into.
+             *
+             */
+            obelisk::KnowledgeBase* cachedKb_ = nullptr;
+
+            /**
+             * @brief The ID of the Entity of each name, or 0 if it hasn't been
+             * inserted yet.
+             *
+             */
+            std::vector<sqlite3_int64> entityIds_;
+
+            /**
+             * @brief The ID of the Verb of each name, or 0 if it hasn't been
+             * inserted yet.
+             *
+             */
+            std::vector<sqlite3_int64> verbIds_;
+
+            /**
+             * @brief The ID of the Action of each name, or 0 if it hasn't been
+             * inserted yet.
+             *
+             */
+            std::vector<sqlite3_int64> actionIds_;
+
+            /**
+             * @brief The number of statements parsed before they are inserted
+             * into the KnowledgeBase as one batch.
+             *
+             */
+            static constexpr std::size_t kBatchSize = 4096;
+
+            /**
+             * @brief The most facts of the cross products of fact statements
+             * kept in memory before they are inserted into the
+             * KnowledgeBase.
+             *
+             */
+            static constexpr std::size_t kFactChunkSize = 65536;
+
+            /**
+             * @brief The IDs of the entities and verb of a fact, the key of
+             * the unique index on the fact table.
+             *
+             */
+            struct FactKey
+            {
+                    /**
+                     * @brief The ID of the left entity.
+                     *
+                     */
+                    sqlite3_int64 leftEntity;
+
+                    /**
+                     * @brief The ID of the right entity.
+                     *
+                     */
+                    sqlite3_int64 rightEntity;
+
+                    /**
+                     * @brief The ID of the verb.
+                     *
+                     */
+                    sqlite3_int64 verb;
+
+                    /**
+                     * @brief Check if two keys are the same fact.
+                     *
+                     * @param[in] other The other key.
+                     * @return true The keys are the same.
+                     * @return false The keys are different.
+                     */
+                    bool operator==(const FactKey& other) const;
+
+                    /**
+                     * @brief Compare two keys in the order of the unique
+                     * index.
+                     *
+                     * @param[in] other The other key.
+                     * @return true This key comes first.
+                     * @return false This key doesn't come first.
+                     */
+                    bool operator<(const FactKey& other) const;
+            };
+
+            /**
+             * @brief The hash of a FactKey.
+             *
+             */
+            struct FactKeyHash
+            {
+                    /**
+                     * @brief Hash a FactKey.
+                     *
+                     * @param[in] key The key.
+                     * @return std::size_t Returns the hash.
+                     */
+                    std::size_t operator()(const FactKey& key) const;
+            };
+
             /**
              * @brief Set the current token.
              *
@@ -138,25 +303,246 @@ namespace obelisk
             std::unique_ptr<obelisk::PrototypeAST> parseExtern();
 
             /**
-             * @brief Parse a SuggestAction.
+             * @brief Describe the current token for an error message.
+             *
+             * @return std::string Returns the token as it appears in the
+             * source code.
+             */
+            std::string describeToken();
+
+            /**
+             * @brief Check if the current token is an identifier with the
+             * given text.
+             *
+             * @param[in] keyword The text to check for.
+             * @return true If the token is the keyword.
+             * @return false If the token is anything else.
+             */
+            bool isKeyword(const char* keyword);
+
+            /**
+             * @brief Skip the current token if it is the expected one.
              *
-             * @param[out] suggestAction The parsed SuggestAction.
+             * @param[in] token The expected token, an ASCII character.
+             * @throws ParserException If the current token is different.
              */
-            void parseAction(obelisk::SuggestAction& suggestAction);
+            void expectToken(int token);
 
             /**
-             * @brief Parse a Rule.
+             * @brief Skip the current token if it is the expected keyword.
              *
-             * @param[out] rule The parsed Rule.
+             * @param[in] keyword The expected keyword.
+             * @throws ParserException If the current token is different.
              */
-            void parseRule(obelisk::Rule& rule);
+            void expectKeyword(const char* keyword);
 
             /**
-             * @brief Parse Facts.
+             * @brief Skip the closing parenthesis of a statement and check
+             * that the statement ends with a semicolon.
+             *
+             * The semicolon is left as the current token.
+             *
+             * @throws ParserException If either one is missing.
+             */
+            void expectEnd();
+
+            /**
+             * @brief Parse the string that names an Entity or Action.
+             *
+             * @return std::uint32_t Returns the ID of the interned name.
+             */
+            std::uint32_t parseName();
+
+            /**
+             * @brief Parse a Verb.
+             *
+             * @return std::uint32_t Returns the ID of the interned name.
+             */
+            std::uint32_t parseVerb();
+
+            /**
+             * @brief Parse one side of a Rule, which is either a string naming
+             * an Entity or an unquoted variable.
+             *
+             * @param[out] entity Set to the ID of the Entity if it is one.
+             * @param[out] variable Set to the ID of the variable if it is one.
+             */
+            void parseTerm(std::uint32_t& entity, std::uint32_t& variable);
+
+            /**
+             * @brief Parse a list of entities separated by "and" into the
+             * names of the arena.
+             *
+             * @param[out] count Set to the number of entities.
+             */
+            void parseEntities(std::uint32_t& count);
+
+            /**
+             * @brief Parse a fact statement.
+             *
+             * Every left Entity is paired with every right Entity.
+             *
+             * @return obelisk::Statement& Returns the parsed Statement.
+             */
+            obelisk::Statement& parseFact();
+
+            /**
+             * @brief Parse a rule statement.
+             *
+             * An unquoted name in place of an entity is a variable, every
+             * variable used in the Fact must also be used in the reason. The
+             * reason can be followed by "with" and a weight between 0 and 1.
              *
-             * @param[out] facts The parsed Facts.
+             * @return obelisk::Statement& Returns the parsed Statement.
              */
-            void parseFact(std::vector<obelisk::Fact>& facts);
+            obelisk::Statement& parseRule();
+
+            /**
+             * @brief Parse an action statement.
+             *
+             * @return obelisk::Statement& Returns the parsed Statement.
+             */
+            obelisk::Statement& parseAction();
+
+            /**
+             * @brief Parse a transitive declaration.
+             *
+             * @return obelisk::Statement& Returns the parsed Statement.
+             */
+            obelisk::Statement& parseTransitive();
+
+            /**
+             * @brief Get an Entity by its name, inserting it the first time
+             * the name is used.
+             *
+             * @param[in] kb The KnowledgeBase to use.
+             * @param[in] name The ID of the name.
+             * @return obelisk::Entity Returns the Entity with its ID.
+             */
+            obelisk::Entity getEntity(
+                std::unique_ptr<obelisk::KnowledgeBase>& kb,
+                std::uint32_t name);
+
+            /**
+             * @brief Get a Verb by its name, inserting it the first time the
+             * name is used.
+             *
+             * @param[in] kb The KnowledgeBase to use.
+             * @param[in] name The ID of the name.
+             * @return obelisk::Verb Returns the Verb with its ID.
+             */
+            obelisk::Verb getVerb(std::unique_ptr<obelisk::KnowledgeBase>& kb,
+                std::uint32_t name);
+
+            /**
+             * @brief Get an Action by its name, inserting it the first time
+             * the name is used.
+             *
+             * @param[in] kb The KnowledgeBase to use.
+             * @param[in] name The ID of the name.
+             * @return obelisk::Action Returns the Action with its ID.
+             */
+            obelisk::Action getAction(
+                std::unique_ptr<obelisk::KnowledgeBase>& kb,
+                std::uint32_t name);
+
+            /**
+             * @brief Check if a rule statement is a PatternRule, which has a
+             * variable on at least one side.
+             *
+             * @param[in] statement The Statement.
+             * @return true The Statement is a PatternRule.
+             * @return false The Statement isn't a PatternRule.
+             */
+            static bool isPatternRule(const obelisk::Statement& statement);
+
+            /**
+             * @brief Get the key of a fact whose names have been inserted.
+             *
+             * @param[in] leftEntity The ID of the name of the left entity.
+             * @param[in] verb The ID of the name of the verb.
+             * @param[in] rightEntity The ID of the name of the right entity.
+             * @return FactKey Returns the key of the fact.
+             */
+            FactKey getFactKey(std::uint32_t leftEntity,
+                std::uint32_t verb,
+                std::uint32_t rightEntity);
+
+            /**
+             * @brief Insert the entities of a batch that aren't cached yet,
+             * sorted by name.
+             *
+             * @param[in] kb The KnowledgeBase to insert the entities into.
+             * @param[in] names The IDs of the names of the entities.
+             */
+            void insertEntityNames(std::unique_ptr<obelisk::KnowledgeBase>& kb,
+                const std::unordered_set<std::uint32_t>& names);
+
+            /**
+             * @brief Insert the verbs of a batch that aren't cached yet,
+             * sorted by name.
+             *
+             * @param[in] kb The KnowledgeBase to insert the verbs into.
+             * @param[in] names The IDs of the names of the verbs.
+             */
+            void insertVerbNames(std::unique_ptr<obelisk::KnowledgeBase>& kb,
+                const std::unordered_set<std::uint32_t>& names);
+
+            /**
+             * @brief Insert the actions of a batch that aren't cached yet,
+             * sorted by name.
+             *
+             * @param[in] kb The KnowledgeBase to insert the actions into.
+             * @param[in] names The IDs of the names of the actions.
+             */
+            void insertActionNames(std::unique_ptr<obelisk::KnowledgeBase>& kb,
+                const std::unordered_set<std::uint32_t>& names);
+
+            /**
+             * @brief Insert facts by their keys.
+             *
+             * A fact that is already in the KnowledgeBase is only updated if
+             * it is given a truth it doesn't have yet.
+             *
+             * @param[in] kb The KnowledgeBase to insert the facts into.
+             * @param[in,out] keys The unique keys of the facts, which are
+             * sorted in the order of the unique index and inserted in that
+             * order.
+             * @param[in] isTrue The truth of the facts.
+             * @param[out] factIds The ID of each fact, in the order of the
+             * sorted keys.
+             */
+            void insertFactKeys(std::unique_ptr<obelisk::KnowledgeBase>& kb,
+                std::vector<FactKey>& keys,
+                double isTrue,
+                std::vector<sqlite3_int64>& factIds);
+
+            /**
+             * @brief Write the rows of the batch of parsed statements to the
+             * KnowledgeBase, insertStatements runs it in a transaction which
+             * is committed after every full chunk of facts.
+             *
+             * @param[in] kb The KnowledgeBase to insert the statements into.
+             */
+            void insertBatch(std::unique_ptr<obelisk::KnowledgeBase>& kb);
+
+            /**
+             * @brief Get the PatternRule of a rule statement.
+             *
+             * @param[in] kb The KnowledgeBase the names are in.
+             * @param[in] statement The Statement.
+             * @return obelisk::PatternRule Returns the PatternRule.
+             */
+            obelisk::PatternRule getPatternRule(
+                std::unique_ptr<obelisk::KnowledgeBase>& kb,
+                const obelisk::Statement& statement);
+
+            /**
+             * @brief Insert the batch of statements if it is full.
+             *
+             * @param[in] kb The KnowledgeBase to insert the statements into.
+             */
+            void insertFullBatch(std::unique_ptr<obelisk::KnowledgeBase>& kb);
 
         public:
             /**
@@ -185,6 +571,31 @@ namespace obelisk
              */
             void setLexer(std::shared_ptr<obelisk::Lexer> lexer);
 
+            /**
+             * @brief Get the arena holding the parsed statements.
+             *
+             * @return obelisk::StatementArena& Returns the arena.
+             */
+            obelisk::StatementArena& getArena();
+
+            /**
+             * @brief Set whether the parsed statements are kept in the arena
+             * instead of being inserted into the KnowledgeBase, which is how
+             * source code is compiled without a KnowledgeBase.
+             *
+             * @param[in] retainStatements Whether to keep the statements.
+             */
+            void setRetainStatements(bool retainStatements);
+
+            /**
+             * @brief Get what the Parser inserted into the KnowledgeBase since
+             * it was created.
+             *
+             * @return const obelisk::ParserStatistics& Returns the
+             * statistics.
+             */
+            const obelisk::ParserStatistics& getStatistics();
+
             /**
              * @brief Gets the current token held inside the Lexer.
              *
@@ -200,27 +611,79 @@ namespace obelisk
             int getNextToken();
 
             /**
-             * @brief Parse the SuggestAction and then insert it into the
-             * KnowledgeBase.
+             * @brief Parse the SuggestAction and add it to the batch of
+             * statements inserted into the KnowledgeBase.
              *
              * @param[in] kb The KnowledgeBase to insert the SuggestAction into.
              */
             void handleAction(std::unique_ptr<obelisk::KnowledgeBase>& kb);
 
             /**
-             * @brief Parse the Rule and then insert it into the KnowledgeBase.
+             * @brief Parse the Rule and add it to the batch of statements
+             * inserted into the KnowledgeBase.
              *
              * @param[in] kb The KnowledgeBase to insert the Rule into.
              */
             void handleRule(std::unique_ptr<obelisk::KnowledgeBase>& kb);
 
             /**
-             * @brief Parse the Fact and then insert it into the KnowledgeBase.
+             * @brief Parse the Fact and add it to the batch of statements
+             * inserted into the KnowledgeBase.
              *
              * @param[in] kb The KnowledgeBase to insert the Fact into.
              */
             void handleFact(std::unique_ptr<obelisk::KnowledgeBase>& kb);
 
+            /**
+             * @brief Parse a transitive declaration and add it to the batch of
+             * statements inserted into the KnowledgeBase.
+             *
+             * @param[in] kb The KnowledgeBase the Verb is in.
+             */
+            void handleTransitive(std::unique_ptr<obelisk::KnowledgeBase>& kb);
+
+            /**
+             * @brief Insert the batch of parsed statements into the
+             * KnowledgeBase.
+             *
+             * The entities, verbs, actions and facts used by the batch are
+             * deduplicated first, so a name or fact that appears many times
+             * is only sent to the KnowledgeBase once, and each table gets its
+             * rows sorted in the order of its unique index. The cross
+             * products of the fact statements are expanded lazily in chunks
+             * of kFactChunkSize facts, so the memory used doesn't grow with
+             * the size of a cross product. The IDs of the names are cached, so
+             * each name is only looked up in the KnowledgeBase once. The arena
+             * is cleared afterwards.
+             *
+             * The batch is written in one transaction, so the file is only
+             * synced once for it instead of once for every row. A cross
+             * product that fills a chunk commits the transaction after the
+             * chunk and starts a new one, so a large batch is synced once per
+             * chunk. If a row can't be inserted, the rows written since the
+             * last commit are rolled back.
+             *
+             * @param[in] kb The KnowledgeBase to insert the statements into.
+             */
+            void insertStatements(std::unique_ptr<obelisk::KnowledgeBase>& kb);
+
+            /**
+             * @brief Insert the batch of parsed statements into a
+             * ShardedKnowledgeBase.
+             *
+             * The verbs are made transitive first, so the facts of them are
+             * copied into the Closure that joins the shards as they are added.
+             * The facts of the cross products are added in chunks of
+             * kFactChunkSize facts. The batch is written in one transaction
+             * in every shard, which is rolled back if a row can't be inserted.
+             * The arena is cleared afterwards.
+             *
+             * @param[in] kb The ShardedKnowledgeBase to insert the statements
+             * into.
+             */
+            void insertStatements(
+                std::unique_ptr<obelisk::ShardedKnowledgeBase>& kb);
+
             /**
              * @brief Helper used to insert an Entity into the KnowledgeBase.
              *
@@ -285,6 +748,17 @@ namespace obelisk
              */
             void insertRule(std::unique_ptr<obelisk::KnowledgeBase>& kb,
                 obelisk::Rule& rule);
+
+            /**
+             * @brief Helper used to insert a PatternRule into the
+             * KnowledgeBase.
+             *
+             * @param[in] kb The KnowledgeBase to use.
+             * @param[in,out] patternRule The PatternRule to insert. It will
+             * contain the ID of the PatternRule after inserting it.
+             */
+            void insertPatternRule(std::unique_ptr<obelisk::KnowledgeBase>& kb,
+                obelisk::PatternRule& patternRule);
     };
 
     /**
@@ -0,0 +1,345 @@
+#include "statement.h"
+
+#include <algorithm>
+#include <cstring>
+#include <utility>
+
+obelisk::StringTable& obelisk::StatementArena::getStrings()
+{
+    return strings_;
+}
+
+std::vector<obelisk::Statement>& obelisk::StatementArena::getStatements()
+{
+    return statements_;
+}
+
+obelisk::Statement& obelisk::StatementArena::addStatement(
+    obelisk::Statement::Kind kind)
+{
+    auto& statement = statements_.emplace_back();
+    statement.kind  = kind;
+    addedCounts_[kind]++;
+    return statement;
+}
+
+void obelisk::StatementArena::addName(std::uint32_t name)
+{
+    names_.push_back(name);
+}
+
+std::uint32_t obelisk::StatementArena::getNameCount()
+{
+    return static_cast<std::uint32_t>(names_.size());
+}
+
+std::uint32_t obelisk::StatementArena::getName(std::uint32_t index)
+{
+    return names_[index];
+}
+
+std::size_t obelisk::StatementArena::getAddedCount(
+    obelisk::Statement::Kind kind)
+{
+    return addedCounts_[kind];
+}
+
+void obelisk::StatementArena::clear()
+{
+    statements_.clear();
+    names_.clear();
+}
+
+void obelisk::StatementArena::writeNumber(std::ostream& stream,
+    std::uint64_t value,
+    std::size_t bytes)
+{
+    char buffer[8];
+    for (std::size_t i = 0; i < bytes; i++)
+    {
+        buffer[i] = static_cast<char>((value >> (i * 8)) & 0xff);
+    }
+    stream.write(buffer, bytes);
+}
+
+std::uint64_t obelisk::StatementArena::readNumber(std::istream& stream,
+    std::size_t bytes)
+{
+    unsigned char buffer[8];
+    if (!stream.read(reinterpret_cast<char*>(buffer), bytes))
+    {
+        throw obelisk::StatementArenaException(
+            "the compiled file ended too early");
+    }
+
+    std::uint64_t value = 0;
+    for (std::size_t i = 0; i < bytes; i++)
+    {
+        value |= static_cast<std::uint64_t>(buffer[i]) << (i * 8);
+    }
+    return value;
+}
+
+void obelisk::StatementArena::readString(std::istream& stream,
+    std::string& string)
+{
+    // the length comes from the file, so the string only grows by what was
+    // really read instead of trusting it with one allocation
+    auto length = readNumber(stream, 4);
+    string.clear();
+
+    char buffer[4096];
+    while (length > 0)
+    {
+        auto bytes = std::min<std::uint64_t>(length, sizeof(buffer));
+        if (!stream.read(buffer, bytes))
+        {
+            throw obelisk::StatementArenaException(
+                "the compiled file ended too early");
+        }
+        string.append(buffer, bytes);
+        length -= bytes;
+    }
+}
+
+void obelisk::StatementArena::write(std::ostream& stream)
+{
+    stream.write(kMagic, sizeof(kMagic));
+    writeNumber(stream, kVersion, 4);
+
+    // the empty string always has the ID 0, so it isn't written
+    writeNumber(stream, strings_.size() - 1, 4);
+    for (std::size_t id = 1; id < strings_.size(); id++)
+    {
+        auto& string = strings_.get(static_cast<std::uint32_t>(id));
+        writeNumber(stream, string.size(), 4);
+        stream.write(string.data(), string.size());
+    }
+
+    writeNumber(stream, names_.size(), 4);
+    for (auto name : names_)
+    {
+        writeNumber(stream, name, 4);
+    }
+
+    writeNumber(stream, statements_.size(), 4);
+    for (auto& statement : statements_)
+    {
+        // only the fields used by the kind of the statement are written
+        writeNumber(stream, statement.kind, 1);
+        switch (statement.kind)
+        {
+            case obelisk::Statement::kStatementFact :
+                writeNumber(stream, statement.verb, 4);
+                writeNumber(stream, statement.first, 4);
+                writeNumber(stream, statement.leftCount, 4);
+                writeNumber(stream, statement.rightCount, 4);
+                break;
+            case obelisk::Statement::kStatementRule :
+            {
+                std::uint64_t weight;
+                std::memcpy(&weight, &statement.weight, sizeof(weight));
+
+                writeNumber(stream, statement.leftEntity, 4);
+                writeNumber(stream, statement.verb, 4);
+                writeNumber(stream, statement.rightEntity, 4);
+                writeNumber(stream, statement.leftVariable, 4);
+                writeNumber(stream, statement.rightVariable, 4);
+                writeNumber(stream, statement.reasonLeftEntity, 4);
+                writeNumber(stream, statement.reasonVerb, 4);
+                writeNumber(stream, statement.reasonRightEntity, 4);
+                writeNumber(stream, statement.reasonLeftVariable, 4);
+                writeNumber(stream, statement.reasonRightVariable, 4);
+                writeNumber(stream, weight, 8);
+                break;
+            }
+            case obelisk::Statement::kStatementAction :
+                writeNumber(stream, statement.leftEntity, 4);
+                writeNumber(stream, statement.verb, 4);
+                writeNumber(stream, statement.rightEntity, 4);
+                writeNumber(stream, statement.trueAction, 4);
+                writeNumber(stream, statement.falseAction, 4);
+                break;
+            case obelisk::Statement::kStatementTransitive :
+                writeNumber(stream, statement.verb, 4);
+                break;
+        }
+    }
+
+    if (!stream)
+    {
+        throw obelisk::StatementArenaException(
+            "failed to write the compiled file");
+    }
+}
+
+void obelisk::StatementArena::checkRule(const obelisk::Statement& statement)
+{
+    if (statement.verb == 0 || statement.reasonVerb == 0)
+    {
+        throw obelisk::StatementArenaException(
+            "the compiled file has a statement with a missing name");
+    }
+
+    // every side of the fact and the reason is either an entity or a
+    // variable, never both or neither
+    const std::pair<std::uint32_t, std::uint32_t> terms[] = {
+        {statement.leftEntity, statement.leftVariable},
+        {statement.rightEntity, statement.rightVariable},
+        {statement.reasonLeftEntity, statement.reasonLeftVariable},
+        {statement.reasonRightEntity, statement.reasonRightVariable}};
+    for (const auto& term : terms)
+    {
+        if ((term.first == 0) == (term.second == 0))
+        {
+            throw obelisk::StatementArenaException(
+                "the compiled file has a rule side that isn't an entity or "
+                "a variable");
+        }
+    }
+
+    // every variable in the fact has to be bound by the reason
+    for (auto variable : {statement.leftVariable, statement.rightVariable})
+    {
+        if (variable != 0 && variable != statement.reasonLeftVariable
+            && variable != statement.reasonRightVariable)
+        {
+            throw obelisk::StatementArenaException(
+                "the compiled file has a rule with a variable that is not "
+                "used in the reason");
+        }
+    }
+}
+
+void obelisk::StatementArena::read(std::istream& stream)
+{
+    char magic[sizeof(kMagic)];
+    if (!stream.read(magic, sizeof(magic))
+        || std::memcmp(magic, kMagic, sizeof(magic)) != 0)
+    {
+        throw obelisk::StatementArenaException("not a compiled obelisk file");
+    }
+    if (readNumber(stream, 4) != kVersion)
+    {
+        throw obelisk::StatementArenaException(
+            "unsupported version of the compiled format");
+    }
+
+    // the IDs in the file are mapped to the IDs the names get in this arena
+    auto stringCount = readNumber(stream, 4) + 1;
+    std::vector<std::uint32_t> ids;
+    ids.push_back(0);
+    std::string string;
+    for (std::uint64_t id = 1; id < stringCount; id++)
+    {
+        readString(stream, string);
+        ids.push_back(strings_.intern(string));
+    }
+
+    auto mapName = [&ids](std::uint64_t name) -> std::uint32_t
+    {
+        if (name >= ids.size())
+        {
+            throw obelisk::StatementArenaException(
+                "the compiled file uses a name that doesn't exist");
+        }
+        return ids[name];
+    };
+
+    // the parser never leaves a name out where one is required, so a record
+    // without one didn't come from it
+    auto requireName = [&mapName](std::uint64_t name) -> std::uint32_t
+    {
+        if (name == 0)
+        {
+            throw obelisk::StatementArenaException(
+                "the compiled file has a statement with a missing name");
+        }
+        return mapName(name);
+    };
+
+    std::uint64_t firstName = names_.size();
+    auto nameCount          = readNumber(stream, 4);
+    for (std::uint64_t i = 0; i < nameCount; i++)
+    {
+        names_.push_back(requireName(readNumber(stream, 4)));
+    }
+
+    auto statementCount = readNumber(stream, 4);
+    for (std::uint64_t i = 0; i < statementCount; i++)
+    {
+        auto kind = readNumber(stream, 1);
+        if (kind > obelisk::Statement::kStatementTransitive)
+        {
+            throw obelisk::StatementArenaException(
+                "the compiled file has an unknown kind of statement");
+        }
+
+        obelisk::Statement statement;
+        statement.kind = static_cast<obelisk::Statement::Kind>(kind);
+        switch (statement.kind)
+        {
+            case obelisk::Statement::kStatementFact :
+            {
+                statement.verb  = requireName(readNumber(stream, 4));
+                auto first      = readNumber(stream, 4);
+                auto leftCount  = readNumber(stream, 4);
+                auto rightCount = readNumber(stream, 4);
+                if (leftCount == 0 || rightCount == 0)
+                {
+                    throw obelisk::StatementArenaException(
+                        "the compiled file has a fact without entities");
+                }
+                if (first + leftCount + rightCount > nameCount)
+                {
+                    throw obelisk::StatementArenaException(
+                        "the compiled file has a fact with entities that "
+                        "don't exist");
+                }
+                statement.first
+                    = static_cast<std::uint32_t>(firstName + first);
+                statement.leftCount  = static_cast<std::uint32_t>(leftCount);
+                statement.rightCount = static_cast<std::uint32_t>(rightCount);
+                break;
+            }
+            case obelisk::Statement::kStatementRule :
+            {
+                statement.leftEntity          = mapName(readNumber(stream, 4));
+                statement.verb                = mapName(readNumber(stream, 4));
+                statement.rightEntity         = mapName(readNumber(stream, 4));
+                statement.leftVariable        = mapName(readNumber(stream, 4));
+                statement.rightVariable       = mapName(readNumber(stream, 4));
+                statement.reasonLeftEntity    = mapName(readNumber(stream, 4));
+                statement.reasonVerb          = mapName(readNumber(stream, 4));
+                statement.reasonRightEntity   = mapName(readNumber(stream, 4));
+                statement.reasonLeftVariable  = mapName(readNumber(stream, 4));
+                statement.reasonRightVariable = mapName(readNumber(stream, 4));
+
+                checkRule(statement);
+
+                auto weight = readNumber(stream, 8);
+                std::memcpy(&statement.weight, &weight, sizeof(weight));
+                if (!(statement.weight >= 0.0 && statement.weight <= 1.0))
+                {
+                    throw obelisk::StatementArenaException(
+                        "the compiled file has a rule weight that isn't "
+                        "between 0 and 1");
+                }
+                break;
+            }
+            case obelisk::Statement::kStatementAction :
+                statement.leftEntity  = requireName(readNumber(stream, 4));
+                statement.verb        = requireName(readNumber(stream, 4));
+                statement.rightEntity = requireName(readNumber(stream, 4));
+                statement.trueAction  = requireName(readNumber(stream, 4));
+                statement.falseAction = requireName(readNumber(stream, 4));
+                break;
+            case obelisk::Statement::kStatementTransitive :
+                statement.verb = requireName(readNumber(stream, 4));
+                break;
+        }
+
+        statements_.push_back(statement);
+        addedCounts_[statement.kind]++;
+    }
+}
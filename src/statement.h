@@ -0,0 +1,400 @@
+#ifndef OBELISK_STATEMENT_H
+#define OBELISK_STATEMENT_H
+
+#include "string_table.h"
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <exception>
+#include <istream>
+#include <ostream>
+#include <string>
+#include <vector>
+
+namespace obelisk
+{
+    /**
+     * @brief The Statement struct is a parsed statement of the source code.
+     *
+     * The names are IDs in the StringTable of the StatementArena the
+     * Statement belongs to, an ID of 0 means the name isn't used. Which fields
+     * are used depends on the kind of the Statement.
+     *
+     */
+    struct Statement
+    {
+            /**
+             * @brief The kinds of statement.
+             *
+             */
+            enum Kind : std::uint8_t
+            {
+                /**
+                 * @brief A fact, every left entity is paired with every right
+                 * entity. The entities are in the names of the arena, starting
+                 * at first.
+                 *
+                 */
+                kStatementFact,
+
+                /**
+                 * @brief A rule, each side of the fact and the reason is
+                 * either an entity or a variable.
+                 *
+                 */
+                kStatementRule,
+
+                /**
+                 * @brief A suggested action for a fact.
+                 *
+                 */
+                kStatementAction,
+
+                /**
+                 * @brief A verb declared transitive.
+                 *
+                 */
+                kStatementTransitive
+            };
+
+            /**
+             * @brief The kind of the Statement.
+             *
+             */
+            Kind kind = kStatementFact;
+
+            /**
+             * @brief The left entity of the fact.
+             *
+             */
+            std::uint32_t leftEntity = 0;
+
+            /**
+             * @brief The verb of the fact, or the transitive verb.
+             *
+             */
+            std::uint32_t verb = 0;
+
+            /**
+             * @brief The right entity of the fact.
+             *
+             */
+            std::uint32_t rightEntity = 0;
+
+            /**
+             * @brief The variable in place of the left entity of the fact.
+             *
+             */
+            std::uint32_t leftVariable = 0;
+
+            /**
+             * @brief The variable in place of the right entity of the fact.
+             *
+             */
+            std::uint32_t rightVariable = 0;
+
+            /**
+             * @brief The left entity of the reason of a rule.
+             *
+             */
+            std::uint32_t reasonLeftEntity = 0;
+
+            /**
+             * @brief The verb of the reason of a rule.
+             *
+             */
+            std::uint32_t reasonVerb = 0;
+
+            /**
+             * @brief The right entity of the reason of a rule.
+             *
+             */
+            std::uint32_t reasonRightEntity = 0;
+
+            /**
+             * @brief The variable in place of the left entity of the reason.
+             *
+             */
+            std::uint32_t reasonLeftVariable = 0;
+
+            /**
+             * @brief The variable in place of the right entity of the reason.
+             *
+             */
+            std::uint32_t reasonRightVariable = 0;
+
+            /**
+             * @brief The action suggested when the fact is true.
+             *
+             */
+            std::uint32_t trueAction = 0;
+
+            /**
+             * @brief The action suggested when the fact is false.
+             *
+             */
+            std::uint32_t falseAction = 0;
+
+            /**
+             * @brief The index of the first left entity of a fact in the names
+             * of the arena, the right entities follow the left ones.
+             *
+             */
+            std::uint32_t first = 0;
+
+            /**
+             * @brief The number of left entities of a fact.
+             *
+             */
+            std::uint32_t leftCount = 0;
+
+            /**
+             * @brief The number of right entities of a fact.
+             *
+             */
+            std::uint32_t rightCount = 0;
+
+            /**
+             * @brief The weight of a rule.
+             *
+             */
+            double weight = 1.0;
+    };
+
+    /**
+     * @brief The StatementArena class holds parsed statements and the names
+     * they use.
+     *
+     * The statements and the lists of entities are kept in flat vectors that
+     * are reused after being cleared, and the names are interned, so parsing
+     * another statement doesn't allocate once the arena has grown to fit.
+     *
+     */
+    class StatementArena
+    {
+        private:
+            /**
+             * @brief The interned names.
+             *
+             */
+            obelisk::StringTable strings_;
+
+            /**
+             * @brief The parsed statements.
+             *
+             */
+            std::vector<obelisk::Statement> statements_;
+
+            /**
+             * @brief The lists of entities used by the fact statements.
+             *
+             */
+            std::vector<std::uint32_t> names_;
+
+            /**
+             * @brief The number of statements of each kind ever added, which
+             * isn't reset when the arena is cleared.
+             *
+             */
+            std::array<std::size_t,
+                obelisk::Statement::kStatementTransitive + 1>
+                addedCounts_ {};
+
+            /**
+             * @brief The magic at the start of a compiled file.
+             *
+             */
+            static constexpr char kMagic[4] = {'O', 'B', 'K', 'C'};
+
+            /**
+             * @brief The version of the compiled format, changed whenever the
+             * layout of a record changes.
+             *
+             */
+            static constexpr std::uint32_t kVersion = 1;
+
+            /**
+             * @brief Write a little endian number to a compiled file.
+             *
+             * @param[in] stream The stream to write to.
+             * @param[in] value The number.
+             * @param[in] bytes The number of bytes to write.
+             */
+            static void writeNumber(std::ostream& stream,
+                std::uint64_t value,
+                std::size_t bytes);
+
+            /**
+             * @brief Read a little endian number from a compiled file.
+             *
+             * @param[in] stream The stream to read from.
+             * @param[in] bytes The number of bytes to read.
+             * @throws StatementArenaException when the file ends before the
+             * number.
+             * @return std::uint64_t Returns the number.
+             */
+            static std::uint64_t readNumber(std::istream& stream,
+                std::size_t bytes);
+
+            /**
+             * @brief Read a string and its length from a compiled file.
+             *
+             * @param[in] stream The stream to read from.
+             * @param[out] string The string.
+             * @throws StatementArenaException when the file ends before the
+             * string.
+             */
+            static void readString(std::istream& stream, std::string& string);
+
+            /**
+             * @brief Check that a rule read from a compiled file is one the
+             * parser could have produced.
+             *
+             * @param[in] statement The rule.
+             * @throws StatementArenaException when the rule is malformed.
+             */
+            static void checkRule(const obelisk::Statement& statement);
+
+        public:
+            /**
+             * @brief Get the interned names.
+             *
+             * @return obelisk::StringTable& The names.
+             */
+            obelisk::StringTable& getStrings();
+
+            /**
+             * @brief Get the parsed statements.
+             *
+             * @return std::vector<obelisk::Statement>& The statements.
+             */
+            std::vector<obelisk::Statement>& getStatements();
+
+            /**
+             * @brief Add a new empty Statement.
+             *
+             * @param[in] kind The kind of the Statement.
+             * @return obelisk::Statement& Returns the Statement, which stays
+             * valid until another one is added.
+             */
+            obelisk::Statement& addStatement(obelisk::Statement::Kind kind);
+
+            /**
+             * @brief Add a name to the lists of entities.
+             *
+             * @param[in] name The ID of the name.
+             */
+            void addName(std::uint32_t name);
+
+            /**
+             * @brief Get the number of names in the lists of entities, which
+             * is the index the next name is added at.
+             *
+             * @return std::uint32_t Returns the number of names.
+             */
+            std::uint32_t getNameCount();
+
+            /**
+             * @brief Get a name from the lists of entities.
+             *
+             * @param[in] index The index of the name.
+             * @return std::uint32_t Returns the ID of the name.
+             */
+            std::uint32_t getName(std::uint32_t index);
+
+            /**
+             * @brief Get the number of statements of a kind added to the
+             * arena, by parsing or by reading a compiled file, since it was
+             * created.
+             *
+             * @param[in] kind The kind of the statements.
+             * @return std::size_t Returns the number of statements.
+             */
+            std::size_t getAddedCount(obelisk::Statement::Kind kind);
+
+            /**
+             * @brief Remove every Statement while keeping the memory and the
+             * interned names to reuse.
+             *
+             */
+            void clear();
+
+            /**
+             * @brief Write the statements in the compiled format of an .obkc
+             * file.
+             *
+             * The file starts with the magic "OBKC" and the version of the
+             * format, followed by the interned names, the lists of entities
+             * and then one packed record for each Statement holding only the
+             * fields its kind uses. All the numbers are little endian, so a
+             * file can be read on any machine.
+             *
+             * @param[in] stream The stream to write to, opened in binary mode.
+             * @throws StatementArenaException when the stream can't be written
+             * to.
+             */
+            void write(std::ostream& stream);
+
+            /**
+             * @brief Read the statements of an .obkc file and add them after
+             * the statements already in the arena.
+             *
+             * The names of the file are interned in the arena and the
+             * statements are changed to use their new IDs, so statements
+             * compiled from several files can be merged.
+             *
+             * @param[in] stream The stream to read from, opened in binary
+             * mode.
+             * @throws StatementArenaException when the file isn't in the
+             * compiled format or is corrupted.
+             */
+            void read(std::istream& stream);
+    };
+
+    /**
+     * @brief The exceptions thrown by the StatementArena.
+     *
+     */
+    class StatementArenaException : public std::exception
+    {
+        private:
+            /**
+             * @brief The error message.
+             *
+             */
+            const std::string errorMessage_;
+
+        public:
+            /**
+             * @brief Construct a new StatementArenaException object.
+             *
+             */
+            StatementArenaException() :
+                errorMessage_("an unknown error ocurred")
+            {
+            }
+
+            /**
+             * @brief Construct a new StatementArenaException object.
+             *
+             * @param[in] errorMessage The error message.
+             */
+            StatementArenaException(const std::string& errorMessage) :
+                errorMessage_(errorMessage)
+            {
+            }
+
+            /**
+             * @brief Return the error message as a C style string.
+             *
+             * @return const char* Returns the error message.
+             */
+            const char* what() const noexcept
+            {
+                return errorMessage_.c_str();
+            }
+    };
+} // namespace obelisk
+
+#endif
@@ -0,0 +1,37 @@
+#include "string_table.h"
+
+#include <stdexcept>
+
+obelisk::StringTable::StringTable()
+{
+    intern("");
+}
+
+std::uint32_t obelisk::StringTable::intern(std::string_view string)
+{
+    auto id = ids_.find(string);
+    if (id != ids_.end())
+    {
+        return id->second;
+    }
+
+    if (strings_.size() > UINT32_MAX)
+    {
+        throw std::length_error("too many names");
+    }
+
+    auto& stored = strings_.emplace_back(string);
+    auto newId   = static_cast<std::uint32_t>(strings_.size() - 1);
+    ids_.emplace(std::string_view(stored), newId);
+    return newId;
+}
+
+const std::string& obelisk::StringTable::get(std::uint32_t id) const
+{
+    return strings_.at(id);
+}
+
+std::size_t obelisk::StringTable::size() const
+{
+    return strings_.size();
+}
@@ -0,0 +1,78 @@
+#ifndef OBELISK_STRING_TABLE_H
+#define OBELISK_STRING_TABLE_H
+
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+
+namespace obelisk
+{
+    /**
+     * @brief The StringTable class interns the names found in the source
+     * code.
+     *
+     * Every distinct name is stored once and referred to by a small ID, so a
+     * name that is used in many statements is only allocated the first time
+     * it is seen. The ID 0 is always the empty string.
+     *
+     */
+    class StringTable
+    {
+        private:
+            /**
+             * @brief The interned strings indexed by their ID.
+             *
+             * A deque never moves its elements, so the views used as keys of
+             * the index stay valid as strings are added.
+             *
+             */
+            std::deque<std::string> strings_;
+
+            /**
+             * @brief The ID of each interned string.
+             *
+             */
+            std::unordered_map<std::string_view, std::uint32_t> ids_;
+
+        public:
+            /**
+             * @brief Construct a new StringTable object holding only the
+             * empty string.
+             *
+             */
+            StringTable();
+
+            StringTable(const StringTable&)            = delete;
+            StringTable& operator=(const StringTable&) = delete;
+
+            /**
+             * @brief Intern a string.
+             *
+             * @param[in] string The string to intern.
+             * @return std::uint32_t Returns the ID of the string, which is the
+             * same every time the same string is interned.
+             */
+            std::uint32_t intern(std::string_view string);
+
+            /**
+             * @brief Get an interned string.
+             *
+             * @param[in] id The ID of the string.
+             * @return const std::string& Returns the string.
+             */
+            const std::string& get(std::uint32_t id) const;
+
+            /**
+             * @brief Get the number of interned strings.
+             *
+             * @return std::size_t Returns the number of strings, including the
+             * empty string.
+             */
+            std::size_t size() const;
+    };
+} // namespace obelisk
+
+#endif